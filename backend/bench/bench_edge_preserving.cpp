@@ -0,0 +1,127 @@
+/**
+ * @file bench_edge_preserving.cpp
+ * @brief Speed/quality comparison of GuidedFilter against cv::bilateralFilter
+ *
+ * A synthetic scene (flat regions, gradients, sharp edges) is corrupted with
+ * gaussian noise and smoothed with both filters at several radii. For each
+ * configuration the benchmark prints the median time per frame and the PSNR
+ * of the result against the clean scene.
+ *
+ * Usage: bench_edge_preserving [width] [height] [iterations]
+ */
+
+#include "filters/GuidedFilter.hpp"
+#include "utils/Logger.hpp"
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace visioncore;
+
+namespace {
+
+cv::Mat makeScene(const cv::Size &size) {
+  cv::Mat scene(size, CV_8UC3);
+
+  // Horizontal gradient background
+  for (int y = 0; y < size.height; ++y) {
+    auto *row = scene.ptr<cv::Vec3b>(y);
+    for (int x = 0; x < size.width; ++x) {
+      const auto v = static_cast<uchar>(40 + 120 * x / size.width);
+      row[x] = cv::Vec3b(v, static_cast<uchar>(v / 2 + 30), 90);
+    }
+  }
+
+  // Hard edged shapes
+  const int unit = std::max(8, size.height / 12);
+  for (int i = 0; i < 8; ++i) {
+    const cv::Point center(size.width * (i + 1) / 9,
+                           size.height / 2 + ((i % 2) ? unit : -unit));
+    cv::circle(scene, center, unit, cv::Scalar(30 * i, 200, 255 - 25 * i),
+               cv::FILLED);
+    cv::rectangle(scene,
+                  cv::Rect(center.x - unit / 2, unit, unit, 2 * unit),
+                  cv::Scalar(240, 240 - 20 * i, 20), cv::FILLED);
+  }
+
+  return scene;
+}
+
+/**
+ * @brief Median wall time in milliseconds of fn over iterations runs
+ */
+double medianMs(int iterations, const std::function<void()> &fn) {
+  fn(); // warm up caches, thread pool and scratch buffers
+
+  std::vector<double> times;
+  for (int i = 0; i < iterations; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    times.push_back(
+        std::chrono::duration<double, std::milli>(end - start).count());
+  }
+
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+void printRow(const std::string &name, int radius, double ms, double psnr) {
+  std::printf("%-28s %6d %10.2f %8.1f %8.2f\n", name.c_str(), radius, ms,
+              1000.0 / ms, psnr);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const int width = argc > 1 ? std::stoi(argv[1]) : 1920;
+  const int height = argc > 2 ? std::stoi(argv[2]) : 1080;
+  const int iterations = argc > 3 ? std::stoi(argv[3]) : 10;
+
+  utils::Logger::instance().setLogLevel(utils::LogLevel::WARNING);
+
+  const cv::Mat clean = makeScene(cv::Size(width, height));
+
+  cv::Mat noise(clean.size(), CV_16SC3);
+  cv::randn(noise, cv::Scalar::all(0), cv::Scalar::all(12));
+  cv::Mat noisy;
+  clean.convertTo(noisy, CV_16SC3);
+  noisy += noise;
+  noisy.convertTo(noisy, CV_8UC3);
+
+  std::printf("Edge-preserving smoothing, %dx%d BGR, %d threads, median of "
+              "%d runs\n",
+              width, height, cv::getNumThreads(), iterations);
+  std::printf("Noisy input PSNR: %.2f dB\n\n", cv::PSNR(clean, noisy));
+  std::printf("%-28s %6s %10s %8s %8s\n", "filter", "radius", "ms/frame",
+              "fps", "PSNR");
+
+  cv::Mat output;
+
+  for (int radius : {4, 8, 16}) {
+    for (int subsample : {1, 4}) {
+      filters::GuidedFilter guided(radius, 0.01, subsample);
+      const double ms =
+          medianMs(iterations, [&] { guided.apply(noisy, output); });
+      printRow("guided (subsample " + std::to_string(subsample) + ")",
+               radius, ms, cv::PSNR(clean, output));
+    }
+
+    // Bilateral cost grows with the square of the diameter: fewer runs
+    const int bilateral_runs = std::max(1, iterations / (radius / 4));
+    const double ms = medianMs(bilateral_runs, [&] {
+      cv::bilateralFilter(noisy, output, 2 * radius + 1, 30.0,
+                          static_cast<double>(radius));
+    });
+    printRow("cv::bilateralFilter", radius, ms, cv::PSNR(clean, output));
+  }
+
+  return 0;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file bench_jpeg.cpp
+ * @brief JPEG encode cost: cv::imencode vs the direct libjpeg backend
+ *
+ * Encodes the same SyntheticSource frames with each backend and option set,
+ * reusing one output buffer per run as the streaming path does. Reports
+ * ms/frame and the average JPEG size; the libjpeg rows are skipped when the
+ * library was not found at configure time. The strip rows show how the
+ * parallel encoder scales with the number of cores.
+ *
+ * Usage: bench_jpeg [width] [height] [frames] [quality]
+ */
+
+#include "core/SyntheticSource.hpp"
+#include "processing/FrameEncoder.hpp"
+#include "utils/Logger.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace visioncore;
+
+namespace {
+
+std::vector<cv::Mat> makeFrames(int width, int height, int frames, int type) {
+  core::SyntheticOptions options;
+  options.width = width;
+  options.height = height;
+  options.frame_count = frames;
+  options.type = type;
+  options.pattern = core::SyntheticOptions::Pattern::GRADIENT;
+
+  core::SyntheticSource source(options);
+  source.open();
+
+  std::vector<cv::Mat> result;
+  cv::Mat frame;
+  while (source.readFrame(frame)) {
+    result.push_back(frame.clone());
+  }
+  return result;
+}
+
+void bench(const char *name, const std::vector<cv::Mat> &frames, int quality,
+           const processing::JpegOptions &options) {
+  const processing::FrameEncoder encoder(quality, options);
+  std::vector<uint8_t> buffer;
+  size_t total_bytes = 0;
+
+  encoder.encodeJPEG(frames.front(), buffer); // warm-up
+
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto &frame : frames) {
+    encoder.encodeJPEG(frame, buffer);
+    total_bytes += buffer.size();
+  }
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+
+  std::printf("%-32s %8.3f ms/frame %9zu bytes\n", name,
+              seconds * 1000.0 / frames.size(), total_bytes / frames.size());
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const int width = argc > 1 ? std::stoi(argv[1]) : 1920;
+  const int height = argc > 2 ? std::stoi(argv[2]) : 1080;
+  const int count = argc > 3 ? std::stoi(argv[3]) : 100;
+  const int quality = argc > 4 ? std::stoi(argv[4]) : 85;
+
+  utils::Logger::instance().setLogLevel(utils::LogLevel::WARNING);
+
+  using processing::ChromaSubsampling;
+  using processing::DctMethod;
+  using processing::JpegBackend;
+  using processing::JpegOptions;
+
+  JpegOptions opencv;
+  opencv.backend = JpegBackend::OPENCV;
+  JpegOptions libjpeg;
+  libjpeg.backend = JpegBackend::LIBJPEG;
+
+  const std::vector<cv::Mat> color = makeFrames(width, height, count, CV_8UC3);
+  const std::vector<cv::Mat> gray = makeFrames(width, height, count, CV_8UC1);
+  std::printf("%dx%d, %d frames, quality %d\n", width, height, count,
+              quality);
+
+  bench("imencode BGR 4:2:0", color, quality, opencv);
+  bench("imencode gray", gray, quality, opencv);
+
+  if (!processing::FrameEncoder::hasLibjpeg()) {
+    std::printf("libjpeg backend not built (VISIONCORE_HAS_LIBJPEG)\n");
+    return 0;
+  }
+
+  bench("libjpeg BGR 4:2:0", color, quality, libjpeg);
+  bench("libjpeg gray", gray, quality, libjpeg);
+
+  JpegOptions variant = libjpeg;
+  variant.subsampling = ChromaSubsampling::S422;
+  bench("libjpeg BGR 4:2:2", color, quality, variant);
+  variant.subsampling = ChromaSubsampling::S444;
+  bench("libjpeg BGR 4:4:4", color, quality, variant);
+
+  variant = libjpeg;
+  variant.dct = DctMethod::IFAST;
+  bench("libjpeg BGR 4:2:0 IFAST", color, quality, variant);
+  variant.dct = DctMethod::ISLOW;
+  variant.optimize_huffman = true;
+  bench("libjpeg BGR 4:2:0 optimized", color, quality, variant);
+
+  const int cores = static_cast<int>(std::thread::hardware_concurrency());
+  for (int strips = 2; strips <= cores; strips *= 2) {
+    variant = libjpeg;
+    variant.strips = strips;
+    const std::string name =
+        "libjpeg BGR 4:2:0 " + std::to_string(strips) + " strips";
+    bench(name.c_str(), color, quality, variant);
+  }
+  variant.strips = 0;
+  bench("libjpeg BGR 4:2:0 auto strips", color, quality, variant);
+
+  return 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file bench_prefetch.cpp
+ * @brief Throughput of a heavy pipeline on VideoFileSource, with and without
+ * PrefetchingSource
+ *
+ * The same video is decoded and processed twice: once reading synchronously
+ * on the processing thread (as FrameController does with a bare source) and
+ * once through a NEVER_DROP PrefetchingSource. The speedup is bounded by the
+ * share of decode time in the serial loop.
+ *
+ * Usage: bench_prefetch <video> [max_frames] [depth]
+ */
+
+#include "core/PrefetchingSource.hpp"
+#include "core/VideoFileSource.hpp"
+#include "filters/CLAHEFilter.hpp"
+#include "filters/GuidedFilter.hpp"
+#include "pipeline/FramePipeline.hpp"
+#include "utils/Logger.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+using namespace visioncore;
+
+namespace {
+
+struct RunResult {
+  int frames = 0;
+  double seconds = 0.0;
+  double decode_wait_ms = 0.0; ///< Time spent inside readFrame()
+};
+
+RunResult run(core::VideoSource &source, pipeline::FramePipeline &pipeline,
+              int max_frames) {
+  RunResult result;
+  cv::Mat input;
+  cv::Mat output;
+
+  const auto start = std::chrono::steady_clock::now();
+
+  while (result.frames < max_frames) {
+    const auto read_start = std::chrono::steady_clock::now();
+    if (!source.readFrame(input)) {
+      break;
+    }
+    result.decode_wait_ms += std::chrono::duration<double, std::milli>(
+                                 std::chrono::steady_clock::now() - read_start)
+                                 .count();
+
+    pipeline.process(input, output);
+    ++result.frames;
+  }
+
+  result.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return result;
+}
+
+void printResult(const char *name, const RunResult &r) {
+  std::printf("%-12s %6d frames %8.2f fps   read wait %6.2f ms/frame\n", name,
+              r.frames, r.frames / r.seconds,
+              r.frames > 0 ? r.decode_wait_ms / r.frames : 0.0);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::printf("Usage: %s <video> [max_frames] [depth]\n", argv[0]);
+    return 1;
+  }
+
+  const std::string path = argv[1];
+  const int max_frames = argc > 2 ? std::stoi(argv[2]) : 300;
+  const size_t depth = argc > 3 ? std::stoul(argv[3]) : 3;
+
+  utils::Logger::instance().setLogLevel(utils::LogLevel::WARNING);
+
+  // Heavy enough that processing and decode are of the same order
+  pipeline::FramePipeline pipeline("bench");
+  pipeline.addFilter(std::make_shared<filters::GuidedFilter>(8, 0.01, 2));
+  pipeline.addFilter(std::make_shared<filters::CLAHEFilter>());
+
+  core::VideoFileSource serial(path);
+  if (!serial.open()) {
+    std::printf("Cannot open %s\n", path.c_str());
+    return 1;
+  }
+  const RunResult base = run(serial, pipeline, max_frames);
+  serial.close();
+
+  core::PrefetchingSource prefetched(
+      std::make_unique<core::VideoFileSource>(path),
+      core::PrefetchingSource::Mode::NEVER_DROP, depth);
+  if (!prefetched.open()) {
+    std::printf("Cannot open %s\n", path.c_str());
+    return 1;
+  }
+  const RunResult async = run(prefetched, pipeline, max_frames);
+  prefetched.close();
+
+  std::printf("%s, %dx%d, depth %zu\n", path.c_str(), serial.getWidth(),
+              serial.getHeight(), depth);
+  printResult("serial", base);
+  printResult("prefetch", async);
+  std::printf("speedup: %.2fx, pool allocations: %llu\n",
+              (async.frames / async.seconds) / (base.frames / base.seconds),
+              static_cast<unsigned long long>(
+                  prefetched.getPoolAllocations()));
+
+  return 0;
+}
@@ -0,0 +1,178 @@
+/**
+ * @file bench_shm.cpp
+ * @brief Shared-memory ring throughput and publish-to-read latency
+ *
+ * Publishes SyntheticSource frames into a SharedMemorySink at a given rate
+ * (0 = as fast as possible) while a forked reader process follows the
+ * stream with SharedMemoryReader, once copying each frame out and once
+ * looking at it in place. Reports the publish cost, the frames the reader
+ * got and missed, and the publish-to-read latency seen by the reader.
+ *
+ * Usage: bench_shm [width] [height] [frames] [fps]
+ */
+
+#include "core/SyntheticSource.hpp"
+#include "sinks/SharedMemoryReader.hpp"
+#include "sinks/SharedMemorySink.hpp"
+#include "utils/Logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace visioncore;
+
+namespace {
+
+struct ReaderResult {
+  uint64_t received = 0;
+  uint64_t missed = 0;
+  double avg_latency_us = 0.0;
+  double max_latency_us = 0.0;
+};
+
+/// Reader process body: follows the ring until the last frame id
+ReaderResult follow(const std::string &name, uint64_t last_id, bool copy) {
+  ReaderResult result;
+  sinks::SharedMemoryReader reader(name);
+  if (!reader.open()) {
+    return result;
+  }
+
+  cv::Mat frame;
+  sinks::SharedFrameInfo info;
+  uint64_t index = 0; // next frame to try
+  uint64_t next = 0;  // next frame not received or counted as missed
+  double total_us = 0.0;
+  while (reader.waitFor(index, std::chrono::seconds(5))) {
+    const bool ok =
+        copy ? reader.read(index, frame, info) ==
+                   sinks::SharedMemoryReader::ReadResult::OK
+             : reader.peekLatest(frame, info) && reader.isCurrent(info);
+    if (!ok) {
+      // Lapped by the writer: catch up with the newest frame
+      index = std::max(index + 1, reader.getPublishedCount()) - 1;
+      continue;
+    }
+
+    const double latency_us = static_cast<double>(
+        sinks::shmMicros(std::chrono::steady_clock::now()) - info.publish_us);
+    total_us += latency_us;
+    result.max_latency_us = std::max(result.max_latency_us, latency_us);
+    result.missed += info.index - next;
+    ++result.received;
+    next = index = info.index + 1;
+    if (info.frame_id == last_id) {
+      break;
+    }
+  }
+  result.avg_latency_us =
+      result.received > 0 ? total_us / result.received : 0.0;
+  return result;
+}
+
+void bench(const char *mode, const std::vector<cv::Mat> &frames, double fps,
+           bool copy) {
+  const std::string name = "/visioncore_bench_" + std::to_string(::getpid());
+  sinks::SharedMemoryOptions options;
+  options.slots = 4;
+  options.frame_capacity = frames.front().total() * frames.front().elemSize();
+  sinks::SharedMemorySink sink(name, options);
+  if (!sink.open()) {
+    std::printf("%-8s cannot create shared memory\n", mode);
+    return;
+  }
+
+  int pipe_fds[2];
+  if (::pipe(pipe_fds) != 0) {
+    return;
+  }
+  const uint64_t last_id = frames.size() - 1;
+  const pid_t pid = ::fork();
+  if (pid == 0) {
+    ::close(pipe_fds[0]);
+    const ReaderResult result = follow(name, last_id, copy);
+    const bool sent =
+        ::write(pipe_fds[1], &result, sizeof(result)) == sizeof(result);
+    ::_exit(sent ? 0 : 1);
+  }
+  ::close(pipe_fds[1]);
+
+  // Give the reader time to map the ring
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  const auto period = std::chrono::duration<double>(fps > 0.0 ? 1.0 / fps : 0);
+  auto next = std::chrono::steady_clock::now();
+  double publish_ms = 0.0;
+  for (uint64_t i = 0; i < frames.size(); ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    sink.publish(frames[i], i, start);
+    publish_ms += std::chrono::duration<double, std::milli>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+    if (fps > 0.0) {
+      next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          period);
+      std::this_thread::sleep_until(next);
+    }
+  }
+
+  ReaderResult result;
+  const bool received =
+      ::read(pipe_fds[0], &result, sizeof(result)) == sizeof(result);
+  ::close(pipe_fds[0]);
+  ::waitpid(pid, nullptr, 0);
+  if (!received) {
+    std::printf("%-8s reader failed\n", mode);
+    return;
+  }
+
+  const double mb = static_cast<double>(options.frame_capacity) / 1e6;
+  std::printf("%-8s publish %7.3f ms/frame %8.1f MB/s | read %5lu missed "
+              "%5lu | latency avg %8.1f us max %8.1f us\n",
+              mode, publish_ms / frames.size(),
+              mb * frames.size() / (publish_ms / 1000.0),
+              static_cast<unsigned long>(result.received),
+              static_cast<unsigned long>(result.missed),
+              result.avg_latency_us, result.max_latency_us);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const int width = argc > 1 ? std::stoi(argv[1]) : 1920;
+  const int height = argc > 2 ? std::stoi(argv[2]) : 1080;
+  const int count = argc > 3 ? std::stoi(argv[3]) : 300;
+  const double fps = argc > 4 ? std::stod(argv[4]) : 60.0;
+
+  utils::Logger::instance().setLogLevel(utils::LogLevel::WARNING);
+
+  core::SyntheticOptions options;
+  options.width = width;
+  options.height = height;
+  options.frame_count = count;
+  options.pattern = core::SyntheticOptions::Pattern::GRADIENT;
+  core::SyntheticSource source(options);
+  source.open();
+
+  std::vector<cv::Mat> frames;
+  cv::Mat frame;
+  while (source.readFrame(frame)) {
+    frames.push_back(frame.clone());
+  }
+  if (frames.empty()) {
+    std::printf("No frames\n");
+    return 1;
+  }
+
+  std::printf("%dx%d, %zu frames at %g fps (0 = unpaced)\n", width, height,
+              frames.size(), fps);
+  bench("copy", frames, fps, true);
+  bench("in place", frames, fps, false);
+  return 0;
+}
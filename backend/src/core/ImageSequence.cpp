@@ -0,0 +1,507 @@
+/**
+ * @file ImageSequence.cpp
+ * @brief ImageSequenceSource implementation
+ */
+
+#include "ImageSequence.hpp"
+#include "../utils/Logger.hpp"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <opencv2/imgcodecs.hpp>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace visioncore::core {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/**
+ * @brief Extensions cv::imread is expected to handle
+ */
+bool isImageFile(const fs::path &path) {
+  std::string ext = path.extension().string();
+  std::transform(ext.begin(), ext.end(), ext.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+
+  static const char *const kExtensions[] = {
+      ".jpg", ".jpeg", ".png", ".bmp", ".tif", ".tiff",
+      ".webp", ".pgm", ".ppm", ".pbm", ".pnm", ".exr"};
+  return std::find(std::begin(kExtensions), std::end(kExtensions), ext) !=
+         std::end(kExtensions);
+}
+
+/**
+ * @brief String order where digit runs compare as numbers (2 < 10)
+ */
+bool naturalLess(const std::string &a, const std::string &b) {
+  size_t i = 0;
+  size_t j = 0;
+
+  while (i < a.size() && j < b.size()) {
+    const bool da = std::isdigit(static_cast<unsigned char>(a[i]));
+    const bool db = std::isdigit(static_cast<unsigned char>(b[j]));
+
+    if (da && db) {
+      size_t ei = i;
+      size_t ej = j;
+      while (ei < a.size() && std::isdigit(static_cast<unsigned char>(a[ei])))
+        ++ei;
+      while (ej < b.size() && std::isdigit(static_cast<unsigned char>(b[ej])))
+        ++ej;
+
+      // Compare numbers without converting them: skip leading zeros, then a
+      // longer run is bigger, then lexicographic
+      size_t si = i;
+      size_t sj = j;
+      while (si + 1 < ei && a[si] == '0')
+        ++si;
+      while (sj + 1 < ej && b[sj] == '0')
+        ++sj;
+
+      if (ei - si != ej - sj) {
+        return ei - si < ej - sj;
+      }
+      const int cmp = a.compare(si, ei - si, b, sj, ej - sj);
+      if (cmp != 0) {
+        return cmp < 0;
+      }
+
+      i = ei;
+      j = ej;
+    } else {
+      if (a[i] != b[j]) {
+        return a[i] < b[j];
+      }
+      ++i;
+      ++j;
+    }
+  }
+
+  return a.size() - i < b.size() - j;
+}
+
+/**
+ * @brief Shell-style match of a file name: '*' any run, '?' any character
+ */
+bool wildcardMatch(const std::string &pattern, const std::string &text) {
+  size_t p = 0;
+  size_t t = 0;
+  size_t star = std::string::npos;
+  size_t resume = 0;
+
+  while (t < text.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+      ++p;
+      ++t;
+    } else if (p < pattern.size() && pattern[p] == '*') {
+      star = p++;
+      resume = t;
+    } else if (star != std::string::npos) {
+      p = star + 1;
+      t = ++resume;
+    } else {
+      return false;
+    }
+  }
+
+  while (p < pattern.size() && pattern[p] == '*') {
+    ++p;
+  }
+  return p == pattern.size();
+}
+
+/**
+ * @brief File name pattern with a single %d, %Nd or %0Nd conversion
+ */
+struct NumberPattern {
+  std::string prefix;
+  std::string suffix;
+  size_t width = 0;     ///< Minimum number of digits
+  bool zero_pad = false;
+};
+
+std::optional<NumberPattern> parseNumberPattern(const std::string &name) {
+  const size_t percent = name.find('%');
+  if (percent == std::string::npos) {
+    return std::nullopt;
+  }
+
+  NumberPattern number;
+  number.prefix = name.substr(0, percent);
+
+  size_t pos = percent + 1;
+  if (pos < name.size() && name[pos] == '0') {
+    number.zero_pad = true;
+    ++pos;
+  }
+  while (pos < name.size() &&
+         std::isdigit(static_cast<unsigned char>(name[pos]))) {
+    number.width = number.width * 10 + static_cast<size_t>(name[pos] - '0');
+    ++pos;
+  }
+  if (pos >= name.size() || name[pos] != 'd') {
+    return std::nullopt;
+  }
+
+  number.suffix = name.substr(pos + 1);
+  if (number.suffix.find('%') != std::string::npos) {
+    return std::nullopt;
+  }
+  return number;
+}
+
+/**
+ * @brief Number matched by a file name, if it follows the pattern
+ */
+std::optional<uint64_t> matchNumber(const NumberPattern &number,
+                                    const std::string &name) {
+  if (name.size() <= number.prefix.size() + number.suffix.size() ||
+      name.compare(0, number.prefix.size(), number.prefix) != 0 ||
+      name.compare(name.size() - number.suffix.size(), number.suffix.size(),
+                   number.suffix) != 0) {
+    return std::nullopt;
+  }
+
+  const std::string digits =
+      name.substr(number.prefix.size(),
+                  name.size() - number.prefix.size() - number.suffix.size());
+  if (digits.size() > 18 ||
+      !std::all_of(digits.begin(), digits.end(), [](unsigned char c) {
+        return std::isdigit(c);
+      })) {
+    return std::nullopt;
+  }
+
+  // "%05d" writes exactly 5 digits below 100000, never a leading zero beyond
+  if (number.zero_pad && digits.size() < number.width) {
+    return std::nullopt;
+  }
+  if (digits.size() > 1 && digits[0] == '0' &&
+      (!number.zero_pad || digits.size() > number.width)) {
+    return std::nullopt;
+  }
+
+  return std::stoull(digits);
+}
+
+} // namespace
+
+ImageSequenceSource::ImageSequenceSource(const std::string &pattern, double fps)
+    : pattern_(pattern) {
+  options_.fps = fps;
+}
+
+ImageSequenceSource::ImageSequenceSource(const std::string &pattern,
+                                         const ImageSequenceOptions &options)
+    : pattern_(pattern), options_(options) {}
+
+ImageSequenceSource::~ImageSequenceSource() { close(); }
+
+std::vector<std::string>
+ImageSequenceSource::expandPattern(const std::string &pattern) {
+  std::vector<std::string> paths;
+  std::error_code ec;
+
+  // Whole directory
+  if (fs::is_directory(pattern, ec)) {
+    for (const auto &entry : fs::directory_iterator(pattern, ec)) {
+      if (entry.is_regular_file(ec) && isImageFile(entry.path())) {
+        paths.push_back(entry.path().string());
+      }
+    }
+    std::sort(paths.begin(), paths.end(), naturalLess);
+    return paths;
+  }
+
+  // Patterns only apply to the file name
+  const fs::path full(pattern);
+  const fs::path dir = full.has_parent_path() ? full.parent_path() : ".";
+  const std::string name = full.filename().string();
+
+  if (const auto number = parseNumberPattern(name)) {
+    std::vector<std::pair<uint64_t, std::string>> numbered;
+    for (const auto &entry : fs::directory_iterator(dir, ec)) {
+      if (!entry.is_regular_file(ec)) {
+        continue;
+      }
+      if (const auto n =
+              matchNumber(*number, entry.path().filename().string())) {
+        numbered.emplace_back(*n, entry.path().string());
+      }
+    }
+    std::sort(numbered.begin(), numbered.end());
+    for (auto &[n, path] : numbered) {
+      paths.push_back(std::move(path));
+    }
+    return paths;
+  }
+
+  if (name.find_first_of("*?") != std::string::npos) {
+    for (const auto &entry : fs::directory_iterator(dir, ec)) {
+      if (entry.is_regular_file(ec) &&
+          wildcardMatch(name, entry.path().filename().string())) {
+        paths.push_back(entry.path().string());
+      }
+    }
+    std::sort(paths.begin(), paths.end(), naturalLess);
+    return paths;
+  }
+
+  // Plain file: a sequence of one
+  if (fs::is_regular_file(full, ec)) {
+    paths.push_back(pattern);
+  }
+  return paths;
+}
+
+bool ImageSequenceSource::open() {
+  LOG_INFO("Opening image sequence: " + pattern_);
+
+  if (is_opened_) {
+    close();
+  }
+
+  paths_ = expandPattern(pattern_);
+  if (paths_.empty()) {
+    LOG_ERROR("No image matches " + pattern_);
+    return false;
+  }
+
+  pool_ = std::make_unique<utils::ThreadPool>(options_.decode_threads);
+  current_index_ = 0;
+  decode_count_ = 0;
+  cache_hits_ = 0;
+
+  // The first frame gives the geometry of the sequence
+  {
+    std::unique_lock<std::mutex> lock(cache_mutex_);
+    window_begin_ = 0;
+    scheduleLocked(0);
+    cache_cv_.wait(lock, [this] { return cache_.at(0).ready; });
+
+    const CacheEntry &first = cache_.at(0);
+    if (first.failed) {
+      lock.unlock();
+      LOG_ERROR("Failed to decode " + paths_.front());
+      close();
+      return false;
+    }
+    width_ = first.frame.cols;
+    height_ = first.frame.rows;
+  }
+
+  is_opened_ = true;
+  next_frame_time_ = std::chrono::steady_clock::now();
+
+  LOG_INFO("Image sequence opened: " + std::to_string(paths_.size()) +
+           " frames, " + std::to_string(width_) + "x" +
+           std::to_string(height_) + " @ " + std::to_string(options_.fps) +
+           " FPS, " + std::to_string(pool_->size()) + " decoder threads");
+  return true;
+}
+
+bool ImageSequenceSource::readFrame(cv::Mat &frame) {
+  FrameInfo info;
+  return readFrame(frame, info);
+}
+
+bool ImageSequenceSource::readFrame(cv::Mat &frame, FrameInfo &info) {
+  if (!is_opened_) {
+    return false;
+  }
+
+  // Unreadable files are skipped, at most one full pass over the sequence
+  size_t index = current_index_;
+  bool found = false;
+  for (size_t attempt = 0; attempt < paths_.size(); ++attempt) {
+    if (index >= paths_.size()) {
+      if (!options_.loop) {
+        current_index_ = index;
+        return false;
+      }
+      index = 0;
+    }
+
+    std::unique_lock<std::mutex> lock(cache_mutex_);
+    window_begin_ = index;
+    scheduleLocked(index);
+
+    CacheEntry &entry = cache_.at(index);
+    if (entry.ready) {
+      ++cache_hits_;
+    } else {
+      cache_cv_.wait(lock, [&entry] { return entry.ready; });
+    }
+
+    if (entry.failed) {
+      LOG_WARNING("Skipping unreadable image " + paths_[index]);
+      ++index;
+      continue;
+    }
+
+    // The cache keeps its copy for looping and seeking back
+    entry.frame.copyTo(frame);
+    lru_.splice(lru_.begin(), lru_, entry.lru);
+    found = true;
+    break;
+  }
+
+  if (!found) {
+    return false;
+  }
+
+  if (options_.pace && options_.fps > 0.0) {
+    const auto period =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / options_.fps));
+    const auto now = std::chrono::steady_clock::now();
+
+    if (next_frame_time_ > now) {
+      std::this_thread::sleep_until(next_frame_time_);
+    } else if (now - next_frame_time_ > period) {
+      // Late (slow consumer or decoder): do not burst to catch up
+      next_frame_time_ = now;
+    }
+    next_frame_time_ += period;
+  }
+
+  info.capture_time = std::chrono::steady_clock::now();
+  info.frame_index = static_cast<int64_t>(index);
+  info.pts_ms = options_.fps > 0.0
+                    ? static_cast<double>(index) * 1000.0 / options_.fps
+                    : -1.0;
+
+  current_index_ = index + 1;
+  return true;
+}
+
+void ImageSequenceSource::scheduleLocked(size_t index) {
+  const size_t count = paths_.size();
+
+  for (size_t k = 0; k <= options_.read_ahead; ++k) {
+    size_t i = index + k;
+    if (i >= count) {
+      if (!options_.loop) {
+        break;
+      }
+      i %= count;
+    }
+
+    if (cache_.count(i) > 0) {
+      continue; // decoded or in flight
+    }
+
+    cache_.emplace(i, CacheEntry{});
+    pool_->enqueue([this, i] { decode(i); });
+  }
+}
+
+void ImageSequenceSource::decode(size_t index) {
+  cv::Mat image = cv::imread(paths_[index], options_.imread_flags);
+  ++decode_count_;
+
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    const auto it = cache_.find(index);
+    if (it == cache_.end()) {
+      return;
+    }
+
+    CacheEntry &entry = it->second;
+    entry.failed = image.empty();
+    entry.bytes = image.total() * image.elemSize();
+    entry.frame = std::move(image);
+    entry.ready = true;
+
+    lru_.push_front(index);
+    entry.lru = lru_.begin();
+    cache_bytes_ += entry.bytes;
+
+    evictLocked(window_begin_);
+  }
+  cache_cv_.notify_all();
+}
+
+bool ImageSequenceSource::inWindow(size_t index, size_t window_begin) const {
+  const size_t count = paths_.size();
+  size_t distance;
+  if (index >= window_begin) {
+    distance = index - window_begin;
+  } else if (options_.loop) {
+    distance = index + count - window_begin;
+  } else {
+    return false;
+  }
+  return distance <= options_.read_ahead;
+}
+
+void ImageSequenceSource::evictLocked(size_t window_begin) {
+  auto it = lru_.end();
+  while (cache_bytes_ > options_.cache_bytes && it != lru_.begin()) {
+    --it;
+    if (inWindow(*it, window_begin)) {
+      continue; // about to be played
+    }
+
+    const auto entry = cache_.find(*it);
+    cache_bytes_ -= entry->second.bytes;
+    cache_.erase(entry);
+    it = lru_.erase(it);
+  }
+}
+
+size_t ImageSequenceSource::getCacheBytes() const {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  return cache_bytes_;
+}
+
+bool ImageSequenceSource::seek(size_t index) {
+  if (!is_opened_ || index >= paths_.size()) {
+    return false;
+  }
+
+  current_index_ = index;
+  next_frame_time_ = std::chrono::steady_clock::now();
+
+  // Start decoding the new position right away
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  window_begin_ = index;
+  scheduleLocked(index);
+  return true;
+}
+
+void ImageSequenceSource::reset() {
+  if (!seek(0)) {
+    current_index_ = 0;
+  }
+}
+
+void ImageSequenceSource::close() {
+  // Joins the decoders: nothing touches the cache afterwards
+  pool_.reset();
+
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    cache_.clear();
+    lru_.clear();
+    cache_bytes_ = 0;
+  }
+
+  if (is_opened_) {
+    LOG_INFO(pattern_ + " closed");
+  }
+  is_opened_ = false;
+}
+
+int ImageSequenceSource::getWidth() const { return width_; }
+int ImageSequenceSource::getHeight() const { return height_; }
+double ImageSequenceSource::getFPS() const { return options_.fps; }
+bool ImageSequenceSource::isOpened() const { return is_opened_; }
+std::string ImageSequenceSource::getName() const { return pattern_; }
+
+} // namespace visioncore::core
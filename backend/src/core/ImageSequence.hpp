@@ -0,0 +1,184 @@
+/**
+ * @file ImageSequence.hpp
+ * @brief VideoSource implementation for numbered image files
+ *
+ * Plays a sequence of image files as a video. The files are given by:
+ *  - a directory: every image in it, in natural order (frame2 < frame10)
+ *  - a glob in the file name: "dir/frame_*.png"
+ *  - a printf-style pattern: "dir/frame_%05d.jpg", in numeric order
+ *
+ * Frames are decoded ahead of playback on a pool of worker threads and kept
+ * in a memory-bounded LRU cache, so looping over a sequence that fits in
+ * the budget decodes each file once.
+ */
+
+#ifndef IMAGE_SEQUENCE_HPP
+#define IMAGE_SEQUENCE_HPP
+
+#include "VideoSource.hpp"
+#include "../utils/ThreadPool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace visioncore::core {
+
+/**
+ * @brief Playback and decoding settings for ImageSequenceSource
+ */
+struct ImageSequenceOptions {
+  double fps = 30.0;         ///< Playback rate, also used for timestamps
+  bool pace = true;          ///< Sleep in readFrame() to honor fps
+  bool loop = false;         ///< Restart at the first frame after the last
+  size_t decode_threads = 0; ///< Decoder workers, 0 = one per core
+  size_t read_ahead = 8;     ///< Frames decoded ahead of playback
+  size_t cache_bytes = size_t{512} << 20; ///< Decoded frame budget
+  int imread_flags = cv::IMREAD_COLOR;    ///< Passed to cv::imread
+};
+
+class ImageSequenceSource : public VideoSource {
+public:
+  /**
+   * @brief Constructs a sequence source with default options
+   *
+   * @param pattern Directory, glob or printf-style pattern
+   * @param fps Playback rate
+   */
+  ImageSequenceSource(const std::string &pattern, double fps);
+
+  /**
+   * @brief Constructs a sequence source
+   *
+   * The files are not listed until open() is called.
+   *
+   * @param pattern Directory, glob or printf-style pattern
+   * @param options Playback and decoding settings
+   */
+  ImageSequenceSource(const std::string &pattern,
+                      const ImageSequenceOptions &options);
+
+  ~ImageSequenceSource() override;
+
+  // VideoSource implementation
+  bool open() override;
+  bool readFrame(cv::Mat &frame) override;
+  bool readFrame(cv::Mat &frame, FrameInfo &info) override;
+  void close() override;
+
+  int getWidth() const override;
+  int getHeight() const override;
+  double getFPS() const override;
+  bool isOpened() const override;
+  std::string getName() const override;
+
+  /**
+   * @brief Go back to the first frame
+   */
+  void reset();
+
+  /**
+   * @brief Position playback so the next readFrame() returns frame index
+   * @return false if the index is out of range or the source is closed
+   */
+  bool seek(size_t index);
+
+  /**
+   * @brief Number of files in the sequence
+   */
+  size_t getFrameCount() const { return paths_.size(); }
+
+  /**
+   * @brief Index of the next frame readFrame() will return
+   */
+  size_t getCurrentFrameIndex() const { return current_index_; }
+
+  /**
+   * @brief Files of the sequence, in playback order
+   */
+  const std::vector<std::string> &getPaths() const { return paths_; }
+
+  /**
+   * @brief Number of cv::imread calls since open()
+   */
+  uint64_t getDecodeCount() const { return decode_count_; }
+
+  /**
+   * @brief Frames already decoded when readFrame() asked for them
+   */
+  uint64_t getCacheHits() const { return cache_hits_; }
+
+  /**
+   * @brief Memory currently held by decoded frames
+   */
+  size_t getCacheBytes() const;
+
+  /**
+   * @brief List the files matching a directory, glob or printf pattern
+   */
+  static std::vector<std::string> expandPattern(const std::string &pattern);
+
+private:
+  /**
+   * @brief Decoded (or in-flight) frame
+   */
+  struct CacheEntry {
+    cv::Mat frame;
+    bool ready = false;
+    bool failed = false;
+    size_t bytes = 0;
+    std::list<size_t>::iterator lru; ///< Valid once ready
+  };
+
+  std::string pattern_;
+  ImageSequenceOptions options_;
+  std::vector<std::string> paths_;
+  size_t current_index_ = 0;
+  int width_ = 0;
+  int height_ = 0;
+  bool is_opened_ = false;
+
+  std::chrono::steady_clock::time_point next_frame_time_;
+
+  mutable std::mutex cache_mutex_;
+  std::condition_variable cache_cv_;
+  std::unordered_map<size_t, CacheEntry> cache_; ///< Guarded by cache_mutex_
+  std::list<size_t> lru_; ///< Ready frames, most recently used first
+  size_t cache_bytes_ = 0;
+  size_t window_begin_ = 0; ///< Frame being played, guarded by cache_mutex_
+
+  std::atomic<uint64_t> decode_count_{0};
+  std::atomic<uint64_t> cache_hits_{0};
+
+  std::unique_ptr<utils::ThreadPool> pool_;
+
+  /**
+   * @brief Queue decodes for index and the frames that follow it
+   */
+  void scheduleLocked(size_t index);
+
+  /**
+   * @brief Decode one file into its cache entry (worker thread)
+   */
+  void decode(size_t index);
+
+  /**
+   * @brief Drop least recently used frames outside the read-ahead window
+   */
+  void evictLocked(size_t window_begin);
+
+  /**
+   * @brief True if index will be needed within the read-ahead window
+   */
+  bool inWindow(size_t index, size_t window_begin) const;
+};
+
+} // namespace visioncore::core
+
+#endif // IMAGE_SEQUENCE_HPP
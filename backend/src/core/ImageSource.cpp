@@ -24,6 +24,7 @@ bool ImageSource::open() {
     is_opened_ = false;
   } else {
     is_opened_ = true;
+    ++generation_;
   }
 
   return is_opened_;
@@ -32,10 +33,18 @@ bool ImageSource::open() {
 bool ImageSource::readFrame(cv::Mat &frame) {
   if (!is_opened_)
     return false;
-  image_.copyTo(frame);
+  frame = image_; // shared, read-only
   return !frame.empty();
 }
 
+bool ImageSource::readFrame(cv::Mat &frame, FrameInfo &info) {
+  if (!readFrame(frame))
+    return false;
+  info.capture_time = std::chrono::steady_clock::now();
+  info.generation = generation_;
+  return true;
+}
+
 void ImageSource::close() {
   if (is_opened_) {
     image_.release();
@@ -5,6 +5,10 @@
  * Loads a single image file and returns it repeatedly on each readFrame() call.
  * Useful for testing pipelines with static input or creating slideshow-like
  * behavior. getFPS() returns 0.0 since this is not a time-based source.
+ *
+ * Frames are not copied: every readFrame() hands out a header sharing the
+ * decoded image, and FrameInfo::generation stays the same until the image is
+ * reloaded. Treat frames as read-only and clone() before writing into them.
  */
 #include "VideoSource.hpp"
 
@@ -29,6 +33,7 @@ public:
   // VideoSource implementation
   bool open() override;
   bool readFrame(cv::Mat &frame) override; // Always returns the same image
+  bool readFrame(cv::Mat &frame, FrameInfo &info) override;
   void close() override;
 
   // Property getters - return static image properties
@@ -38,10 +43,16 @@ public:
   bool isOpened() const override;
   std::string getName() const override;
 
+  /**
+   * @brief Version of the loaded image, bumped by every successful open()
+   */
+  uint64_t getGeneration() const { return generation_; }
+
 private:
   std::string image_path_; ///< Filesystem path to the image file
   cv::Mat image_;          ///< Cached image data (loaded once during open())
   bool is_opened_; ///< True if image was successfully loaded, false otherwise
+  uint64_t generation_ = 0; ///< Reported in FrameInfo, 0 until loaded
 };
 
 } // namespace visioncore::core
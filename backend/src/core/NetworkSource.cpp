@@ -0,0 +1,301 @@
+/**
+ * @file NetworkSource.cpp
+ * @brief NetworkSource implementation
+ */
+
+#include "NetworkSource.hpp"
+#include "../utils/Logger.hpp"
+
+#include <opencv2/imgcodecs.hpp>
+#include <string>
+
+namespace visioncore::core {
+
+namespace {
+
+constexpr size_t kMaxFreeBuffers = 32;
+constexpr double kAverageWeight = 0.1; ///< Moving average smoothing
+
+double toMs(std::chrono::steady_clock::duration d) {
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+
+void updateAverage(double &average, double sample, uint64_t samples) {
+  average = samples <= 1 ? sample
+                         : average + kAverageWeight * (sample - average);
+}
+
+} // namespace
+
+NetworkSource::NetworkSource(const NetworkSourceOptions &options)
+    : options_(options) {}
+
+NetworkSource::~NetworkSource() { close(); }
+
+bool NetworkSource::open() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  interrupted_ = false;
+
+  if (is_opened_) {
+    return true;
+  }
+
+  pool_ = std::make_unique<utils::ThreadPool>(options_.decode_threads);
+  stats_ = IngestStats{};
+  rate_window_start_ = Clock::now();
+  rate_window_count_ = 0;
+  frames_read_ = 0;
+  is_opened_ = true;
+
+  LOG_INFO("Network source opened, " + std::to_string(pool_->size()) +
+           " decode threads");
+  return true;
+}
+
+bool NetworkSource::submit(uint64_t uploader_id, std::string_view data) {
+  std::vector<uint8_t> bytes;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!is_opened_ || data.empty() ||
+        data.size() > options_.max_message_bytes) {
+      ++stats_.rejected;
+      return false;
+    }
+    if (!free_buffers_.empty()) {
+      bytes = std::move(free_buffers_.back());
+      free_buffers_.pop_back();
+    }
+  }
+
+  // The only copy: the transport reuses its receive buffer after we return
+  bytes.assign(data.begin(), data.end());
+  Upload upload{std::move(bytes), Clock::now()};
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!is_opened_) {
+    ++stats_.rejected;
+    return false;
+  }
+
+  ++stats_.received;
+  ++rate_window_count_;
+  const double window =
+      std::chrono::duration<double>(upload.received - rate_window_start_)
+          .count();
+  if (window >= 1.0) {
+    stats_.ingest_fps = static_cast<double>(rate_window_count_) / window;
+    rate_window_start_ = upload.received;
+    rate_window_count_ = 0;
+  }
+
+  auto &uploader = uploaders_[uploader_id];
+  if (!uploader) {
+    uploader = std::make_shared<Uploader>();
+    uploader->id = uploader_id;
+    LOG_INFO("Network uploader " + std::to_string(uploader_id) + " connected");
+  }
+
+  if (uploader->decoding) {
+    // Latest wins: only the newest waiting message will be decoded
+    if (uploader->pending) {
+      recycleLocked(std::move(uploader->pending->bytes));
+      ++stats_.superseded;
+    }
+    uploader->pending = std::move(upload);
+  } else {
+    uploader->decoding = true;
+    scheduleLocked(uploader, std::move(upload));
+  }
+  return true;
+}
+
+void NetworkSource::scheduleLocked(const std::shared_ptr<Uploader> &uploader,
+                                   Upload upload) {
+  pool_->enqueue(
+      [this, uploader, upload = std::move(upload)]() mutable {
+        decode(uploader, std::move(upload));
+      });
+}
+
+void NetworkSource::decode(const std::shared_ptr<Uploader> &uploader,
+                           Upload upload) {
+  const auto start = Clock::now();
+
+  // One decode per uploader at a time: its pool has a single producer.
+  // The slot is reused unless a reader still holds its previous frame.
+  cv::Mat &slot = uploader->frames.acquire();
+  const cv::Mat encoded(1, static_cast<int>(upload.bytes.size()), CV_8UC1,
+                        upload.bytes.data());
+  cv::Mat decoded;
+  try {
+    // On failure slot keeps its old pixels: only trust the return value
+    decoded = cv::imdecode(encoded, options_.imread_flags, &slot);
+  } catch (const std::exception &) {
+    decoded.release();
+  }
+
+  const auto end = Clock::now();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  recycleLocked(std::move(upload.bytes));
+
+  if (decoded.empty()) {
+    ++stats_.failed;
+  } else if (!uploader->removed) {
+    if (uploader->ready_sequence != 0) {
+      ++stats_.overwritten;
+    }
+    uploader->ready = decoded;
+    uploader->ready_received = upload.received;
+    uploader->ready_sequence = ++sequence_;
+    width_ = decoded.cols;
+    height_ = decoded.rows;
+
+    ++stats_.decoded;
+    stats_.last_latency_ms = toMs(end - upload.received);
+    updateAverage(stats_.avg_decode_ms, toMs(end - start), stats_.decoded);
+    updateAverage(stats_.avg_latency_ms, stats_.last_latency_ms,
+                  stats_.decoded);
+    frame_cv_.notify_all();
+  }
+
+  if (uploader->pending && !uploader->removed && is_opened_) {
+    Upload next = std::move(*uploader->pending);
+    uploader->pending.reset();
+    scheduleLocked(uploader, std::move(next));
+  } else {
+    uploader->decoding = false;
+  }
+}
+
+void NetworkSource::recycleLocked(std::vector<uint8_t> &&bytes) {
+  if (free_buffers_.size() < kMaxFreeBuffers) {
+    bytes.clear(); // keeps the capacity
+    free_buffers_.push_back(std::move(bytes));
+  }
+}
+
+bool NetworkSource::readFrame(cv::Mat &frame) {
+  FrameInfo info;
+  return readFrame(frame, info);
+}
+
+bool NetworkSource::readFrame(cv::Mat &frame, FrameInfo &info) {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  // Oldest ready frame first, so every uploader gets its turn
+  std::shared_ptr<Uploader> next;
+  const auto ready = [&] {
+    next.reset();
+    for (const auto &entry : uploaders_) {
+      const auto &uploader = entry.second;
+      if (uploader->ready_sequence != 0 &&
+          (!next || uploader->ready_sequence < next->ready_sequence)) {
+        next = uploader;
+      }
+    }
+    return next != nullptr || !is_opened_ || interrupted_;
+  };
+
+  if (options_.idle_timeout.count() > 0) {
+    if (!frame_cv_.wait_for(lock, options_.idle_timeout, ready)) {
+      LOG_INFO("Network source idle for " +
+               std::to_string(options_.idle_timeout.count()) + " ms");
+      return false;
+    }
+  } else {
+    frame_cv_.wait(lock, ready);
+  }
+
+  if (!next || !is_opened_ || interrupted_) {
+    return false;
+  }
+
+  frame = next->ready;
+  next->ready.release();
+  next->ready_sequence = 0;
+  last_uploader_ = next->id;
+
+  info.capture_time = next->ready_received; // arrival on the server
+  info.frame_index = frames_read_++;
+  return true;
+}
+
+void NetworkSource::interrupt() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    interrupted_ = true;
+  }
+  frame_cv_.notify_all();
+}
+
+void NetworkSource::removeUploader(uint64_t uploader_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = uploaders_.find(uploader_id);
+  if (it == uploaders_.end()) {
+    return;
+  }
+
+  // An in-flight decode keeps the uploader alive and drops its result
+  it->second->removed = true;
+  uploaders_.erase(it);
+  LOG_INFO("Network uploader " + std::to_string(uploader_id) + " removed");
+}
+
+void NetworkSource::close() {
+  std::unique_ptr<utils::ThreadPool> pool;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!is_opened_) {
+      return;
+    }
+    is_opened_ = false;
+    pool = std::move(pool_);
+  }
+  frame_cv_.notify_all();
+
+  // Joins the decoders; queued decodes are discarded
+  pool.reset();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  uploaders_.clear();
+  free_buffers_.clear();
+  LOG_INFO("Network source closed after " + std::to_string(stats_.decoded) +
+           " decoded frames");
+}
+
+int NetworkSource::getWidth() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return width_;
+}
+
+int NetworkSource::getHeight() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return height_;
+}
+
+double NetworkSource::getFPS() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_.ingest_fps;
+}
+
+bool NetworkSource::isOpened() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return is_opened_;
+}
+
+std::string NetworkSource::getName() const { return "Network ingest"; }
+
+uint64_t NetworkSource::getLastUploader() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return last_uploader_;
+}
+
+IngestStats NetworkSource::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  IngestStats stats = stats_;
+  stats.uploaders = uploaders_.size();
+  return stats;
+}
+
+} // namespace visioncore::core
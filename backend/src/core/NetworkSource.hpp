@@ -0,0 +1,174 @@
+/**
+ * @file NetworkSource.hpp
+ * @brief VideoSource fed with encoded frames pushed by remote uploaders
+ *
+ * Browsers and edge devices send JPEG (or PNG...) frames, typically as
+ * binary WebSocket messages; the server hands each message to submit().
+ * submit() only copies the bytes into a pooled buffer (the transport owns
+ * the message memory) and queues it, decoding runs on a worker pool
+ * straight from that buffer into pooled frames.
+ *
+ * Every uploader is latest-frame-wins: at most one decode in flight and one
+ * waiting per uploader, a newer message replaces the waiting one, and a
+ * decoded frame not read yet is replaced by the next. A slow pipeline thus
+ * always processes the most recent frame instead of building up latency.
+ * readFrame() serves the uploaders in turn.
+ */
+
+#ifndef NETWORK_SOURCE_HPP
+#define NETWORK_SOURCE_HPP
+
+#include "VideoSource.hpp"
+#include "../utils/FramePool.hpp"
+#include "../utils/ThreadPool.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace visioncore::core {
+
+/**
+ * @brief Decoding settings for NetworkSource
+ */
+struct NetworkSourceOptions {
+  size_t decode_threads = 0;   ///< Decoder workers, 0 = one per core
+  int imread_flags = cv::IMREAD_COLOR;     ///< Passed to cv::imdecode
+  size_t max_message_bytes = size_t{16} << 20; ///< Larger messages rejected
+  /// readFrame() gives up (end of stream) after this long without a frame,
+  /// zero waits until close() or interrupt()
+  std::chrono::milliseconds idle_timeout{0};
+};
+
+/**
+ * @brief Ingest counters, rates measured over the last second
+ */
+struct IngestStats {
+  uint64_t received = 0;   ///< Messages accepted by submit()
+  uint64_t rejected = 0;   ///< Empty, oversized or submitted while closed
+  uint64_t superseded = 0; ///< Replaced by a newer message before decoding
+  uint64_t decoded = 0;    ///< Successfully decoded frames
+  uint64_t failed = 0;     ///< Messages that did not decode
+  uint64_t overwritten = 0; ///< Decoded frames replaced before being read
+  double ingest_fps = 0.0;  ///< Accepted messages per second
+  double avg_decode_ms = 0.0;  ///< cv::imdecode time, moving average
+  double avg_latency_ms = 0.0; ///< Receive to decoded, moving average
+  double last_latency_ms = 0.0;
+  size_t uploaders = 0; ///< Uploaders currently known
+};
+
+class NetworkSource : public VideoSource {
+public:
+  /**
+   * @brief Constructs a network source
+   *
+   * The decode pool is started by open().
+   */
+  explicit NetworkSource(const NetworkSourceOptions &options = {});
+
+  ~NetworkSource() override;
+
+  NetworkSource(const NetworkSource &) = delete;
+  NetworkSource &operator=(const NetworkSource &) = delete;
+
+  // VideoSource implementation
+  bool open() override;
+  bool readFrame(cv::Mat &frame) override;
+  bool readFrame(cv::Mat &frame, FrameInfo &info) override;
+  void interrupt() override;
+  void close() override;
+
+  int getWidth() const override;  ///< Size of the last decoded frame
+  int getHeight() const override; ///< Size of the last decoded frame
+  double getFPS() const override; ///< Measured ingest rate
+  bool isOpened() const override;
+  std::string getName() const override;
+
+  /**
+   * @brief Queue an encoded frame from an uploader (any thread)
+   *
+   * The bytes are copied once, the caller keeps ownership of data.
+   *
+   * @param uploader Identifier of the sender (e.g. WebSocket client id)
+   * @param data Encoded image
+   * @return false if the message was rejected
+   */
+  bool submit(uint64_t uploader, std::string_view data);
+
+  /**
+   * @brief Forget an uploader (disconnected); its pending frames are dropped
+   */
+  void removeUploader(uint64_t uploader);
+
+  /**
+   * @brief Uploader of the frame last returned by readFrame()
+   */
+  uint64_t getLastUploader() const;
+
+  IngestStats getStats() const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Upload {
+    std::vector<uint8_t> bytes;
+    Clock::time_point received;
+  };
+
+  struct Uploader {
+    uint64_t id = 0;
+    bool decoding = false;       ///< A decode task owns this uploader
+    bool removed = false;
+    std::optional<Upload> pending; ///< Next message, replaced by newer ones
+    cv::Mat ready;               ///< Decoded, not read yet
+    Clock::time_point ready_received;
+    uint64_t ready_sequence = 0; ///< 0 when nothing is ready
+    utils::FramePool frames{3};  ///< Decode targets
+  };
+
+  NetworkSourceOptions options_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable frame_cv_;
+  bool is_opened_ = false;
+  bool interrupted_ = false;
+  std::unordered_map<uint64_t, std::shared_ptr<Uploader>> uploaders_;
+  std::vector<std::vector<uint8_t>> free_buffers_; ///< Recycled messages
+  uint64_t sequence_ = 0;
+  uint64_t last_uploader_ = 0;
+  int64_t frames_read_ = 0;
+  int width_ = 0;
+  int height_ = 0;
+
+  IngestStats stats_;
+  Clock::time_point rate_window_start_;
+  uint64_t rate_window_count_ = 0;
+
+  std::unique_ptr<utils::ThreadPool> pool_;
+
+  /**
+   * @brief Hand an upload to the decode pool
+   */
+  void scheduleLocked(const std::shared_ptr<Uploader> &uploader,
+                      Upload upload);
+
+  /**
+   * @brief Decode one message into the uploader's next frame (worker)
+   */
+  void decode(const std::shared_ptr<Uploader> &uploader, Upload upload);
+
+  /**
+   * @brief Return a message buffer to the free list
+   */
+  void recycleLocked(std::vector<uint8_t> &&bytes);
+};
+
+} // namespace visioncore::core
+
+#endif // NETWORK_SOURCE_HPP
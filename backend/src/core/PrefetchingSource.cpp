@@ -0,0 +1,162 @@
+/**
+ * @file PrefetchingSource.cpp
+ * @brief PrefetchingSource implementation
+ */
+
+#include "PrefetchingSource.hpp"
+#include "../utils/Logger.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace visioncore::core {
+
+PrefetchingSource::PrefetchingSource(std::unique_ptr<VideoSource> source,
+                                     Mode mode, size_t depth)
+    : source_(std::move(source)), mode_(mode), depth_(depth),
+      pool_(depth + 2) {
+
+  if (!source_) {
+    throw std::invalid_argument("PrefetchingSource needs a source");
+  }
+
+  if (depth_ == 0) {
+    throw std::invalid_argument("PrefetchingSource depth must be >= 1");
+  }
+}
+
+PrefetchingSource::~PrefetchingSource() { stopCapture(); }
+
+bool PrefetchingSource::open() {
+  // Already capturing (opened by the caller, then again by the controller):
+  // restarting would throw away the frames queued so far
+  if (running_ && capture_thread_.joinable() && !exhausted_) {
+    return true;
+  }
+  stopCapture();
+
+  // An exhausted source starts over, as it would after close()
+  if (exhausted_) {
+    source_->close();
+    exhausted_ = false;
+  }
+
+  if (!source_->isOpened() && !source_->open()) {
+    return false;
+  }
+
+  queue_ = std::make_unique<utils::ThreadSafeQueue<Prefetched>>(depth_);
+  captured_ = 0;
+  dropped_ = 0;
+
+  running_ = true;
+  capture_thread_ = std::thread(&PrefetchingSource::captureLoop, this);
+
+  LOG_INFO("Prefetching " + source_->getName() + " (" +
+           (mode_ == Mode::LATEST_ONLY ? "latest only" : "never drop") +
+           ", depth " + std::to_string(depth_) + ")");
+  return true;
+}
+
+bool PrefetchingSource::readFrame(cv::Mat &frame) {
+  FrameInfo info;
+  return readFrame(frame, info);
+}
+
+bool PrefetchingSource::readFrame(cv::Mat &frame, FrameInfo &info) {
+  if (!queue_ || !running_) {
+    return false;
+  }
+
+  Prefetched item;
+  if (!queue_->pop(item)) {
+    return false; // end of stream or closed
+  }
+
+  if (mode_ == Mode::LATEST_ONLY) {
+    // Skip everything that became stale while we were busy
+    Prefetched newer;
+    while (queue_->tryPop(newer)) {
+      item = std::move(newer);
+      ++dropped_;
+    }
+  }
+
+  frame = item.frame;
+  info = item.info;
+  return true;
+}
+
+void PrefetchingSource::close() {
+  stopCapture();
+  source_->close();
+  exhausted_ = false;
+}
+
+void PrefetchingSource::captureLoop() {
+  while (running_) {
+    Prefetched item;
+    cv::Mat &slot = pool_.acquire();
+
+    if (!source_->readFrame(slot, item.info)) {
+      LOG_INFO("Prefetch: end of stream on " + source_->getName());
+      exhausted_ = true;
+      break;
+    }
+
+    ++captured_;
+    item.frame = slot;
+
+    if (mode_ == Mode::NEVER_DROP) {
+      if (!queue_->push(std::move(item))) {
+        break; // closed
+      }
+      continue;
+    }
+
+    // LATEST_ONLY: make room by discarding the oldest frame
+    while (!queue_->tryPush(item)) {
+      if (queue_->isClosed()) {
+        return;
+      }
+
+      Prefetched stale;
+      if (queue_->tryPop(stale)) {
+        ++dropped_;
+      }
+    }
+  }
+
+  // Wake the consumer so it sees the end of stream once the queue is drained
+  queue_->close();
+}
+
+void PrefetchingSource::interrupt() {
+  // Unblocks both the capture thread and the consumer
+  source_->interrupt();
+  if (queue_) {
+    queue_->close();
+  }
+}
+
+void PrefetchingSource::stopCapture() {
+  running_ = false;
+
+  if (queue_) {
+    queue_->close();
+  }
+
+  if (capture_thread_.joinable()) {
+    capture_thread_.join();
+  }
+}
+
+int PrefetchingSource::getWidth() const { return source_->getWidth(); }
+int PrefetchingSource::getHeight() const { return source_->getHeight(); }
+double PrefetchingSource::getFPS() const { return source_->getFPS(); }
+bool PrefetchingSource::isOpened() const { return source_->isOpened(); }
+
+std::string PrefetchingSource::getName() const {
+  return "prefetch:" + source_->getName();
+}
+
+} // namespace visioncore::core
@@ -0,0 +1,111 @@
+/**
+ * @file PrefetchingSource.hpp
+ * @brief VideoSource decorator that captures frames on its own thread
+ *
+ * Wraps any VideoSource and moves capture, demux and decode off the caller's
+ * thread. Frames are read into a small pool of reusable buffers and queued
+ * for readFrame(), which only waits when the capture thread is behind.
+ */
+
+#ifndef PREFETCHING_SOURCE_HPP
+#define PREFETCHING_SOURCE_HPP
+
+#include "VideoSource.hpp"
+#include "../utils/FramePool.hpp"
+#include "../utils/ThreadSafeQueue.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+namespace visioncore::core {
+
+class PrefetchingSource : public VideoSource {
+public:
+  enum class Mode {
+    LATEST_ONLY, ///< Live sources: stale frames are dropped, lowest latency
+    NEVER_DROP   ///< Files: capture blocks when the queue is full
+  };
+
+  /**
+   * @brief Wrap a source
+   *
+   * @param source Source to read from (ownership transferred)
+   * @param mode Drop policy when the consumer is slower than the source
+   * @param depth Number of frames queued ahead of the consumer (>= 1)
+   *
+   * @throws std::invalid_argument if source is null or depth is 0
+   */
+  explicit PrefetchingSource(std::unique_ptr<VideoSource> source,
+                             Mode mode = Mode::NEVER_DROP, size_t depth = 3);
+
+  ~PrefetchingSource() override;
+
+  // VideoSource implementation
+  bool open() override;
+  bool readFrame(cv::Mat &frame) override;
+  bool readFrame(cv::Mat &frame, FrameInfo &info) override;
+  void interrupt() override;
+  void close() override;
+
+  int getWidth() const override;
+  int getHeight() const override;
+  double getFPS() const override;
+  bool isOpened() const override;
+  std::string getName() const override;
+
+  Mode getMode() const { return mode_; }
+
+  /**
+   * @brief Frames read from the wrapped source since open()
+   */
+  uint64_t getCapturedCount() const { return captured_; }
+
+  /**
+   * @brief Frames discarded in LATEST_ONLY mode since open()
+   */
+  uint64_t getDroppedCount() const { return dropped_; }
+
+  /**
+   * @brief Buffer allocations that could not be served by the pool
+   */
+  uint64_t getPoolAllocations() const { return pool_.allocations(); }
+
+private:
+  /**
+   * @brief Queued frame with the metadata reported by the wrapped source
+   */
+  struct Prefetched {
+    cv::Mat frame;
+    FrameInfo info;
+  };
+
+  std::unique_ptr<VideoSource> source_;
+  Mode mode_;
+  size_t depth_;
+
+  // Queue plus one frame being captured and one held by the consumer
+  utils::FramePool pool_;
+  std::unique_ptr<utils::ThreadSafeQueue<Prefetched>> queue_;
+
+  std::thread capture_thread_;
+  std::atomic<bool> running_{false};
+  std::atomic<bool> exhausted_{false}; ///< Wrapped source hit end of stream
+  std::atomic<uint64_t> captured_{0};
+  std::atomic<uint64_t> dropped_{0};
+
+  /**
+   * @brief Capture loop, runs until close() or end of stream
+   */
+  void captureLoop();
+
+  /**
+   * @brief Stop and join the capture thread
+   */
+  void stopCapture();
+};
+
+} // namespace visioncore::core
+
+#endif // PREFETCHING_SOURCE_HPP
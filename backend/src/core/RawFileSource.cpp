@@ -0,0 +1,274 @@
+/**
+ * @file RawFileSource.cpp
+ * @brief RawFileSource implementation
+ */
+
+#include "RawFileSource.hpp"
+#include "../utils/Logger.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <opencv2/imgproc.hpp>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace visioncore::core {
+
+namespace {
+
+constexpr char kFrameMarker[] = "FRAME";
+constexpr size_t kFrameMarkerSize = sizeof(kFrameMarker) - 1;
+constexpr size_t kMaxFrameHeaderSize = 256;
+
+} // namespace
+
+RawFileSource::RawFileSource(const std::string &path,
+                             const RawFileOptions &options)
+    : path_(path), options_(options) {}
+
+RawFileSource::~RawFileSource() { close(); }
+
+bool RawFileSource::open() {
+  LOG_INFO("Opening raw video file " + path_);
+
+  if (isOpened()) {
+    close();
+  }
+
+  fd_ = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd_ < 0) {
+    LOG_ERROR("Failed to open " + path_ + ": " + std::strerror(errno));
+    return false;
+  }
+
+  struct stat st {};
+  if (::fstat(fd_, &st) != 0 || st.st_size <= 0) {
+    LOG_ERROR("Empty or unreadable file " + path_);
+    close();
+    return false;
+  }
+  map_size_ = static_cast<size_t>(st.st_size);
+
+  // Private writable mapping: consumers may write into frames, the pages
+  // they touch are copied and the file is left alone
+  void *map = ::mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                     fd_, 0);
+  if (map == MAP_FAILED) {
+    LOG_ERROR("Failed to map " + path_ + ": " + std::strerror(errno));
+    map_size_ = 0;
+    close();
+    return false;
+  }
+  map_ = static_cast<char *>(map);
+
+  // Doubles the kernel readahead and frees pages behind the reader sooner
+  ::madvise(map_, map_size_, MADV_SEQUENTIAL);
+
+  size_t header_size = 0;
+  const auto header = parseRawHeader(map_, map_size_, header_size);
+  if (!header) {
+    LOG_ERROR("Unsupported raw video header in " + path_);
+    close();
+    return false;
+  }
+  header_ = *header;
+
+  if (header_.pixel == RawVideoHeader::Pixel::I420 &&
+      (header_.width % 2 != 0 || header_.height % 2 != 0)) {
+    LOG_ERROR("Odd-sized 4:2:0 video is not supported: " + path_);
+    close();
+    return false;
+  }
+
+  if (!indexFrames(header_size)) {
+    LOG_ERROR("No complete frame in " + path_);
+    close();
+    return false;
+  }
+
+  position_ = 0;
+  prefetched_until_ = 0;
+
+  LOG_INFO("Raw video file opened: " + std::to_string(header_.width) + "x" +
+           std::to_string(header_.height) + "@" +
+           std::to_string(header_.fps()) + "FPS, " +
+           std::to_string(frame_offsets_.size()) + " frames" +
+           (isZeroCopy() ? ", zero-copy" : ""));
+  return true;
+}
+
+bool RawFileSource::indexFrames(size_t header_size) {
+  frame_offsets_.clear();
+  const size_t frame_bytes = header_.frameBytes();
+
+  if (header_.container == RawVideoHeader::Container::VCRAW) {
+    for (size_t offset = header_size; offset + frame_bytes <= map_size_;
+         offset += frame_bytes) {
+      frame_offsets_.push_back(offset);
+    }
+    return !frame_offsets_.empty();
+  }
+
+  // Y4M written by us or ffmpeg: every frame starts with a bare "FRAME\n".
+  // Check the first and last markers instead of touching every frame.
+  const size_t stride = kFrameMarkerSize + 1 + frame_bytes;
+  const size_t payload = map_size_ - header_size;
+  const auto isBareMarker = [this](size_t offset) {
+    return std::memcmp(map_ + offset, "FRAME\n", kFrameMarkerSize + 1) == 0;
+  };
+
+  if (payload >= stride && payload % stride == 0 &&
+      isBareMarker(header_size) &&
+      isBareMarker(header_size + payload - stride)) {
+    const size_t count = payload / stride;
+    frame_offsets_.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      frame_offsets_.push_back(header_size + i * stride + kFrameMarkerSize + 1);
+    }
+    return true;
+  }
+
+  // Frame parameters present: walk the markers
+  size_t offset = header_size;
+  while (map_size_ - offset > kFrameMarkerSize &&
+         std::memcmp(map_ + offset, kFrameMarker, kFrameMarkerSize) == 0) {
+    const size_t limit = std::min(kMaxFrameHeaderSize, map_size_ - offset);
+    const void *newline = std::memchr(map_ + offset, '\n', limit);
+    if (newline == nullptr) {
+      break;
+    }
+
+    const size_t data = static_cast<const char *>(newline) - map_ + 1;
+    if (data + frame_bytes > map_size_) {
+      break; // truncated last frame
+    }
+    frame_offsets_.push_back(data);
+    offset = data + frame_bytes;
+  }
+
+  if (offset < map_size_) {
+    LOG_WARNING("Ignoring " + std::to_string(map_size_ - offset) +
+                " trailing bytes in " + path_);
+  }
+  return !frame_offsets_.empty();
+}
+
+bool RawFileSource::readFrame(cv::Mat &frame) {
+  FrameInfo info;
+  return readFrame(frame, info);
+}
+
+bool RawFileSource::readFrame(cv::Mat &frame, FrameInfo &info) {
+  if (!isOpened()) {
+    return false;
+  }
+
+  if (position_ >= getFrameCount()) {
+    if (!options_.loop) {
+      return false;
+    }
+    position_ = 0;
+    prefetched_until_ = 0;
+  }
+
+  const size_t offset = frame_offsets_[position_];
+  prefetch(offset);
+
+  char *data = map_ + offset;
+  switch (header_.pixel) {
+  case RawVideoHeader::Pixel::GRAY:
+    frame = cv::Mat(header_.height, header_.width, CV_8UC1, data);
+    break;
+  case RawVideoHeader::Pixel::BGR:
+    frame = cv::Mat(header_.height, header_.width, CV_8UC3, data);
+    break;
+  case RawVideoHeader::Pixel::I420: {
+    const cv::Mat yuv(header_.height * 3 / 2, header_.width, CV_8UC1, data);
+    if (options_.convert_yuv) {
+      cv::cvtColor(yuv, frame, cv::COLOR_YUV2BGR_I420);
+    } else {
+      frame = yuv;
+    }
+    break;
+  }
+  }
+
+  info.capture_time = std::chrono::steady_clock::now();
+  info.frame_index = position_;
+  info.pts_ms = header_.fps() > 0.0
+                    ? static_cast<double>(position_) * 1000.0 / header_.fps()
+                    : -1.0;
+
+  ++position_;
+  return true;
+}
+
+void RawFileSource::prefetch(size_t offset) {
+  if (options_.readahead_bytes == 0) {
+    return;
+  }
+
+  // One madvise per half window is enough to stay ahead of the reader
+  if (offset + options_.readahead_bytes / 2 < prefetched_until_) {
+    return;
+  }
+
+  static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  const size_t begin = offset / page * page;
+  const size_t end = std::min(map_size_, offset + options_.readahead_bytes);
+  if (end > begin) {
+    ::madvise(map_ + begin, end - begin, MADV_WILLNEED);
+  }
+  prefetched_until_ = end;
+}
+
+bool RawFileSource::seek(int64_t frame_index) {
+  if (!isOpened() || frame_index < 0 || frame_index >= getFrameCount()) {
+    return false;
+  }
+
+  position_ = frame_index;
+  prefetched_until_ = 0;
+  return true;
+}
+
+void RawFileSource::close() {
+  const bool was_opened = isOpened();
+
+  if (map_ != nullptr) {
+    ::munmap(map_, map_size_);
+    map_ = nullptr;
+  }
+  map_size_ = 0;
+
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+
+  frame_offsets_.clear();
+  position_ = 0;
+
+  if (was_opened) {
+    LOG_INFO(path_ + " source closed");
+  }
+}
+
+bool RawFileSource::isZeroCopy() const {
+  return header_.pixel != RawVideoHeader::Pixel::I420 ||
+         !options_.convert_yuv;
+}
+
+int RawFileSource::getWidth() const { return header_.width; }
+int RawFileSource::getHeight() const { return header_.height; }
+double RawFileSource::getFPS() const { return header_.fps(); }
+bool RawFileSource::isOpened() const {
+  return map_ != nullptr && !frame_offsets_.empty();
+}
+std::string RawFileSource::getName() const { return path_; }
+
+} // namespace visioncore::core
@@ -0,0 +1,119 @@
+/**
+ * @file RawFileSource.hpp
+ * @brief VideoSource for uncompressed Y4M / VCRAW files, read through mmap
+ *
+ * The file is memory-mapped and each frame returned by readFrame() is a
+ * cv::Mat header pointing straight into the mapping: no read() copy and no
+ * decode. Sequential playback is announced to the kernel (MADV_SEQUENTIAL)
+ * and the frames ahead of the read position are prefetched with
+ * MADV_WILLNEED, so replay runs from the page cache.
+ *
+ * The mapping is private and writable: a consumer writing into a frame gets
+ * its own copy of the touched pages, the file is never modified. Frames stay
+ * valid until close(); clone() them to keep them longer.
+ */
+
+#ifndef RAW_FILE_SOURCE_HPP
+#define RAW_FILE_SOURCE_HPP
+
+#include "RawFormat.hpp"
+#include "VideoSource.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace visioncore::core {
+
+/**
+ * @brief Playback settings for RawFileSource
+ */
+struct RawFileOptions {
+  bool loop = false;        ///< Restart at the first frame after the last
+  bool convert_yuv = true;  ///< Y4M 4:2:0: return BGR (one cvtColor) instead
+                            ///< of the zero-copy planar I420 buffer
+  size_t readahead_bytes = size_t{32} << 20; ///< Prefetch window ahead
+};
+
+class RawFileSource : public VideoSource {
+public:
+  /**
+   * @brief Constructs a raw file source
+   *
+   * The file is not mapped until open() is called.
+   *
+   * @param path .y4m or .vcraw file
+   * @param options Playback settings
+   */
+  explicit RawFileSource(const std::string &path,
+                         const RawFileOptions &options = {});
+
+  ~RawFileSource() override;
+
+  RawFileSource(const RawFileSource &) = delete;
+  RawFileSource &operator=(const RawFileSource &) = delete;
+
+  // VideoSource implementation
+  bool open() override;
+  bool readFrame(cv::Mat &frame) override;
+  bool readFrame(cv::Mat &frame, FrameInfo &info) override;
+  void close() override;
+
+  int getWidth() const override;
+  int getHeight() const override;
+  double getFPS() const override;
+  bool isOpened() const override;
+  std::string getName() const override;
+
+  /**
+   * @brief Position playback so the next readFrame() returns frame_index
+   * @return false if the index is out of range or the source is closed
+   */
+  bool seek(int64_t frame_index);
+
+  int64_t getFrameCount() const {
+    return static_cast<int64_t>(frame_offsets_.size());
+  }
+
+  /**
+   * @brief Index of the next frame readFrame() will return
+   */
+  int64_t getPosition() const { return position_; }
+
+  /**
+   * @brief Parsed file header (valid after open())
+   */
+  const RawVideoHeader &getHeader() const { return header_; }
+
+  /**
+   * @brief True if readFrame() hands out views of the mapping
+   */
+  bool isZeroCopy() const;
+
+private:
+  std::string path_;
+  RawFileOptions options_;
+  RawVideoHeader header_;
+
+  int fd_ = -1;
+  char *map_ = nullptr;
+  size_t map_size_ = 0;
+
+  std::vector<size_t> frame_offsets_; ///< Start of each frame's pixels
+  int64_t position_ = 0;
+  size_t prefetched_until_ = 0; ///< End of the last MADV_WILLNEED range
+
+  /**
+   * @brief Locate every frame in the mapping
+   * @return false if the file holds no complete frame
+   */
+  bool indexFrames(size_t header_size);
+
+  /**
+   * @brief Ask the kernel to read ahead of the given offset
+   */
+  void prefetch(size_t offset);
+};
+
+} // namespace visioncore::core
+
+#endif // RAW_FILE_SOURCE_HPP
@@ -0,0 +1,169 @@
+/**
+ * @file RawFormat.cpp
+ * @brief Y4M and VCRAW header parsing and formatting
+ */
+
+#include "RawFormat.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+namespace visioncore::core {
+
+namespace {
+
+constexpr char kY4MMagic[] = "YUV4MPEG2";
+constexpr char kVCRawMagic[] = "VCRAW1";
+constexpr size_t kMaxHeaderSize = 1024;
+constexpr size_t kVCRawAlignment = 64;
+
+bool parseRational(const std::string &text, int &num, int &den) {
+  const size_t colon = text.find(':');
+  if (colon == std::string::npos) {
+    return false;
+  }
+  try {
+    num = std::stoi(text.substr(0, colon));
+    den = std::stoi(text.substr(colon + 1));
+  } catch (const std::exception &) {
+    return false;
+  }
+  return num > 0 && den > 0;
+}
+
+} // namespace
+
+size_t RawVideoHeader::frameBytes() const {
+  const size_t pixels = static_cast<size_t>(width) * height;
+  switch (pixel) {
+  case Pixel::GRAY:
+    return pixels;
+  case Pixel::BGR:
+    return pixels * 3;
+  case Pixel::I420:
+    return pixels + 2 * (static_cast<size_t>((width + 1) / 2) *
+                         ((height + 1) / 2));
+  }
+  return 0;
+}
+
+std::optional<RawVideoHeader> parseRawHeader(const char *data, size_t size,
+                                             size_t &header_size) {
+  const size_t limit = std::min(size, kMaxHeaderSize);
+  const void *newline = std::memchr(data, '\n', limit);
+  if (newline == nullptr) {
+    return std::nullopt;
+  }
+
+  const size_t line_size = static_cast<const char *>(newline) - data;
+  std::istringstream line(std::string(data, line_size));
+  std::string magic;
+  line >> magic;
+
+  RawVideoHeader header;
+  if (magic == kY4MMagic) {
+    header.container = RawVideoHeader::Container::Y4M;
+    header.pixel = RawVideoHeader::Pixel::I420; // Y4M default: 420jpeg
+    header_size = line_size + 1;
+  } else if (magic == kVCRawMagic) {
+    header.container = RawVideoHeader::Container::VCRAW;
+    header_size = line_size + 1;
+  } else {
+    return std::nullopt;
+  }
+
+  std::string token;
+  while (line >> token) {
+    const char tag = token[0];
+    const std::string value = token.substr(1);
+
+    try {
+      if (tag == 'W') {
+        header.width = std::stoi(value);
+      } else if (tag == 'H') {
+        header.height = std::stoi(value);
+      } else if (tag == 'F') {
+        if (!parseRational(value, header.fps_num, header.fps_den)) {
+          return std::nullopt;
+        }
+      } else if (tag == 'C') {
+        if (value == "mono" || value == "gray") {
+          header.pixel = RawVideoHeader::Pixel::GRAY;
+        } else if (value == "bgr" &&
+                   header.container == RawVideoHeader::Container::VCRAW) {
+          header.pixel = RawVideoHeader::Pixel::BGR;
+        } else if ((value == "420" || value == "420jpeg" ||
+                    value == "420paldv" || value == "420mpeg2") &&
+                   header.container == RawVideoHeader::Container::Y4M) {
+          header.pixel = RawVideoHeader::Pixel::I420; // chroma siting ignored
+        } else {
+          return std::nullopt; // 422, 444, high bit depth (420p10)...
+        }
+      }
+      // I (interlacing), A (aspect), X (extensions) do not change the layout
+    } catch (const std::exception &) {
+      return std::nullopt;
+    }
+  }
+
+  if (header.width <= 0 || header.height <= 0) {
+    return std::nullopt;
+  }
+  return header;
+}
+
+std::string formatRawHeader(const RawVideoHeader &header) {
+  std::ostringstream out;
+  const bool y4m = header.container == RawVideoHeader::Container::Y4M;
+
+  out << (y4m ? kY4MMagic : kVCRawMagic) << " W" << header.width << " H"
+      << header.height << " F" << header.fps_num << ":" << header.fps_den;
+
+  if (y4m) {
+    out << " Ip A1:1 C"
+        << (header.pixel == RawVideoHeader::Pixel::GRAY ? "mono" : "420jpeg");
+    out << '\n';
+    return out.str();
+  }
+
+  out << " C"
+      << (header.pixel == RawVideoHeader::Pixel::GRAY ? "gray" : "bgr");
+
+  // Pad so that frame data starts on a cache line
+  std::string text = out.str();
+  const size_t padded =
+      (text.size() + 1 + kVCRawAlignment - 1) / kVCRawAlignment *
+      kVCRawAlignment;
+  text.append(padded - text.size() - 1, ' ');
+  text.push_back('\n');
+  return text;
+}
+
+void fpsToRational(double fps, int &num, int &den) {
+  if (fps <= 0.0) {
+    num = 30;
+    den = 1;
+    return;
+  }
+
+  if (std::abs(fps - std::round(fps)) < 1e-3) {
+    num = static_cast<int>(std::lround(fps));
+    den = 1;
+    return;
+  }
+
+  // 23.976, 29.97, 59.94...
+  const double ntsc = fps * 1.001;
+  if (std::abs(ntsc - std::round(ntsc)) < 1e-3) {
+    num = static_cast<int>(std::lround(ntsc)) * 1000;
+    den = 1001;
+    return;
+  }
+
+  num = static_cast<int>(std::lround(fps * 1000.0));
+  den = 1000;
+}
+
+} // namespace visioncore::core
@@ -0,0 +1,72 @@
+/**
+ * @file RawFormat.hpp
+ * @brief Headers of the uncompressed video files read by RawFileSource and
+ * written by sinks::RawFileSink
+ *
+ * Two containers are supported:
+ *  - Y4M (YUV4MPEG2): "YUV4MPEG2 W.. H.. F..:.. C..\n", then every frame is
+ *    "FRAME\n" followed by the planes. Colorspaces mono and 4:2:0.
+ *  - VCRAW: "VCRAW1 W.. H.. F..:.. C<bgr|gray>\n" padded with spaces to a
+ *    multiple of 64 bytes, then the frames back to back with no marker.
+ *    Interleaved BGR or gray, exactly what the pipeline consumes.
+ */
+
+#ifndef RAW_FORMAT_HPP
+#define RAW_FORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace visioncore::core {
+
+struct RawVideoHeader {
+  enum class Container { Y4M, VCRAW };
+  enum class Pixel {
+    GRAY, ///< 8-bit luma (Y4M "mono", VCRAW "gray")
+    BGR,  ///< 8-bit interleaved BGR (VCRAW only)
+    I420  ///< 8-bit planar Y, U, V with 2x2 subsampled chroma (Y4M only)
+  };
+
+  Container container = Container::VCRAW;
+  Pixel pixel = Pixel::BGR;
+  int width = 0;
+  int height = 0;
+  int fps_num = 30;
+  int fps_den = 1;
+
+  /**
+   * @brief Bytes of pixel data per frame (without the Y4M frame marker)
+   */
+  size_t frameBytes() const;
+
+  double fps() const {
+    return fps_den > 0 ? static_cast<double>(fps_num) / fps_den : 0.0;
+  }
+};
+
+/**
+ * @brief Parse a file header
+ *
+ * @param data Start of the file
+ * @param size Bytes available
+ * @param header_size Set to the offset of the first frame (or Y4M marker)
+ * @return The header, or std::nullopt if the data is not a supported file
+ */
+std::optional<RawVideoHeader> parseRawHeader(const char *data, size_t size,
+                                             size_t &header_size);
+
+/**
+ * @brief Serialize a header, including the VCRAW padding
+ */
+std::string formatRawHeader(const RawVideoHeader &header);
+
+/**
+ * @brief Frame rate as a rational, 30000:1001 style for NTSC rates
+ */
+void fpsToRational(double fps, int &num, int &den);
+
+} // namespace visioncore::core
+
+#endif // RAW_FORMAT_HPP
@@ -0,0 +1,275 @@
+/**
+ * @file SyntheticSource.cpp
+ * @brief SyntheticSource implementation
+ */
+
+#include "SyntheticSource.hpp"
+#include "../utils/Logger.hpp"
+
+#include <algorithm>
+#include <opencv2/imgproc.hpp>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace visioncore::core {
+
+namespace {
+
+constexpr int kStampBits = 32;
+constexpr size_t kNoiseFrames = 8;
+
+/// Cell size of the frame-index stamp, derived from the frame width only so
+/// the decoder finds it without knowing the source settings
+int stampCellSize(int width) { return std::clamp(width / 64, 1, 16); }
+
+const char *patternName(SyntheticOptions::Pattern pattern) {
+  switch (pattern) {
+  case SyntheticOptions::Pattern::BARS:
+    return "bars";
+  case SyntheticOptions::Pattern::GRADIENT:
+    return "gradient";
+  case SyntheticOptions::Pattern::CHECKER:
+    return "checker";
+  case SyntheticOptions::Pattern::NOISE:
+    return "noise";
+  }
+  return "unknown";
+}
+
+} // namespace
+
+SyntheticSource::SyntheticSource(const SyntheticOptions &options)
+    : options_(options) {
+  if (options_.width <= 0 || options_.height <= 0) {
+    throw std::invalid_argument("Synthetic frame size must be positive");
+  }
+  if (options_.fps <= 0.0) {
+    throw std::invalid_argument("Synthetic fps must be positive");
+  }
+  if (options_.type != CV_8UC1 && options_.type != CV_8UC3 &&
+      options_.type != CV_8UC4) {
+    throw std::invalid_argument("Synthetic pixel type must be 8-bit 1, 3 or "
+                                "4 channels");
+  }
+}
+
+bool SyntheticSource::open() {
+  canvas_.release();
+  noise_.clear();
+
+  if (options_.pattern == SyntheticOptions::Pattern::NOISE) {
+    cv::RNG rng(options_.seed);
+    noise_.resize(kNoiseFrames);
+    for (auto &frame : noise_) {
+      frame.create(options_.height, options_.width, options_.type);
+      rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+    }
+  } else {
+    cv::Mat period = renderPattern();
+    if (options_.type == CV_8UC1) {
+      cv::cvtColor(period, period, cv::COLOR_BGR2GRAY);
+    } else if (options_.type == CV_8UC4) {
+      cv::cvtColor(period, period, cv::COLOR_BGR2BGRA);
+    }
+
+    // Any window of width `width` in two copies side by side is a valid
+    // frame: motion costs nothing but an offset
+    cv::hconcat(period, period, canvas_);
+  }
+
+  position_ = 0;
+  next_frame_time_ = std::chrono::steady_clock::now();
+  is_opened_ = true;
+
+  LOG_INFO("Synthetic source opened: " + getName());
+  return true;
+}
+
+cv::Mat SyntheticSource::renderPattern() const {
+  const int w = options_.width;
+  const int h = options_.height;
+  cv::Mat pattern(h, w, CV_8UC3, cv::Scalar::all(0));
+
+  switch (options_.pattern) {
+  case SyntheticOptions::Pattern::BARS: {
+    // 75% bars over 2/3 of the height, luma ramp below
+    static const cv::Scalar bars[] = {
+        {191, 191, 191}, {0, 191, 191}, {191, 191, 0}, {0, 191, 0},
+        {191, 0, 191},   {0, 0, 191},   {191, 0, 0}};
+    constexpr int count = sizeof(bars) / sizeof(bars[0]);
+    const int bar_height = std::max(1, h * 2 / 3);
+
+    for (int i = 0; i < count; ++i) {
+      const int x0 = w * i / count;
+      const int x1 = w * (i + 1) / count;
+      if (x1 > x0) {
+        pattern(cv::Rect(x0, 0, x1 - x0, bar_height)).setTo(bars[i]);
+      }
+    }
+    for (int x = 0; x < w && bar_height < h; ++x) {
+      const auto v = static_cast<double>(x * 255 / std::max(1, w - 1));
+      pattern(cv::Rect(x, bar_height, 1, h - bar_height))
+          .setTo(cv::Scalar::all(v));
+    }
+    break;
+  }
+
+  case SyntheticOptions::Pattern::GRADIENT:
+    for (int y = 0; y < h; ++y) {
+      auto *row = pattern.ptr<cv::Vec3b>(y);
+      for (int x = 0; x < w; ++x) {
+        row[x] = cv::Vec3b(
+            static_cast<uchar>(x * 255 / std::max(1, w - 1)),
+            static_cast<uchar>(y * 255 / std::max(1, h - 1)),
+            static_cast<uchar>((x + y) * 255 / std::max(1, w + h - 2)));
+      }
+    }
+    break;
+
+  case SyntheticOptions::Pattern::CHECKER: {
+    const int square = std::max(4, std::min(w, h) / 9);
+    for (int y = 0; y < h; y += square) {
+      for (int x = 0; x < w; x += square) {
+        if (((x / square) + (y / square)) % 2 == 0) {
+          pattern(cv::Rect(x, y, std::min(square, w - x),
+                           std::min(square, h - y)))
+              .setTo(cv::Scalar::all(255));
+        }
+      }
+    }
+    break;
+  }
+
+  case SyntheticOptions::Pattern::NOISE:
+    break; // generated in open()
+  }
+
+  return pattern;
+}
+
+bool SyntheticSource::readFrame(cv::Mat &frame) {
+  FrameInfo info;
+  return readFrame(frame, info);
+}
+
+bool SyntheticSource::readFrame(cv::Mat &frame, FrameInfo &info) {
+  if (!is_opened_) {
+    return false;
+  }
+  if (options_.frame_count > 0 && position_ >= options_.frame_count) {
+    return false;
+  }
+
+  if (options_.pace) {
+    std::this_thread::sleep_until(next_frame_time_);
+    const auto now = std::chrono::steady_clock::now();
+    next_frame_time_ +=
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / options_.fps));
+    if (next_frame_time_ < now) {
+      next_frame_time_ = now; // fell behind, do not burst
+    }
+  }
+
+  if (!noise_.empty()) {
+    noise_[static_cast<size_t>(position_) % noise_.size()].copyTo(frame);
+  } else {
+    const int64_t shift =
+        (position_ * options_.speed) % options_.width + options_.width;
+    const int offset = static_cast<int>(shift % options_.width);
+    canvas_(cv::Rect(offset, 0, options_.width, options_.height))
+        .copyTo(frame);
+  }
+
+  if (options_.stamp) {
+    stampFrameIndex(frame, position_);
+  }
+
+  info.capture_time = std::chrono::steady_clock::now();
+  info.frame_index = position_;
+  info.pts_ms = static_cast<double>(position_) * 1000.0 / options_.fps;
+
+  ++position_;
+  return true;
+}
+
+void SyntheticSource::stampFrameIndex(cv::Mat &frame, int64_t index) {
+  const int cell = stampCellSize(frame.cols);
+  if (cell * kStampBits > frame.cols || cell > frame.rows) {
+    return;
+  }
+
+  const auto bits = static_cast<uint32_t>(index);
+  for (int bit = 0; bit < kStampBits; ++bit) {
+    const bool set = (bits >> bit) & 1u;
+    frame(cv::Rect(bit * cell, 0, cell, cell))
+        .setTo(cv::Scalar::all(set ? 255 : 0));
+  }
+}
+
+std::optional<int64_t> SyntheticSource::decodeFrameIndex(const cv::Mat &frame) {
+  const int cell = stampCellSize(frame.cols);
+  if (frame.empty() || frame.depth() != CV_8U ||
+      cell * kStampBits > frame.cols || cell > frame.rows) {
+    return std::nullopt;
+  }
+
+  const int channels = frame.channels();
+  const uchar *row = frame.ptr<uchar>(cell / 2);
+  uint32_t bits = 0;
+
+  for (int bit = 0; bit < kStampBits; ++bit) {
+    const uchar *pixel = row + (bit * cell + cell / 2) * channels;
+    int sum = 0;
+    for (int c = 0; c < channels; ++c) {
+      sum += pixel[c];
+    }
+    if (sum > 127 * channels) {
+      bits |= 1u << bit;
+    }
+  }
+  return static_cast<int64_t>(bits);
+}
+
+std::optional<SyntheticOptions::Pattern>
+SyntheticSource::parsePattern(const std::string &name) {
+  for (const auto pattern :
+       {SyntheticOptions::Pattern::BARS, SyntheticOptions::Pattern::GRADIENT,
+        SyntheticOptions::Pattern::CHECKER,
+        SyntheticOptions::Pattern::NOISE}) {
+    if (name == patternName(pattern)) {
+      return pattern;
+    }
+  }
+  return std::nullopt;
+}
+
+void SyntheticSource::reset() {
+  position_ = 0;
+  next_frame_time_ = std::chrono::steady_clock::now();
+}
+
+void SyntheticSource::close() {
+  if (!is_opened_) {
+    return;
+  }
+  canvas_.release();
+  noise_.clear();
+  is_opened_ = false;
+  LOG_INFO(getName() + " closed");
+}
+
+int SyntheticSource::getWidth() const { return options_.width; }
+int SyntheticSource::getHeight() const { return options_.height; }
+double SyntheticSource::getFPS() const { return options_.fps; }
+bool SyntheticSource::isOpened() const { return is_opened_; }
+
+std::string SyntheticSource::getName() const {
+  return std::string("Synthetic ") + patternName(options_.pattern) + " " +
+         std::to_string(options_.width) + "x" +
+         std::to_string(options_.height) + "@" +
+         std::to_string(static_cast<int>(options_.fps));
+}
+
+} // namespace visioncore::core
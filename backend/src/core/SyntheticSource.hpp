@@ -0,0 +1,126 @@
+/**
+ * @file SyntheticSource.hpp
+ * @brief Deterministic test-pattern VideoSource for benchmarks and load tests
+ *
+ * Generates moving color bars, gradients, checkerboards or noise at any
+ * resolution, rate and pixel format, with no file, codec or device involved.
+ * Every pattern is rendered once in open(): a moving pattern is drawn twice
+ * side by side and each frame is a shifted window of it, noise cycles
+ * through a few pre-generated frames. A frame therefore costs one copy plus
+ * a frame-index stamp, so benchmarks measure the pipeline, not the source.
+ *
+ * The frame index is burned into the top-left corner as a row of black and
+ * white cells (32 bits, LSB first) and can be read back downstream with
+ * decodeFrameIndex(), e.g. to check ordering or measure end-to-end latency.
+ */
+
+#ifndef SYNTHETIC_SOURCE_HPP
+#define SYNTHETIC_SOURCE_HPP
+
+#include "VideoSource.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace visioncore::core {
+
+/**
+ * @brief Generation settings for SyntheticSource
+ */
+struct SyntheticOptions {
+  enum class Pattern {
+    BARS,     ///< SMPTE-like color bars scrolling horizontally
+    GRADIENT, ///< Diagonal color ramp scrolling horizontally
+    CHECKER,  ///< Checkerboard scrolling horizontally
+    NOISE     ///< Uniform random noise, new pixels every frame
+  };
+
+  int width = 1280;
+  int height = 720;
+  double fps = 30.0;                ///< Used for timestamps and pacing
+  Pattern pattern = Pattern::BARS;
+  int type = CV_8UC3;               ///< CV_8UC1, CV_8UC3 or CV_8UC4
+  int speed = 4;                    ///< Horizontal motion, pixels per frame
+  int64_t frame_count = 0;          ///< Frames before end of stream, 0 = endless
+  bool pace = false;                ///< Sleep in readFrame() to honor fps
+  bool stamp = true;                ///< Burn the frame index into the pixels
+  uint64_t seed = 1;                ///< Noise seed, same seed = same frames
+};
+
+class SyntheticSource : public VideoSource {
+public:
+  /**
+   * @brief Constructs a synthetic source
+   *
+   * Nothing is generated until open() is called.
+   *
+   * @throws std::invalid_argument on a non-positive size or fps, or an
+   * unsupported pixel type
+   */
+  explicit SyntheticSource(const SyntheticOptions &options = {});
+
+  ~SyntheticSource() override = default;
+
+  // VideoSource implementation
+  bool open() override;
+  bool readFrame(cv::Mat &frame) override;
+  bool readFrame(cv::Mat &frame, FrameInfo &info) override;
+  void close() override;
+
+  int getWidth() const override;
+  int getHeight() const override;
+  double getFPS() const override;
+  bool isOpened() const override;
+  std::string getName() const override;
+
+  /**
+   * @brief Go back to frame 0
+   */
+  void reset();
+
+  /**
+   * @brief Index of the next frame readFrame() will return
+   */
+  int64_t getPosition() const { return position_; }
+
+  /**
+   * @brief Read back the index stamped into a frame
+   *
+   * Works on any frame that still has the source's size and top-left
+   * corner (e.g. after color changes, not after a resize or crop).
+   *
+   * @return The index, or std::nullopt if the frame is too small to hold it
+   */
+  static std::optional<int64_t> decodeFrameIndex(const cv::Mat &frame);
+
+  /**
+   * @brief Parse a pattern name ("bars", "gradient", "checker", "noise")
+   */
+  static std::optional<SyntheticOptions::Pattern>
+  parsePattern(const std::string &name);
+
+private:
+  SyntheticOptions options_;
+  bool is_opened_ = false;
+  int64_t position_ = 0;
+
+  cv::Mat canvas_;                  ///< Moving patterns: two periods wide
+  std::vector<cv::Mat> noise_;      ///< Noise pattern: frames to cycle
+  std::chrono::steady_clock::time_point next_frame_time_;
+
+  /**
+   * @brief Render one period of a moving pattern (width x height)
+   */
+  cv::Mat renderPattern() const;
+
+  /**
+   * @brief Write the frame index as black/white cells
+   */
+  static void stampFrameIndex(cv::Mat &frame, int64_t index);
+};
+
+} // namespace visioncore::core
+
+#endif // SYNTHETIC_SOURCE_HPP
@@ -5,20 +5,56 @@
 
 #include "VideoFileSource.hpp"
 #include "../utils/Logger.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <nlohmann/json.hpp>
 #include <string>
+#include <system_error>
+#include <utility>
 
 namespace visioncore::core {
 
+namespace {
+
+constexpr int kIndexVersion = 1;
+
+/**
+ * @brief Size and modification time, used to detect a stale index
+ */
+std::pair<uint64_t, int64_t> fileIdentity(const std::string &path) {
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(path, ec);
+  if (ec) {
+    return {0, 0};
+  }
+
+  const auto mtime = std::filesystem::last_write_time(path, ec);
+  if (ec) {
+    return {size, 0};
+  }
+
+  return {size, static_cast<int64_t>(mtime.time_since_epoch().count())};
+}
+
+} // namespace
+
 VideoFileSource::VideoFileSource(const std::string &video_path, bool loop)
-    : video_path_(video_path), configured_width_(0), configured_height_(0),
-      configured_fps_(0), loop_(loop) {}
+    : VideoFileSource(video_path, loop, VideoFileOptions{}) {}
+
+VideoFileSource::VideoFileSource(const std::string &video_path, bool loop,
+                                 const VideoFileOptions &options)
+    : video_path_(video_path), options_(options), configured_width_(0),
+      configured_height_(0), configured_fps_(0), loop_(loop) {}
 
 VideoFileSource::~VideoFileSource() = default;
 
 bool VideoFileSource::open() {
   LOG_INFO("Opening video file " + video_path_);
 
-  if (!capture_.open(video_path_)) {
+  if (!openCapture()) {
     LOG_ERROR("Failed to open " + video_path_);
     return false;
   }
@@ -28,33 +64,314 @@ bool VideoFileSource::open() {
   configured_height_ =
       static_cast<int>(capture_.get(cv::CAP_PROP_FRAME_HEIGHT));
   configured_fps_ = capture_.get(cv::CAP_PROP_FPS);
+  frame_count_ =
+      static_cast<int64_t>(capture_.get(cv::CAP_PROP_FRAME_COUNT));
+  position_ = 0;
 
   LOG_INFO("Video file opened: " + std::to_string(configured_width_) + "x" +
            std::to_string(configured_height_) + "@" +
            std::to_string(configured_fps_) + "FPS");
 
+  if (options_.build_index) {
+    prepareIndex();
+  }
+
   return true;
 }
 
+bool VideoFileSource::openCapture() {
+  if (options_.decode_threads > 0) {
+    const std::vector<int> params{cv::CAP_PROP_N_THREADS,
+                                  options_.decode_threads};
+    if (capture_.open(video_path_, cv::CAP_ANY, params)) {
+      return true;
+    }
+    LOG_WARNING("Decoder rejected " + std::to_string(options_.decode_threads) +
+                " threads, using backend default");
+  }
+
+  return capture_.open(video_path_);
+}
+
 bool VideoFileSource::readFrame(cv::Mat &frame) {
+  FrameInfo info;
+  return readFrame(frame, info);
+}
+
+bool VideoFileSource::readFrame(cv::Mat &frame, FrameInfo &info) {
   if (!capture_.isOpened())
     return false;
 
-  if (capture_.read(frame)) {
+  if (!capture_.read(frame)) {
+    // EOF atteint
+    if (!loop_) {
+      return false;
+    }
+
+    // Loop activée : retour au début (frame 0 is always a keyframe, no
+    // decode forward needed)
+    LOG_INFO("Looping video file: " + video_path_);
+
+    if (!seek(0) || !capture_.read(frame)) {
+      return false;
+    }
+  }
+
+  info.capture_time = std::chrono::steady_clock::now();
+  info.frame_index = position_;
+
+  if (position_ < static_cast<int64_t>(pts_ms_.size())) {
+    info.pts_ms = pts_ms_[position_];
+  } else {
+    info.pts_ms = capture_.get(cv::CAP_PROP_POS_MSEC);
+  }
+
+  ++position_;
+  return true;
+}
+
+bool VideoFileSource::seek(int64_t frame_index) {
+  if (!capture_.isOpened() || frame_index < 0) {
+    return false;
+  }
+
+  const int64_t count = getFrameCount();
+  if (count > 0 && frame_index >= count) {
+    LOG_WARNING("Seek past end of " + video_path_ + ": " +
+                std::to_string(frame_index) + " >= " + std::to_string(count));
+    return false;
+  }
+
+  if (frame_index == position_) {
     return true;
   }
 
-  // EOF atteint
-  if (!loop_) {
+  if (!hasIndex()) {
+    // No keyframe information: rely on the backend's own seek
+    if (!capture_.set(cv::CAP_PROP_POS_FRAMES,
+                      static_cast<double>(frame_index))) {
+      return false;
+    }
+    position_ = frame_index;
+    return true;
+  }
+
+  // Closest keyframe at or before the target. keyframes_ is sorted and
+  // starts at frame 0, so there always is one
+  const auto it =
+      std::upper_bound(keyframes_.begin(), keyframes_.end(), frame_index);
+  const int64_t keyframe = *std::prev(it);
+
+  // Decoding forward from where we are is cheaper when the target lies in
+  // the current GOP, ahead of the current position
+  if (frame_index < position_ || position_ < keyframe) {
+    if (!capture_.set(cv::CAP_PROP_POS_FRAMES,
+                      static_cast<double>(keyframe))) {
+      return false;
+    }
+    position_ = keyframe;
+  }
+
+  // grab() decodes without the color conversion done by retrieve()
+  while (position_ < frame_index) {
+    if (!capture_.grab()) {
+      return false;
+    }
+    ++position_;
+  }
+
+  return true;
+}
+
+bool VideoFileSource::seekToTime(double pts_ms) {
+  if (pts_ms_.empty()) {
+    if (configured_fps_ <= 0.0) {
+      return false;
+    }
+    return seek(static_cast<int64_t>(pts_ms * configured_fps_ / 1000.0));
+  }
+
+  // Frame being displayed at pts_ms: last frame whose PTS is <= pts_ms
+  const auto it = std::upper_bound(pts_ms_.begin(), pts_ms_.end(), pts_ms);
+  const int64_t index =
+      it == pts_ms_.begin() ? 0 : std::distance(pts_ms_.begin(), it) - 1;
+  return seek(index);
+}
+
+int64_t VideoFileSource::getFrameCount() const {
+  return pts_ms_.empty() ? frame_count_
+                         : static_cast<int64_t>(pts_ms_.size());
+}
+
+void VideoFileSource::prepareIndex() {
+  if (loadIndex()) {
+    LOG_INFO("Loaded keyframe index " + getIndexPath() + " (" +
+             std::to_string(keyframes_.size()) + " keyframes)");
+    return;
+  }
+
+  if (!buildIndex()) {
+    LOG_WARNING("Backend cannot report keyframes for " + video_path_ +
+                ", seeks fall back to CAP_PROP_POS_FRAMES");
+    return;
+  }
+
+  LOG_INFO("Built keyframe index for " + video_path_ + ": " +
+           std::to_string(pts_ms_.size()) + " frames, " +
+           std::to_string(keyframes_.size()) + " keyframes");
+
+  if (options_.persist_index) {
+    saveIndex();
+  }
+}
+
+bool VideoFileSource::buildIndex() {
+  keyframes_.clear();
+  pts_ms_.clear();
+
+  // Raw mode: grab() only demuxes packets, nothing is decoded
+  cv::VideoCapture raw;
+  if (!raw.open(video_path_, cv::CAP_FFMPEG, {cv::CAP_PROP_FORMAT, -1})) {
+    return false;
+  }
+
+  struct Packet {
+    double pts_ms;
+    bool key;
+  };
+  std::vector<Packet> packets;
+  if (frame_count_ > 0) {
+    packets.reserve(static_cast<size_t>(frame_count_));
+  }
+
+  while (raw.grab()) {
+    const double key = raw.get(cv::CAP_PROP_LRF_HAS_KEY_FRAME);
+    if (key < 0) {
+      return false; // property not supported by this backend
+    }
+    packets.push_back({raw.get(cv::CAP_PROP_POS_MSEC), key > 0});
+  }
+
+  if (packets.empty()) {
+    return false;
+  }
+
+  // Backends without the property report 0, not an error, for every
+  // packet. An index holding only frame 0 would make every seek decode
+  // from the start, so without a keyframe after the first packet the
+  // backend's own seek is used instead.
+  const bool keys_reported =
+      std::any_of(packets.begin() + 1, packets.end(),
+                  [](const Packet &packet) { return packet.key; });
+  if (!keys_reported) {
+    return false;
+  }
+
+  // Packets come in decode order; presentation order is PTS order
+  std::stable_sort(
+      packets.begin(), packets.end(),
+      [](const Packet &a, const Packet &b) { return a.pts_ms < b.pts_ms; });
+
+  pts_ms_.reserve(packets.size());
+  for (size_t i = 0; i < packets.size(); ++i) {
+    pts_ms_.push_back(packets[i].pts_ms);
+    if (packets[i].key) {
+      keyframes_.push_back(static_cast<int64_t>(i));
+    }
+  }
+
+  // Some containers do not expose packet timestamps in raw mode: fall back
+  // to the nominal frame rate
+  const bool pts_valid =
+      std::adjacent_find(pts_ms_.begin(), pts_ms_.end(),
+                         std::greater_equal<double>()) == pts_ms_.end();
+  if (!pts_valid && configured_fps_ > 0.0) {
+    for (size_t i = 0; i < pts_ms_.size(); ++i) {
+      pts_ms_[i] = static_cast<double>(i) * 1000.0 / configured_fps_;
+    }
+  }
+
+  // Seeking to frame 0 must always be possible
+  if (keyframes_.empty() || keyframes_.front() != 0) {
+    keyframes_.insert(keyframes_.begin(), 0);
+  }
+
+  return true;
+}
+
+bool VideoFileSource::loadIndex() {
+  std::ifstream in(getIndexPath());
+  if (!in) {
     return false;
   }
 
-  // Loop activée : retour au début
-  LOG_INFO("Looping video file: " + video_path_);
+  try {
+    const nlohmann::json index = nlohmann::json::parse(in);
+    const auto [size, mtime] = fileIdentity(video_path_);
 
-  capture_.set(cv::CAP_PROP_POS_FRAMES, 0);
+    if (index.at("version").get<int>() != kIndexVersion ||
+        index.at("size").get<uint64_t>() != size ||
+        index.at("mtime").get<int64_t>() != mtime) {
+      LOG_INFO("Keyframe index " + getIndexPath() + " is stale, rebuilding");
+      return false;
+    }
 
-  return capture_.read(frame);
+    keyframes_ = index.at("keyframes").get<std::vector<int64_t>>();
+    pts_ms_ = index.at("pts_ms").get<std::vector<double>>();
+  } catch (const nlohmann::json::exception &e) {
+    LOG_WARNING("Invalid keyframe index " + getIndexPath() + ": " + e.what());
+    keyframes_.clear();
+    pts_ms_.clear();
+    return false;
+  }
+
+  // seek() and seekToTime() binary-search both lists and start decoding
+  // from keyframes_.front(): anything buildIndex() would not produce is
+  // rejected
+  const bool valid =
+      !keyframes_.empty() && keyframes_.front() == 0 &&
+      std::adjacent_find(keyframes_.begin(), keyframes_.end(),
+                         std::greater_equal<int64_t>()) == keyframes_.end() &&
+      keyframes_.back() < static_cast<int64_t>(pts_ms_.size()) &&
+      std::is_sorted(pts_ms_.begin(), pts_ms_.end());
+  if (!valid) {
+    LOG_WARNING("Invalid keyframe index " + getIndexPath() + ", rebuilding");
+    keyframes_.clear();
+    pts_ms_.clear();
+    return false;
+  }
+
+  return true;
+}
+
+void VideoFileSource::saveIndex() const {
+  const auto [size, mtime] = fileIdentity(video_path_);
+
+  nlohmann::json index;
+  index["version"] = kIndexVersion;
+  index["size"] = size;
+  index["mtime"] = mtime;
+  index["fps"] = configured_fps_;
+  index["keyframes"] = keyframes_;
+  index["pts_ms"] = pts_ms_;
+
+  // Write then rename so a concurrent reader never sees a partial file
+  const std::string tmp_path = getIndexPath() + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::trunc);
+    if (!out || !(out << index.dump())) {
+      LOG_DEBUG("Cannot write keyframe index " + getIndexPath());
+      return;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tmp_path, getIndexPath(), ec);
+  if (ec) {
+    LOG_DEBUG("Cannot write keyframe index " + getIndexPath() + ": " +
+              ec.message());
+    std::filesystem::remove(tmp_path, ec);
+  }
 }
 
 void VideoFileSource::close() {
@@ -64,6 +381,7 @@ void VideoFileSource::close() {
   } else {
     LOG_INFO(video_path_ + " source already closed");
   }
+  position_ = 0;
 }
 
 int VideoFileSource::getWidth() const { return configured_width_; }
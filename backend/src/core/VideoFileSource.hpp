@@ -3,12 +3,32 @@
  * @brief VideoSource implementation for video files.
  *
  * Takes a video file path and provides frames from the video.
+ *
+ * On first open a keyframe index is built by demuxing the file without
+ * decoding, and persisted next to it (<video>.vcidx). Seeks jump to the
+ * closest preceding keyframe and decode forward, which is frame accurate and
+ * bounded by the GOP length. The index also provides the presentation
+ * timestamp attached to each frame.
  */
 
+#ifndef VIDEO_FILE_SOURCE_HPP
+#define VIDEO_FILE_SOURCE_HPP
+
 #include "VideoSource.hpp"
+#include <cstdint>
+#include <vector>
 
 namespace visioncore::core {
 
+/**
+ * @brief Decoder and index settings for VideoFileSource
+ */
+struct VideoFileOptions {
+  int decode_threads = 0;    ///< Decoder threads, 0 lets the backend decide
+  bool build_index = true;   ///< Build/load the keyframe index on open()
+  bool persist_index = true; ///< Save the index next to the video file
+};
+
 class VideoFileSource : public VideoSource {
 public:
   /**
@@ -20,11 +40,22 @@ public:
    */
   explicit VideoFileSource(const std::string &video_path, bool loop = false);
 
+  /**
+   * @brief Constructs a video file source with decoder/index options
+   *
+   * @param video_path Filesystem path to the video file
+   * @param loop Auto-restart when the end of the file is reached
+   * @param options Decoder threads and keyframe index settings
+   */
+  VideoFileSource(const std::string &video_path, bool loop,
+                  const VideoFileOptions &options);
+
   ~VideoFileSource() override;
 
   // VideoSource implementation
   bool open() override;
   bool readFrame(cv::Mat &frame) override;
+  bool readFrame(cv::Mat &frame, FrameInfo &info) override;
   void close() override;
 
   // Property getters - return actual video properties
@@ -35,13 +66,83 @@ public:
   std::string getName() const override;
   bool isLoopEnabled() const;
 
+  /**
+   * @brief Position the stream so the next readFrame() returns frame_index
+   * @return false if the source is closed or the index is out of range
+   */
+  bool seek(int64_t frame_index);
+
+  /**
+   * @brief Seek to the frame displayed at the given presentation time
+   */
+  bool seekToTime(double pts_ms);
+
+  /**
+   * @brief Index of the next frame readFrame() will return
+   */
+  int64_t getPosition() const { return position_; }
+
+  /**
+   * @brief Number of frames (from the index when available)
+   */
+  int64_t getFrameCount() const;
+
+  /**
+   * @brief True if a keyframe index is available
+   */
+  bool hasIndex() const { return !keyframes_.empty(); }
+
+  /**
+   * @brief Frame indices of the keyframes, in presentation order
+   */
+  const std::vector<int64_t> &getKeyframes() const { return keyframes_; }
+
+  /**
+   * @brief Path of the persisted index file
+   */
+  std::string getIndexPath() const { return video_path_ + ".vcidx"; }
+
 private:
   cv::VideoCapture capture_; ///< OpenCV video capture handle for file I/O
   std::string video_path_;   ///< Filesystem path to the video file
+  VideoFileOptions options_; ///< Decoder/index settings
 
   int configured_width_;  ///< Actual frame width provided by video
   int configured_height_; ///< Actual frame height provided by video
   double configured_fps_; ///< Actual FPS provided by video
   bool loop_ = false;     ///< Auto-restart video when it ends
+
+  int64_t position_ = 0;           ///< Next frame to be read
+  int64_t frame_count_ = 0;        ///< Reported by the container
+  std::vector<int64_t> keyframes_; ///< Keyframe indices, sorted
+  std::vector<double> pts_ms_;     ///< PTS of every frame, sorted
+
+  /**
+   * @brief Open the decoder with the configured thread count
+   */
+  bool openCapture();
+
+  /**
+   * @brief Load the persisted index, or build (and save) a new one
+   */
+  void prepareIndex();
+
+  /**
+   * @brief Demux the whole file without decoding to find keyframes
+   * @return false if the backend cannot report keyframes
+   */
+  bool buildIndex();
+
+  /**
+   * @brief Load the index file if it matches the current video file
+   */
+  bool loadIndex();
+
+  /**
+   * @brief Write the index file next to the video
+   */
+  void saveIndex() const;
 };
 } // namespace visioncore::core
+
+#endif // VIDEO_FILE_SOURCE_HPP
@@ -11,11 +11,26 @@
 #define VIDEO_SOURCE_HPP
 
 // #include <opencv2/opencv.hpp>
+#include <chrono>
+#include <cstdint>
 #include <opencv2/opencv.hpp>
 #include <string>
 
 namespace visioncore::core {
 
+/**
+ * @brief Metadata attached to a frame by its source
+ */
+struct FrameInfo {
+  /// Moment the frame left the device/decoder (steady clock)
+  std::chrono::steady_clock::time_point capture_time;
+  int64_t frame_index = -1; ///< Position in the stream, -1 if unknown
+  double pts_ms = -1.0;     ///< Presentation timestamp, -1 if unknown
+  /// Content version: two frames of the same source with the same non-zero
+  /// generation hold the same pixels, so per-frame work can be reused
+  uint64_t generation = 0;
+};
+
 class VideoSource {
 public:
   virtual ~VideoSource() = default;
@@ -34,6 +49,34 @@ public:
    */
   virtual bool readFrame(cv::Mat &frame) = 0;
 
+  /**
+   * @brief Reads the next frame and its metadata
+   *
+   * The default implementation stamps the frame when readFrame() returns.
+   * Sources that know better (device timestamps, prefetch queues) override
+   * it.
+   *
+   * @param frame Output parameter where the frame will be stored
+   * @param info Output parameter for the frame metadata
+   * @return true if frame was successfully read, false on error or end of
+   * stream
+   */
+  virtual bool readFrame(cv::Mat &frame, FrameInfo &info) {
+    if (!readFrame(frame)) {
+      return false;
+    }
+    info.capture_time = std::chrono::steady_clock::now();
+    return true;
+  }
+
+  /**
+   * @brief Wakes a readFrame() blocked waiting for data, which then fails
+   *
+   * Called from another thread to stop a consumer (FrameController::stop()).
+   * Only sources that can wait indefinitely (network ingest) need it.
+   */
+  virtual void interrupt() {}
+
   /**
    * @brief Closes the video source and releases all resources
    */
@@ -5,41 +5,222 @@
 
 #include "WebcamSource.hpp"
 #include "../utils/Logger.hpp"
+#include <algorithm>
+#include <cmath>
 #include <string>
 
 namespace visioncore::core {
 
+namespace {
+
+constexpr int kDefaultDriverBuffers = 4; ///< V4L2 default queue depth
+constexpr double kFpsTolerance = 0.9;    ///< Accept 90% of requested FPS
+
+} // namespace
+
 WebcamSource::WebcamSource(int device_id)
     : device_id_(device_id), configured_width_(0), configured_height_(0),
-      configured_fps_(0) {}
+      configured_fps_(0) {
+  // Keep the historical behavior: no format request, driver buffering
+  config_.buffer_size = 0;
+  config_.drain_stale = false;
+}
+
+WebcamSource::WebcamSource(int device_id, int width, int height, double fps)
+    : device_id_(device_id), configured_width_(0), configured_height_(0),
+      configured_fps_(0) {
+  config_.width = width;
+  config_.height = height;
+  config_.fps = fps;
+}
+
+WebcamSource::WebcamSource(int device_id, const WebcamConfig &config)
+    : device_id_(device_id), config_(config), configured_width_(0),
+      configured_height_(0), configured_fps_(0) {}
 
 WebcamSource::~WebcamSource() = default;
 
 bool WebcamSource::open() {
   LOG_INFO("Opening webcam device" + std::to_string(device_id_));
 
-  if (!capture_.open(device_id_)) {
+  if (!capture_.open(device_id_, config_.api)) {
     LOG_ERROR("Failed to open camera " + std::to_string(device_id_));
     return false;
   }
 
+  // Format the driver picked by itself, restored for the "" candidate
+  default_fourcc_ = static_cast<int>(capture_.get(cv::CAP_PROP_FOURCC));
+  negotiateFormat();
+
+  if (config_.buffer_size > 0 &&
+      !capture_.set(cv::CAP_PROP_BUFFERSIZE, config_.buffer_size)) {
+    LOG_WARNING("Camera backend does not support CAP_PROP_BUFFERSIZE");
+  }
+  format_.buffer_size =
+      static_cast<int>(capture_.get(cv::CAP_PROP_BUFFERSIZE));
+
   // Query actual device capabilities (may differ from requested values)
-  configured_width_ = static_cast<int>(capture_.get(cv::CAP_PROP_FRAME_WIDTH));
-  configured_height_ =
-      static_cast<int>(capture_.get(cv::CAP_PROP_FRAME_HEIGHT));
-  configured_fps_ = capture_.get(cv::CAP_PROP_FPS);
+  configured_width_ = format_.width;
+  configured_height_ = format_.height;
+  configured_fps_ = format_.fps;
+  drained_frames_ = 0;
+  last_grab_ = std::chrono::steady_clock::now();
 
-  LOG_INFO("Webcam opened: " + std::to_string(configured_width_) + "x" +
+  LOG_INFO("Webcam opened: " + format_.fourcc + " " +
+           std::to_string(configured_width_) + "x" +
            std::to_string(configured_height_) + " @ " +
-           std::to_string(configured_fps_) + " FPS");
+           std::to_string(configured_fps_) + " FPS, driver buffers: " +
+           (format_.buffer_size > 0 ? std::to_string(format_.buffer_size)
+                                    : std::string("unknown")));
+
+  return true;
+}
+
+void WebcamSource::negotiateFormat() {
+  const auto score = [this](const WebcamFormat &f, const std::string &want) {
+    const bool size_ok = (config_.width <= 0 || f.width == config_.width) &&
+                         (config_.height <= 0 || f.height == config_.height);
+    const bool fps_ok =
+        config_.fps <= 0.0 || f.fps >= config_.fps * kFpsTolerance;
+    const bool fourcc_ok = want.empty() || f.fourcc == want;
+    return (size_ok ? 4 : 0) + (fps_ok ? 2 : 0) + (fourcc_ok ? 1 : 0);
+  };
+
+  std::string best_fourcc;
+  int best_score = -1;
+
+  for (const auto &candidate : fourccCandidates()) {
+    const WebcamFormat applied = applyFormat(candidate);
+    const int s = score(applied, candidate);
+
+    if (s > best_score) {
+      best_score = s;
+      best_fourcc = candidate;
+      format_ = applied;
+    }
+
+    if (s == 7) {
+      return; // everything granted
+    }
+
+    LOG_WARNING("Camera refused " +
+                (candidate.empty() ? std::string("default format")
+                                   : candidate) +
+                " " + std::to_string(config_.width) + "x" +
+                std::to_string(config_.height) + "@" +
+                std::to_string(config_.fps) + ", got " + applied.fourcc + " " +
+                std::to_string(applied.width) + "x" +
+                std::to_string(applied.height) + "@" +
+                std::to_string(applied.fps));
+  }
+
+  // The last attempt is what the driver holds now: go back to the best one
+  format_ = applyFormat(best_fourcc);
+}
+
+WebcamFormat WebcamSource::applyFormat(const std::string &fourcc) {
+  // V4L2 wants the pixel format first: size and rate depend on it
+  if (fourcc.size() == 4) {
+    capture_.set(cv::CAP_PROP_FOURCC,
+                 cv::VideoWriter::fourcc(fourcc[0], fourcc[1], fourcc[2],
+                                         fourcc[3]));
+  } else if (default_fourcc_ != 0) {
+    // Undo the previous candidate instead of inheriting its format
+    capture_.set(cv::CAP_PROP_FOURCC, default_fourcc_);
+  }
+
+  if (config_.width > 0 && config_.height > 0) {
+    capture_.set(cv::CAP_PROP_FRAME_WIDTH, config_.width);
+    capture_.set(cv::CAP_PROP_FRAME_HEIGHT, config_.height);
+  }
 
+  if (config_.fps > 0.0) {
+    capture_.set(cv::CAP_PROP_FPS, config_.fps);
+  }
+
+  WebcamFormat format;
+  format.fourcc =
+      fourccToString(static_cast<int>(capture_.get(cv::CAP_PROP_FOURCC)));
+  format.width = static_cast<int>(capture_.get(cv::CAP_PROP_FRAME_WIDTH));
+  format.height = static_cast<int>(capture_.get(cv::CAP_PROP_FRAME_HEIGHT));
+  format.fps = capture_.get(cv::CAP_PROP_FPS);
+  return format;
+}
+
+std::vector<std::string> WebcamSource::fourccCandidates() const {
+  if (config_.fourcc.empty()) {
+    return {""};
+  }
+
+  std::vector<std::string> candidates{config_.fourcc};
+  for (const char *fallback : {"MJPG", "YUYV"}) {
+    if (config_.fourcc != fallback) {
+      candidates.emplace_back(fallback);
+    }
+  }
+  candidates.emplace_back(""); // whatever the driver prefers
+  return candidates;
+}
+
+bool WebcamSource::grabLatest() {
+  const auto now = std::chrono::steady_clock::now();
+  const double period_ms = 1000.0 / (configured_fps_ > 0.0 ? configured_fps_
+                                                           : 30.0);
+  const double away_ms =
+      std::chrono::duration<double, std::milli>(now - last_grab_).count();
+
+  // Frames captured while we were away are waiting in the driver queue,
+  // oldest first. Drop all of them but the newest one.
+  int stale = 0;
+  if (config_.drain_stale) {
+    const int queued = static_cast<int>(away_ms / period_ms);
+    const int depth = format_.buffer_size > 0 ? format_.buffer_size
+                                              : kDefaultDriverBuffers;
+    stale = std::min(queued, depth) - 1;
+  }
+
+  for (int i = 0; i < stale; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    if (!capture_.grab()) {
+      return false;
+    }
+    ++drained_frames_;
+
+    // A grab that had to wait for the sensor means the queue is empty:
+    // this frame is fresh, keep it
+    const double waited_ms = std::chrono::duration<double, std::milli>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+    if (waited_ms > period_ms / 2) {
+      --drained_frames_;
+      last_grab_ = std::chrono::steady_clock::now();
+      return true;
+    }
+  }
+
+  if (!capture_.grab()) {
+    return false;
+  }
+
+  last_grab_ = std::chrono::steady_clock::now();
   return true;
 }
 
 bool WebcamSource::readFrame(cv::Mat &frame) {
+  FrameInfo info;
+  return readFrame(frame, info);
+}
+
+bool WebcamSource::readFrame(cv::Mat &frame, FrameInfo &info) {
   if (!capture_.isOpened())
     return false;
-  return capture_.read(frame);
+
+  if (!grabLatest()) {
+    return false;
+  }
+
+  info.capture_time = last_grab_;
+  return capture_.retrieve(frame);
 }
 
 void WebcamSource::close() {
@@ -49,6 +230,15 @@ void WebcamSource::close() {
   }
 }
 
+std::string WebcamSource::fourccToString(int fourcc) {
+  std::string text(4, ' ');
+  for (int i = 0; i < 4; ++i) {
+    const char c = static_cast<char>((fourcc >> (8 * i)) & 0xFF);
+    text[i] = (c >= 32 && c < 127) ? c : '?';
+  }
+  return text;
+}
+
 int WebcamSource::getWidth() const { return configured_width_; }
 int WebcamSource::getHeight() const { return configured_height_; }
 double WebcamSource::getFPS() const { return configured_fps_; }
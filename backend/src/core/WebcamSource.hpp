@@ -4,12 +4,46 @@
  *
  * Captures live video from a physical camera device using OpenCV's
  * VideoCapture. Supports both auto-configuration (query device capabilities)
- * and manual configuration (request specific resolution/FPS).
+ * and manual configuration (request pixel format, resolution, FPS and driver
+ * buffer depth, with fallbacks when the device refuses them).
  */
+
+#ifndef WEBCAM_SOURCE_HPP
+#define WEBCAM_SOURCE_HPP
+
 #include "VideoSource.hpp"
+#include <chrono>
+#include <cstdint>
+#include <vector>
 
 namespace visioncore::core {
 
+/**
+ * @brief Capture settings requested from the camera
+ *
+ * Zero/empty fields keep the driver's choice.
+ */
+struct WebcamConfig {
+  std::string fourcc;      ///< Pixel format, e.g. "MJPG" or "YUYV"
+  int width = 0;           ///< Frame width in pixels
+  int height = 0;          ///< Frame height in pixels
+  double fps = 0.0;        ///< Frames per second
+  int buffer_size = 1;     ///< Driver queue depth (CAP_PROP_BUFFERSIZE)
+  bool drain_stale = true; ///< Skip frames already queued by the driver
+  int api = cv::CAP_ANY;   ///< Capture backend (cv::CAP_V4L2, ...)
+};
+
+/**
+ * @brief Format actually delivered by the camera after negotiation
+ */
+struct WebcamFormat {
+  std::string fourcc;
+  int width = 0;
+  int height = 0;
+  double fps = 0.0;
+  int buffer_size = 0; ///< 0 if the backend does not report it
+};
+
 class WebcamSource : public VideoSource {
 public:
   /**
@@ -35,6 +69,14 @@ public:
    */
   WebcamSource(int device_id, int width, int height, double fps);
 
+  /**
+   * @brief Constructs a webcam source with a full capture configuration
+   *
+   * @param device_id Camera device index (0 = default/first camera)
+   * @param config Requested format and buffering
+   */
+  WebcamSource(int device_id, const WebcamConfig &config);
+
   /**
    * @brief Destructor
    */
@@ -43,6 +85,7 @@ public:
   // VideoSource implementation
   bool open() override;
   bool readFrame(cv::Mat &frame) override;
+  bool readFrame(cv::Mat &frame, FrameInfo &info) override;
   void close() override;
 
   // Property getters - return actual capture device properties
@@ -52,13 +95,58 @@ public:
   bool isOpened() const override;
   std::string getName() const override;
 
+  /**
+   * @brief Format negotiated with the device (valid after open())
+   */
+  const WebcamFormat &getNegotiatedFormat() const { return format_; }
+
+  /**
+   * @brief Number of stale driver buffers skipped since open()
+   */
+  uint64_t getDrainedFrameCount() const { return drained_frames_; }
+
+  /**
+   * @brief Convert a FOURCC code to its 4 character string
+   */
+  static std::string fourccToString(int fourcc);
+
 private:
   cv::VideoCapture capture_; ///< OpenCV video capture handle for camera I/O
   int device_id_;            ///< Camera device index (0 = default camera)
+  WebcamConfig config_;      ///< Requested configuration
+  WebcamFormat format_;      ///< Negotiated configuration
+  int default_fourcc_ = 0;   ///< Driver format right after opening
 
   int configured_width_;  ///< Actual frame width provided by device
   int configured_height_; ///< Actual frame height provided by device
   double configured_fps_; ///< Actual FPS provided by device
+
+  uint64_t drained_frames_ = 0;
+  std::chrono::steady_clock::time_point last_grab_; ///< End of previous grab
+
+  /**
+   * @brief Try the requested format, then fallbacks, keep the best match
+   */
+  void negotiateFormat();
+
+  /**
+   * @brief Apply one candidate format and read back what the driver chose
+   */
+  WebcamFormat applyFormat(const std::string &fourcc);
+
+  /**
+   * @brief Pixel formats to try, requested one first
+   */
+  std::vector<std::string> fourccCandidates() const;
+
+  /**
+   * @brief Grab the most recent frame, skipping buffers the driver already
+   * queued while we were busy
+   * @return false if the device failed to deliver a frame
+   */
+  bool grabLatest();
 };
 
 } // namespace visioncore::core
+
+#endif // WEBCAM_SOURCE_HPP
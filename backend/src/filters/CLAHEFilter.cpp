@@ -0,0 +1,331 @@
+/**
+ * @file CLAHEFilter.cpp
+ * @brief CLAHEFilter implementation
+ */
+
+#include "CLAHEFilter.hpp"
+#include "../utils/Logger.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+namespace visioncore::filters {
+
+namespace {
+
+constexpr int kHistSize = 256;
+constexpr int kMaxTiles = 64;
+
+/**
+ * @brief Histogram of one tile
+ *
+ * Four interleaved sub-histograms are filled so that runs of equal pixels
+ * (flat areas are common in low-light footage) do not serialize on the same
+ * counter through store-to-load forwarding. They are summed at the end.
+ */
+void tileHistogram(const cv::Mat &src, const cv::Rect &tile,
+                   uint32_t hist[kHistSize]) {
+  std::array<std::array<uint32_t, kHistSize>, 4> sub{};
+
+  for (int y = tile.y; y < tile.y + tile.height; ++y) {
+    const uchar *p = src.ptr<uchar>(y) + tile.x;
+    int x = 0;
+
+    for (; x + 8 <= tile.width; x += 8) {
+      uint64_t v;
+      std::memcpy(&v, p + x, sizeof(v));
+      ++sub[0][v & 0xFF];
+      ++sub[1][(v >> 8) & 0xFF];
+      ++sub[2][(v >> 16) & 0xFF];
+      ++sub[3][(v >> 24) & 0xFF];
+      ++sub[0][(v >> 32) & 0xFF];
+      ++sub[1][(v >> 40) & 0xFF];
+      ++sub[2][(v >> 48) & 0xFF];
+      ++sub[3][(v >> 56) & 0xFF];
+    }
+
+    for (; x < tile.width; ++x) {
+      ++sub[0][p[x]];
+    }
+  }
+
+  for (int i = 0; i < kHistSize; ++i) {
+    hist[i] = sub[0][i] + sub[1][i] + sub[2][i] + sub[3][i];
+  }
+}
+
+/**
+ * @brief Clip the histogram and spread the excess uniformly over all bins
+ */
+void clipHistogram(uint32_t hist[kHistSize], uint32_t limit) {
+  uint32_t excess = 0;
+  for (int i = 0; i < kHistSize; ++i) {
+    if (hist[i] > limit) {
+      excess += hist[i] - limit;
+      hist[i] = limit;
+    }
+  }
+
+  const uint32_t batch = excess / kHistSize;
+  uint32_t residual = excess - batch * kHistSize;
+
+  for (int i = 0; i < kHistSize; ++i) {
+    hist[i] += batch;
+  }
+
+  if (residual > 0) {
+    const int step = std::max<int>(kHistSize / static_cast<int>(residual), 1);
+    for (int i = 0; i < kHistSize && residual > 0; i += step, --residual) {
+      ++hist[i];
+    }
+  }
+}
+
+} // namespace
+
+CLAHEFilter::CLAHEFilter(double clip_limit, int tiles_x, int tiles_y)
+    : clip_limit_(clip_limit), tiles_x_(tiles_x), tiles_y_(tiles_y) {
+
+  if (clip_limit_ <= 0.0) {
+    throw std::invalid_argument("CLAHE clip limit must be > 0");
+  }
+
+  if (tiles_x_ < 1 || tiles_x_ > kMaxTiles || tiles_y_ < 1 ||
+      tiles_y_ > kMaxTiles) {
+    throw std::invalid_argument("CLAHE tile grid must be in [1, 64]");
+  }
+}
+
+CLAHEFilter::~CLAHEFilter() = default;
+
+void CLAHEFilter::apply(const cv::Mat &input, cv::Mat &output) {
+  if (!enabled_) {
+    output = input.clone();
+    return;
+  }
+
+  if (input.empty() || input.depth() != CV_8U) {
+    if (!input.empty()) {
+      LOG_WARNING("CLAHE filter only supports 8-bit images");
+    }
+    output = input.clone();
+    return;
+  }
+
+  if (input.channels() == 1) {
+    equalize(input, output);
+    return;
+  }
+
+  if (input.channels() != 3) {
+    LOG_WARNING("CLAHE filter only supports 1 or 3 channel images");
+    output = input.clone();
+    return;
+  }
+
+  // Equalize luma only so that colors are not shifted
+  cv::Mat ycrcb;
+  cv::cvtColor(input, ycrcb, cv::COLOR_BGR2YCrCb);
+
+  cv::Mat luma;
+  cv::extractChannel(ycrcb, luma, 0);
+
+  cv::Mat equalized;
+  equalize(luma, equalized);
+
+  cv::insertChannel(equalized, ycrcb, 0);
+  cv::cvtColor(ycrcb, output, cv::COLOR_YCrCb2BGR);
+}
+
+void CLAHEFilter::equalize(const cv::Mat &src, cv::Mat &dst) {
+  const int tiles_x = std::min(tiles_x_, src.cols);
+  const int tiles_y = std::min(tiles_y_, src.rows);
+  const bool grid_changed = luts_.rows != tiles_x * tiles_y ||
+                            lut_frame_size_ != src.size() ||
+                            tile_means_.cols != tiles_x ||
+                            tile_means_.rows != tiles_y;
+
+  cv::Mat means;
+  if (reuse_luts_ && !grid_changed && reused_frames_ < max_reuse_frames_ &&
+      canReuseLUTs(src, means)) {
+    ++reused_frames_;
+    ++lut_reuses_;
+  } else {
+    if (reuse_luts_ && means.empty()) {
+      cv::resize(src, means, cv::Size(tiles_x, tiles_y), 0, 0,
+                 cv::INTER_AREA);
+    }
+
+    buildTileLUTs(src);
+    tile_means_ = means;
+    lut_frame_size_ = src.size();
+    reused_frames_ = 0;
+    ++lut_builds_;
+  }
+
+  interpolate(src, dst);
+}
+
+bool CLAHEFilter::canReuseLUTs(const cv::Mat &src, cv::Mat &means) const {
+  // INTER_AREA down to the tile grid yields the mean of every tile in one
+  // vectorized pass, much cheaper than rebuilding all histograms
+  cv::resize(src, means, tile_means_.size(), 0, 0, cv::INTER_AREA);
+  return cv::norm(means, tile_means_, cv::NORM_INF) <= reuse_threshold_;
+}
+
+void CLAHEFilter::buildTileLUTs(const cv::Mat &src) {
+  const int tiles_x = std::min(tiles_x_, src.cols);
+  const int tiles_y = std::min(tiles_y_, src.rows);
+  const double clip_limit = clip_limit_;
+
+  luts_.create(tiles_x * tiles_y, kHistSize, CV_8U);
+
+  cv::parallel_for_(cv::Range(0, tiles_x * tiles_y), [&](const cv::Range &r) {
+    uint32_t hist[kHistSize];
+
+    for (int t = r.start; t < r.end; ++t) {
+      const int tx = t % tiles_x;
+      const int ty = t / tiles_x;
+
+      const int x0 = tx * src.cols / tiles_x;
+      const int x1 = (tx + 1) * src.cols / tiles_x;
+      const int y0 = ty * src.rows / tiles_y;
+      const int y1 = (ty + 1) * src.rows / tiles_y;
+      const cv::Rect tile(x0, y0, x1 - x0, y1 - y0);
+      const int area = tile.area();
+
+      tileHistogram(src, tile, hist);
+
+      const auto limit = static_cast<uint32_t>(
+          std::max(1.0, clip_limit * area / kHistSize));
+      clipHistogram(hist, limit);
+
+      const float scale = 255.0f / static_cast<float>(area);
+      uchar *lut = luts_.ptr<uchar>(t);
+      uint32_t cdf = 0;
+      for (int i = 0; i < kHistSize; ++i) {
+        cdf += hist[i];
+        lut[i] = cv::saturate_cast<uchar>(static_cast<float>(cdf) * scale);
+      }
+    }
+  });
+}
+
+void CLAHEFilter::interpolate(const cv::Mat &src, cv::Mat &dst) const {
+  const int tiles_x = std::min(tiles_x_, src.cols);
+  const int tiles_y = std::min(tiles_y_, src.rows);
+  const float tile_w = static_cast<float>(src.cols) / tiles_x;
+  const float tile_h = static_cast<float>(src.rows) / tiles_y;
+
+  // Column -> (left LUT offset, right LUT offset, right weight), shared by
+  // every row
+  std::vector<int> left(src.cols);
+  std::vector<int> right(src.cols);
+  std::vector<float> weight(src.cols);
+
+  for (int x = 0; x < src.cols; ++x) {
+    const float txf = (x + 0.5f) / tile_w - 0.5f;
+    const int tx1 = static_cast<int>(std::floor(txf));
+    const int tx2 = tx1 + 1;
+    weight[x] = txf - static_cast<float>(tx1);
+    left[x] = std::max(tx1, 0) * kHistSize;
+    right[x] = std::min(tx2, tiles_x - 1) * kHistSize;
+  }
+
+  dst.create(src.size(), CV_8UC1);
+
+  cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range &r) {
+    for (int y = r.start; y < r.end; ++y) {
+      const float tyf = (y + 0.5f) / tile_h - 0.5f;
+      const int ty1 = static_cast<int>(std::floor(tyf));
+      const int ty2 = ty1 + 1;
+      const float ya = tyf - static_cast<float>(ty1);
+      const float ya1 = 1.0f - ya;
+
+      const uchar *lut_top = luts_.ptr<uchar>(std::max(ty1, 0) * tiles_x);
+      const uchar *lut_bottom =
+          luts_.ptr<uchar>(std::min(ty2, tiles_y - 1) * tiles_x);
+
+      const uchar *s = src.ptr<uchar>(y);
+      uchar *d = dst.ptr<uchar>(y);
+
+      for (int x = 0; x < src.cols; ++x) {
+        const int v = s[x];
+        const float xa = weight[x];
+        const float xa1 = 1.0f - xa;
+
+        const float top = lut_top[left[x] + v] * xa1 + lut_top[right[x] + v] * xa;
+        const float bottom =
+            lut_bottom[left[x] + v] * xa1 + lut_bottom[right[x] + v] * xa;
+
+        d[x] = cv::saturate_cast<uchar>(top * ya1 + bottom * ya);
+      }
+    }
+  });
+}
+
+void CLAHEFilter::setParameter(const std::string &name,
+                               const nlohmann::json &value) {
+  if (name == "clip_limit") {
+    double limit = value.get<double>();
+    if (limit <= 0.0) {
+      LOG_WARNING("Invalid clip_limit value: " + std::to_string(limit) +
+                  ", must be positive");
+      return;
+    }
+    clip_limit_ = limit;
+    luts_.release(); // force a rebuild with the new limit
+
+  } else if (name == "tiles_x" || name == "tiles_y") {
+    int tiles = value.get<int>();
+    if (tiles < 1 || tiles > kMaxTiles) {
+      LOG_WARNING("Invalid " + name + " value: " + std::to_string(tiles) +
+                  ", must be in [1, 64]");
+      return;
+    }
+    (name == "tiles_x" ? tiles_x_ : tiles_y_) = tiles;
+    luts_.release();
+
+  } else if (name == "reuse_luts") {
+    reuse_luts_ = value.get<bool>();
+
+  } else if (name == "reuse_threshold") {
+    double threshold = value.get<double>();
+    if (threshold < 0.0) {
+      LOG_WARNING("Invalid reuse_threshold value, must be >= 0");
+      return;
+    }
+    reuse_threshold_ = threshold;
+
+  } else if (name == "max_reuse_frames") {
+    int frames = value.get<int>();
+    if (frames < 0) {
+      LOG_WARNING("Invalid max_reuse_frames value, must be >= 0");
+      return;
+    }
+    max_reuse_frames_ = frames;
+
+  } else {
+    LOG_WARNING("Unknown parameter: " + name);
+  }
+}
+
+nlohmann::json CLAHEFilter::getParameters() const {
+  nlohmann::json params;
+  params["clip_limit"] = clip_limit_;
+  params["tiles_x"] = tiles_x_;
+  params["tiles_y"] = tiles_y_;
+  params["reuse_luts"] = reuse_luts_;
+  params["reuse_threshold"] = reuse_threshold_;
+  params["max_reuse_frames"] = max_reuse_frames_;
+  params["enabled"] = enabled_;
+  return params;
+}
+
+std::string CLAHEFilter::getName() const { return "clahe"; }
+
+} // namespace visioncore::filters
@@ -0,0 +1,97 @@
+/**
+ * @file CLAHEFilter.hpp
+ * @brief IFilter implementation for Contrast Limited Adaptive Histogram
+ * Equalization (CLAHE)
+ *
+ * The frame is split into a grid of tiles. Each tile gets its own clipped
+ * histogram and equalization LUT, and every pixel is mapped through a
+ * bilinear blend of the four closest tile LUTs. Color frames are processed on
+ * the luma channel only (YCrCb) so hues are preserved.
+ */
+
+#ifndef CLAHE_FILTER_HPP
+#define CLAHE_FILTER_HPP
+
+#include "IFilter.hpp"
+#include <cstdint>
+
+namespace visioncore::filters {
+
+class CLAHEFilter : public IFilter {
+public:
+  /**
+   * @brief Construct the filter
+   *
+   * @param clip_limit Contrast limit, relative to a flat histogram (> 0)
+   * @param tiles_x Number of tile columns
+   * @param tiles_y Number of tile rows
+   */
+  explicit CLAHEFilter(double clip_limit = 2.0, int tiles_x = 8,
+                       int tiles_y = 8);
+
+  /**
+   * @brief Destructor
+   */
+  ~CLAHEFilter() override;
+
+  // CLAHEFilter implementation
+  void apply(const cv::Mat &input, cv::Mat &output) override;
+  void setParameter(const std::string &name,
+                    const nlohmann::json &value) override;
+  nlohmann::json getParameters() const override;
+  std::string getName() const override;
+
+  /**
+   * @brief Number of frames whose tile LUTs were rebuilt
+   */
+  uint64_t getLUTBuildCount() const { return lut_builds_; }
+
+  /**
+   * @brief Number of frames that reused the previous frame's tile LUTs
+   */
+  uint64_t getLUTReuseCount() const { return lut_reuses_; }
+
+private:
+  double clip_limit_;
+  int tiles_x_;
+  int tiles_y_;
+
+  bool reuse_luts_ = false;      ///< Reuse tile LUTs on stable scenes
+  double reuse_threshold_ = 2.0; ///< Max tile mean drift (gray levels)
+  int max_reuse_frames_ = 30;    ///< Force a rebuild after N reused frames
+
+  cv::Mat luts_;       ///< One 256-entry LUT per tile (tiles x 256, CV_8U)
+  cv::Mat tile_means_; ///< Tile means of the frame the LUTs were built on
+  cv::Size lut_frame_size_;
+  int reused_frames_ = 0;
+
+  uint64_t lut_builds_ = 0;
+  uint64_t lut_reuses_ = 0;
+
+  /**
+   * @brief Equalize a single 8-bit channel
+   */
+  void equalize(const cv::Mat &src, cv::Mat &dst);
+
+  /**
+   * @brief Decide whether the cached LUTs can be used for this frame
+   *
+   * @param src Luma channel of the current frame
+   * @param means Tile means of the current frame (filled)
+   */
+  bool canReuseLUTs(const cv::Mat &src, cv::Mat &means) const;
+
+  /**
+   * @brief Build the clipped histogram and LUT of every tile in parallel
+   */
+  void buildTileLUTs(const cv::Mat &src);
+
+  /**
+   * @brief Map every pixel through the bilinear blend of its tile LUTs
+   */
+  void interpolate(const cv::Mat &src, cv::Mat &dst) const;
+};
+
+} // namespace visioncore::filters
+
+#endif // CLAHE_FILTER_HPP
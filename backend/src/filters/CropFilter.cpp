@@ -0,0 +1,78 @@
+/**
+ * @file CropFilter.cpp
+ * @brief CropFilter implementation
+ */
+
+#include "CropFilter.hpp"
+#include "utils/Logger.hpp"
+#include <opencv2/opencv.hpp>
+#include <string>
+
+namespace visioncore::filters {
+
+CropFilter::CropFilter(const cv::Rect &region) : region_(region) {
+  if (region_.width <= 0 || region_.height <= 0) {
+    throw std::invalid_argument("Crop region must have a positive size");
+  }
+}
+
+CropFilter::~CropFilter() = default;
+
+void CropFilter::apply(const cv::Mat &input, cv::Mat &output) {
+  if (!enabled_) {
+    output = input.clone();
+    return;
+  }
+
+  const cv::Rect clipped = region_ & cv::Rect(0, 0, input.cols, input.rows);
+
+  if (clipped.empty()) {
+    if (!input.empty()) {
+      LOG_WARNING("Crop region is outside of the frame");
+    }
+    output = input.clone();
+    return;
+  }
+
+  // Header only: shares the input buffer
+  output = input(clipped);
+}
+
+void CropFilter::setParameter(const std::string &name,
+                              const nlohmann::json &value) {
+  if (name == "x" || name == "y") {
+    int new_value = value.get<int>();
+    if (new_value < 0) {
+      LOG_WARNING("Invalid " + name + " value: " + std::to_string(new_value) +
+                  ", must be >= 0");
+      return;
+    }
+    (name == "x" ? region_.x : region_.y) = new_value;
+
+  } else if (name == "width" || name == "height") {
+    int new_value = value.get<int>();
+    if (new_value <= 0) {
+      LOG_WARNING("Invalid " + name + " value: " + std::to_string(new_value) +
+                  ", must be positive");
+      return;
+    }
+    (name == "width" ? region_.width : region_.height) = new_value;
+
+  } else {
+    LOG_WARNING("Unknown parameter: " + name);
+  }
+}
+
+nlohmann::json CropFilter::getParameters() const {
+  nlohmann::json params;
+  params["x"] = region_.x;
+  params["y"] = region_.y;
+  params["width"] = region_.width;
+  params["height"] = region_.height;
+  params["enabled"] = enabled_;
+  return params;
+}
+
+std::string CropFilter::getName() const { return "crop"; }
+
+} // namespace visioncore::filters
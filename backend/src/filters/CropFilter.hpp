@@ -0,0 +1,43 @@
+/**
+ * @file CropFilter.hpp
+ * @brief IFilter implementation for crop filter
+ *
+ * Keep only a rectangular region of the frame. The output is a view into
+ * the input buffer (no pixel copy); the region is clipped to the frame.
+ */
+
+#ifndef CROP_FILTER_HPP
+#define CROP_FILTER_HPP
+
+#include "IFilter.hpp"
+
+namespace visioncore::filters {
+
+class CropFilter : public IFilter {
+public:
+  /**
+   * @brief Construct the filter
+   *
+   * @param region Region to keep, in input pixel coordinates
+   */
+  explicit CropFilter(const cv::Rect &region);
+
+  /**
+   * @brief Destructor
+   */
+  ~CropFilter() override;
+
+  // CropFilter implementation
+  void apply(const cv::Mat &input, cv::Mat &output) override;
+  void setParameter(const std::string &name,
+                    const nlohmann::json &value) override;
+  nlohmann::json getParameters() const override;
+  std::string getName() const override;
+
+private:
+  cv::Rect region_;
+};
+
+} // namespace visioncore::filters
+
+#endif // CROP_FILTER_HPP
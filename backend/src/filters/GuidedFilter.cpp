@@ -0,0 +1,221 @@
+/**
+ * @file GuidedFilter.cpp
+ * @brief GuidedFilter implementation
+ */
+
+#include "GuidedFilter.hpp"
+#include "../utils/Logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+namespace visioncore::filters {
+
+namespace {
+
+constexpr int kMaxSubsample = 8;
+
+/**
+ * @brief Normalized box filter with the border handling used everywhere
+ */
+void boxMean(const cv::Mat &src, cv::Mat &dst, int radius) {
+  cv::boxFilter(src, dst, CV_32F, cv::Size(2 * radius + 1, 2 * radius + 1),
+                cv::Point(-1, -1), true, cv::BORDER_REFLECT);
+}
+
+} // namespace
+
+GuidedFilter::GuidedFilter(int radius, double eps, int subsample)
+    : radius_(radius), eps_(eps), subsample_(subsample) {
+
+  if (radius_ < 1) {
+    throw std::invalid_argument("Guided filter radius must be >= 1");
+  }
+
+  if (eps_ <= 0.0) {
+    throw std::invalid_argument("Guided filter eps must be > 0");
+  }
+
+  if (subsample_ < 1 || subsample_ > kMaxSubsample) {
+    throw std::invalid_argument("Guided filter subsample must be in [1, 8]");
+  }
+}
+
+GuidedFilter::~GuidedFilter() = default;
+
+void GuidedFilter::apply(const cv::Mat &input, cv::Mat &output) {
+  if (!enabled_) {
+    output = input.clone();
+    return;
+  }
+
+  if (input.empty() || input.depth() != CV_8U ||
+      (input.channels() != 1 && input.channels() != 3)) {
+    if (!input.empty()) {
+      LOG_WARNING("Guided filter only supports 8-bit 1 or 3 channel images");
+    }
+    output = input.clone();
+    return;
+  }
+
+  input.convertTo(src_, CV_32F, 1.0 / 255.0);
+
+  if (input.channels() == 1) {
+    guide_ = src_;
+  } else {
+    cv::cvtColor(src_, guide_, cv::COLOR_BGR2GRAY);
+  }
+
+  // Never subsample below a few pixels per radius
+  const int subsample =
+      std::max(1, std::min({subsample_, radius_, input.cols, input.rows}));
+  const int radius = std::max(
+      1, static_cast<int>(std::lround(static_cast<double>(radius_) / subsample)));
+
+  if (subsample == 1) {
+    guide_low_ = guide_;
+    src_low_ = src_;
+  } else {
+    const cv::Size low(input.cols / subsample, input.rows / subsample);
+    cv::resize(guide_, guide_low_, low, 0, 0, cv::INTER_AREA);
+    cv::resize(src_, src_low_, low, 0, 0, cv::INTER_AREA);
+  }
+
+  computeCoefficients(radius);
+
+  if (subsample == 1) {
+    a_up_ = mean_a_;
+    b_up_ = mean_b_;
+  } else {
+    cv::resize(mean_a_, a_up_, input.size(), 0, 0, cv::INTER_LINEAR);
+    cv::resize(mean_b_, b_up_, input.size(), 0, 0, cv::INTER_LINEAR);
+  }
+
+  // q = mean_a * I + mean_b at full resolution
+  output.create(input.size(), input.type());
+  const int cn = input.channels();
+
+  cv::parallel_for_(cv::Range(0, input.rows), [&](const cv::Range &r) {
+    for (int y = r.start; y < r.end; ++y) {
+      const float *guide = guide_.ptr<float>(y);
+      const float *a = a_up_.ptr<float>(y);
+      const float *b = b_up_.ptr<float>(y);
+      uchar *dst = output.ptr<uchar>(y);
+
+      for (int x = 0; x < input.cols; ++x) {
+        const float g = guide[x];
+        for (int c = 0; c < cn; ++c) {
+          const int i = x * cn + c;
+          dst[i] = cv::saturate_cast<uchar>((a[i] * g + b[i]) * 255.0f);
+        }
+      }
+    }
+  });
+}
+
+void GuidedFilter::computeCoefficients(int radius) {
+  const int rows = guide_low_.rows;
+  const int cn = src_low_.channels();
+  const int halo = 2 * radius;
+  const float eps = static_cast<float>(eps_);
+
+  mean_a_.create(guide_low_.size(), CV_32FC(cn));
+  mean_b_.create(guide_low_.size(), CV_32FC(cn));
+
+  // Bands tall enough that the halo does not dominate the work
+  const int threads = std::max(1, cv::getNumThreads());
+  const int band_rows =
+      std::max((rows + 2 * threads - 1) / (2 * threads), 4 * radius);
+  const int bands = (rows + band_rows - 1) / band_rows;
+
+  cv::parallel_for_(cv::Range(0, bands), [&](const cv::Range &range) {
+    cv::Mat mean_i, corr_ii, var_i, mean_p, corr_ip, a, b;
+    std::vector<cv::Mat> planes;
+    std::vector<cv::Mat> band_a(cn);
+    std::vector<cv::Mat> band_b(cn);
+
+    for (int band = range.start; band < range.end; ++band) {
+      const int y0 = band * band_rows;
+      const int y1 = std::min(rows, y0 + band_rows);
+      const int h0 = std::max(0, y0 - halo);
+      const int h1 = std::min(rows, y1 + halo);
+      const cv::Range keep(y0 - h0, y1 - h0);
+
+      const cv::Mat guide = guide_low_.rowRange(h0, h1).clone();
+      const cv::Mat src = src_low_.rowRange(h0, h1).clone();
+
+      boxMean(guide, mean_i, radius);
+      boxMean(guide.mul(guide), corr_ii, radius);
+      var_i = corr_ii - mean_i.mul(mean_i);
+
+      cv::split(src, planes);
+
+      for (int c = 0; c < cn; ++c) {
+        boxMean(planes[c], mean_p, radius);
+        boxMean(guide.mul(planes[c]), corr_ip, radius);
+
+        a = (corr_ip - mean_i.mul(mean_p)) / (var_i + eps);
+        b = mean_p - a.mul(mean_i);
+
+        boxMean(a, band_a[c], radius);
+        boxMean(b, band_b[c], radius);
+        band_a[c] = band_a[c].rowRange(keep);
+        band_b[c] = band_b[c].rowRange(keep);
+      }
+
+      cv::Mat out_a = mean_a_.rowRange(y0, y1);
+      cv::Mat out_b = mean_b_.rowRange(y0, y1);
+      cv::merge(band_a, out_a);
+      cv::merge(band_b, out_b);
+    }
+  });
+}
+
+void GuidedFilter::setParameter(const std::string &name,
+                                const nlohmann::json &value) {
+  if (name == "radius") {
+    int radius = value.get<int>();
+    if (radius < 1) {
+      LOG_WARNING("Invalid radius value: " + std::to_string(radius) +
+                  ", must be >= 1");
+      return;
+    }
+    radius_ = radius;
+
+  } else if (name == "eps") {
+    double eps = value.get<double>();
+    if (eps <= 0.0) {
+      LOG_WARNING("Invalid eps value: " + std::to_string(eps) +
+                  ", must be positive");
+      return;
+    }
+    eps_ = eps;
+
+  } else if (name == "subsample") {
+    int subsample = value.get<int>();
+    if (subsample < 1 || subsample > kMaxSubsample) {
+      LOG_WARNING("Invalid subsample value: " + std::to_string(subsample) +
+                  ", must be in [1, 8]");
+      return;
+    }
+    subsample_ = subsample;
+
+  } else {
+    LOG_WARNING("Unknown parameter: " + name);
+  }
+}
+
+nlohmann::json GuidedFilter::getParameters() const {
+  nlohmann::json params;
+  params["radius"] = radius_;
+  params["eps"] = eps_;
+  params["subsample"] = subsample_;
+  params["enabled"] = enabled_;
+  return params;
+}
+
+std::string GuidedFilter::getName() const { return "guided"; }
+
+} // namespace visioncore::filters
@@ -0,0 +1,645 @@
+/**
+ * @file OverlayFilter.cpp
+ * @brief OverlayFilter implementation
+ */
+
+#include "OverlayFilter.hpp"
+#include "../utils/Logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <opencv2/core/hal/intrin.hpp>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+namespace visioncore::filters {
+
+namespace {
+
+constexpr int kFont = cv::FONT_HERSHEY_SIMPLEX;
+
+/**
+ * @brief Exact rounded x / 255 for x in [0, 255 * 255]
+ */
+inline int div255(int x) {
+  x += 128;
+  return (x + (x >> 8)) >> 8;
+}
+
+#if CV_SIMD128
+/**
+ * @brief v * inv / 255 on 16 lanes, widened to 16 bits for the product
+ */
+inline cv::v_uint8x16 scaleByInverseAlpha(const cv::v_uint8x16 &v,
+                                          const cv::v_uint8x16 &inv) {
+  cv::v_uint16x8 v_lo, v_hi, inv_lo, inv_hi;
+  cv::v_expand(v, v_lo, v_hi);
+  cv::v_expand(inv, inv_lo, inv_hi);
+
+  const cv::v_uint16x8 half = cv::v_setall_u16(128);
+  cv::v_uint16x8 lo = cv::v_mul_wrap(v_lo, inv_lo) + half;
+  cv::v_uint16x8 hi = cv::v_mul_wrap(v_hi, inv_hi) + half;
+  lo = (lo + (lo >> 8)) >> 8;
+  hi = (hi + (hi >> 8)) >> 8;
+
+  return cv::v_pack(lo, hi);
+}
+#endif
+
+/**
+ * @brief Blend premultiplied BGRA over a BGR row
+ */
+void blendRowBGR(const uchar *src, uchar *dst, int width) {
+  int x = 0;
+
+#if CV_SIMD128
+  const cv::v_uint8x16 full = cv::v_setall_u8(255);
+  for (; x + 16 <= width; x += 16) {
+    cv::v_uint8x16 sb, sg, sr, sa, db, dg, dr;
+    cv::v_load_deinterleave(src + 4 * x, sb, sg, sr, sa);
+    cv::v_load_deinterleave(dst + 3 * x, db, dg, dr);
+
+    const cv::v_uint8x16 inv = full - sa;
+    db = sb + scaleByInverseAlpha(db, inv);
+    dg = sg + scaleByInverseAlpha(dg, inv);
+    dr = sr + scaleByInverseAlpha(dr, inv);
+
+    cv::v_store_interleave(dst + 3 * x, db, dg, dr);
+  }
+#endif
+
+  for (; x < width; ++x) {
+    const uchar *s = src + 4 * x;
+    uchar *d = dst + 3 * x;
+    const int inv = 255 - s[3];
+    d[0] = static_cast<uchar>(s[0] + div255(d[0] * inv));
+    d[1] = static_cast<uchar>(s[1] + div255(d[1] * inv));
+    d[2] = static_cast<uchar>(s[2] + div255(d[2] * inv));
+  }
+}
+
+/**
+ * @brief Blend premultiplied BGRA over a BGRA row (alpha is composited too)
+ */
+void blendRowBGRA(const uchar *src, uchar *dst, int width) {
+  int x = 0;
+
+#if CV_SIMD128
+  const cv::v_uint8x16 full = cv::v_setall_u8(255);
+  for (; x + 16 <= width; x += 16) {
+    cv::v_uint8x16 sb, sg, sr, sa, db, dg, dr, da;
+    cv::v_load_deinterleave(src + 4 * x, sb, sg, sr, sa);
+    cv::v_load_deinterleave(dst + 4 * x, db, dg, dr, da);
+
+    const cv::v_uint8x16 inv = full - sa;
+    db = sb + scaleByInverseAlpha(db, inv);
+    dg = sg + scaleByInverseAlpha(dg, inv);
+    dr = sr + scaleByInverseAlpha(dr, inv);
+    da = sa + scaleByInverseAlpha(da, inv);
+
+    cv::v_store_interleave(dst + 4 * x, db, dg, dr, da);
+  }
+#endif
+
+  for (; x < width; ++x) {
+    const uchar *s = src + 4 * x;
+    uchar *d = dst + 4 * x;
+    const int inv = 255 - s[3];
+    for (int c = 0; c < 4; ++c) {
+      d[c] = static_cast<uchar>(s[c] + div255(d[c] * inv));
+    }
+  }
+}
+
+/**
+ * @brief Blend premultiplied luma + alpha over a grayscale row
+ */
+void blendRowGray(const uchar *src, uchar *dst, int width) {
+  int x = 0;
+
+#if CV_SIMD128
+  const cv::v_uint8x16 full = cv::v_setall_u8(255);
+  for (; x + 16 <= width; x += 16) {
+    cv::v_uint8x16 sl, sa;
+    cv::v_load_deinterleave(src + 2 * x, sl, sa);
+    const cv::v_uint8x16 d = cv::v_load(dst + x);
+
+    cv::v_store(dst + x, sl + scaleByInverseAlpha(d, full - sa));
+  }
+#endif
+
+  for (; x < width; ++x) {
+    const uchar *s = src + 2 * x;
+    dst[x] = static_cast<uchar>(s[0] + div255(dst[x] * (255 - s[1])));
+  }
+}
+
+} // namespace
+
+OverlayFilter::OverlayFilter() = default;
+
+OverlayFilter::~OverlayFilter() = default;
+
+void OverlayFilter::apply(const cv::Mat &input, cv::Mat &output) {
+  if (!enabled_) {
+    output = input.clone();
+    return;
+  }
+
+  const int channels = input.channels();
+  if (input.empty() || input.depth() != CV_8U ||
+      (channels != 1 && channels != 3 && channels != 4)) {
+    if (!input.empty()) {
+      LOG_WARNING("Overlay filter only supports 8-bit 1, 3 or 4 channel "
+                  "images");
+    }
+    output = input.clone();
+    return;
+  }
+
+  if (&output != &input) {
+    input.copyTo(output);
+  }
+
+  std::lock_guard<std::mutex> lock(layers_mutex_);
+
+  for (const auto &layer : layers_) {
+    for (const auto &patch : layer.patches) {
+      blendPatch(patch, patch.origin, output);
+    }
+  }
+
+  if (timestamp_enabled_) {
+    blendTimestamp(output);
+  }
+}
+
+void OverlayFilter::setImageLayer(const std::string &id, const cv::Mat &image,
+                                  const cv::Point &position, double opacity) {
+  if (image.empty() || image.depth() != CV_8U) {
+    LOG_WARNING("Overlay image layer '" + id + "' must be a non-empty 8-bit "
+                "image");
+    return;
+  }
+
+  Layer layer;
+  layer.id = id;
+  layer.origin = position;
+  layer.opacity = std::clamp(opacity, 0.0, 1.0);
+  layer.patches.push_back(makeImagePatch(image, layer.opacity, position));
+
+  std::lock_guard<std::mutex> lock(layers_mutex_);
+  ++rasterize_count_;
+  storeLayer(std::move(layer));
+}
+
+void OverlayFilter::setTextLayer(const std::string &id,
+                                 const std::string &text,
+                                 const cv::Point &origin,
+                                 const cv::Scalar &color, double font_scale,
+                                 int thickness, double opacity) {
+  if (font_scale <= 0.0 || thickness < 1) {
+    LOG_WARNING("Invalid text style for overlay layer '" + id + "'");
+    return;
+  }
+
+  opacity = std::clamp(opacity, 0.0, 1.0);
+
+  {
+    std::lock_guard<std::mutex> lock(layers_mutex_);
+    Layer *existing = findLayer(id);
+
+    if (existing && existing->text == text && existing->color == color &&
+        existing->font_scale == font_scale &&
+        existing->thickness == thickness && existing->opacity == opacity) {
+      // Same content: at most a move, no rasterization
+      const cv::Point delta = origin - existing->origin;
+      for (auto &patch : existing->patches) {
+        patch.origin += delta;
+      }
+      existing->origin = origin;
+      return;
+    }
+  }
+
+  // Rasterize outside the lock so apply() is not blocked by putText
+  int baseline = 0;
+  const cv::Size size =
+      cv::getTextSize(text, kFont, font_scale, thickness, &baseline);
+  const int pad = thickness;
+
+  cv::Mat coverage = cv::Mat::zeros(size.height + baseline + 2 * pad,
+                                    size.width + 2 * pad, CV_8UC1);
+  cv::putText(coverage, text, cv::Point(pad, pad + size.height), kFont,
+              font_scale, cv::Scalar(255), thickness, cv::LINE_AA);
+
+  Layer layer;
+  layer.id = id;
+  layer.text = text;
+  layer.origin = origin;
+  layer.color = color;
+  layer.font_scale = font_scale;
+  layer.thickness = thickness;
+  layer.opacity = opacity;
+  layer.patches.push_back(
+      makePatch(coverage, color, opacity,
+                origin - cv::Point(pad, pad + size.height)));
+
+  std::lock_guard<std::mutex> lock(layers_mutex_);
+  ++rasterize_count_;
+  storeLayer(std::move(layer));
+}
+
+void OverlayFilter::setBoxesLayer(const std::string &id,
+                                  const std::vector<cv::Rect> &boxes,
+                                  const cv::Scalar &color, int thickness,
+                                  double opacity) {
+  if (thickness < 1) {
+    LOG_WARNING("Invalid box thickness for overlay layer '" + id + "'");
+    return;
+  }
+
+  Layer layer;
+  layer.id = id;
+  layer.color = color;
+  layer.thickness = thickness;
+  layer.opacity = std::clamp(opacity, 0.0, 1.0);
+
+  int max_w = 0;
+  int max_h = 0;
+  for (const auto &box : boxes) {
+    max_w = std::max(max_w, box.width);
+    max_h = std::max(max_h, box.height);
+  }
+
+  if (max_w > 0 && max_h > 0) {
+    // One solid premultiplied block; every box edge is a view into it
+    const Patch solid =
+        makePatch(cv::Mat(max_h, max_w, CV_8UC1, cv::Scalar(255)), color,
+                  layer.opacity, cv::Point(0, 0));
+
+    for (const auto &box : boxes) {
+      if (box.width <= 0 || box.height <= 0) {
+        continue;
+      }
+
+      const int t = std::min({thickness, (box.width + 1) / 2,
+                              (box.height + 1) / 2});
+      const cv::Rect edges[] = {
+          cv::Rect(box.x, box.y, box.width, t),
+          cv::Rect(box.x, box.y + box.height - t, box.width, t),
+          cv::Rect(box.x, box.y + t, t, box.height - 2 * t),
+          cv::Rect(box.x + box.width - t, box.y + t, t, box.height - 2 * t)};
+
+      for (const auto &edge : edges) {
+        if (edge.width <= 0 || edge.height <= 0) {
+          continue;
+        }
+        const cv::Rect extent(0, 0, edge.width, edge.height);
+        layer.patches.push_back(
+            {edge.tl(), solid.bgra(extent), solid.gray(extent)});
+      }
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(layers_mutex_);
+  ++rasterize_count_;
+  storeLayer(std::move(layer));
+}
+
+bool OverlayFilter::removeLayer(const std::string &id) {
+  std::lock_guard<std::mutex> lock(layers_mutex_);
+
+  auto it = std::find_if(layers_.begin(), layers_.end(),
+                         [&](const Layer &l) { return l.id == id; });
+  if (it == layers_.end()) {
+    return false;
+  }
+
+  layers_.erase(it);
+  return true;
+}
+
+void OverlayFilter::clearLayers() {
+  std::lock_guard<std::mutex> lock(layers_mutex_);
+  layers_.clear();
+}
+
+size_t OverlayFilter::getLayerCount() const {
+  std::lock_guard<std::mutex> lock(layers_mutex_);
+  return layers_.size();
+}
+
+void OverlayFilter::enableTimestamp(const cv::Point &origin,
+                                    const cv::Scalar &color, double font_scale,
+                                    int thickness) {
+  if (font_scale <= 0.0 || thickness < 1) {
+    LOG_WARNING("Invalid timestamp style");
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(layers_mutex_);
+
+  if (color != timestamp_color_ || font_scale != timestamp_scale_ ||
+      thickness != timestamp_thickness_) {
+    atlas_dirty_ = true;
+  }
+
+  timestamp_origin_ = origin;
+  timestamp_color_ = color;
+  timestamp_scale_ = font_scale;
+  timestamp_thickness_ = thickness;
+  timestamp_enabled_ = true;
+}
+
+void OverlayFilter::disableTimestamp() {
+  std::lock_guard<std::mutex> lock(layers_mutex_);
+  timestamp_enabled_ = false;
+}
+
+void OverlayFilter::setTimestampProvider(
+    std::function<std::string()> provider) {
+  std::lock_guard<std::mutex> lock(layers_mutex_);
+  timestamp_provider_ = std::move(provider);
+}
+
+OverlayFilter::Layer *OverlayFilter::findLayer(const std::string &id) {
+  for (auto &layer : layers_) {
+    if (layer.id == id) {
+      return &layer;
+    }
+  }
+  return nullptr;
+}
+
+void OverlayFilter::storeLayer(Layer layer) {
+  if (Layer *existing = findLayer(layer.id)) {
+    *existing = std::move(layer);
+  } else {
+    layers_.push_back(std::move(layer));
+  }
+}
+
+OverlayFilter::Patch OverlayFilter::makePatch(const cv::Mat &coverage,
+                                              const cv::Scalar &color,
+                                              double opacity,
+                                              const cv::Point &origin) {
+  Patch patch;
+
+  const cv::Rect bbox = cv::boundingRect(coverage);
+  if (bbox.empty() || opacity <= 0.0) {
+    return patch;
+  }
+
+  cv::Mat alpha;
+  coverage(bbox).convertTo(alpha, CV_8U, opacity);
+
+  // Premultiply once here instead of once per frame in the blend kernel
+  std::vector<cv::Mat> planes(4);
+  for (int c = 0; c < 3; ++c) {
+    alpha.convertTo(planes[c], CV_8U, color[c] / 255.0);
+  }
+  planes[3] = alpha;
+  cv::merge(planes, patch.bgra);
+
+  const double luma =
+      0.114 * color[0] + 0.587 * color[1] + 0.299 * color[2];
+  cv::Mat gray_planes[2];
+  alpha.convertTo(gray_planes[0], CV_8U, luma / 255.0);
+  gray_planes[1] = alpha;
+  cv::merge(gray_planes, 2, patch.gray);
+
+  patch.origin = origin + bbox.tl();
+  return patch;
+}
+
+OverlayFilter::Patch OverlayFilter::makeImagePatch(const cv::Mat &image,
+                                                   double opacity,
+                                                   const cv::Point &origin) {
+  cv::Mat bgr;
+  cv::Mat alpha;
+
+  if (image.channels() == 4) {
+    cv::cvtColor(image, bgr, cv::COLOR_BGRA2BGR);
+    cv::extractChannel(image, alpha, 3);
+    alpha.convertTo(alpha, CV_8U, opacity);
+  } else if (image.channels() == 1) {
+    cv::cvtColor(image, bgr, cv::COLOR_GRAY2BGR);
+    alpha = cv::Mat(image.size(), CV_8UC1, cv::Scalar(255 * opacity));
+  } else {
+    bgr = image;
+    alpha = cv::Mat(image.size(), CV_8UC1, cv::Scalar(255 * opacity));
+  }
+
+  Patch patch;
+  const cv::Rect bbox = cv::boundingRect(alpha);
+  if (bbox.empty()) {
+    return patch;
+  }
+
+  bgr = bgr(bbox);
+  alpha = alpha(bbox);
+
+  cv::Mat gray;
+  cv::cvtColor(bgr, gray, cv::COLOR_BGR2GRAY);
+
+  std::vector<cv::Mat> planes(3);
+  cv::split(bgr, planes);
+  for (auto &plane : planes) {
+    cv::multiply(plane, alpha, plane, 1.0 / 255.0);
+  }
+  planes.push_back(alpha);
+  cv::merge(planes, patch.bgra);
+
+  cv::multiply(gray, alpha, gray, 1.0 / 255.0);
+  cv::Mat gray_planes[2] = {gray, alpha};
+  cv::merge(gray_planes, 2, patch.gray);
+
+  patch.origin = origin + bbox.tl();
+  return patch;
+}
+
+void OverlayFilter::buildGlyphAtlas() {
+  const int thickness = timestamp_thickness_;
+  const int pad = thickness;
+
+  // Monospace advance and common cell height so any string lines up
+  int max_w = 0;
+  int max_h = 0;
+  int max_baseline = 0;
+  for (size_t i = 0; i < kGlyphCount; ++i) {
+    int baseline = 0;
+    const cv::Size size = cv::getTextSize(std::string(1, kGlyphChars[i]),
+                                          kFont, timestamp_scale_, thickness,
+                                          &baseline);
+    max_w = std::max(max_w, size.width);
+    max_h = std::max(max_h, size.height);
+    max_baseline = std::max(max_baseline, baseline);
+  }
+
+  glyph_advance_ = max_w + thickness;
+
+  for (size_t i = 0; i < kGlyphCount; ++i) {
+    const std::string glyph(1, kGlyphChars[i]);
+    int baseline = 0;
+    const cv::Size size =
+        cv::getTextSize(glyph, kFont, timestamp_scale_, thickness, &baseline);
+    const int x = pad + (max_w - size.width) / 2;
+
+    cv::Mat coverage = cv::Mat::zeros(max_h + max_baseline + 2 * pad,
+                                      max_w + 2 * pad, CV_8UC1);
+    cv::putText(coverage, glyph, cv::Point(x, pad + max_h), kFont,
+                timestamp_scale_, cv::Scalar(255), thickness, cv::LINE_AA);
+
+    // Origin relative to the baseline start of the character cell
+    glyphs_[i] = makePatch(coverage, timestamp_color_, 1.0,
+                           cv::Point(-pad, -(pad + max_h)));
+  }
+
+  atlas_dirty_ = false;
+  ++rasterize_count_;
+}
+
+void OverlayFilter::blendTimestamp(cv::Mat &frame) {
+  if (atlas_dirty_) {
+    buildGlyphAtlas();
+  }
+
+  const std::string text =
+      timestamp_provider_ ? timestamp_provider_() : currentTimestamp();
+
+  cv::Point pen = timestamp_origin_;
+  for (char ch : text) {
+    const char *found = std::strchr(kGlyphChars, ch);
+
+    if (ch != '\0' && found) {
+      const Patch &glyph = glyphs_[found - kGlyphChars];
+      if (!glyph.bgra.empty()) {
+        blendPatch(glyph, pen + glyph.origin, frame);
+      }
+    }
+
+    pen.x += glyph_advance_;
+  }
+}
+
+void OverlayFilter::blendPatch(const Patch &patch, const cv::Point &origin,
+                               cv::Mat &frame) {
+  if (patch.bgra.empty()) {
+    return;
+  }
+
+  const cv::Rect area = cv::Rect(origin, patch.bgra.size()) &
+                        cv::Rect(0, 0, frame.cols, frame.rows);
+  if (area.empty()) {
+    return;
+  }
+
+  const cv::Point offset = area.tl() - origin;
+  const int channels = frame.channels();
+  const cv::Mat &src = channels == 1 ? patch.gray : patch.bgra;
+
+  for (int y = 0; y < area.height; ++y) {
+    const uchar *s = src.ptr<uchar>(offset.y + y) + offset.x * src.channels();
+    uchar *d = frame.ptr<uchar>(area.y + y) + area.x * channels;
+
+    if (channels == 1) {
+      blendRowGray(s, d, area.width);
+    } else if (channels == 3) {
+      blendRowBGR(s, d, area.width);
+    } else {
+      blendRowBGRA(s, d, area.width);
+    }
+  }
+}
+
+std::string OverlayFilter::currentTimestamp() {
+  const auto now = std::chrono::system_clock::now();
+  const std::time_t seconds = std::chrono::system_clock::to_time_t(now);
+  const auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          now.time_since_epoch())
+                          .count() %
+                      1000;
+
+  std::tm local{};
+  localtime_r(&seconds, &local);
+
+  char buffer[32];
+  const size_t len =
+      std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local);
+  std::snprintf(buffer + len, sizeof(buffer) - len, ".%03d",
+                static_cast<int>(millis));
+
+  return buffer;
+}
+
+void OverlayFilter::setParameter(const std::string &name,
+                                 const nlohmann::json &value) {
+  if (name == "timestamp") {
+    if (value.get<bool>()) {
+      enableTimestamp(timestamp_origin_, timestamp_color_, timestamp_scale_,
+                      timestamp_thickness_);
+    } else {
+      disableTimestamp();
+    }
+
+  } else if (name == "timestamp_x" || name == "timestamp_y") {
+    std::lock_guard<std::mutex> lock(layers_mutex_);
+    (name == "timestamp_x" ? timestamp_origin_.x : timestamp_origin_.y) =
+        value.get<int>();
+
+  } else if (name == "timestamp_scale") {
+    double scale = value.get<double>();
+    if (scale <= 0.0) {
+      LOG_WARNING("Invalid timestamp_scale value: " + std::to_string(scale) +
+                  ", must be positive");
+      return;
+    }
+    std::lock_guard<std::mutex> lock(layers_mutex_);
+    timestamp_scale_ = scale;
+    atlas_dirty_ = true;
+
+  } else if (name == "timestamp_thickness") {
+    int thickness = value.get<int>();
+    if (thickness < 1) {
+      LOG_WARNING("Invalid timestamp_thickness value, must be >= 1");
+      return;
+    }
+    std::lock_guard<std::mutex> lock(layers_mutex_);
+    timestamp_thickness_ = thickness;
+    atlas_dirty_ = true;
+
+  } else if (name == "remove_layer") {
+    if (!removeLayer(value.get<std::string>())) {
+      LOG_WARNING("Unknown overlay layer: " + value.get<std::string>());
+    }
+
+  } else {
+    LOG_WARNING("Unknown parameter: " + name);
+  }
+}
+
+nlohmann::json OverlayFilter::getParameters() const {
+  std::lock_guard<std::mutex> lock(layers_mutex_);
+
+  nlohmann::json params;
+  nlohmann::json layers = nlohmann::json::array();
+  for (const auto &layer : layers_) {
+    layers.push_back(layer.id);
+  }
+  params["layers"] = layers;
+  params["timestamp"] = timestamp_enabled_;
+  params["timestamp_x"] = timestamp_origin_.x;
+  params["timestamp_y"] = timestamp_origin_.y;
+  params["timestamp_scale"] = timestamp_scale_;
+  params["timestamp_thickness"] = timestamp_thickness_;
+  params["enabled"] = enabled_;
+  return params;
+}
+
+std::string OverlayFilter::getName() const { return "overlay"; }
+
+} // namespace visioncore::filters
@@ -0,0 +1,231 @@
+/**
+ * @file OverlayFilter.hpp
+ * @brief IFilter implementation for alpha blended overlays (logos, text,
+ * detection boxes, timestamp)
+ *
+ * Every layer is kept as a set of premultiplied-alpha BGRA patches placed in
+ * frame coordinates. Patches are rasterized only when the layer content
+ * changes; per frame the filter only blends them, and only over their
+ * bounding boxes, with a vectorized kernel:
+ *
+ *   dst = src_premultiplied + dst * (255 - alpha) / 255
+ *
+ * The timestamp layer is composed from a cached glyph atlas (digits and
+ * separators), so updating it every frame costs a few small blends.
+ */
+
+#ifndef OVERLAY_FILTER_HPP
+#define OVERLAY_FILTER_HPP
+
+#include "IFilter.hpp"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace visioncore::filters {
+
+class OverlayFilter : public IFilter {
+public:
+  /**
+   * @brief Construct the filter without any layer
+   */
+  OverlayFilter();
+
+  /**
+   * @brief Destructor
+   */
+  ~OverlayFilter() override;
+
+  // OverlayFilter implementation
+  void apply(const cv::Mat &input, cv::Mat &output) override;
+  void setParameter(const std::string &name,
+                    const nlohmann::json &value) override;
+  nlohmann::json getParameters() const override;
+  std::string getName() const override;
+
+  /**
+   * @brief Add or replace an image layer (logo, watermark)
+   *
+   * @param id Layer identifier
+   * @param image 8-bit BGR or BGRA image (alpha is used when present)
+   * @param position Top left corner in frame coordinates
+   * @param opacity Global opacity multiplier in [0, 1]
+   */
+  void setImageLayer(const std::string &id, const cv::Mat &image,
+                     const cv::Point &position, double opacity = 1.0);
+
+  /**
+   * @brief Add or replace a text layer
+   *
+   * The text is rasterized again only if the text or its style changed, so
+   * this can be called every frame with the same content.
+   *
+   * @param id Layer identifier
+   * @param text Text to draw
+   * @param origin Bottom left corner of the text (as cv::putText)
+   * @param color BGR color
+   * @param font_scale Hershey simplex font scale
+   * @param thickness Stroke thickness
+   * @param opacity Global opacity multiplier in [0, 1]
+   */
+  void setTextLayer(const std::string &id, const std::string &text,
+                    const cv::Point &origin,
+                    const cv::Scalar &color = cv::Scalar(0, 255, 0),
+                    double font_scale = 0.7, int thickness = 2,
+                    double opacity = 1.0);
+
+  /**
+   * @brief Add or replace a layer of rectangle outlines (detection boxes)
+   *
+   * @param id Layer identifier
+   * @param boxes Rectangles in frame coordinates
+   * @param color BGR color
+   * @param thickness Outline thickness in pixels
+   * @param opacity Global opacity multiplier in [0, 1]
+   */
+  void setBoxesLayer(const std::string &id, const std::vector<cv::Rect> &boxes,
+                     const cv::Scalar &color = cv::Scalar(0, 0, 255),
+                     int thickness = 2, double opacity = 1.0);
+
+  /**
+   * @brief Remove a layer
+   * @return false if no layer has this identifier
+   */
+  bool removeLayer(const std::string &id);
+
+  /**
+   * @brief Remove every layer (the timestamp is kept)
+   */
+  void clearLayers();
+
+  /**
+   * @brief Number of layers, timestamp excluded
+   */
+  size_t getLayerCount() const;
+
+  /**
+   * @brief Enable the timestamp layer
+   *
+   * @param origin Bottom left corner of the text
+   * @param color BGR color
+   * @param font_scale Hershey simplex font scale
+   * @param thickness Stroke thickness
+   */
+  void enableTimestamp(const cv::Point &origin,
+                       const cv::Scalar &color = cv::Scalar(255, 255, 255),
+                       double font_scale = 0.6, int thickness = 1);
+
+  /**
+   * @brief Disable the timestamp layer
+   */
+  void disableTimestamp();
+
+  /**
+   * @brief Replace the wall clock used by the timestamp layer
+   *
+   * @param provider Returns the text to stamp; only digits and " -:./"
+   * are drawn. Pass nullptr to restore local time (YYYY-MM-DD HH:MM:SS.mmm)
+   */
+  void setTimestampProvider(std::function<std::string()> provider);
+
+  /**
+   * @brief Number of layer or glyph atlas rasterizations since construction
+   */
+  uint64_t getRasterizeCount() const { return rasterize_count_; }
+
+private:
+  /**
+   * @brief Premultiplied patch placed in frame coordinates
+   */
+  struct Patch {
+    cv::Point origin; ///< Top left corner in the frame
+    cv::Mat bgra;     ///< Premultiplied B, G, R and alpha (CV_8UC4)
+    cv::Mat gray;     ///< Premultiplied luma and alpha (CV_8UC2)
+  };
+
+  /**
+   * @brief Source description of a layer, used to skip re-rasterization
+   */
+  struct Layer {
+    std::string id;
+    std::string text;
+    cv::Point origin;
+    cv::Scalar color;
+    double font_scale = 0.0;
+    int thickness = 0;
+    double opacity = 1.0;
+    std::vector<Patch> patches;
+  };
+
+  static constexpr const char *kGlyphChars = "0123456789 -:./";
+  static constexpr size_t kGlyphCount = 15;
+
+  mutable std::mutex layers_mutex_;
+  std::vector<Layer> layers_; ///< Blended in insertion order
+
+  bool timestamp_enabled_ = false;
+  cv::Point timestamp_origin_{10, 30};
+  cv::Scalar timestamp_color_{255, 255, 255};
+  double timestamp_scale_ = 0.6;
+  int timestamp_thickness_ = 1;
+  std::function<std::string()> timestamp_provider_;
+
+  std::array<Patch, kGlyphCount> glyphs_; ///< Patch origin is the offset
+                                          ///< from the text baseline
+  int glyph_advance_ = 0;
+  bool atlas_dirty_ = true;
+
+  uint64_t rasterize_count_ = 0;
+
+  /**
+   * @brief Find a layer by identifier, nullptr if absent
+   */
+  Layer *findLayer(const std::string &id);
+
+  /**
+   * @brief Insert a layer or replace the existing one with the same id
+   */
+  void storeLayer(Layer layer);
+
+  /**
+   * @brief Build premultiplied patches from a color and a coverage mask
+   *
+   * The patch is cropped to the mask bounding box so blending never visits
+   * fully transparent pixels.
+   */
+  static Patch makePatch(const cv::Mat &coverage, const cv::Scalar &color,
+                         double opacity, const cv::Point &origin);
+
+  /**
+   * @brief Build premultiplied patches from a BGR(A) image
+   */
+  static Patch makeImagePatch(const cv::Mat &image, double opacity,
+                              const cv::Point &origin);
+
+  /**
+   * @brief Rasterize the timestamp glyphs at a fixed advance
+   */
+  void buildGlyphAtlas();
+
+  /**
+   * @brief Blend the current timestamp from the glyph atlas
+   */
+  void blendTimestamp(cv::Mat &frame);
+
+  /**
+   * @brief Blend one patch over a CV_8UC1, CV_8UC3 or CV_8UC4 frame
+   */
+  static void blendPatch(const Patch &patch, const cv::Point &origin,
+                         cv::Mat &frame);
+
+  /**
+   * @brief Default timestamp text from the local wall clock
+   */
+  static std::string currentTimestamp();
+};
+
+} // namespace visioncore::filters
+
+#endif // OVERLAY_FILTER_HPP
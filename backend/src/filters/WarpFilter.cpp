@@ -0,0 +1,387 @@
+/**
+ * @file WarpFilter.cpp
+ * @brief WarpFilter implementation
+ */
+
+#include "WarpFilter.hpp"
+#include "../utils/Logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <opencv2/opencv.hpp>
+#include <string>
+
+namespace visioncore::filters {
+
+namespace {
+
+constexpr size_t kBandBytes = 256 * 1024; ///< Target working set per band
+
+/**
+ * @brief Invert a row-major 3x3 matrix
+ * @return false if the matrix is singular
+ */
+bool invert3x3(const std::array<double, 9> &m, std::array<double, 9> &inv) {
+  const double det = m[0] * (m[4] * m[8] - m[5] * m[7]) -
+                     m[1] * (m[3] * m[8] - m[5] * m[6]) +
+                     m[2] * (m[3] * m[7] - m[4] * m[6]);
+
+  if (std::abs(det) < 1e-12) {
+    return false;
+  }
+
+  const double d = 1.0 / det;
+  inv = {(m[4] * m[8] - m[5] * m[7]) * d, (m[2] * m[7] - m[1] * m[8]) * d,
+         (m[1] * m[5] - m[2] * m[4]) * d, (m[5] * m[6] - m[3] * m[8]) * d,
+         (m[0] * m[8] - m[2] * m[6]) * d, (m[2] * m[3] - m[0] * m[5]) * d,
+         (m[3] * m[7] - m[4] * m[6]) * d, (m[1] * m[6] - m[0] * m[7]) * d,
+         (m[0] * m[4] - m[1] * m[3]) * d};
+  return true;
+}
+
+} // namespace
+
+WarpFilter::WarpFilter(WarpMode mode) : mode_(mode) {}
+
+WarpFilter::~WarpFilter() = default;
+
+void WarpFilter::apply(const cv::Mat &input, cv::Mat &output) {
+  if (!enabled_ || input.empty()) {
+    output = input.clone();
+    return;
+  }
+
+  const WarpMode mode = effectiveMode(input.size());
+
+  if (mode == WarpMode::NONE) {
+    output = input.clone();
+    return;
+  }
+
+  if (applyFastPath(mode, input, output)) {
+    return;
+  }
+
+  if (maps_dirty_ || map_size_ != input.size()) {
+    buildMaps(input.size());
+  }
+
+  if (map1_.empty()) {
+    output = input.clone();
+    return;
+  }
+
+  remapBands(input, output);
+}
+
+WarpFilter::WarpMode WarpFilter::effectiveMode(const cv::Size &size) const {
+  if (mode_ != WarpMode::ROTATE || scale_ != 1.0) {
+    return mode_;
+  }
+
+  const double turns = angle_ / 90.0;
+  if (std::abs(turns - std::round(turns)) > 1e-9) {
+    return mode_;
+  }
+
+  // ROTATE keeps the frame size for every angle: quarter turns only take
+  // the transpose kernel when that does not swap width and height
+  const bool square = size.width == size.height;
+
+  // Positive angles are counter clockwise
+  switch (((static_cast<long>(std::round(turns)) % 4) + 4) % 4) {
+  case 1:
+    return square ? WarpMode::ROTATE_270 : mode_;
+  case 2:
+    return WarpMode::ROTATE_180;
+  case 3:
+    return square ? WarpMode::ROTATE_90 : mode_;
+  default:
+    return WarpMode::NONE;
+  }
+}
+
+bool WarpFilter::applyFastPath(WarpMode mode, const cv::Mat &input,
+                               cv::Mat &output) const {
+  switch (mode) {
+  case WarpMode::ROTATE_90:
+    cv::rotate(input, output, cv::ROTATE_90_CLOCKWISE);
+    return true;
+  case WarpMode::ROTATE_180:
+    cv::rotate(input, output, cv::ROTATE_180);
+    return true;
+  case WarpMode::ROTATE_270:
+    cv::rotate(input, output, cv::ROTATE_90_COUNTERCLOCKWISE);
+    return true;
+  case WarpMode::FLIP_HORIZONTAL:
+    cv::flip(input, output, 1);
+    return true;
+  case WarpMode::FLIP_VERTICAL:
+    cv::flip(input, output, 0);
+    return true;
+  default:
+    return false;
+  }
+}
+
+void WarpFilter::buildMaps(const cv::Size &size) {
+  map1_.release();
+  map2_.release();
+  map_size_ = size;
+  maps_dirty_ = false;
+
+  std::array<double, 9> inv{};
+  if (mode_ == WarpMode::PERSPECTIVE && !invert3x3(homography_, inv)) {
+    LOG_ERROR("Warp homography is singular");
+    return;
+  }
+
+  const double cx = cx_ > 0.0 ? cx_ : (size.width - 1) * 0.5;
+  const double cy = cy_ > 0.0 ? cy_ : (size.height - 1) * 0.5;
+  const double fx = fx_ > 0.0 ? fx_ : static_cast<double>(size.width);
+  const double fy = fy_ > 0.0 ? fy_ : fx;
+
+  const double rad = angle_ * CV_PI / 180.0;
+  const double cos_a = std::cos(rad) / scale_;
+  const double sin_a = std::sin(rad) / scale_;
+
+  const WarpMode mode = mode_;
+  const auto k = k_;
+  const auto p = p_;
+
+  cv::Mat mapx(size, CV_32FC1);
+  cv::Mat mapy(size, CV_32FC1);
+
+  // Each destination pixel is mapped back to its source coordinates
+  cv::parallel_for_(cv::Range(0, size.height), [&](const cv::Range &r) {
+    for (int v = r.start; v < r.end; ++v) {
+      float *mx = mapx.ptr<float>(v);
+      float *my = mapy.ptr<float>(v);
+
+      for (int u = 0; u < size.width; ++u) {
+        double sx = u;
+        double sy = v;
+
+        if (mode == WarpMode::ROTATE) {
+          // Inverse of a counter clockwise rotation around the center
+          const double dx = u - cx;
+          const double dy = v - cy;
+          sx = cos_a * dx - sin_a * dy + cx;
+          sy = sin_a * dx + cos_a * dy + cy;
+
+        } else if (mode == WarpMode::PERSPECTIVE) {
+          const double w = inv[6] * u + inv[7] * v + inv[8];
+          const double iw = std::abs(w) > 1e-12 ? 1.0 / w : 0.0;
+          sx = (inv[0] * u + inv[1] * v + inv[2]) * iw;
+          sy = (inv[3] * u + inv[4] * v + inv[5]) * iw;
+
+        } else if (mode == WarpMode::UNDISTORT) {
+          const double x = (u - cx) / fx;
+          const double y = (v - cy) / fy;
+          const double r2 = x * x + y * y;
+          const double radial =
+              1.0 + r2 * (k[0] + r2 * (k[1] + r2 * k[2]));
+          const double xd =
+              x * radial + 2.0 * p[0] * x * y + p[1] * (r2 + 2.0 * x * x);
+          const double yd =
+              y * radial + p[0] * (r2 + 2.0 * y * y) + 2.0 * p[1] * x * y;
+          sx = fx * xd + cx;
+          sy = fy * yd + cy;
+
+        } else if (mode == WarpMode::FISHEYE) {
+          const double x = (u - cx) / fx;
+          const double y = (v - cy) / fy;
+          const double r = std::sqrt(x * x + y * y);
+          const double theta = std::atan(r);
+          const double t2 = theta * theta;
+          const double theta_d =
+              theta *
+              (1.0 + t2 * (k[0] + t2 * (k[1] + t2 * (k[2] + t2 * k[3]))));
+          const double s = r > 1e-12 ? theta_d / r : 1.0;
+          sx = fx * x * s + cx;
+          sy = fy * y * s + cy;
+        }
+
+        mx[u] = static_cast<float>(sx);
+        my[u] = static_cast<float>(sy);
+      }
+    }
+  });
+
+  // Fixed-point maps: integer coordinates + index into the interpolation
+  // table, about twice as fast to remap as float maps
+  cv::convertMaps(mapx, mapy, map1_, map2_, CV_16SC2,
+                  interpolation_ == cv::INTER_NEAREST);
+
+  ++map_builds_;
+  LOG_DEBUG("Warp maps built for " + std::to_string(size.width) + "x" +
+            std::to_string(size.height));
+}
+
+void WarpFilter::remapBands(const cv::Mat &input, cv::Mat &output) const {
+  output.create(input.size(), input.type());
+
+  // Bands sized so that destination rows and their map rows fit in L2
+  const size_t row_bytes =
+      static_cast<size_t>(input.cols) * (input.elemSize() + 4 + 2);
+  const int band_rows =
+      std::clamp(static_cast<int>(kBandBytes / std::max<size_t>(row_bytes, 1)),
+                 8, 128);
+  const int bands = (input.rows + band_rows - 1) / band_rows;
+
+  cv::parallel_for_(cv::Range(0, bands), [&](const cv::Range &r) {
+    for (int b = r.start; b < r.end; ++b) {
+      const int y0 = b * band_rows;
+      const int y1 = std::min(y0 + band_rows, input.rows);
+
+      // dst band is a view: remap writes straight into output
+      cv::Mat dst_band = output.rowRange(y0, y1);
+      cv::Mat map2_band =
+          map2_.empty() ? cv::Mat() : map2_.rowRange(y0, y1);
+
+      cv::remap(input, dst_band, map1_.rowRange(y0, y1), map2_band,
+                interpolation_, cv::BORDER_CONSTANT, cv::Scalar::all(0));
+    }
+  });
+}
+
+void WarpFilter::setParameter(const std::string &name,
+                              const nlohmann::json &value) {
+  if (name == "mode") {
+    std::string mode_str = value.get<std::string>();
+
+    if (mode_str == "none") {
+      mode_ = WarpMode::NONE;
+    } else if (mode_str == "rotate_90") {
+      mode_ = WarpMode::ROTATE_90;
+    } else if (mode_str == "rotate_180") {
+      mode_ = WarpMode::ROTATE_180;
+    } else if (mode_str == "rotate_270") {
+      mode_ = WarpMode::ROTATE_270;
+    } else if (mode_str == "flip_horizontal") {
+      mode_ = WarpMode::FLIP_HORIZONTAL;
+    } else if (mode_str == "flip_vertical") {
+      mode_ = WarpMode::FLIP_VERTICAL;
+    } else if (mode_str == "rotate") {
+      mode_ = WarpMode::ROTATE;
+    } else if (mode_str == "perspective") {
+      mode_ = WarpMode::PERSPECTIVE;
+    } else if (mode_str == "undistort") {
+      mode_ = WarpMode::UNDISTORT;
+    } else if (mode_str == "fisheye") {
+      mode_ = WarpMode::FISHEYE;
+    } else {
+      LOG_WARNING("Unknown warp mode : " + mode_str);
+      return;
+    }
+
+  } else if (name == "angle") {
+    angle_ = value.get<double>();
+
+  } else if (name == "scale") {
+    double s = value.get<double>();
+    if (s <= 0.0) {
+      LOG_WARNING("Invalid scale value");
+      return;
+    }
+    scale_ = s;
+
+  } else if (name == "matrix") {
+    if (!value.is_array() || value.size() != 9) {
+      LOG_WARNING("Warp matrix must be an array of 9 values");
+      return;
+    }
+    for (size_t i = 0; i < 9; ++i) {
+      homography_[i] = value[i].get<double>();
+    }
+
+  } else if (name == "fx" || name == "fy" || name == "cx" || name == "cy") {
+    double v = value.get<double>();
+    if (v < 0.0) {
+      LOG_WARNING("Invalid " + name + " value, must be >= 0");
+      return;
+    }
+    (name == "fx"   ? fx_
+     : name == "fy" ? fy_
+     : name == "cx" ? cx_
+                    : cy_) = v;
+
+  } else if (name == "k1" || name == "k2" || name == "k3" || name == "k4") {
+    k_[name[1] - '1'] = value.get<double>();
+
+  } else if (name == "p1" || name == "p2") {
+    p_[name[1] - '1'] = value.get<double>();
+
+  } else if (name == "interpolation") {
+    std::string interp = value.get<std::string>();
+    if (interp == "nearest") {
+      interpolation_ = cv::INTER_NEAREST;
+    } else if (interp == "linear") {
+      interpolation_ = cv::INTER_LINEAR;
+    } else if (interp == "cubic") {
+      interpolation_ = cv::INTER_CUBIC;
+    } else {
+      LOG_WARNING("Unknown interpolation : " + interp);
+      return;
+    }
+
+  } else {
+    LOG_WARNING("Unknown parameter : " + name);
+    return;
+  }
+
+  maps_dirty_ = true;
+}
+
+nlohmann::json WarpFilter::getParameters() const {
+  nlohmann::json params;
+  params["mode"] = modeToString(mode_);
+  params["angle"] = angle_;
+  params["scale"] = scale_;
+  params["matrix"] = homography_;
+  params["fx"] = fx_;
+  params["fy"] = fy_;
+  params["cx"] = cx_;
+  params["cy"] = cy_;
+  params["k1"] = k_[0];
+  params["k2"] = k_[1];
+  params["k3"] = k_[2];
+  params["k4"] = k_[3];
+  params["p1"] = p_[0];
+  params["p2"] = p_[1];
+  params["interpolation"] = interpolation_ == cv::INTER_NEAREST ? "nearest"
+                            : interpolation_ == cv::INTER_CUBIC ? "cubic"
+                                                                : "linear";
+  params["enabled"] = enabled_;
+  return params;
+}
+
+std::string WarpFilter::getName() const { return "warp"; }
+
+std::string WarpFilter::modeToString(WarpMode mode) {
+  switch (mode) {
+  case WarpMode::NONE:
+    return "none";
+  case WarpMode::ROTATE_90:
+    return "rotate_90";
+  case WarpMode::ROTATE_180:
+    return "rotate_180";
+  case WarpMode::ROTATE_270:
+    return "rotate_270";
+  case WarpMode::FLIP_HORIZONTAL:
+    return "flip_horizontal";
+  case WarpMode::FLIP_VERTICAL:
+    return "flip_vertical";
+  case WarpMode::ROTATE:
+    return "rotate";
+  case WarpMode::PERSPECTIVE:
+    return "perspective";
+  case WarpMode::UNDISTORT:
+    return "undistort";
+  case WarpMode::FISHEYE:
+    return "fisheye";
+  default:
+    return "unknown";
+  }
+}
+
+} // namespace visioncore::filters
@@ -0,0 +1,117 @@
+/**
+ * @file WarpFilter.hpp
+ * @brief IFilter implementation for geometric warps
+ *
+ * Rotates, flips, applies a perspective transform or corrects lens
+ * distortion (Brown-Conrady or fisheye/equidistant model).
+ *
+ * Remap based modes build fixed-point maps (CV_16SC2 + interpolation table)
+ * once per parameter or frame size change and reuse them for every frame.
+ * Right-angle rotations and flips bypass remap entirely. ROTATE always
+ * keeps the input size, so it only uses the quarter-turn kernels on square
+ * frames.
+ */
+
+#ifndef WARP_FILTER_HPP
+#define WARP_FILTER_HPP
+
+#include "IFilter.hpp"
+#include <array>
+#include <cstdint>
+
+namespace visioncore::filters {
+
+class WarpFilter : public IFilter {
+public:
+  enum class WarpMode {
+    NONE,            ///< No changes
+    ROTATE_90,       ///< 90° clockwise (transpose kernel)
+    ROTATE_180,      ///< 180° (flip kernel)
+    ROTATE_270,      ///< 90° counter clockwise (transpose kernel)
+    FLIP_HORIZONTAL, ///< Mirror around the vertical axis
+    FLIP_VERTICAL,   ///< Mirror around the horizontal axis
+    ROTATE,          ///< Arbitrary rotation and scale around the center
+    PERSPECTIVE,     ///< 3x3 homography (source -> destination)
+    UNDISTORT,       ///< Radial/tangential lens distortion correction
+    FISHEYE          ///< Equidistant fisheye correction
+  };
+
+  /**
+   * @brief Construct the filter
+   *
+   * @param mode Warp to apply
+   */
+  explicit WarpFilter(WarpMode mode = WarpMode::NONE);
+
+  /**
+   * @brief Destructor
+   */
+  ~WarpFilter() override;
+
+  // WarpFilter implementation
+  void apply(const cv::Mat &input, cv::Mat &output) override;
+  void setParameter(const std::string &name,
+                    const nlohmann::json &value) override;
+  nlohmann::json getParameters() const override;
+  std::string getName() const override;
+
+  /**
+   * @brief Number of times the remap tables were (re)built
+   */
+  uint64_t getMapBuildCount() const { return map_builds_; }
+
+private:
+  WarpMode mode_;
+  double angle_ = 0.0; ///< Rotation in degrees, counter clockwise
+  double scale_ = 1.0; ///< Zoom factor for ROTATE mode
+  std::array<double, 9> homography_{1, 0, 0, 0, 1, 0, 0, 0, 1};
+
+  // Camera intrinsics; 0 means derived from the frame size
+  double fx_ = 0.0;
+  double fy_ = 0.0;
+  double cx_ = 0.0;
+  double cy_ = 0.0;
+  std::array<double, 4> k_{}; ///< Radial coefficients k1..k4
+  std::array<double, 2> p_{}; ///< Tangential coefficients p1, p2
+
+  int interpolation_ = cv::INTER_LINEAR;
+
+  cv::Mat map1_;         ///< CV_16SC2 integer source coordinates
+  cv::Mat map2_;         ///< CV_16UC1 interpolation table indices
+  cv::Size map_size_;    ///< Frame size the maps were built for
+  bool maps_dirty_ = true;
+  uint64_t map_builds_ = 0;
+
+  /**
+   * @brief Apply right angle rotations and flips
+   * @return false if the current mode is not a fast path
+   */
+  bool applyFastPath(WarpMode mode, const cv::Mat &input,
+                     cv::Mat &output) const;
+
+  /**
+   * @brief Resolve ROTATE with a multiple of 90° to a fast path mode when
+   * it gives the same output size as remap
+   */
+  WarpMode effectiveMode(const cv::Size &size) const;
+
+  /**
+   * @brief Compute the float maps for the current mode and convert them
+   * to the fixed-point representation used by remap
+   */
+  void buildMaps(const cv::Size &size);
+
+  /**
+   * @brief Remap the frame in row bands sized to stay in cache
+   */
+  void remapBands(const cv::Mat &input, cv::Mat &output) const;
+
+  /**
+   * @brief Return name of the warp mode given
+   */
+  static std::string modeToString(WarpMode mode);
+};
+
+} // namespace visioncore::filters
+
+#endif // WARP_FILTER_HPP
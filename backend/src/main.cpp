@@ -14,10 +14,16 @@
 #include <cstdlib>
 #include <memory>
 #include <mutex>
+#include <nlohmann/json.hpp>
 #include <string>
 
 // Core
+#include "core/ImageSequence.hpp"
 #include "core/ImageSource.hpp"
+#include "core/NetworkSource.hpp"
+#include "core/PrefetchingSource.hpp"
+#include "core/RawFileSource.hpp"
+#include "core/SyntheticSource.hpp"
 #include "core/VideoFileSource.hpp"
 #include "core/VideoSource.hpp"
 #include "core/WebcamSource.hpp"
@@ -25,9 +31,11 @@
 // Filters
 #include "filters/GrayscaleFilter.hpp"
 #include "filters/LUTFilter.hpp"
+#include "filters/OverlayFilter.hpp"
 #include "filters/ResizeFilter.hpp"
 
 // Network
+#include "network/BinaryFrameEncoder.hpp"
 #include "network/WSFrameServer.hpp"
 
 // Pipeline
@@ -35,8 +43,16 @@
 #include "pipeline/PipelineError.hpp"
 
 // Processing
+#include "processing/BatchTranscoder.hpp"
 #include "processing/FrameController.hpp"
-#include "processing/FrameEncoder.hpp"
+#include "processing/RateController.hpp"
+#include "processing/SimulcastEncoder.hpp"
+#include "processing/TileDeltaEncoder.hpp"
+
+// Sinks
+#include "sinks/RawFileSink.hpp"
+#include "sinks/RecordingSink.hpp"
+#include "sinks/SharedMemorySink.hpp"
 
 // Utils
 #include "utils/Logger.hpp"
@@ -78,6 +94,25 @@ inline void unwrap_or_exit(pipeline::PipelineResult<void> &&res,
   }
 }
 
+/* ============================================================
+ * Simulcast helpers
+ * ============================================================ */
+
+/**
+ * @brief Text message telling a client the renditions it can pick and the
+ *        one it receives
+ */
+std::string renditionMessage(const processing::SimulcastEncoder &simulcast,
+                             const std::string &subscribed) {
+  nlohmann::json message;
+  message["renditions"] = nlohmann::json::array();
+  for (const auto &rendition : simulcast.getRenditions()) {
+    message["renditions"].push_back(rendition.name);
+  }
+  message["subscribed"] = subscribed;
+  return message.dump();
+}
+
 /* ============================================================
  * Usage
  * ============================================================ */
@@ -87,12 +122,50 @@ void printUsage(const std::string &programName) {
             << "  " << programName
             << " --image <path> [--no-display] [--ws-port PORT]\n"
             << "  " << programName
+            << " --sequence <dir|glob|pattern> [--fps N] [--no-display]\n"
+            << "  " << programName
             << " --video <path> [--no-display] [--ws-port PORT]\n"
             << "  " << programName
+            << " --raw <file.y4m|file.vcraw> [--no-display] [--ws-port PORT]\n"
+            << "  " << programName
+            << " --synthetic <bars|gradient|checker|noise> [--size WxH]"
+               " [--fps N]\n"
+            << "  " << programName
+            << " --network <decode_threads> [--ws-port PORT]"
+               "  (JPEG frames uploaded over WebSocket)\n"
+            << "  " << programName
             << " --webcam <device_id> [--no-display] [--ws-port PORT]\n"
+            << "  " << programName
+            << " --transcode <path> --output <file.avi> [--segments N]\n"
             << "\nOptions:\n"
             << "  --no-display    Disable local OpenCV display window\n"
-            << "  --ws-port PORT  WebSocket server port (default: 9001)\n";
+            << "  --ws-port PORT  WebSocket server port (default: 9001)\n"
+            << "  --record FILE   Record processed frames (.avi, .y4m or .vcraw)\n"
+            << "  --segment-mb N  Start a new recording file every N MB\n"
+            << "  --segment-sec N Start a new recording file every N seconds\n"
+            << "  --shm NAME      Publish processed frames to shared memory\n"
+               "                  (e.g. /visioncore)\n"
+            << "  --bitrate KBPS  Streaming bitrate target (default: 8000)\n"
+            << "  --encode-budget MS  Per-frame encode time limit\n"
+            << "  --delta         Stream changed tiles only (VCTD packets)\n"
+            << "  --payload TYPE  Stream payload: jpeg (default), raw, zlib,\n"
+               "                  lossless\n"
+            << "  --predictor P   Lossless predictor: none, left, up (default),\n"
+               "                  paeth, delta (previous frame)\n"
+            << "  --simulcast R   JPEG renditions as height:quality, e.g.\n"
+               "                  1080:85,540:75,270:60; clients pick one\n"
+            << "\nWebcam options:\n"
+            << "  --fourcc CODE   Pixel format (MJPG, YUYV)\n"
+            << "  --size WxH      Capture resolution (e.g. 1280x720)\n"
+            << "  --fps N         Capture frame rate (also --sequence rate)\n"
+            << "  --buffers N     Driver buffer depth (default: 1)\n"
+            << "\nSynthetic options (also --size, --fps):\n"
+            << "  --pixel FORMAT  bgr (default), gray or bgra\n"
+            << "\nVideo options:\n"
+            << "  --decode-threads N  Decoder threads (default: backend)\n"
+            << "\nTranscode options (offline, parallel over segments):\n"
+            << "  --output FILE   MJPEG AVI file to write\n"
+            << "  --segments N    Parallel segments (default: one per core)\n";
 }
 
 /* ============================================================
@@ -116,6 +189,18 @@ int main(int argc, char *argv[]) {
   const std::string sourceParam = argv[2];
   bool showDisplay = true;
   int wsPort = 9001;
+  core::WebcamConfig webcamConfig;
+  core::VideoFileOptions videoOptions;
+  std::string outputPath;
+  processing::BatchOptions batchOptions;
+  std::string recordPath;
+  sinks::RecordingOptions recordOptions;
+  int syntheticType = CV_8UC3;
+  processing::RateControlOptions rateOptions;
+  network::PayloadType streamPayload = network::PayloadType::JPEG;
+  processing::LosslessOptions losslessOptions;
+  std::string simulcastSpec;
+  std::string shmName;
 
   // Parse optional flags
   for (int i = 3; i < argc; i++) {
@@ -124,7 +209,91 @@ int main(int argc, char *argv[]) {
       showDisplay = false;
     } else if (arg == "--ws-port" && i + 1 < argc) {
       wsPort = std::stoi(argv[++i]);
+    } else if (arg == "--fourcc" && i + 1 < argc) {
+      webcamConfig.fourcc = argv[++i];
+    } else if (arg == "--size" && i + 1 < argc) {
+      const std::string size = argv[++i];
+      const auto x = size.find('x');
+      if (x != std::string::npos) {
+        webcamConfig.width = std::stoi(size.substr(0, x));
+        webcamConfig.height = std::stoi(size.substr(x + 1));
+      }
+    } else if (arg == "--fps" && i + 1 < argc) {
+      webcamConfig.fps = std::stod(argv[++i]);
+    } else if (arg == "--buffers" && i + 1 < argc) {
+      webcamConfig.buffer_size = std::stoi(argv[++i]);
+    } else if (arg == "--decode-threads" && i + 1 < argc) {
+      videoOptions.decode_threads = std::stoi(argv[++i]);
+    } else if (arg == "--output" && i + 1 < argc) {
+      outputPath = argv[++i];
+    } else if (arg == "--segments" && i + 1 < argc) {
+      batchOptions.segments = std::stoul(argv[++i]);
+    } else if (arg == "--record" && i + 1 < argc) {
+      recordPath = argv[++i];
+    } else if (arg == "--segment-mb" && i + 1 < argc) {
+      recordOptions.segment_bytes = std::stoull(argv[++i]) * 1024 * 1024;
+    } else if (arg == "--segment-sec" && i + 1 < argc) {
+      recordOptions.segment_seconds = std::stod(argv[++i]);
+    } else if (arg == "--shm" && i + 1 < argc) {
+      shmName = argv[++i];
+    } else if (arg == "--bitrate" && i + 1 < argc) {
+      rateOptions.target_kbps = std::stod(argv[++i]);
+    } else if (arg == "--encode-budget" && i + 1 < argc) {
+      rateOptions.encode_budget_ms = std::stod(argv[++i]);
+    } else if (arg == "--delta") {
+      streamPayload = network::PayloadType::TILE_DELTA;
+    } else if (arg == "--payload" && i + 1 < argc) {
+      const std::string payload = argv[++i];
+      streamPayload = payload == "raw"        ? network::PayloadType::RAW
+                      : payload == "zlib"     ? network::PayloadType::RAW_ZLIB
+                      : payload == "lossless" ? network::PayloadType::LOSSLESS
+                                              : network::PayloadType::JPEG;
+    } else if (arg == "--simulcast" && i + 1 < argc) {
+      simulcastSpec = argv[++i];
+    } else if (arg == "--predictor" && i + 1 < argc) {
+      using processing::LosslessPredictor;
+      const std::string predictor = argv[++i];
+      losslessOptions.predictor =
+          predictor == "none"    ? LosslessPredictor::NONE
+          : predictor == "left"  ? LosslessPredictor::LEFT
+          : predictor == "paeth" ? LosslessPredictor::PAETH
+          : predictor == "delta" ? LosslessPredictor::FRAME_DELTA
+                                 : LosslessPredictor::UP;
+    } else if (arg == "--pixel" && i + 1 < argc) {
+      const std::string pixel = argv[++i];
+      syntheticType = pixel == "gray"   ? CV_8UC1
+                      : pixel == "bgra" ? CV_8UC4
+                                        : CV_8UC3;
+    }
+  }
+
+  /* ------------------------------------------------------------
+   * Offline batch mode
+   * ------------------------------------------------------------ */
+
+  if (sourceType == "--transcode") {
+    if (outputPath.empty()) {
+      printUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+
+    processing::BatchTranscoder transcoder(
+        sourceParam, outputPath,
+        [](pipeline::FramePipeline &pipeline) {
+          pipeline.addFilter(std::make_shared<filters::GrayscaleFilter>());
+        },
+        batchOptions);
+
+    try {
+      const processing::BatchReport report = transcoder.run();
+      std::cout << report.frames << " frames, " << report.segments.size()
+                << " segments, " << report.fps << " frames/s, "
+                << report.core_utilization * 100.0 << "% core utilization\n";
+    } catch (const std::exception &e) {
+      LOG_CRITICAL(std::string("Transcode failed: ") + e.what());
+      return EXIT_FAILURE;
     }
+    return EXIT_SUCCESS;
   }
 
   LOG_INFO("=== VisionCore WebSocket Streaming ===");
@@ -134,13 +303,60 @@ int main(int argc, char *argv[]) {
    * ------------------------------------------------------------ */
 
   std::unique_ptr<core::VideoSource> source;
+  core::NetworkSource *networkSource = nullptr; // fed by the WebSocket server
 
   if (sourceType == "--image") {
     source = std::make_unique<core::ImageSource>(sourceParam);
+  } else if (sourceType == "--sequence") {
+    // Decoded ahead on a worker pool, looped from the frame cache
+    core::ImageSequenceOptions sequenceOptions;
+    sequenceOptions.fps = webcamConfig.fps > 0.0 ? webcamConfig.fps : 30.0;
+    sequenceOptions.loop = true;
+    source = std::make_unique<core::ImageSequenceSource>(sourceParam,
+                                                         sequenceOptions);
   } else if (sourceType == "--webcam") {
-    source = std::make_unique<core::WebcamSource>(std::stoi(sourceParam));
+    // Capture on its own thread, always hand out the freshest frame
+    source = std::make_unique<core::PrefetchingSource>(
+        std::make_unique<core::WebcamSource>(std::stoi(sourceParam),
+                                             webcamConfig),
+        core::PrefetchingSource::Mode::LATEST_ONLY, 1);
   } else if (sourceType == "--video") {
-    source = std::make_unique<core::VideoFileSource>(sourceParam, true);
+    // Decode ahead on its own thread without skipping frames
+    source = std::make_unique<core::PrefetchingSource>(
+        std::make_unique<core::VideoFileSource>(sourceParam, true,
+                                                videoOptions),
+        core::PrefetchingSource::Mode::NEVER_DROP, 3);
+  } else if (sourceType == "--raw") {
+    // Frames are views of the memory-mapped file, nothing to decode
+    core::RawFileOptions rawOptions;
+    rawOptions.loop = true;
+    source = std::make_unique<core::RawFileSource>(sourceParam, rawOptions);
+  } else if (sourceType == "--synthetic") {
+    // Generated test pattern: no codec or device in the measurements
+    const auto pattern = core::SyntheticSource::parsePattern(sourceParam);
+    if (!pattern) {
+      LOG_CRITICAL("Unknown synthetic pattern: " + sourceParam);
+      printUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+    core::SyntheticOptions syntheticOptions;
+    syntheticOptions.pattern = *pattern;
+    syntheticOptions.type = syntheticType;
+    if (webcamConfig.width > 0 && webcamConfig.height > 0) {
+      syntheticOptions.width = webcamConfig.width;
+      syntheticOptions.height = webcamConfig.height;
+    }
+    if (webcamConfig.fps > 0.0) {
+      syntheticOptions.fps = webcamConfig.fps;
+    }
+    source = std::make_unique<core::SyntheticSource>(syntheticOptions);
+  } else if (sourceType == "--network") {
+    // Clients push encoded frames, decoded on a pool, latest frame wins
+    core::NetworkSourceOptions networkOptions;
+    networkOptions.decode_threads = std::stoul(sourceParam);
+    auto network = std::make_unique<core::NetworkSource>(networkOptions);
+    networkSource = network.get();
+    source = std::move(network);
   } else {
     LOG_CRITICAL("Unknown source type");
     printUsage(argv[0]);
@@ -181,6 +397,86 @@ int main(int argc, char *argv[]) {
 
   network::WSFrameServer wsServer;
 
+  // Renditions encoded from one downscale pyramid, one channel each
+  std::unique_ptr<processing::SimulcastEncoder> simulcast;
+  if (!simulcastSpec.empty()) {
+    auto renditions = processing::SimulcastEncoder::parse(simulcastSpec);
+    if (!renditions) {
+      LOG_CRITICAL("Invalid simulcast renditions: " + simulcastSpec);
+      return EXIT_FAILURE;
+    }
+    simulcast =
+        std::make_unique<processing::SimulcastEncoder>(std::move(*renditions));
+  }
+
+  // Changed tiles only; clients start from a keyframe
+  const bool deltaStreaming =
+      streamPayload == network::PayloadType::TILE_DELTA;
+  processing::TileDeltaEncoder deltaEncoder;
+
+  // Header (frame id, timestamps, format) and payload in one pooled buffer.
+  // A recording can hold a queue of streamed JPEGs until they are written.
+  const size_t messagesPerFrame =
+      simulcast ? simulcast->getRenditions().size() : 1;
+  const size_t recordedMessages =
+      recordPath.empty() ? 0 : recordOptions.queue_depth;
+  network::BinaryFrameEncoder frameEncoder(
+      4 * messagesPerFrame + recordedMessages, 1, losslessOptions);
+
+  // JPEG payloads encoded once per frame and variant, shared by every
+  // consumer
+  const auto encodeCache = controller.getEncodedFrameCache();
+
+  if (simulcast) {
+    // New clients get the largest rendition until they pick another
+    wsServer.setConnectCallback([&](uint64_t clientId) {
+      const std::string &name =
+          simulcast->getRenditions()[simulcast->largest()].name;
+      wsServer.setClientChannel(clientId, name);
+      wsServer.sendText(clientId, renditionMessage(*simulcast, name));
+    });
+  } else if (deltaStreaming ||
+             streamPayload == network::PayloadType::LOSSLESS) {
+    wsServer.setConnectCallback([&](uint64_t) {
+      deltaEncoder.requestKeyframe();
+      frameEncoder.requestKeyframe();
+    });
+  }
+
+  if (networkSource || simulcast) {
+    // Binary messages are uploaded frames, one uploader per client; text
+    // messages pick a rendition: {"subscribe": "540p"}
+    wsServer.setMessageCallback([&, networkSource](uint64_t clientId,
+                                                   std::string_view data,
+                                                   bool binary) {
+      if (binary) {
+        if (networkSource) {
+          networkSource->submit(clientId, data);
+        }
+        return;
+      }
+      if (!simulcast) {
+        return;
+      }
+      const auto request =
+          nlohmann::json::parse(data.begin(), data.end(), nullptr, false);
+      if (request.is_object() && request.contains("subscribe") &&
+          request["subscribe"].is_string()) {
+        const std::string name = request["subscribe"];
+        if (simulcast->find(name) >= 0) {
+          wsServer.setClientChannel(clientId, name);
+          wsServer.sendText(clientId, renditionMessage(*simulcast, name));
+        }
+      }
+    });
+  }
+
+  if (networkSource) {
+    wsServer.setDisconnectCallback([networkSource](uint64_t clientId) {
+      networkSource->removeUploader(clientId);
+    });
+  }
+
   if (!wsServer.start(wsPort)) {
     LOG_ERROR("Failed to start WebSocket server on port " +
               std::to_string(wsPort));
@@ -194,7 +490,64 @@ int main(int argc, char *argv[]) {
    * Frame encoder setup
    * ------------------------------------------------------------ */
 
-  processing::FrameEncoder encoder(100); // JPEG quality 85
+  // Exact pixels, no quality or resolution to adapt
+  const bool rawStream = streamPayload == network::PayloadType::RAW ||
+                         streamPayload == network::PayloadType::RAW_ZLIB ||
+                         streamPayload == network::PayloadType::LOSSLESS;
+  processing::LosslessStats losslessStats;
+
+  // Quality and resolution picked per frame to meet the bitrate target
+  rateOptions.jpeg.strips = 0; // large frames encoded on every core
+  processing::RateController rateController(rateOptions);
+
+  /* ------------------------------------------------------------
+   * Optional recording
+   * ------------------------------------------------------------ */
+
+  std::unique_ptr<sinks::FrameSink> recorder;
+  sinks::RecordingSink *archive = nullptr; // recorder, when it has stats
+
+  if (!recordPath.empty()) {
+    const double recordFps =
+        sourceType == "--raw" || sourceType == "--video" ||
+                sourceType == "--synthetic"
+            ? source->getFPS()
+            : 30.0;
+    // AVI and segmented recordings drop frames rather than stall the
+    // pipeline; single raw files keep every frame
+    if (sinks::RecordingSink::handles(recordPath, recordOptions)) {
+      auto sink = std::make_unique<sinks::RecordingSink>(recordPath, recordFps,
+                                                         recordOptions);
+      archive = sink.get();
+      recorder = std::move(sink);
+    } else {
+      recorder = std::make_unique<sinks::RawFileSink>(recordPath, recordFps);
+    }
+    if (!recorder->open()) {
+      LOG_CRITICAL("Failed to open recording " + recordPath);
+      return EXIT_FAILURE;
+    }
+  }
+
+  /* ------------------------------------------------------------
+   * Optional shared-memory output
+   * ------------------------------------------------------------ */
+
+  // Published by the worker thread before the callbacks run, so local
+  // consumers never wait on display or streaming
+  std::shared_ptr<sinks::SharedMemorySink> shmSink;
+  if (!shmName.empty()) {
+    // Sized for the source's frames, up to BGRA; larger processed frames
+    // are dropped and counted
+    shmSink = std::make_shared<sinks::SharedMemorySink>(
+        shmName, sinks::SharedMemoryOptions::forFrameSize(
+                     cv::Size(source->getWidth(), source->getHeight())));
+    if (!shmSink->open()) {
+      LOG_CRITICAL("Failed to open shared memory " + shmName);
+      return EXIT_FAILURE;
+    }
+    controller.setSharedMemorySink(shmSink);
+  }
 
   /* ------------------------------------------------------------
    * Frame callback with WebSocket streaming
@@ -215,21 +568,119 @@ int main(int argc, char *argv[]) {
       frame_available.store(true, std::memory_order_release);
     }
 
-    // Stream via WebSocket if clients connected
-    if (wsServer.getClientCount() > 0) {
-      std::vector<uint8_t> jpegBuffer;
+    // Copied here, written to disk by the sink's own thread. An AVI
+    // archive takes a streamed full-size JPEG as is instead of encoding the
+    // frame a second time.
+    const auto record =
+        [&](const network::BinaryFrameEncoder::Buffer &message) {
+          if (!recorder) {
+            return;
+          }
+          network::FrameHeader header;
+          if (archive && archive->acceptsEncoded() && message &&
+              network::BinaryFrameEncoder::parseHeader(
+                  message->data(), message->size(), header) &&
+              header.payload == network::PayloadType::JPEG &&
+              header.width == processed.cols &&
+              header.height == processed.rows) {
+            archive->writeEncoded(message, header.header_bytes,
+                                  processed.size());
+            return;
+          }
+          recorder->write(processed);
+        };
+
+    // Simulcast: each rendition to its own subscribers, none if unwatched
+    if (simulcast) {
+      if (wsServer.getClientCount() == 0) {
+        record(nullptr);
+        return;
+      }
+      const auto &renditions = simulcast->getRenditions();
+      std::vector<bool> wanted(renditions.size());
+      for (size_t i = 0; i < renditions.size(); ++i) {
+        wanted[i] = wsServer.getChannelClientCount(renditions[i].name) > 0;
+      }
+      const processing::FrameTiming &timing = controller.getFrameTiming();
+      const auto messages = frameEncoder.encodeSimulcast(
+          processed,
+          {frame_id, timing.capture_time, timing.processed_time}, *simulcast,
+          wanted);
+      for (size_t i = 0; i < messages.size(); ++i) {
+        if (messages[i]) {
+          wsServer.sendFrame(*messages[i], renditions[i].name);
+        }
+      }
+      record(messages.empty() ? nullptr : messages.front());
+      return;
+    }
 
-      if (encoder.encodeJPEG(processed, jpegBuffer)) {
-        wsServer.sendFrame(jpegBuffer);
+    // Stream via WebSocket if clients connected and keeping up
+    network::BinaryFrameEncoder::Buffer message;
+    if (wsServer.getClientCount() > 0 &&
+        rateController.admit(wsServer.getSendBacklog())) {
+      const processing::EncodeSpec spec = rateController.next(processed.size());
+      const processing::FrameTiming &timing = controller.getFrameTiming();
+      const network::FrameMetadata meta{frame_id, timing.capture_time,
+                                        timing.processed_time};
+      const auto encodeStart = std::chrono::steady_clock::now();
+
+      switch (streamPayload) {
+      case network::PayloadType::TILE_DELTA:
+        // Stateful, one stream for every client; nothing if unchanged
+        message = frameEncoder.encodeTileDelta(processed, meta, deltaEncoder,
+                                               spec);
+        break;
+      case network::PayloadType::RAW:
+      case network::PayloadType::RAW_ZLIB:
+        message = frameEncoder.encodeRaw(
+            processed, meta, streamPayload == network::PayloadType::RAW_ZLIB);
+        break;
+      case network::PayloadType::LOSSLESS: {
+        processing::LosslessStats stats;
+        message = frameEncoder.encodeLossless(processed, meta, &stats);
+        std::lock_guard<std::mutex> lock(frame_mutex);
+        losslessStats = stats;
+        break;
+      }
+      case network::PayloadType::JPEG:
+        // Shared with the encoded frame callback: encoded once per spec
+        message = frameEncoder.encodeJpeg(processed, meta, spec, *encodeCache);
+        break;
+      }
+      const double encodeMs =
+          std::chrono::duration<double, std::milli>(
+              std::chrono::steady_clock::now() - encodeStart)
+              .count();
+
+      if (message) {
+        if (!wsServer.sendFrame(*message)) {
+          // A client lost a delta, resynchronize everyone
+          deltaEncoder.requestKeyframe();
+          frameEncoder.requestKeyframe();
+        }
+        if (!rawStream) {
+          rateController.update(spec, message->size(), encodeMs,
+                                wsServer.getSendBacklog());
+        }
       }
     }
+    record(message);
   });
 
   /* ------------------------------------------------------------
    * Start processing engine
    * ------------------------------------------------------------ */
 
-  controller.start(std::move(source), 30.0);
+  // Image sequences pace themselves, network uploads arrive at the uploaders'
+  // rate, raw files and synthetic patterns play at their own rate
+  double targetFps = 30.0;
+  if (sourceType == "--sequence" || sourceType == "--network") {
+    targetFps = 0.0;
+  } else if (sourceType == "--raw" || sourceType == "--synthetic") {
+    targetFps = source->getFPS();
+  }
+  controller.start(std::move(source), targetFps);
 
   LOG_INFO("\nControls:");
   LOG_INFO("  g : toggle grayscale");
@@ -248,6 +699,9 @@ int main(int argc, char *argv[]) {
    * UI loop (main thread only)
    * ------------------------------------------------------------ */
 
+  // Stats text is rasterized only when it changes, then alpha blended
+  filters::OverlayFilter hud;
+
   int frameDisplayCount = 0;
   auto lastStatsTime = std::chrono::steady_clock::now();
 
@@ -292,8 +746,8 @@ int main(int argc, char *argv[]) {
         // Add text overlay with stats
         std::string info =
             "Clients: " + std::to_string(wsServer.getClientCount());
-        cv::putText(display, info, cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX,
-                    0.7, cv::Scalar(0, 255, 0), 2);
+        hud.setTextLayer("stats", info, cv::Point(10, 30));
+        hud.apply(display, display);
 
         cv::imshow("VisionCore - Original | Processed", display);
 
@@ -388,8 +842,67 @@ int main(int argc, char *argv[]) {
     auto elapsed =
         std::chrono::duration_cast<std::chrono::seconds>(now - lastStatsTime);
     if (elapsed.count() >= 5) {
+      const auto latency = controller.getCaptureLatency();
+      const auto rate = rateController.getStats();
       LOG_INFO("Stats - Clients: " + std::to_string(wsServer.getClientCount()) +
-               " | Frames displayed: " + std::to_string(frameDisplayCount));
+               " | Frames displayed: " + std::to_string(frameDisplayCount) +
+               " | Capture latency: " + std::to_string(latency.last_ms) +
+               " ms (avg " + std::to_string(latency.avg_ms) + " ms)" +
+               " | Stream: q" + std::to_string(rate.quality) + " x" +
+               std::to_string(rate.scale) + " " +
+               std::to_string(static_cast<int>(rate.bitrate_kbps)) + "/" +
+               std::to_string(static_cast<int>(rate.target_kbps)) +
+               " kbps, encode " + std::to_string(rate.encode_ms) +
+               " ms, skipped " + std::to_string(rate.skipped));
+      if (deltaStreaming) {
+        const auto delta = deltaEncoder.getStats();
+        LOG_INFO("Delta - changed tiles: " +
+                 std::to_string(static_cast<int>(delta.changed_ratio * 100)) +
+                 "% | keyframes: " + std::to_string(delta.keyframes) +
+                 " | patches: " + std::to_string(delta.patches) +
+                 " | unchanged frames: " + std::to_string(delta.unchanged));
+      }
+      if (streamPayload == network::PayloadType::LOSSLESS) {
+        processing::LosslessStats lossless;
+        {
+          std::lock_guard<std::mutex> lock(frame_mutex);
+          lossless = losslessStats;
+        }
+        LOG_INFO("Lossless - " +
+                 std::to_string(static_cast<int>(lossless.mb_per_s)) +
+                 " MB/s | ratio " + std::to_string(lossless.ratio) +
+                 " | encode " + std::to_string(lossless.encode_ms) + " ms" +
+                 (lossless.codec == processing::LosslessCodec::LZ4
+                      ? " | lz4"
+                      : " | zlib"));
+      }
+      if (archive) {
+        const auto recording = archive->getStats();
+        LOG_INFO("Recording - backlog: " + std::to_string(recording.backlog) +
+                 " | written: " + std::to_string(recording.written) +
+                 " | dropped: " + std::to_string(recording.dropped) +
+                 " | segments: " + std::to_string(recording.segments) +
+                 " | " + std::to_string(recording.bytes / (1024 * 1024)) +
+                 " MB");
+      }
+      if (shmSink) {
+        LOG_INFO("Shared memory - published: " +
+                 std::to_string(shmSink->getPublishedCount()) +
+                 " | dropped: " + std::to_string(shmSink->getDroppedCount()));
+      }
+      if (simulcast) {
+        std::string line = "Simulcast -";
+        for (const auto &rendition : simulcast->getStats()) {
+          line += " | " + rendition.name + " " +
+                  std::to_string(rendition.size.width) + "x" +
+                  std::to_string(rendition.size.height) + " " +
+                  std::to_string(rendition.bytes / 1024) + " KB " +
+                  std::to_string(rendition.encode_ms) + " ms, " +
+                  std::to_string(wsServer.getChannelClientCount(rendition.name)) +
+                  " clients";
+        }
+        LOG_INFO(line);
+      }
       frameDisplayCount = 0;
       lastStatsTime = now;
     }
@@ -404,6 +917,10 @@ int main(int argc, char *argv[]) {
   controller.stop();
   wsServer.stop();
 
+  if (recorder) {
+    recorder->close();
+  }
+
   if (showDisplay) {
     cv::destroyAllWindows();
     cv::waitKey(100);
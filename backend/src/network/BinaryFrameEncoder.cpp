@@ -0,0 +1,271 @@
+/**
+ * @file BinaryFrameEncoder.cpp
+ * @brief Implementation of BinaryFrameEncoder
+ */
+
+#include "network/BinaryFrameEncoder.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <opencv2/imgproc.hpp>
+
+#include "utils/Deflater.hpp"
+
+namespace visioncore::network {
+
+namespace {
+
+bool pixelFormat(const cv::Mat &frame, PixelFormat &format) {
+  if (frame.depth() != CV_8U) {
+    return false;
+  }
+  switch (frame.channels()) {
+  case 1:
+    format = PixelFormat::GRAY8;
+    return true;
+  case 3:
+    format = PixelFormat::BGR8;
+    return true;
+  case 4:
+    format = PixelFormat::BGRA8;
+    return true;
+  }
+  return false;
+}
+
+/// The header stores width and height on 16 bits
+bool fitsHeader(const cv::Size &size) {
+  return size.width <= kMaxFrameDimension && size.height <= kMaxFrameDimension;
+}
+
+void put(uint8_t *p, uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; ++i) {
+    p[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+uint64_t get(const uint8_t *p, int bytes) {
+  uint64_t value = 0;
+  for (int i = bytes - 1; i >= 0; --i) {
+    value = value << 8 | p[i];
+  }
+  return value;
+}
+
+} // namespace
+
+BinaryFrameEncoder::BinaryFrameEncoder(
+    size_t pool_size, int zlib_level,
+    const processing::LosslessOptions &lossless)
+    : pool_(pool_size), deflater_(std::make_unique<utils::Deflater>()),
+      zlib_level_(zlib_level) {
+  lossless_.setLosslessOptions(lossless);
+}
+
+BinaryFrameEncoder::~BinaryFrameEncoder() = default;
+
+BinaryFrameEncoder::Buffer
+BinaryFrameEncoder::encodeJpeg(const cv::Mat &frame, const FrameMetadata &meta,
+                               const processing::EncodeSpec &spec) {
+  if (frame.empty() ||
+      !fitsHeader(spec.size.empty() ? frame.size() : spec.size)) {
+    return nullptr;
+  }
+
+  const cv::Mat *source = &frame;
+  if (!spec.size.empty() && spec.size != frame.size()) {
+    const bool shrink = spec.size.area() < frame.size().area();
+    cv::resize(frame, scaled_, spec.size, 0, 0,
+               shrink ? cv::INTER_AREA : cv::INTER_LINEAR);
+    source = &scaled_;
+  }
+
+  Buffer buffer = pool_.acquire();
+  buffer->resize(kFrameHeaderBytes);
+  const processing::FrameEncoder encoder(spec.quality, spec.jpeg);
+  if (!encoder.encodeJPEG(*source, *buffer, kFrameHeaderBytes)) {
+    return nullptr;
+  }
+  writeHeader(*buffer, PayloadType::JPEG, frame, source->size(), meta);
+  return buffer;
+}
+
+BinaryFrameEncoder::Buffer
+BinaryFrameEncoder::encodeJpeg(const cv::Mat &frame, const FrameMetadata &meta,
+                               const processing::EncodeSpec &spec,
+                               processing::EncodedFrameCache &cache) {
+  if (frame.empty() || spec.codec != processing::Codec::JPEG ||
+      !fitsHeader(spec.size.empty() ? frame.size() : spec.size)) {
+    return nullptr;
+  }
+
+  const processing::EncodedBuffer jpeg = cache.get(meta.frame_id, frame, spec);
+  if (!jpeg) {
+    return nullptr;
+  }
+
+  Buffer buffer = pool_.acquire();
+  buffer->resize(kFrameHeaderBytes + jpeg->size());
+  std::memcpy(buffer->data() + kFrameHeaderBytes, jpeg->data(), jpeg->size());
+  writeHeader(*buffer, PayloadType::JPEG, frame,
+              spec.size.empty() ? frame.size() : spec.size, meta);
+  return buffer;
+}
+
+BinaryFrameEncoder::Buffer
+BinaryFrameEncoder::encodeRaw(const cv::Mat &frame, const FrameMetadata &meta,
+                              bool compress) {
+  PixelFormat format;
+  if (frame.empty() || !pixelFormat(frame, format) ||
+      !fitsHeader(frame.size())) {
+    return nullptr;
+  }
+
+  Buffer buffer = pool_.acquire();
+  if (compress) {
+    buffer->resize(kFrameHeaderBytes);
+    if (!deflater_->compress(frame, zlib_level_, *buffer, kFrameHeaderBytes)) {
+      return nullptr;
+    }
+  } else {
+    const size_t row_bytes = frame.cols * frame.elemSize();
+    buffer->resize(kFrameHeaderBytes + row_bytes * frame.rows);
+    uint8_t *dst = buffer->data() + kFrameHeaderBytes;
+    for (int y = 0; y < frame.rows; ++y, dst += row_bytes) {
+      std::memcpy(dst, frame.ptr<uchar>(y), row_bytes);
+    }
+  }
+  writeHeader(*buffer, compress ? PayloadType::RAW_ZLIB : PayloadType::RAW,
+              frame, frame.size(), meta);
+  return buffer;
+}
+
+BinaryFrameEncoder::Buffer
+BinaryFrameEncoder::encodeLossless(const cv::Mat &frame,
+                                   const FrameMetadata &meta,
+                                   processing::LosslessStats *stats) {
+  PixelFormat format;
+  if (frame.empty() || !pixelFormat(frame, format) ||
+      !fitsHeader(frame.size())) {
+    return nullptr;
+  }
+
+  if (keyframe_requested_.exchange(false, std::memory_order_relaxed)) {
+    lossless_.requestLosslessKeyframe();
+  }
+
+  Buffer buffer = pool_.acquire();
+  buffer->resize(kFrameHeaderBytes);
+  if (!lossless_.encodeLossless(frame, *buffer, kFrameHeaderBytes, stats)) {
+    return nullptr;
+  }
+  writeHeader(*buffer, PayloadType::LOSSLESS, frame, frame.size(), meta);
+  return buffer;
+}
+
+BinaryFrameEncoder::Buffer BinaryFrameEncoder::encodeTileDelta(
+    const cv::Mat &frame, const FrameMetadata &meta,
+    processing::TileDeltaEncoder &delta, const processing::EncodeSpec &spec) {
+  const cv::Size size = spec.size.empty() ? frame.size() : spec.size;
+  if (frame.empty() || !fitsHeader(size)) {
+    return nullptr;
+  }
+
+  Buffer buffer = pool_.acquire();
+  buffer->resize(kFrameHeaderBytes);
+  if (!delta.encode(frame, spec, *buffer, kFrameHeaderBytes) ||
+      buffer->size() == kFrameHeaderBytes) {
+    return nullptr;
+  }
+  writeHeader(*buffer, PayloadType::TILE_DELTA, frame, size, meta);
+  return buffer;
+}
+
+std::vector<BinaryFrameEncoder::Buffer> BinaryFrameEncoder::encodeSimulcast(
+    const cv::Mat &frame, const FrameMetadata &meta,
+    processing::SimulcastEncoder &simulcast, const std::vector<bool> &wanted) {
+  const auto &renditions = simulcast.getRenditions();
+  std::vector<Buffer> messages(renditions.size());
+  if (frame.empty()) {
+    return messages;
+  }
+
+  std::vector<std::vector<uint8_t> *> outputs(renditions.size(), nullptr);
+  for (size_t i = 0; i < renditions.size(); ++i) {
+    const cv::Size size = processing::SimulcastEncoder::renditionSize(
+        frame.size(), renditions[i].height);
+    if (!fitsHeader(size)) {
+      continue;
+    }
+    if (wanted.empty() || (i < wanted.size() && wanted[i])) {
+      messages[i] = pool_.acquire();
+      messages[i]->resize(kFrameHeaderBytes);
+      outputs[i] = messages[i].get();
+    }
+  }
+
+  simulcast.encode(frame, outputs, kFrameHeaderBytes);
+
+  for (size_t i = 0; i < renditions.size(); ++i) {
+    if (!messages[i]) {
+      continue;
+    }
+    if (messages[i]->size() <= kFrameHeaderBytes) {
+      messages[i] = nullptr; // failed
+      continue;
+    }
+    writeHeader(*messages[i], PayloadType::JPEG, frame,
+                processing::SimulcastEncoder::renditionSize(
+                    frame.size(), renditions[i].height),
+                meta);
+  }
+  return messages;
+}
+
+void BinaryFrameEncoder::writeHeader(std::vector<uint8_t> &buffer,
+                                     PayloadType payload, const cv::Mat &frame,
+                                     const cv::Size &size,
+                                     const FrameMetadata &meta) {
+  PixelFormat format = PixelFormat::GRAY8;
+  pixelFormat(frame, format);
+
+  uint8_t *p = buffer.data();
+  std::memcpy(p, kFrameMagic, sizeof(kFrameMagic));
+  put(p + 4, kFrameHeaderBytes, 2);
+  p[6] = static_cast<uint8_t>(payload);
+  p[7] = static_cast<uint8_t>(format);
+  put(p + 8, meta.frame_id, 8);
+  put(p + 16, toEpochMicros(meta.capture_time), 8);
+  put(p + 24, toEpochMicros(meta.processed_time), 8);
+  put(p + 32, toEpochMicros(std::chrono::steady_clock::now()), 8);
+  put(p + 40, static_cast<uint16_t>(size.width), 2);
+  put(p + 42, static_cast<uint16_t>(size.height), 2);
+  put(p + 44, buffer.size() - kFrameHeaderBytes, 4);
+}
+
+bool BinaryFrameEncoder::parseHeader(const uint8_t *data, size_t size,
+                                     FrameHeader &header) {
+  if (size < kFrameHeaderBytes ||
+      std::memcmp(data, kFrameMagic, sizeof(kFrameMagic)) != 0) {
+    return false;
+  }
+
+  header.header_bytes = static_cast<uint16_t>(get(data + 4, 2));
+  header.payload = static_cast<PayloadType>(data[6]);
+  header.format = static_cast<PixelFormat>(data[7]);
+  header.frame_id = get(data + 8, 8);
+  header.capture_us = get(data + 16, 8);
+  header.processed_us = get(data + 24, 8);
+  header.encoded_us = get(data + 32, 8);
+  header.width = static_cast<uint16_t>(get(data + 40, 2));
+  header.height = static_cast<uint16_t>(get(data + 42, 2));
+  header.payload_bytes = static_cast<uint32_t>(get(data + 44, 4));
+
+  // Newer headers may be longer, the payload always follows them
+  return header.header_bytes >= kFrameHeaderBytes &&
+         header.header_bytes <= size &&
+         header.payload_bytes <= size - header.header_bytes;
+}
+
+} // namespace visioncore::network
@@ -0,0 +1,169 @@
+/**
+ * @file BinaryFrameEncoder.hpp
+ * @brief Builds the framed binary messages sent to WebSocket clients
+ *
+ * See ProtocolTypes.hpp for the format. Header and payload share one pooled
+ * buffer: room for the header is reserved, the payload is encoded right
+ * after it (libjpeg, zlib, the lossless and tile delta encoders all write in
+ * place),
+ * then the header is filled in. The buffer goes to WSFrameServer::sendFrame
+ * as is, and returns to the pool once every holder dropped it.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include <opencv2/core.hpp>
+
+#include "network/ProtocolTypes.hpp"
+#include "processing/EncodedFrameCache.hpp"
+#include "processing/FrameEncoder.hpp"
+#include "processing/SimulcastEncoder.hpp"
+#include "processing/TileDeltaEncoder.hpp"
+#include "utils/BufferPool.hpp"
+
+namespace visioncore::utils {
+class Deflater;
+} // namespace visioncore::utils
+
+namespace visioncore::network {
+
+/**
+ * @brief Per-frame values carried by the header.
+ */
+struct FrameMetadata {
+  uint64_t frame_id = 0;
+  std::chrono::steady_clock::time_point capture_time{};   ///< Unset = unknown
+  std::chrono::steady_clock::time_point processed_time{}; ///< Unset = unknown
+};
+
+/**
+ * @brief Frame message builder
+ *
+ * Frames wider or taller than kMaxFrameDimension (after resizing) do not
+ * fit the header and are rejected: the encode functions return nullptr.
+ *
+ * Not thread-safe: one caller at a time (buffers it returned may be used
+ * anywhere).
+ */
+class BinaryFrameEncoder {
+public:
+  using Buffer = utils::BufferPool::Buffer;
+
+  /**
+   * @param pool_size  Buffers kept for reuse, enough for the messages still
+   *                   queued or being sent
+   * @param zlib_level Compression level of RAW_ZLIB payloads (1-9)
+   * @param lossless   Predictor and codec of LOSSLESS payloads
+   */
+  explicit BinaryFrameEncoder(size_t pool_size = 4, int zlib_level = 1,
+                              const processing::LosslessOptions &lossless = {});
+  ~BinaryFrameEncoder();
+
+  BinaryFrameEncoder(const BinaryFrameEncoder &) = delete;
+  BinaryFrameEncoder &operator=(const BinaryFrameEncoder &) = delete;
+
+  /**
+   * @brief JPEG payload, resized to spec.size when set.
+   *
+   * @return The message, nullptr if encoding failed
+   */
+  Buffer encodeJpeg(const cv::Mat &frame, const FrameMetadata &meta,
+                    const processing::EncodeSpec &spec);
+
+  /**
+   * @brief JPEG payload shared through an encoded frame cache.
+   *
+   * The JPEG comes from cache.get(meta.frame_id, frame, spec), so other
+   * consumers of the same frame and spec (e.g. the controller's encoded
+   * frame callback) do not encode it again; only the payload is copied
+   * behind the header.
+   *
+   * @return The message, nullptr if encoding failed
+   */
+  Buffer encodeJpeg(const cv::Mat &frame, const FrameMetadata &meta,
+                    const processing::EncodeSpec &spec,
+                    processing::EncodedFrameCache &cache);
+
+  /**
+   * @brief RAW payload (rows packed), or RAW_ZLIB when compress is set.
+   *
+   * @param frame 8-bit gray, BGR or BGRA
+   * @return The message, nullptr if the frame has another format
+   */
+  Buffer encodeRaw(const cv::Mat &frame, const FrameMetadata &meta,
+                   bool compress);
+
+  /**
+   * @brief LOSSLESS payload, see FrameEncoder::encodeLossless.
+   *
+   * @param stats If set, receives the ratio and speed of this frame
+   * @return The message, nullptr if the frame has another format
+   */
+  Buffer encodeLossless(const cv::Mat &frame, const FrameMetadata &meta,
+                        processing::LosslessStats *stats = nullptr);
+
+  /**
+   * @brief Make the next LOSSLESS delta frame a keyframe.
+   *
+   * Thread-safe; for clients that joined or lost a message.
+   */
+  void requestKeyframe() {
+    keyframe_requested_.store(true, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief TILE_DELTA payload: the changes since the previous frame.
+   *
+   * @return The message, nullptr if no tile changed or encoding failed
+   */
+  Buffer encodeTileDelta(const cv::Mat &frame, const FrameMetadata &meta,
+                         processing::TileDeltaEncoder &delta,
+                         const processing::EncodeSpec &spec);
+
+  /**
+   * @brief JPEG messages of several renditions, encoded in parallel.
+   *
+   * @param wanted Renditions to encode (e.g. those with subscribers), in
+   *               rendition order; empty = all
+   * @return One message per rendition, nullptr where not wanted or failed
+   */
+  std::vector<Buffer> encodeSimulcast(const cv::Mat &frame,
+                                      const FrameMetadata &meta,
+                                      processing::SimulcastEncoder &simulcast,
+                                      const std::vector<bool> &wanted = {});
+
+  /**
+   * @brief Decode and validate the header of a message.
+   *
+   * @return false if the message is truncated or not a frame message
+   */
+  static bool parseHeader(const uint8_t *data, size_t size,
+                          FrameHeader &header);
+
+  /**
+   * @brief Buffers allocated so far; stays flat once the pool is warm.
+   */
+  uint64_t getPoolAllocations() const { return pool_.allocations(); }
+
+private:
+  utils::BufferPool pool_;
+  std::unique_ptr<utils::Deflater> deflater_; ///< RAW_ZLIB payloads
+  int zlib_level_;
+  processing::FrameEncoder lossless_; ///< Keeps the FRAME_DELTA reference
+  std::atomic<bool> keyframe_requested_{false};
+  cv::Mat scaled_; ///< Resize buffer
+
+  /**
+   * @brief Fill in the header once the payload follows it.
+   */
+  static void writeHeader(std::vector<uint8_t> &buffer, PayloadType payload,
+                          const cv::Mat &frame, const cv::Size &size,
+                          const FrameMetadata &meta);
+};
+
+} // namespace visioncore::network
@@ -0,0 +1,94 @@
+/**
+ * @file ProtocolTypes.hpp
+ * @brief Wire format of the frames streamed to WebSocket clients
+ *
+ * Every binary message is a fixed 48-byte little-endian header followed by
+ * the payload:
+ *
+ *   offset size
+ *    0     4   "VCF1"
+ *    4     2   header size (48), payloads start there
+ *    6     1   payload type (PayloadType)
+ *    7     1   pixel format of the frame (PixelFormat)
+ *    8     8   frame id
+ *   16     8   capture time   \
+ *   24     8   processed time  > microseconds since the Unix epoch, 0 = unknown
+ *   32     8   encoded time   /
+ *   40     2   width
+ *   42     2   height
+ *   44     4   payload size
+ *
+ * Clients measure latency from the timestamps and detect drops from gaps in
+ * the frame ids.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace visioncore::network {
+
+/// First bytes of every frame message
+inline constexpr char kFrameMagic[4] = {'V', 'C', 'F', '1'};
+
+/// Size of the header before the payload
+inline constexpr size_t kFrameHeaderBytes = 48;
+
+/// Largest width or height the header can carry (16-bit fields)
+inline constexpr int kMaxFrameDimension = 0xFFFF;
+
+/**
+ * @brief Content of the payload.
+ */
+enum class PayloadType : uint8_t {
+  JPEG = 1,       ///< JPEG image
+  RAW = 2,        ///< Pixels, rows packed, in the header's pixel format
+  RAW_ZLIB = 3,   ///< RAW compressed with zlib (RFC 1950)
+  TILE_DELTA = 4, ///< "VCTD" packet of changed tiles (TileDeltaEncoder)
+  LOSSLESS = 5    ///< "VCLS" predicted and compressed frame (FrameEncoder)
+};
+
+/**
+ * @brief Pixel layout of the frame (and of RAW payloads).
+ */
+enum class PixelFormat : uint8_t {
+  GRAY8 = 1, ///< 8-bit luma
+  BGR8 = 2,  ///< 8-bit interleaved BGR
+  BGRA8 = 3  ///< 8-bit interleaved BGRA
+};
+
+/**
+ * @brief Decoded frame header.
+ */
+struct FrameHeader {
+  uint16_t header_bytes = kFrameHeaderBytes; ///< Offset of the payload
+  PayloadType payload = PayloadType::JPEG;
+  PixelFormat format = PixelFormat::GRAY8;
+  uint64_t frame_id = 0;
+  uint64_t capture_us = 0;   ///< Since the Unix epoch, 0 = unknown
+  uint64_t processed_us = 0; ///< Since the Unix epoch, 0 = unknown
+  uint64_t encoded_us = 0;   ///< Since the Unix epoch, 0 = unknown
+  uint16_t width = 0;
+  uint16_t height = 0;
+  uint32_t payload_bytes = 0;
+};
+
+/**
+ * @brief Wall-clock microseconds of a steady_clock instant, 0 if unset.
+ */
+inline uint64_t toEpochMicros(std::chrono::steady_clock::time_point time) {
+  if (time == std::chrono::steady_clock::time_point{}) {
+    return 0;
+  }
+  const auto wall = std::chrono::system_clock::now() -
+                    std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                        std::chrono::steady_clock::now() - time);
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          wall.time_since_epoch())
+          .count());
+}
+
+} // namespace visioncore::network
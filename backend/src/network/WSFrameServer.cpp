@@ -4,11 +4,19 @@
  */
 
 #include "WSFrameServer.hpp"
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 
 namespace visioncore::network {
 
+namespace {
+
+/// Uploaded frames are whole encoded images, far above the 16 KB default
+constexpr unsigned int kMaxMessageBytes = 16 * 1024 * 1024;
+
+} // namespace
+
 WSFrameServer::~WSFrameServer() { stop(); }
 
 void WSFrameServer::addClient(WebSocketType *ws) {
@@ -25,25 +33,80 @@ void WSFrameServer::removeClient(WebSocketType *ws) {
             << clients_.size() << std::endl;
 }
 
-void WSFrameServer::sendFrame(const std::vector<unsigned char> &data) {
+WSFrameServer::WebSocketType *
+WSFrameServer::findClient(uint64_t clientId) const {
+  for (auto *client : clients_) {
+    if (client->getUserData()->clientId == clientId) {
+      return client;
+    }
+  }
+  return nullptr;
+}
+
+bool WSFrameServer::setClientChannel(uint64_t clientId, std::string channel) {
+  std::lock_guard<std::mutex> lock(clientsMutex_);
+  WebSocketType *client = findClient(clientId);
+  if (!client) {
+    return false;
+  }
+  client->getUserData()->channel = std::move(channel);
+  return true;
+}
+
+size_t WSFrameServer::getChannelClientCount(std::string_view channel) const {
+  std::lock_guard<std::mutex> lock(clientsMutex_);
+  return std::count_if(clients_.begin(), clients_.end(), [&](auto *client) {
+    return client->getUserData()->channel == channel;
+  });
+}
+
+bool WSFrameServer::sendText(uint64_t clientId, std::string_view text) {
+  std::lock_guard<std::mutex> lock(clientsMutex_);
+  WebSocketType *client = findClient(clientId);
+  return client &&
+         client->send(text, uWS::OpCode::TEXT) != WebSocketType::DROPPED;
+}
+
+bool WSFrameServer::sendFrame(const std::vector<unsigned char> &data) {
+  return send(data, nullptr);
+}
+
+bool WSFrameServer::sendFrame(const std::vector<unsigned char> &data,
+                              std::string_view channel) {
+  return send(data, &channel);
+}
+
+bool WSFrameServer::send(const std::vector<unsigned char> &data,
+                         const std::string_view *channel) {
   if (!running_ || data.empty()) {
-    return;
+    return true;
   }
 
   std::lock_guard<std::mutex> lock(clientsMutex_);
 
   if (clients_.empty()) {
-    return;
+    sendBacklog_ = 0;
+    return true;
   }
 
   // Convert to string_view for uWebSockets
   std::string_view view(reinterpret_cast<const char *>(data.data()),
                         data.size());
 
-  // Send to all connected clients
+  // Send to all connected clients (or the channel's), tracking the slowest
+  size_t backlog = 0;
+  bool delivered = true;
   for (auto *client : clients_) {
-    client->send(view, uWS::OpCode::BINARY);
+    const bool subscribed =
+        !channel || client->getUserData()->channel == *channel;
+    if (subscribed &&
+        client->send(view, uWS::OpCode::BINARY) == WebSocketType::DROPPED) {
+      delivered = false;
+    }
+    backlog = std::max<size_t>(backlog, client->getBufferedAmount());
   }
+  sendBacklog_ = backlog;
+  return delivered;
 }
 
 bool WSFrameServer::start(int port) {
@@ -103,14 +166,26 @@ void WSFrameServer::serverThreadFunc(int port) {
     app.ws<PerSocketData>(
         "/*",
         {
+            .maxPayloadLength = kMaxMessageBytes,
+
             // On connection open
-            .open = [this](auto *ws) { this->addClient(ws); },
+            .open =
+                [this](auto *ws) {
+                  ws->getUserData()->clientId = nextClientId_++;
+                  this->addClient(ws);
+                  if (connectCallback_) {
+                    connectCallback_(ws->getUserData()->clientId);
+                  }
+                },
 
-            // On message received (not used for frame streaming)
+            // On message received: commands or uploaded frames
             .message =
-                [](auto * /*ws*/, std::string_view /*msg*/,
-                   uWS::OpCode /*opCode*/) {
-                  // You can handle commands from clients here
+                [this](auto *ws, std::string_view msg, uWS::OpCode opCode) {
+                  if (messageCallback_) {
+                    messageCallback_(ws->getUserData()->clientId, msg,
+                                     opCode == uWS::OpCode::BINARY);
+                    return;
+                  }
                   std::cout << "[WSFrameServer] Received message from client"
                             << std::endl;
                 },
@@ -123,6 +198,9 @@ void WSFrameServer::serverThreadFunc(int port) {
             .close =
                 [this](auto *ws, int /*code*/, std::string_view /*message*/) {
                   this->removeClient(ws);
+                  if (disconnectCallback_) {
+                    disconnectCallback_(ws->getUserData()->clientId);
+                  }
                 },
         });
 
@@ -5,12 +5,19 @@
  *
  * Uses uWebSockets as the underlying library.
  * Designed to integrate with FrameController's encoded frame callback.
+ *
+ * Each client can be assigned a channel (e.g. a simulcast rendition):
+ * frames sent to a channel only reach the clients subscribed to it.
  */
 #pragma once
 
 #include <atomic>
+#include <cstdint>
+#include <functional>
 #include <mutex>
 #include <set>
+#include <string>
+#include <string_view>
 #include <thread>
 #include <uWebSockets/App.h>
 #include <vector>
@@ -30,11 +37,30 @@ public:
    */
   struct PerSocketData {
     uint64_t clientId = 0;
+    std::string channel; ///< Guarded by clientsMutex_
   };
 
   // Type alias for WebSocket
   using WebSocketType = uWS::WebSocket<false, true, PerSocketData>;
 
+  /**
+   * @brief Called on the server thread for each client message
+   *
+   * data is only valid during the call.
+   */
+  using MessageCallback = std::function<void(
+      uint64_t clientId, std::string_view data, bool binary)>;
+
+  /**
+   * @brief Called on the server thread when a client connects
+   */
+  using ConnectCallback = std::function<void(uint64_t clientId)>;
+
+  /**
+   * @brief Called on the server thread when a client disconnects
+   */
+  using DisconnectCallback = std::function<void(uint64_t clientId)>;
+
   WSFrameServer() = default;
   ~WSFrameServer();
 
@@ -69,11 +95,66 @@ public:
     return clients_.size();
   }
 
+  /**
+   * @brief Number of connected clients subscribed to a channel
+   */
+  size_t getChannelClientCount(std::string_view channel) const;
+
+  /**
+   * @brief Largest number of bytes queued for a client but not yet sent,
+   *        as of the last sendFrame()
+   *
+   * Grows when a client's link is slower than the stream.
+   */
+  size_t getSendBacklog() const { return sendBacklog_; }
+
   /**
    * @brief Send a frame to all connected clients
    * @param data Binary frame data (JPEG encoded)
+   * @return false if a client's backpressure limit made it drop the frame
+   */
+  bool sendFrame(const std::vector<unsigned char> &data);
+
+  /**
+   * @brief Send a frame to the clients subscribed to a channel
+   * @return false if a client's backpressure limit made it drop the frame
+   */
+  bool sendFrame(const std::vector<unsigned char> &data,
+                 std::string_view channel);
+
+  /**
+   * @brief Subscribe a client to a channel, replacing its previous one
+   * @return false if the client is not connected
    */
-  void sendFrame(const std::vector<unsigned char> &data);
+  bool setClientChannel(uint64_t clientId, std::string channel);
+
+  /**
+   * @brief Send a text message (e.g. a JSON reply) to one client
+   *
+   * Server thread only: from the message or connect callbacks.
+   */
+  bool sendText(uint64_t clientId, std::string_view text);
+
+  /**
+   * @brief Handle client messages (e.g. uploaded frames). Set before start()
+   */
+  void setMessageCallback(MessageCallback callback) {
+    messageCallback_ = std::move(callback);
+  }
+
+  /**
+   * @brief Be notified of new clients. Set before start()
+   */
+  void setConnectCallback(ConnectCallback callback) {
+    connectCallback_ = std::move(callback);
+  }
+
+  /**
+   * @brief Be notified of disconnections. Set before start()
+   */
+  void setDisconnectCallback(DisconnectCallback callback) {
+    disconnectCallback_ = std::move(callback);
+  }
 
 private:
   /**
@@ -91,11 +172,28 @@ private:
    */
   void removeClient(WebSocketType *ws);
 
+  /**
+   * @brief Send to every client, or to the subscribers of *channel
+   */
+  bool send(const std::vector<unsigned char> &data,
+            const std::string_view *channel);
+
+  /**
+   * @brief Connected client with this id, nullptr if none. Lock held
+   */
+  WebSocketType *findClient(uint64_t clientId) const;
+
 private:
   mutable std::mutex clientsMutex_;
   std::set<WebSocketType *> clients_; // Use std::set instead of unordered_set
 
   std::atomic<bool> running_{false};
+  std::atomic<size_t> sendBacklog_{0};
+  uint64_t nextClientId_ = 1; ///< Server thread only
+
+  MessageCallback messageCallback_;
+  ConnectCallback connectCallback_;
+  DisconnectCallback disconnectCallback_;
   std::thread serverThread_;
 
   // uWebSockets loop handle
@@ -9,6 +9,7 @@
 #include <chrono>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <pstl/glue_algorithm_defs.h>
 #include <ranges>
 #include <stdexcept>
@@ -75,9 +76,11 @@ PipelineResult<void> FramePipeline::process(const cv::Mat &input,
   }
 
   std::vector<std::shared_ptr<filters::IFilter>> local_filters;
+  std::optional<cv::Rect> roi;
   {
     std::lock_guard<std::mutex> lock(filters_mutex_);
     local_filters = filters_;
+    roi = roi_;
   }
 
   if (local_filters.empty()) {
@@ -86,9 +89,45 @@ PipelineResult<void> FramePipeline::process(const cv::Mat &input,
     return PipelineResult<void>::Ok();
   }
 
-  cv::Mat current = input.clone();
+  if (roi) {
+    const cv::Rect clipped = *roi & cv::Rect(0, 0, input.cols, input.rows);
+
+    if (!clipped.empty()) {
+      // Filters read a view of the region: work scales with ROI area
+      cv::Mat processed;
+      auto result = runFilters(local_filters, input(clipped), processed);
+      if (result.isErr()) {
+        return result;
+      }
+
+      auto composed = compositeROI(input, clipped, processed, output);
+      if (composed.isErr()) {
+        return composed;
+      }
+      return PipelineResult<void>::Ok();
+    }
+
+    LOG_DEBUG("ROI outside of frame, processing full frame");
+  }
+
+  auto result = runFilters(local_filters, input, output);
+
+  // Filters only read their input, so it is not copied up front. The output
+  // can still share it (no filter ran, or a view such as CropFilter's): copy
+  // the result then, the caller's frame may be a source's cached buffer
+  if (result.isOk() && output.datastart == input.datastart) {
+    output = output.clone();
+  }
+  return result;
+}
+
+PipelineResult<void> FramePipeline::runFilters(
+    const std::vector<std::shared_ptr<filters::IFilter>> &filters,
+    const cv::Mat &input, cv::Mat &output) {
+
+  cv::Mat current = input;
 
-  for (auto &f : local_filters) {
+  for (auto &f : filters) {
 
     if (!f->isEnabled()) {
       LOG_DEBUG(f->getName() + " disabled");
@@ -128,6 +167,81 @@ PipelineResult<void> FramePipeline::process(const cv::Mat &input,
   return PipelineResult<void>::Ok();
 }
 
+PipelineResult<void> FramePipeline::compositeROI(const cv::Mat &frame,
+                                                 const cv::Rect &roi,
+                                                 const cv::Mat &processed,
+                                                 cv::Mat &output) {
+  cv::Mat patch = processed;
+
+  if (patch.size() != roi.size()) {
+    cv::Mat resized;
+    cv::resize(patch, resized, roi.size());
+    patch = resized;
+  }
+
+  // The untouched part of the frame follows the channel layout of the
+  // processed region (e.g. grayscale applied to the ROI)
+  const int from = frame.channels();
+  const int to = patch.channels();
+
+  if (from == to) {
+    output = frame.clone();
+  } else if (from == 3 && to == 1) {
+    cv::cvtColor(frame, output, cv::COLOR_BGR2GRAY);
+  } else if (from == 4 && to == 1) {
+    cv::cvtColor(frame, output, cv::COLOR_BGRA2GRAY);
+  } else if (from == 1 && to == 3) {
+    cv::cvtColor(frame, output, cv::COLOR_GRAY2BGR);
+  } else if (from == 1 && to == 4) {
+    cv::cvtColor(frame, output, cv::COLOR_GRAY2BGRA);
+  } else if (from == 4 && to == 3) {
+    cv::cvtColor(frame, output, cv::COLOR_BGRA2BGR);
+  } else if (from == 3 && to == 4) {
+    cv::cvtColor(frame, output, cv::COLOR_BGR2BGRA);
+  } else {
+    return PipelineResult<void>::Err(
+        PipelineError::InvalidFilter,
+        "Cannot composite a " + std::to_string(to) +
+            "-channel region into a " + std::to_string(from) +
+            "-channel frame");
+  }
+
+  if (patch.depth() != output.depth()) {
+    cv::Mat converted;
+    patch.convertTo(converted, output.depth());
+    patch = converted;
+  }
+
+  patch.copyTo(output(roi));
+  return PipelineResult<void>::Ok();
+}
+
+PipelineResult<void> FramePipeline::setROI(const cv::Rect &roi) {
+  if (roi.width <= 0 || roi.height <= 0 || roi.x < 0 || roi.y < 0) {
+    return PipelineResult<void>::Err(PipelineError::InvalidROI,
+                                     "ROI must have a positive size and "
+                                     "non-negative origin");
+  }
+
+  std::lock_guard<std::mutex> lock(filters_mutex_);
+  roi_ = roi;
+  LOG_DEBUG("Pipeline: " + name_ + " ROI set to " + std::to_string(roi.x) +
+            "," + std::to_string(roi.y) + " " + std::to_string(roi.width) +
+            "x" + std::to_string(roi.height));
+
+  return PipelineResult<void>::Ok();
+}
+
+void FramePipeline::clearROI() {
+  std::lock_guard<std::mutex> lock(filters_mutex_);
+  roi_.reset();
+}
+
+std::optional<cv::Rect> FramePipeline::getROI() const {
+  std::lock_guard<std::mutex> lock(filters_mutex_);
+  return roi_;
+}
+
 PipelineResult<void> FramePipeline::moveFilter(size_t oldIndex,
                                                size_t newIndex) {
   std::lock_guard<std::mutex> lock(filters_mutex_);
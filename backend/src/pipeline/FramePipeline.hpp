@@ -13,6 +13,7 @@
 #include <memory>
 #include <nlohmann/json.hpp>
 #include <opencv2/opencv.hpp>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -46,11 +47,39 @@ public:
 
   /**
    * @brief Process an input frame through all active filters
+   *
+   * When a region of interest is set, filters only see that region and the
+   * result is composited back into a copy of the full frame.
+   *
+   * The input is never written to and the output never shares its memory.
+   *
    * @param Input frame (cv::Mat)
    * @param Output frame (cv::Mat)
    */
   PipelineResult<void> process(const cv::Mat &input, cv::Mat &output) const;
 
+  /**
+   * @brief Restrict processing to a region of the frame
+   *
+   * The region is clipped to each frame; if it does not intersect the frame
+   * the whole frame is processed. If filters change the region size it is
+   * resized back, and the frame is converted to match a channel change
+   * (e.g. grayscale).
+   *
+   * @param roi Region in input pixel coordinates
+   */
+  PipelineResult<void> setROI(const cv::Rect &roi);
+
+  /**
+   * @brief Process the full frame again
+   */
+  void clearROI();
+
+  /**
+   * @brief Get the current region of interest, if any
+   */
+  std::optional<cv::Rect> getROI() const;
+
   /**
    * @brief Move a filter from one position to another
    * @param oldIndex Current index
@@ -95,10 +124,29 @@ public:
   bool isActive() const;
 
 private:
+  /**
+   * @brief Run the filter chain on a frame (or a region view of it)
+   */
+  static PipelineResult<void>
+  runFilters(const std::vector<std::shared_ptr<filters::IFilter>> &filters,
+             const cv::Mat &input, cv::Mat &output);
+
+  /**
+   * @brief Paste a processed region back into a copy of the full frame
+   *
+   * Fails (InvalidFilter) when the frame and the region have channel
+   * counts with no conversion between them (e.g. 2-channel input).
+   */
+  static PipelineResult<void> compositeROI(const cv::Mat &frame,
+                                           const cv::Rect &roi,
+                                           const cv::Mat &processed,
+                                           cv::Mat &output);
+
   mutable std::mutex filters_mutex_; ///< Mutex for thread safety
   std::vector<std::shared_ptr<filters::IFilter>> filters_; ///< List of filters
   bool active_;      ///< Activation state of the pipeline
   std::string name_; ///< Pipeline name
+  std::optional<cv::Rect> roi_; ///< Region of interest (full frame if unset)
 };
 
 } // namespace visioncore::pipeline
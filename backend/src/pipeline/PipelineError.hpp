@@ -27,7 +27,8 @@ enum class PipelineError {
   EmptyPipeline,   ///< Operation requires filters but pipeline is empty
   InvalidFilter,   ///< Filter pointer is null or invalid
   NullPointer,     ///< Unexpected null pointer encountered
-  ThreadLockFailed ///< Failed to acquire thread synchronization lock}
+  ThreadLockFailed, ///< Failed to acquire thread synchronization lock
+  InvalidROI        ///< Region of interest is empty or malformed
 };
 
 /**
@@ -50,6 +51,8 @@ inline std::string toString(PipelineError error) {
     return "Null pointer";
   case PipelineError::ThreadLockFailed:
     return "Thread lock failed";
+  case PipelineError::InvalidROI:
+    return "Invalid region of interest";
   default:
     return "Unknown error";
   }
@@ -183,6 +186,7 @@ inline int toHttpCode(PipelineError error) {
   case PipelineError::IndexOutOfRange:
   case PipelineError::InvalidFilter:
   case PipelineError::NullPointer:
+  case PipelineError::InvalidROI:
     return 400; // Bad Request
   case PipelineError::EmptyPipeline:
     return 404; // Not Found
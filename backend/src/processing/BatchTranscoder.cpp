@@ -0,0 +1,353 @@
+/**
+ * @file BatchTranscoder.cpp
+ * @brief BatchTranscoder implementation
+ */
+
+#include "processing/BatchTranscoder.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include "core/VideoFileSource.hpp"
+#include "processing/FrameController.hpp"
+#include "processing/FrameEncoder.hpp"
+#include "processing/MjpegAviWriter.hpp"
+#include "utils/Logger.hpp"
+
+namespace visioncore::processing {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Reads frames [begin, end) of a video file
+ */
+class SegmentSource : public core::VideoSource {
+public:
+  SegmentSource(const std::string &path, int64_t begin, int64_t end)
+      : file_(path, false, segmentOptions()), begin_(begin), end_(end) {}
+
+  bool open() override { return file_.open() && file_.seek(begin_); }
+
+  bool readFrame(cv::Mat &frame) override {
+    core::FrameInfo info;
+    return readFrame(frame, info);
+  }
+
+  bool readFrame(cv::Mat &frame, core::FrameInfo &info) override {
+    if (file_.getPosition() >= end_) {
+      return false;
+    }
+    return file_.readFrame(frame, info);
+  }
+
+  void close() override { file_.close(); }
+  int getWidth() const override { return file_.getWidth(); }
+  int getHeight() const override { return file_.getHeight(); }
+  double getFPS() const override { return file_.getFPS(); }
+  bool isOpened() const override { return file_.isOpened(); }
+  std::string getName() const override {
+    return file_.getName() + "[" + std::to_string(begin_) + ", " +
+           std::to_string(end_) + ")";
+  }
+
+private:
+  core::VideoFileSource file_;
+  int64_t begin_;
+  int64_t end_;
+
+  static core::VideoFileOptions segmentOptions() {
+    // Parallelism comes from the segments: one decoder thread each
+    core::VideoFileOptions options;
+    options.decode_threads = 1;
+    return options;
+  }
+};
+
+/**
+ * @brief Per-segment state, touched only by that segment's worker thread
+ * until FrameController::wait() returns
+ */
+struct SegmentJob {
+  FrameEncoder encoder;
+  std::ofstream spool;
+  std::vector<uint8_t> buffer;
+  cv::Size size;
+  uint64_t frames = 0;
+  Clock::time_point start;
+  Clock::time_point end;
+  bool failed = false;
+
+  // Declared last: destroyed (worker joined) before the state it uses
+  FrameController controller;
+
+  explicit SegmentJob(int quality) : encoder(quality) {}
+};
+
+/**
+ * @brief Removes the spool files however the run ends
+ */
+struct SpoolFiles {
+  std::vector<std::string> paths;
+
+  ~SpoolFiles() {
+    std::error_code ec;
+    for (const auto &path : paths) {
+      std::filesystem::remove(path, ec);
+    }
+  }
+};
+
+} // namespace
+
+BatchTranscoder::BatchTranscoder(std::string input_path,
+                                 std::string output_path, PipelineSetup setup,
+                                 BatchOptions options)
+    : input_path_(std::move(input_path)), output_path_(std::move(output_path)),
+      setup_(std::move(setup)), options_(std::move(options)) {
+  if (options_.quality < 0 || options_.quality > 100) {
+    throw std::invalid_argument("JPEG quality must be in [0, 100]");
+  }
+}
+
+std::vector<BatchSegment>
+BatchTranscoder::planSegments(const std::vector<int64_t> &keyframes,
+                              int64_t frame_count, size_t segments,
+                              int64_t min_frames) {
+  std::vector<BatchSegment> plan;
+  if (frame_count <= 0) {
+    return plan;
+  }
+
+  segments = std::max<size_t>(segments, 1);
+  min_frames = std::max<int64_t>(min_frames, 1);
+
+  std::vector<int64_t> bounds{0};
+  for (size_t i = 1; i < segments; ++i) {
+    const int64_t ideal =
+        frame_count * static_cast<int64_t>(i) / static_cast<int64_t>(segments);
+
+    // Keyframe closest to the even split point
+    const auto it = std::lower_bound(keyframes.begin(), keyframes.end(), ideal);
+    int64_t best = -1;
+    if (it != keyframes.end()) {
+      best = *it;
+    }
+    if (it != keyframes.begin()) {
+      const int64_t before = *std::prev(it);
+      if (best < 0 || ideal - before < best - ideal) {
+        best = before;
+      }
+    }
+
+    if (best - bounds.back() >= min_frames &&
+        frame_count - best >= min_frames) {
+      bounds.push_back(best);
+    }
+  }
+  bounds.push_back(frame_count);
+
+  for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+    BatchSegment segment;
+    segment.begin = bounds[i];
+    segment.end = bounds[i + 1];
+    plan.push_back(segment);
+  }
+  return plan;
+}
+
+BatchReport BatchTranscoder::run() {
+  const auto wall_start = Clock::now();
+  const std::clock_t cpu_start = std::clock();
+
+  // Probe the file; this also builds and persists the keyframe index that
+  // every segment source then loads
+  core::VideoFileSource probe(input_path_);
+  if (!probe.open()) {
+    throw std::runtime_error("Cannot open " + input_path_);
+  }
+  const double fps = probe.getFPS() > 0.0 ? probe.getFPS() : 30.0;
+  const int64_t frame_count = probe.getFrameCount();
+  std::vector<int64_t> keyframes{0};
+  if (probe.hasIndex()) {
+    keyframes = probe.getKeyframes();
+  } else {
+    LOG_WARNING("No keyframe index for " + input_path_ +
+                ", processing it as a single segment");
+  }
+  probe.close();
+
+  if (frame_count <= 0) {
+    throw std::runtime_error("Cannot determine frame count of " +
+                             input_path_);
+  }
+
+  const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+  const size_t wanted = options_.segments > 0 ? options_.segments : cores;
+
+  BatchReport report;
+  report.segments = planSegments(keyframes, frame_count, wanted,
+                                 options_.min_segment_frames);
+
+  LOG_INFO("Batch transcoding " + input_path_ + ": " +
+           std::to_string(frame_count) + " frames in " +
+           std::to_string(report.segments.size()) + " segments");
+
+  // Spools live next to the output unless told otherwise
+  const std::filesystem::path output(output_path_);
+  std::filesystem::path spool_dir = output.has_parent_path()
+                                        ? output.parent_path()
+                                        : std::filesystem::path(".");
+  if (!options_.temp_dir.empty()) {
+    spool_dir = options_.temp_dir;
+  }
+
+  SpoolFiles spools;
+  std::vector<std::unique_ptr<SegmentJob>> jobs;
+
+  for (size_t i = 0; i < report.segments.size(); ++i) {
+    const BatchSegment &segment = report.segments[i];
+    const std::string spool_path =
+        (spool_dir / (output.filename().string() + ".seg" +
+                      std::to_string(i) + ".tmp"))
+            .string();
+    spools.paths.push_back(spool_path);
+
+    auto job = std::make_unique<SegmentJob>(options_.quality);
+    job->spool.open(spool_path, std::ios::binary | std::ios::trunc);
+    if (!job->spool) {
+      throw std::runtime_error("Cannot create spool file " + spool_path);
+    }
+
+    if (setup_) {
+      setup_(job->controller.getPipeline());
+    }
+
+    SegmentJob *j = job.get();
+    job->controller.setFrameCallback(
+        [j](const cv::Mat &, const cv::Mat &processed, uint64_t) {
+          if (j->failed || !j->encoder.encodeJPEG(processed, j->buffer)) {
+            j->failed = true;
+            return;
+          }
+
+          // Length-prefixed JPEG, read back by stitch()
+          const auto size = static_cast<uint32_t>(j->buffer.size());
+          j->spool.write(reinterpret_cast<const char *>(&size), sizeof(size));
+          j->spool.write(reinterpret_cast<const char *>(j->buffer.data()),
+                         static_cast<std::streamsize>(j->buffer.size()));
+          j->failed = !j->spool;
+          j->size = processed.size();
+          ++j->frames;
+          j->end = Clock::now();
+        });
+
+    job->start = Clock::now();
+    job->end = job->start;
+    job->controller.start(std::make_unique<SegmentSource>(
+                              input_path_, segment.begin, segment.end),
+                          0.0);
+    jobs.push_back(std::move(job));
+  }
+
+  cv::Size size;
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    SegmentJob &job = *jobs[i];
+    BatchSegment &segment = report.segments[i];
+
+    job.controller.wait();
+    job.spool.close();
+
+    if (job.failed) {
+      throw std::runtime_error("Encoding failed in segment " +
+                               std::to_string(i));
+    }
+
+    segment.frames = job.frames;
+    segment.wall_ms =
+        std::chrono::duration<double, std::milli>(job.end - job.start).count();
+    segment.bytes = std::filesystem::file_size(spools.paths[i]) -
+                    job.frames * sizeof(uint32_t);
+
+    if (segment.frames != static_cast<uint64_t>(segment.end - segment.begin)) {
+      LOG_WARNING("Segment " + std::to_string(i) + " produced " +
+                  std::to_string(segment.frames) + " frames, expected " +
+                  std::to_string(segment.end - segment.begin));
+    }
+
+    if (segment.frames == 0) {
+      continue;
+    }
+    if (size.empty()) {
+      size = job.size;
+    } else if (job.size != size) {
+      throw std::runtime_error("Segments produced different frame sizes");
+    }
+  }
+
+  if (size.empty()) {
+    throw std::runtime_error("No frame decoded from " + input_path_);
+  }
+
+  stitch(spools.paths, size, fps, report);
+
+  report.wall_seconds =
+      std::chrono::duration<double>(Clock::now() - wall_start).count();
+  report.cpu_seconds =
+      static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+  report.fps = report.wall_seconds > 0.0
+                   ? static_cast<double>(report.frames) / report.wall_seconds
+                   : 0.0;
+  report.core_utilization =
+      report.wall_seconds > 0.0
+          ? report.cpu_seconds /
+                (report.wall_seconds * static_cast<double>(cores))
+          : 0.0;
+
+  LOG_INFO("Batch done: " + std::to_string(report.frames) + " frames in " +
+           std::to_string(report.wall_seconds) + " s, " +
+           std::to_string(report.fps) + " frames/s, core utilization " +
+           std::to_string(static_cast<int>(report.core_utilization * 100.0)) +
+           "% of " + std::to_string(cores) + " cores");
+
+  return report;
+}
+
+void BatchTranscoder::stitch(const std::vector<std::string> &spools,
+                             const cv::Size &size, double fps,
+                             BatchReport &report) const {
+  MjpegAviWriter writer;
+  if (!writer.open(output_path_, size, fps)) {
+    throw std::runtime_error("Cannot create " + output_path_);
+  }
+
+  std::vector<uint8_t> jpeg;
+  for (const auto &path : spools) {
+    std::ifstream in(path, std::ios::binary);
+    uint32_t length = 0;
+
+    while (in.read(reinterpret_cast<char *>(&length), sizeof(length))) {
+      jpeg.resize(length);
+      if (!in.read(reinterpret_cast<char *>(jpeg.data()), length) ||
+          !writer.writeFrame(jpeg)) {
+        throw std::runtime_error("Failed to stitch " + path + " into " +
+                                 output_path_);
+      }
+    }
+  }
+
+  report.frames = writer.getFrameCount();
+  if (!writer.close()) {
+    throw std::runtime_error("Failed to finalize " + output_path_);
+  }
+  report.output_bytes = writer.getBytesWritten();
+}
+
+} // namespace visioncore::processing
@@ -0,0 +1,119 @@
+/**
+ * @file BatchTranscoder.hpp
+ * @brief Offline, segment-parallel processing of a single video file
+ *
+ * A single VideoFileSource + FramePipeline is bounded by one decoder thread.
+ * For offline reprocessing the file is instead split at keyframes into N
+ * segments. Each segment runs in its own FrameController (own decoder, own
+ * pipeline built by the setup callback, own JPEG encoder) and is spooled to
+ * a temporary file. The spools are then stitched in order into one MJPEG
+ * AVI.
+ *
+ * For pipelines without inter-frame state the output is byte-identical to a
+ * single-segment (serial) run.
+ */
+
+#ifndef BATCH_TRANSCODER_HPP
+#define BATCH_TRANSCODER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "pipeline/FramePipeline.hpp"
+
+namespace visioncore::processing {
+
+/**
+ * @brief Batch run settings
+ */
+struct BatchOptions {
+  size_t segments = 0;            ///< Parallel segments, 0 = one per core
+  int64_t min_segment_frames = 1; ///< Do not split below this length
+  int quality = 90;               ///< JPEG quality of the output
+  std::string temp_dir;           ///< Spool directory, default: output's
+};
+
+/**
+ * @brief Frame range [begin, end) processed by one worker
+ */
+struct BatchSegment {
+  int64_t begin = 0;
+  int64_t end = 0;
+  uint64_t frames = 0;    ///< Frames actually produced
+  double wall_ms = 0.0;   ///< Time spent decoding, processing and encoding
+  uint64_t bytes = 0;     ///< Encoded size
+};
+
+/**
+ * @brief Outcome of a batch run
+ */
+struct BatchReport {
+  std::vector<BatchSegment> segments;
+  uint64_t frames = 0;           ///< Frames written to the output
+  uint64_t output_bytes = 0;     ///< Size of the output file
+  double wall_seconds = 0.0;     ///< Whole run, stitching included
+  double cpu_seconds = 0.0;      ///< Process CPU time over the run
+  double fps = 0.0;              ///< frames / wall_seconds
+  double core_utilization = 0.0; ///< cpu_seconds / (wall_seconds * cores)
+};
+
+class BatchTranscoder {
+public:
+  /**
+   * @brief Configures the pipeline of one segment
+   *
+   * Called once per segment, each time on a new FramePipeline: filters must
+   * be created inside the callback, not shared between calls.
+   */
+  using PipelineSetup = std::function<void(pipeline::FramePipeline &)>;
+
+  /**
+   * @param input_path Video file to process
+   * @param output_path MJPEG AVI file to create
+   * @param setup Pipeline configuration, may be empty (pass-through)
+   * @param options Segmentation and encoding settings
+   *
+   * @throws std::invalid_argument if quality is outside 0-100
+   */
+  BatchTranscoder(std::string input_path, std::string output_path,
+                  PipelineSetup setup, BatchOptions options = {});
+
+  /**
+   * @brief Process the whole file, blocks until the output is written
+   *
+   * @throws std::runtime_error if the input cannot be read or the output
+   * cannot be written
+   */
+  BatchReport run();
+
+  /**
+   * @brief Split [0, frame_count) into up to `segments` ranges starting on
+   * keyframes, as even as the keyframe positions allow
+   *
+   * @param keyframes Sorted keyframe indices (frame 0 is always a boundary)
+   * @param frame_count Number of frames in the file
+   * @param segments Requested number of ranges
+   * @param min_frames Minimum length of a range
+   */
+  static std::vector<BatchSegment>
+  planSegments(const std::vector<int64_t> &keyframes, int64_t frame_count,
+               size_t segments, int64_t min_frames = 1);
+
+private:
+  std::string input_path_;
+  std::string output_path_;
+  PipelineSetup setup_;
+  BatchOptions options_;
+
+  /**
+   * @brief Concatenate the spools into the output file
+   */
+  void stitch(const std::vector<std::string> &spools, const cv::Size &size,
+              double fps, BatchReport &report) const;
+};
+
+} // namespace visioncore::processing
+
+#endif // BATCH_TRANSCODER_HPP
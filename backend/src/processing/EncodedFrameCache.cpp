@@ -0,0 +1,169 @@
+/**
+ * @file EncodedFrameCache.cpp
+ * @brief EncodedFrameCache implementation
+ */
+
+#include "processing/EncodedFrameCache.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "processing/FrameEncoder.hpp"
+
+namespace visioncore::processing {
+
+namespace {
+
+/// JpegOptions fields that change the output, packed into the cache key
+uint32_t packJpegOptions(const EncodeSpec &spec) {
+  if (spec.codec != Codec::JPEG) {
+    return 0;
+  }
+  const JpegOptions &jpeg = spec.jpeg;
+  return static_cast<uint32_t>(jpeg.subsampling) |
+         static_cast<uint32_t>(jpeg.dct) << 2 |
+         static_cast<uint32_t>(jpeg.optimize_huffman) << 4 |
+         static_cast<uint32_t>(jpeg.backend) << 5 |
+         static_cast<uint32_t>(jpeg.strips) << 8;
+}
+
+} // namespace
+
+size_t EncodedFrameCache::KeyHash::operator()(const Key &key) const {
+  size_t h = std::hash<uint64_t>{}(key.frame_id);
+  const auto mix = [&h](size_t v) {
+    h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+  };
+  mix(static_cast<size_t>(key.codec));
+  mix(static_cast<size_t>(key.quality));
+  mix(static_cast<size_t>(key.width));
+  mix(static_cast<size_t>(key.height));
+  mix(static_cast<size_t>(key.jpeg));
+  return h;
+}
+
+EncodedFrameCache::EncodedFrameCache(size_t frame_window)
+    : frame_window_(std::max<size_t>(1, frame_window)) {}
+
+EncodedBuffer EncodedFrameCache::get(uint64_t frame_id, const cv::Mat &frame,
+                                     const EncodeSpec &spec) {
+  const cv::Size size = spec.size.empty() ? frame.size() : spec.size;
+  const Key key{frame_id,   spec.codec,  spec.quality,
+                size.width, size.height, packJpegOptions(spec)};
+
+  std::promise<EncodedBuffer> promise;
+  std::optional<std::shared_future<EncodedBuffer>> pending;
+  bool cached = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.requests;
+
+    const auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      ++stats_.hits;
+      pending = it->second.buffer;
+    } else if (frame_id + frame_window_ > newest_frame_) {
+      // Registered before encoding so concurrent requests wait for it
+      newest_frame_ = std::max(newest_frame_, frame_id);
+      evictLocked();
+      entries_.emplace(key, Entry{promise.get_future().share(), 0});
+      cached = true;
+    }
+  }
+
+  if (pending) {
+    // Without the lock: other variants are encoded meanwhile
+    return pending->get();
+  }
+
+  // Any exception (cv::Exception, std::bad_alloc...) is a failed encode:
+  // nothing below throws, so the promise is always fulfilled
+  EncodedBuffer buffer;
+  try {
+    std::vector<uint8_t> data;
+    if (encode(frame, spec, data)) {
+      buffer = std::make_shared<const std::vector<uint8_t>>(std::move(data));
+    }
+  } catch (...) {
+    buffer = nullptr;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.encodes;
+    if (!buffer) {
+      ++stats_.failures;
+    }
+
+    const auto it = cached ? entries_.find(key) : entries_.end();
+    if (it != entries_.end() && it->second.bytes == 0) {
+      if (buffer) {
+        it->second.bytes = buffer->size();
+        stats_.bytes += buffer->size();
+      } else {
+        entries_.erase(it); // the next request tries again
+      }
+    }
+  }
+
+  // Waiters of a failed encode get nullptr too, the entry is already gone
+  promise.set_value(buffer);
+  return buffer;
+}
+
+void EncodedFrameCache::evictLocked() {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->first.frame_id + frame_window_ <= newest_frame_) {
+      stats_.bytes -= it->second.bytes;
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void EncodedFrameCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  newest_frame_ = 0;
+  stats_.bytes = 0;
+}
+
+EncodedCacheStats EncodedFrameCache::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  EncodedCacheStats stats = stats_;
+  stats.entries = entries_.size();
+  return stats;
+}
+
+bool EncodedFrameCache::encode(const cv::Mat &frame, const EncodeSpec &spec,
+                               std::vector<uint8_t> &out) {
+  if (frame.empty()) {
+    return false;
+  }
+
+  cv::Mat resized;
+  const cv::Mat *source = &frame;
+  if (!spec.size.empty() && spec.size != frame.size()) {
+    const bool shrink = spec.size.area() < frame.size().area();
+    cv::resize(frame, resized, spec.size, 0, 0,
+               shrink ? cv::INTER_AREA : cv::INTER_LINEAR);
+    source = &resized;
+  }
+
+  switch (spec.codec) {
+  case Codec::JPEG:
+    return FrameEncoder(spec.quality, spec.jpeg).encodeJPEG(*source, out);
+  case Codec::PNG:
+    return cv::imencode(".png", *source, out,
+                        {cv::IMWRITE_PNG_COMPRESSION,
+                         std::clamp(spec.quality, 0, 9)});
+  }
+  return false;
+}
+
+} // namespace visioncore::processing
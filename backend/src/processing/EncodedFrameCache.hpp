@@ -0,0 +1,152 @@
+/**
+ * @file EncodedFrameCache.hpp
+ * @brief Encode once per variant, share the result with every consumer
+ *
+ * Several consumers of the same processed frame (WebSocket clients, the
+ * encoded-frame callback, recorders...) each need it encoded, often with
+ * identical settings. The cache keys encoded buffers by
+ * (frame id, codec, quality, resolution): the first request encodes, every
+ * other request for the same variant gets the same buffer, including those
+ * arriving while the encode is still running.
+ *
+ * Buffers are immutable and reference counted. The cache keeps the variants
+ * of the last few frame ids only; an evicted buffer stays alive until the
+ * last consumer holding it has sent it and dropped its reference.
+ */
+
+#ifndef ENCODED_FRAME_CACHE_HPP
+#define ENCODED_FRAME_CACHE_HPP
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "processing/FrameEncoder.hpp"
+
+namespace visioncore::processing {
+
+/**
+ * @brief Shared, immutable encoded frame.
+ */
+using EncodedBuffer = std::shared_ptr<const std::vector<uint8_t>>;
+
+/**
+ * @brief Output format of an encoded frame.
+ */
+enum class Codec {
+  JPEG, ///< Lossy, quality 0-100
+  PNG   ///< Lossless, quality is the compression level 0-9
+};
+
+/**
+ * @brief How to encode a frame.
+ */
+struct EncodeSpec {
+  Codec codec = Codec::JPEG;
+  int quality = 85;
+  cv::Size size{}; ///< Output resolution, empty = frame resolution
+  JpegOptions jpeg{}; ///< JPEG only: subsampling, DCT, strips...
+};
+
+/**
+ * @brief Cache counters.
+ */
+struct EncodedCacheStats {
+  uint64_t requests = 0; ///< Calls to get()
+  uint64_t hits = 0;     ///< Served from an existing or in-flight encode
+  uint64_t encodes = 0;  ///< Encodes actually performed
+  uint64_t failures = 0; ///< Encodes that produced no data
+  size_t entries = 0;    ///< Variants currently held
+  size_t bytes = 0;      ///< Encoded bytes currently held
+};
+
+class EncodedFrameCache {
+public:
+  /**
+   * @brief Constructs a cache.
+   *
+   * @param frame_window Number of most recent frame ids kept (at least 1)
+   */
+  explicit EncodedFrameCache(size_t frame_window = 2);
+
+  EncodedFrameCache(const EncodedFrameCache &) = delete;
+  EncodedFrameCache &operator=(const EncodedFrameCache &) = delete;
+
+  /**
+   * @brief Encoded frame for a variant, encoding it on first request.
+   *
+   * Safe to call from any thread. A caller asking for a variant being
+   * encoded by another thread waits for that encode instead of repeating
+   * it. Frame ids older than the window are encoded but not cached.
+   *
+   * @param frame_id Identifier of the frame (e.g. FrameController frame id)
+   * @param frame    Frame content, only read on a cache miss
+   * @param spec     Encoding settings
+   * @return The encoded buffer, nullptr if encoding failed
+   */
+  EncodedBuffer get(uint64_t frame_id, const cv::Mat &frame,
+                    const EncodeSpec &spec);
+
+  /**
+   * @brief Drop every cached variant (e.g. when the stream restarts).
+   *
+   * Buffers already handed out stay valid.
+   */
+  void clear();
+
+  EncodedCacheStats getStats() const;
+
+  /**
+   * @brief Encode a frame without caching.
+   *
+   * @return false if the frame is empty or the encoder failed
+   */
+  static bool encode(const cv::Mat &frame, const EncodeSpec &spec,
+                     std::vector<uint8_t> &out);
+
+private:
+  struct Key {
+    uint64_t frame_id;
+    Codec codec;
+    int quality;
+    int width;
+    int height;
+    uint32_t jpeg; ///< Packed JpegOptions, 0 for other codecs
+
+    bool operator==(const Key &other) const {
+      return frame_id == other.frame_id && codec == other.codec &&
+             quality == other.quality && width == other.width &&
+             height == other.height && jpeg == other.jpeg;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key &key) const;
+  };
+
+  struct Entry {
+    std::shared_future<EncodedBuffer> buffer;
+    size_t bytes = 0; ///< 0 while encoding
+  };
+
+  const size_t frame_window_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<Key, Entry, KeyHash> entries_;
+  uint64_t newest_frame_ = 0;
+  EncodedCacheStats stats_;
+
+  /**
+   * @brief Remove the variants of frames that left the window.
+   */
+  void evictLocked();
+};
+
+} // namespace visioncore::processing
+
+#endif // ENCODED_FRAME_CACHE_HPP
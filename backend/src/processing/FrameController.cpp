@@ -7,10 +7,12 @@
 
 #include "processing/FrameController.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <string>
 #include <thread>
 
+#include "sinks/SharedMemorySink.hpp"
 #include "utils/Logger.hpp"
 
 namespace visioncore::processing {
@@ -19,7 +21,7 @@ FrameController::FrameController() {
   pipeline_ = std::make_unique<pipeline::FramePipeline>("main");
 }
 
-FrameController::~FrameController() = default;
+FrameController::~FrameController() { stop(); }
 
 pipeline::FramePipeline &FrameController::getPipeline() { return *pipeline_; }
 
@@ -27,6 +29,11 @@ void FrameController::setFrameCallback(FrameCallback cb) {
   frame_callback_ = std::move(cb);
 }
 
+void FrameController::setSharedMemorySink(
+    std::shared_ptr<sinks::SharedMemorySink> sink) {
+  shm_sink_ = std::move(sink);
+}
+
 void FrameController::setErrorCallback(ErrorCallback cb) {
   error_callback_ = std::move(cb);
 }
@@ -37,9 +44,20 @@ void FrameController::start(std::unique_ptr<core::VideoSource> source,
     throw std::runtime_error("FrameController already running");
   }
 
+  // A worker that ended on its own (end of stream) still has to be joined
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+
   source_ = std::move(source);
   target_fps_ = target_fps;
 
+  {
+    std::lock_guard<std::mutex> lock(latency_mutex_);
+    latency_ = LatencyStats{};
+  }
+  encode_cache_->clear();
+
   if (!source_ || !source_->open()) {
     throw std::runtime_error("Failed to open video source");
   }
@@ -49,36 +67,57 @@ void FrameController::start(std::unique_ptr<core::VideoSource> source,
 }
 
 void FrameController::stop() {
-  if (!running_)
-    return;
-
   running_ = false;
+  if (source_)
+    source_->interrupt();
+  wait();
+}
 
-  if (worker_.joinable())
-    worker_.join();
+void FrameController::wait() {
+  // Also joins a worker that already exited at end of stream
+  if (!worker_.joinable())
+    return;
+
+  worker_.join();
 
   if (source_)
     source_->close();
 }
 
+bool FrameController::isRunning() const { return running_; }
+
 // dans FrameController.cpp
 void FrameController::setEncodedFrameCallback(EncodedFrameCallback callback) {
   encoded_frame_callback_ = std::move(callback);
 }
 
 void FrameController::setEncoder(FrameEncoder encoder) {
-  encoder_ = std::move(encoder);
+  encode_spec_.codec = Codec::JPEG;
+  encode_spec_.quality = encoder.getQuality();
+  encode_spec_.jpeg = encoder.getOptions();
+}
+
+void FrameController::setEncodeSpec(const EncodeSpec &spec) {
+  encode_spec_ = spec;
+}
+
+LatencyStats FrameController::getCaptureLatency() const {
+  std::lock_guard<std::mutex> lock(latency_mutex_);
+  return latency_;
 }
 
 void FrameController::workerLoop() {
   cv::Mat input;
   cv::Mat output;
+  core::FrameInfo info;
 
   if (target_fps_ <= 0.0) {
     LOG_WARNING("Target FPS <= 0. Using maximum speed");
   }
 
-  const auto frame_duration = std::chrono::duration<double>(1.0 / target_fps_);
+  // Unbounded: no pacing, frame_duration is only used when target_fps_ > 0
+  const auto frame_duration = std::chrono::duration<double>(
+      target_fps_ > 0.0 ? 1.0 / target_fps_ : 0.0);
   auto next_frame_time = std::chrono::steady_clock::now();
 
   size_t dropped_frames = 0;
@@ -87,36 +126,61 @@ void FrameController::workerLoop() {
   while (running_) {
 
     // Lecture frame
-    if (!source_->readFrame(input)) {
+    if (!source_->readFrame(input, info)) {
       LOG_INFO("End of video stream");
       break;
     }
 
-    cv::Mat input_copy = input.clone();
-
+    // No copy: the pipeline only reads its input, and sources such as
+    // ImageSource hand out a buffer shared with their cache
     auto proc_start = std::chrono::steady_clock::now();
-    pipeline_->process(input_copy, output);
+    pipeline_->process(input, output);
     auto proc_end = std::chrono::steady_clock::now();
 
     double proc_time_ms =
         std::chrono::duration<double, std::milli>(proc_end - proc_start)
             .count();
     total_frame_time += proc_time_ms;
+    frame_timing_ = {info.capture_time, proc_end};
+
+    if (shm_sink_) {
+      shm_sink_->publish(output, frame_id_, info.capture_time);
+    }
 
     if (frame_callback_) {
-      frame_callback_(input_copy, output, frame_id_);
+      frame_callback_(input, output, frame_id_);
     }
 
+    // Shared with any frame callback consumer that encoded it already
     if (encoded_frame_callback_) {
-      std::vector<uint8_t> buffer;
-      if (encoder_.encodeJPEG(output, buffer)) {
-        encoded_frame_callback_(buffer);
+      const EncodedBuffer buffer =
+          encode_cache_->get(frame_id_, output, encode_spec_);
+      if (buffer) {
+        encoded_frame_callback_(*buffer);
       }
     }
 
+    // Capture-to-callback latency
+    const double latency_ms =
+        std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - info.capture_time)
+            .count();
+    {
+      std::lock_guard<std::mutex> lock(latency_mutex_);
+      latency_.last_ms = latency_ms;
+      latency_.max_ms = std::max(latency_.max_ms, latency_ms);
+      ++latency_.samples;
+      latency_.avg_ms +=
+          (latency_ms - latency_.avg_ms) / static_cast<double>(latency_.samples);
+    }
+
     ++frame_id_;
 
     // FPS gestion
+    if (target_fps_ <= 0.0) {
+      continue;
+    }
+
     next_frame_time +=
         std::chrono::duration_cast<std::chrono::steady_clock::duration>(
             frame_duration);
@@ -136,9 +200,7 @@ void FrameController::workerLoop() {
     }
 
     // sleep until next_frame_time
-    if (target_fps_ > 0.0) {
-      std::this_thread::sleep_until(next_frame_time);
-    }
+    std::this_thread::sleep_until(next_frame_time);
   }
 
   if (frame_id_ > 0) {
@@ -148,6 +210,11 @@ void FrameController::workerLoop() {
              ", dropped: " + std::to_string(dropped_frames) +
              ", avg frame time:" + std::to_string(avg_frame_ms) +
              " ms, approx FPS: " + std::to_string(actual_fps));
+
+    const LatencyStats latency = getCaptureLatency();
+    LOG_INFO("Capture-to-callback latency: avg " +
+             std::to_string(latency.avg_ms) + " ms, max " +
+             std::to_string(latency.max_ms) + " ms");
   }
 
   running_ = false;
@@ -4,16 +4,23 @@
  */
 
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <thread>
 
 #include <opencv2/core.hpp>
 
 #include "core/VideoSource.hpp"
 #include "pipeline/FramePipeline.hpp"
+#include "processing/EncodedFrameCache.hpp"
 #include "processing/FrameEncoder.hpp"
 
+namespace visioncore::sinks {
+class SharedMemorySink;
+}
+
 namespace visioncore::processing {
 
 /**
@@ -26,6 +33,27 @@ enum class EngineState {
   ERROR     ///< Engine encountered an error
 };
 
+/**
+ * @brief Capture-to-callback latency statistics, in milliseconds.
+ *
+ * Measured from the capture time reported by the source (FrameInfo) to the
+ * return of the frame callback.
+ */
+struct LatencyStats {
+  double last_ms = 0.0; ///< Latency of the most recent frame
+  double avg_ms = 0.0;  ///< Mean over every frame since start()
+  double max_ms = 0.0;  ///< Worst frame since start()
+  uint64_t samples = 0; ///< Number of frames measured
+};
+
+/**
+ * @brief Timing of the frame being delivered to the callbacks.
+ */
+struct FrameTiming {
+  std::chrono::steady_clock::time_point capture_time;   ///< From the source
+  std::chrono::steady_clock::time_point processed_time; ///< Pipeline output
+};
+
 /**
  * @brief Main processing controller.
  *
@@ -43,7 +71,9 @@ public:
   /**
    * @brief Callback invoked for each processed frame.
    *
-   * @param original  Original input frame (unmodified)
+   * @param original  Original input frame, as returned by the source. It may
+   *                  share memory with the source: read-only, clone() to keep
+   *                  or modify it
    * @param processed Output frame after pipeline processing
    * @param frame_id  Monotonic frame identifier
    */
@@ -88,6 +118,19 @@ public:
    */
   void stop();
 
+  /**
+   * @brief Wait for the worker to reach the end of the stream.
+   *
+   * Blocks until the source stops delivering frames, then closes it. Use
+   * for finite sources (files) processed without interruption.
+   */
+  void wait();
+
+  /**
+   * @brief Return true while the worker is processing frames.
+   */
+  bool isRunning() const;
+
   /**
    * @brief Access the processing pipeline.
    *
@@ -104,6 +147,15 @@ public:
    */
   void setFrameCallback(FrameCallback cb);
 
+  /**
+   * @brief Publish every processed frame to a shared-memory ring.
+   *
+   * The frame is copied into the ring on the worker thread right after
+   * processing, before the callbacks run, so local readers get it first.
+   * Set before start(); nullptr disables it.
+   */
+  void setSharedMemorySink(std::shared_ptr<sinks::SharedMemorySink> sink);
+
   /**
    * @brief Set the error callback.
    *
@@ -130,10 +182,44 @@ public:
   /**
    * @brief Set the frame encoder.
    *
+   * Only its quality and options are used: encoding goes through the
+   * encoded frame cache.
+   *
    * @param encoder Frame encoder to use
    */
   void setEncoder(FrameEncoder encoder);
 
+  /**
+   * @brief Set the encoding (codec, quality, resolution) of the encoded
+   *        frame callback.
+   */
+  void setEncodeSpec(const EncodeSpec &spec);
+
+  /**
+   * @brief Cache shared by every consumer of the encoded frames.
+   *
+   * The encoded frame callback takes its buffers from it, keyed by the
+   * frame id; a frame callback asking for the same variant of the same
+   * frame_id reuses that encode instead of encoding again.
+   */
+  std::shared_ptr<EncodedFrameCache> getEncodedFrameCache() const {
+    return encode_cache_;
+  }
+
+  /**
+   * @brief Capture-to-callback latency since the last start().
+   *
+   * Safe to call from any thread.
+   */
+  LatencyStats getCaptureLatency() const;
+
+  /**
+   * @brief Timing of the frame passed to the running callback.
+   *
+   * Only meaningful from inside the frame or encoded frame callback.
+   */
+  const FrameTiming &getFrameTiming() const { return frame_timing_; }
+
 private:
   /**
    * @brief Main worker loop executed in a dedicated thread.
@@ -151,10 +237,17 @@ private:
 
   FrameCallback frame_callback_;                ///< Frame output callback
   EncodedFrameCallback encoded_frame_callback_; ///< Frame output callback
-  FrameEncoder encoder_;                        ///< Frame encoder
+  EncodeSpec encode_spec_{Codec::JPEG, 95, {}}; ///< Encoded callback format
+  std::shared_ptr<EncodedFrameCache> encode_cache_ =
+      std::make_shared<EncodedFrameCache>(); ///< Encode once per variant
   ErrorCallback error_callback_;                ///< Error callback
+  std::shared_ptr<sinks::SharedMemorySink> shm_sink_; ///< Local readers
 
   uint64_t frame_id_{0}; ///< Frame counter
+  FrameTiming frame_timing_; ///< Of the frame being delivered, worker only
+
+  mutable std::mutex latency_mutex_; ///< Guards latency_
+  LatencyStats latency_;             ///< Capture-to-callback latency
 };
 
 } // namespace visioncore::processing
@@ -6,19 +6,808 @@
 // FrameEncoder.cpp
 #include "processing/FrameEncoder.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <thread>
+
+#include <opencv2/core/hal/intrin.hpp>
+#include <zlib.h>
+
+#include "utils/Deflater.hpp"
+
+#ifdef VISIONCORE_HAS_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef VISIONCORE_HAS_LIBJPEG
+#include <csetjmp>
+#include <cstdio> // jpeglib.h needs FILE
+#include <jpeglib.h>
+
+#include "utils/ThreadPool.hpp"
+#endif
+
 namespace visioncore::processing {
 
-FrameEncoder::FrameEncoder(int jpeg_quality) {
+#ifdef VISIONCORE_HAS_LIBJPEG
+
+namespace {
+
+constexpr int kRowBatch = 16; ///< Scanlines handed to libjpeg per call
+constexpr int kMinStripMcuRows = 2; ///< Below this a strip is not worth it
+constexpr int kAutoStripPixels = 512 * 1024; ///< Strip size when strips = 0
+
+struct ErrorManager {
+  jpeg_error_mgr pub;
+  std::jmp_buf jump;
+};
+
+[[noreturn]] void onError(j_common_ptr cinfo) {
+  std::longjmp(reinterpret_cast<ErrorManager *>(cinfo->err)->jump, 1);
+}
+
+void onMessage(j_common_ptr) {} // no warnings on stderr
+
+/// libjpeg destination writing into a std::vector after its first offset
+/// bytes, grown if needed
+struct VectorDestination {
+  jpeg_destination_mgr pub;
+  std::vector<uint8_t> *buffer = nullptr;
+  size_t offset = 0;
+};
+
+void initDestination(j_compress_ptr cinfo) {
+  auto *dest = reinterpret_cast<VectorDestination *>(cinfo->dest);
+  dest->buffer->resize(dest->buffer->capacity());
+  dest->pub.next_output_byte = dest->buffer->data() + dest->offset;
+  dest->pub.free_in_buffer = dest->buffer->size() - dest->offset;
+}
+
+boolean emptyOutputBuffer(j_compress_ptr cinfo) {
+  // Only called when the whole buffer is full
+  auto *dest = reinterpret_cast<VectorDestination *>(cinfo->dest);
+  const size_t used = dest->buffer->size();
+  dest->buffer->resize(used * 2);
+  dest->pub.next_output_byte = dest->buffer->data() + used;
+  dest->pub.free_in_buffer = dest->buffer->size() - used;
+  return TRUE;
+}
+
+void termDestination(j_compress_ptr cinfo) {
+  auto *dest = reinterpret_cast<VectorDestination *>(cinfo->dest);
+  dest->buffer->resize(dest->buffer->size() - dest->pub.free_in_buffer);
+}
+
+/**
+ * @brief libjpeg compressor owned by one thread for its whole lifetime.
+ *
+ * Creating a compressor allocates its memory pools and tables; keeping it
+ * saves that on every frame.
+ */
+struct Compressor {
+  jpeg_compress_struct cinfo{};
+  ErrorManager error{};
+  VectorDestination dest{};
+  JHUFF_TBL dc_tables[2]{}; ///< Standard Huffman tables, see restoreTables()
+  JHUFF_TBL ac_tables[2]{};
+  size_t last_size = 0; ///< Previous output size, sizes the next buffer
+  bool created = false;
+
+  Compressor() {
+    cinfo.err = jpeg_std_error(&error.pub);
+    error.pub.error_exit = onError;
+    error.pub.output_message = onMessage;
+    if (setjmp(error.jump) == 0) {
+      jpeg_create_compress(&cinfo);
+      cinfo.in_color_space = JCS_RGB;
+      jpeg_set_defaults(&cinfo);
+      for (int i = 0; i < 2; ++i) {
+        dc_tables[i] = *cinfo.dc_huff_tbl_ptrs[i];
+        ac_tables[i] = *cinfo.ac_huff_tbl_ptrs[i];
+      }
+      created = true;
+    }
+
+    dest.pub.init_destination = initDestination;
+    dest.pub.empty_output_buffer = emptyOutputBuffer;
+    dest.pub.term_destination = termDestination;
+    cinfo.dest = &dest.pub;
+  }
+
+  ~Compressor() {
+    if (created) {
+      jpeg_destroy_compress(&cinfo);
+    }
+  }
+
+  Compressor(const Compressor &) = delete;
+  Compressor &operator=(const Compressor &) = delete;
+
+  /**
+   * @brief Put back the standard Huffman tables.
+   *
+   * jpeg_set_defaults() keeps existing tables, so after an optimized
+   * encode they would still hold the previous image's codes, which may
+   * lack symbols of the next one.
+   */
+  void restoreTables() {
+    for (int i = 0; i < 2; ++i) {
+      *cinfo.dc_huff_tbl_ptrs[i] = dc_tables[i];
+      *cinfo.ac_huff_tbl_ptrs[i] = ac_tables[i];
+    }
+  }
+};
+
+Compressor &threadCompressor() {
+  thread_local Compressor compressor;
+  return compressor;
+}
+
+J_DCT_METHOD toLibjpeg(DctMethod dct) {
+  switch (dct) {
+  case DctMethod::IFAST:
+    return JDCT_IFAST;
+  case DctMethod::FLOAT:
+    return JDCT_FLOAT;
+  case DctMethod::ISLOW:
+    break;
+  }
+  return JDCT_ISLOW;
+}
+
+bool encodeLibjpeg(const cv::Mat &frame, int quality,
+                   const JpegOptions &options, std::vector<uint8_t> &out,
+                   size_t offset) {
+  Compressor &compressor = threadCompressor();
+  if (!compressor.created) {
+    return false;
+  }
+
+  // Sized once from the previous frame so the output normally never grows
+  const size_t estimate =
+      compressor.last_size > 0
+          ? compressor.last_size + compressor.last_size / 4
+          : frame.total() * frame.elemSize() / 4 + 4096;
+  if (out.capacity() < offset + estimate) {
+    out.reserve(offset + estimate);
+  }
+
+  jpeg_compress_struct &cinfo = compressor.cinfo;
+  compressor.dest.buffer = &out;
+  compressor.dest.offset = offset;
+
+  if (setjmp(compressor.error.jump) != 0) {
+    jpeg_abort_compress(&cinfo);
+    out.resize(offset);
+    return false;
+  }
+
+  const int channels = frame.channels();
+  cinfo.image_width = static_cast<JDIMENSION>(frame.cols);
+  cinfo.image_height = static_cast<JDIMENSION>(frame.rows);
+  cinfo.input_components = channels;
+  cinfo.in_color_space = channels == 1   ? JCS_GRAYSCALE
+                         : channels == 3 ? JCS_EXT_BGR
+                                         : JCS_EXT_BGRA;
+
+  jpeg_set_defaults(&cinfo);
+  compressor.restoreTables();
+  jpeg_set_quality(&cinfo, std::clamp(quality, 1, 100), TRUE);
+  cinfo.dct_method = toLibjpeg(options.dct);
+  cinfo.optimize_coding = options.optimize_huffman ? TRUE : FALSE;
+
+  if (channels > 1) {
+    // Luma sampling factors relative to the (1x1) chroma components
+    cinfo.comp_info[0].h_samp_factor =
+        options.subsampling == ChromaSubsampling::S444 ? 1 : 2;
+    cinfo.comp_info[0].v_samp_factor =
+        options.subsampling == ChromaSubsampling::S420 ? 2 : 1;
+  }
+
+  jpeg_start_compress(&cinfo, TRUE);
+
+  JSAMPROW rows[kRowBatch];
+  while (cinfo.next_scanline < cinfo.image_height) {
+    const int first = static_cast<int>(cinfo.next_scanline);
+    const int count = std::min(kRowBatch, frame.rows - first);
+    for (int i = 0; i < count; ++i) {
+      // libjpeg only reads the rows, its API is not const-correct
+      rows[i] = const_cast<JSAMPROW>(frame.ptr<uchar>(first + i));
+    }
+    jpeg_write_scanlines(&cinfo, rows, static_cast<JDIMENSION>(count));
+  }
+
+  jpeg_finish_compress(&cinfo);
+  compressor.last_size = out.size() - offset;
+  return true;
+}
+
+/// Strip encoders, shared by every FrameEncoder, started on first use
+utils::ThreadPool &stripPool() {
+  static utils::ThreadPool pool;
+  return pool;
+}
+
+/**
+ * @brief Locate the headers of a JPEG produced by encodeLibjpeg().
+ *
+ * @param sof_height Offset of the frame height in the SOF segment
+ * @param sos        Offset of the SOS marker
+ * @param data       Offset of the entropy-coded data, after the SOS segment
+ */
+bool parseHeaders(const std::vector<uint8_t> &jpeg, size_t &sof_height,
+                  size_t &sos, size_t &data) {
+  sof_height = 0;
+  size_t pos = 2; // after SOI
+  while (pos + 4 <= jpeg.size() && jpeg[pos] == 0xFF) {
+    const uint8_t marker = jpeg[pos + 1];
+    const size_t length = (size_t{jpeg[pos + 2]} << 8) | jpeg[pos + 3];
+
+    if (marker == 0xDA) {
+      sos = pos;
+      data = pos + 2 + length;
+      return sof_height != 0 && data + 2 <= jpeg.size();
+    }
+    // SOF0..SOF15, except DHT (C4), JPG (C8) and DAC (CC)
+    if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 &&
+        marker != 0xC8 && marker != 0xCC) {
+      sof_height = pos + 5;
+    }
+    pos += 2 + length;
+  }
+  return false;
+}
+
+/**
+ * @brief Encode horizontal strips concurrently and join them.
+ *
+ * Every strip is a whole number of MCU rows (except the last one) and is
+ * encoded as a standalone JPEG with identical tables. A restart interval
+ * of exactly one strip makes the joined stream valid: at a restart marker
+ * the decoder resets the DC predictors and expects byte-aligned data,
+ * which is exactly how each standalone strip starts and ends. The result
+ * is the first strip's headers (height patched, DRI added), each strip's
+ * entropy-coded data separated by RST0..RST7, and EOI.
+ *
+ * @return false if not split (too small) or on error, out is then unchanged
+ */
+bool encodeStrips(const cv::Mat &frame, int quality,
+                  const JpegOptions &options, std::vector<uint8_t> &out,
+                  size_t offset) {
+  const bool color = frame.channels() > 1;
+  const int mcu_width =
+      color && options.subsampling != ChromaSubsampling::S444 ? 16 : 8;
+  const int mcu_height =
+      color && options.subsampling == ChromaSubsampling::S420 ? 16 : 8;
+  const int mcu_rows = (frame.rows + mcu_height - 1) / mcu_height;
+  const int mcus_per_row = (frame.cols + mcu_width - 1) / mcu_width;
+
+  int strips = options.strips;
+  if (strips <= 0) {
+    // Automatic: one per core, but small frames are not worth splitting
+    strips = std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                      static_cast<int>(frame.total() / kAutoStripPixels));
+  }
+  strips = std::min(strips, mcu_rows / kMinStripMcuRows);
+  if (strips <= 1) {
+    return false;
+  }
+
+  // The restart interval (one strip, in MCUs) is a 16-bit field
+  const int strip_mcu_rows =
+      std::min((mcu_rows + strips - 1) / strips, 65535 / mcus_per_row);
+  strips = (mcu_rows + strip_mcu_rows - 1) / strip_mcu_rows;
+  const int strip_rows = strip_mcu_rows * mcu_height;
+  const size_t interval = static_cast<size_t>(strip_mcu_rows) * mcus_per_row;
+
+  JpegOptions strip_options = options;
+  strip_options.optimize_huffman = false; // tables must be identical
+
+  // Strip outputs reused across frames; referenced through a local so the
+  // workers write into this thread's buffers, not their own thread_local
+  thread_local std::vector<std::vector<uint8_t>> strip_buffers;
+  std::vector<std::vector<uint8_t>> &parts = strip_buffers;
+  parts.resize(static_cast<size_t>(strips));
+
+  const auto encodeStrip = [&](int i) {
+    const int first = i * strip_rows;
+    const cv::Mat strip =
+        frame.rowRange(first, std::min(frame.rows, first + strip_rows));
+    return encodeLibjpeg(strip, quality, strip_options,
+                         parts[static_cast<size_t>(i)], 0);
+  };
+
+  std::vector<std::future<bool>> pending;
+  pending.reserve(static_cast<size_t>(strips) - 1);
+  for (int i = 1; i < strips; ++i) {
+    pending.push_back(stripPool().enqueue([&encodeStrip, i] {
+      return encodeStrip(i);
+    }));
+  }
+  bool ok = encodeStrip(0); // the calling thread takes the first strip
+  for (auto &strip : pending) {
+    ok = strip.get() && ok;
+  }
+  if (!ok) {
+    return false;
+  }
+
+  // Headers of the first strip, entropy-coded data of every strip
+  size_t sof_height = 0;
+  size_t sos = 0;
+  size_t data = 0;
+  if (!parseHeaders(parts[0], sof_height, sos, data)) {
+    return false;
+  }
+
+  size_t total = parts[0].size() + 6 + 2 * static_cast<size_t>(strips);
+  std::vector<std::pair<size_t, size_t>> ranges; // entropy data of each strip
+  ranges.reserve(parts.size());
+  for (const auto &part : parts) {
+    size_t part_sof = 0;
+    size_t part_sos = 0;
+    size_t part_data = 0;
+    if (!parseHeaders(part, part_sof, part_sos, part_data) ||
+        part[part.size() - 2] != 0xFF || part[part.size() - 1] != 0xD9) {
+      return false;
+    }
+    ranges.emplace_back(part_data, part.size() - 2);
+    total += part.size() - 2 - part_data;
+  }
+
+  out.resize(offset);
+  out.reserve(offset + total);
+  out.insert(out.end(), parts[0].begin(), parts[0].begin() + sos);
+  out[offset + sof_height] = static_cast<uint8_t>(frame.rows >> 8);
+  out[offset + sof_height + 1] = static_cast<uint8_t>(frame.rows & 0xFF);
+
+  const uint8_t dri[6] = {0xFF, 0xDD, 0x00, 0x04,
+                          static_cast<uint8_t>(interval >> 8),
+                          static_cast<uint8_t>(interval & 0xFF)};
+  out.insert(out.end(), dri, dri + 6);
+  out.insert(out.end(), parts[0].begin() + sos, parts[0].begin() + data);
+
+  for (size_t i = 0; i < parts.size(); ++i) {
+    if (i > 0) {
+      out.push_back(0xFF);
+      out.push_back(static_cast<uint8_t>(0xD0 + (i - 1) % 8)); // RSTn
+    }
+    out.insert(out.end(), parts[i].begin() + ranges[i].first,
+               parts[i].begin() + ranges[i].second);
+  }
+  out.push_back(0xFF);
+  out.push_back(0xD9); // EOI
+  return true;
+}
+
+} // namespace
+
+#endif // VISIONCORE_HAS_LIBJPEG
+
+namespace {
+
+/// Lossless container: "VCLS", version, predictor, codec, channels, width,
+/// height and payload size (u32 little-endian), then the compressed rows
+constexpr char kLosslessMagic[4] = {'V', 'C', 'L', 'S'};
+constexpr size_t kLosslessHeaderBytes = 20;
+constexpr uint8_t kLosslessVersion = 1;
+
+void put32(uint8_t *p, uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    p[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+uint32_t get32(const uint8_t *p) {
+  return p[0] | p[1] << 8 | p[2] << 16 | static_cast<uint32_t>(p[3]) << 24;
+}
+
+/**
+ * @brief dst = a - b modulo 256
+ */
+void subtractBytes(const uchar *a, const uchar *b, uchar *dst, size_t n) {
+  size_t i = 0;
+#if CV_SIMD128
+  for (; i + 16 <= n; i += 16) {
+    cv::v_store(dst + i, cv::v_sub_wrap(cv::v_load(a + i), cv::v_load(b + i)));
+  }
+#endif
+  for (; i < n; ++i) {
+    dst[i] = static_cast<uchar>(a[i] - b[i]);
+  }
+}
+
+/**
+ * @brief dst = a + b modulo 256, dst may be b
+ */
+void addBytes(const uchar *a, const uchar *b, uchar *dst, size_t n) {
+  size_t i = 0;
+#if CV_SIMD128
+  for (; i + 16 <= n; i += 16) {
+    cv::v_store(dst + i, cv::v_add_wrap(cv::v_load(a + i), cv::v_load(b + i)));
+  }
+#endif
+  for (; i < n; ++i) {
+    dst[i] = static_cast<uchar>(a[i] + b[i]);
+  }
+}
+
+inline int paeth(int a, int b, int c) {
+  const int pa = std::abs(b - c);
+  const int pb = std::abs(a - c);
+  const int pc = std::abs(a + b - 2 * c);
+  return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+}
+
+#if CV_SIMD128
+/**
+ * @brief Paeth on 8 lanes, widened to 16 bits for a + b - c
+ */
+inline cv::v_uint16x8 paeth(const cv::v_uint16x8 &a, const cv::v_uint16x8 &b,
+                            const cv::v_uint16x8 &c) {
+  const cv::v_int16x8 sa = cv::v_reinterpret_as_s16(a);
+  const cv::v_int16x8 sb = cv::v_reinterpret_as_s16(b);
+  const cv::v_int16x8 sc = cv::v_reinterpret_as_s16(c);
+  const cv::v_uint16x8 pa = cv::v_abs(sb - sc);
+  const cv::v_uint16x8 pb = cv::v_abs(sa - sc);
+  const cv::v_uint16x8 pc = cv::v_abs(sa + sb - sc - sc);
+  return cv::v_select((pa <= pb) & (pa <= pc), a,
+                      cv::v_select(pb <= pc, b, c));
+}
+#endif
+
+void predictLeft(const uchar *row, uchar *dst, size_t n, int cn) {
+  const size_t first = std::min<size_t>(cn, n);
+  std::memcpy(dst, row, first);
+  subtractBytes(row + first, row, dst + first, n - first);
+}
+
+void predictPaeth(const uchar *row, const uchar *prev, uchar *dst, size_t n,
+                  int cn) {
+  // First pixel: left and up-left are 0, Paeth picks up
+  size_t i = std::min<size_t>(cn, n);
+  subtractBytes(row, prev, dst, i);
+
+#if CV_SIMD128
+  for (; i + 16 <= n; i += 16) {
+    cv::v_uint16x8 a_lo, a_hi, b_lo, b_hi, c_lo, c_hi;
+    cv::v_expand(cv::v_load(row + i - cn), a_lo, a_hi);
+    cv::v_expand(cv::v_load(prev + i), b_lo, b_hi);
+    cv::v_expand(cv::v_load(prev + i - cn), c_lo, c_hi);
+    const cv::v_uint8x16 prediction =
+        cv::v_pack(paeth(a_lo, b_lo, c_lo), paeth(a_hi, b_hi, c_hi));
+    cv::v_store(dst + i, cv::v_sub_wrap(cv::v_load(row + i), prediction));
+  }
+#endif
+  for (; i < n; ++i) {
+    dst[i] = static_cast<uchar>(row[i] - paeth(row[i - cn], prev[i],
+                                               prev[i - cn]));
+  }
+}
+
+/**
+ * @brief Residuals of one row of n bytes
+ *
+ * @param prev Previous row, nullptr on the first one
+ * @param ref Same row of the previous frame (FRAME_DELTA)
+ */
+void predictRow(LosslessPredictor predictor, const uchar *row,
+                const uchar *prev, const uchar *ref, uchar *dst, size_t n,
+                int cn) {
+  switch (predictor) {
+  case LosslessPredictor::NONE:
+    std::memcpy(dst, row, n);
+    break;
+  case LosslessPredictor::LEFT:
+    predictLeft(row, dst, n, cn);
+    break;
+  case LosslessPredictor::UP:
+    if (prev) {
+      subtractBytes(row, prev, dst, n);
+    } else {
+      std::memcpy(dst, row, n);
+    }
+    break;
+  case LosslessPredictor::PAETH:
+    if (prev) {
+      predictPaeth(row, prev, dst, n, cn);
+    } else {
+      predictLeft(row, dst, n, cn); // up and up-left are 0
+    }
+    break;
+  case LosslessPredictor::FRAME_DELTA:
+    subtractBytes(row, ref, dst, n);
+    break;
+  }
+}
+
+/**
+ * @brief Inverse of predictRow; for FRAME_DELTA dst holds the reference row
+ */
+void unpredictRow(LosslessPredictor predictor, const uchar *residuals,
+                  const uchar *prev, uchar *dst, size_t n, int cn) {
+  const size_t first = std::min<size_t>(cn, n);
+
+  switch (predictor) {
+  case LosslessPredictor::NONE:
+    std::memcpy(dst, residuals, n);
+    break;
+  case LosslessPredictor::LEFT:
+    std::memcpy(dst, residuals, first);
+    for (size_t i = first; i < n; ++i) {
+      dst[i] = static_cast<uchar>(residuals[i] + dst[i - cn]);
+    }
+    break;
+  case LosslessPredictor::UP:
+    if (prev) {
+      addBytes(residuals, prev, dst, n);
+    } else {
+      std::memcpy(dst, residuals, n);
+    }
+    break;
+  case LosslessPredictor::PAETH:
+    if (!prev) {
+      unpredictRow(LosslessPredictor::LEFT, residuals, prev, dst, n, cn);
+      break;
+    }
+    addBytes(residuals, prev, dst, first);
+    for (size_t i = first; i < n; ++i) {
+      dst[i] = static_cast<uchar>(residuals[i] +
+                                  paeth(dst[i - cn], prev[i], prev[i - cn]));
+    }
+    break;
+  case LosslessPredictor::FRAME_DELTA:
+    addBytes(residuals, dst, dst, n);
+    break;
+  }
+}
+
+bool compressLossless(LosslessCodec codec, const LosslessOptions &options,
+                      const uint8_t *data, size_t size,
+                      std::vector<uint8_t> &out, size_t offset) {
+#ifdef VISIONCORE_HAS_LZ4
+  if (codec == LosslessCodec::LZ4) {
+    const int bound = LZ4_compressBound(static_cast<int>(size));
+    out.resize(offset + bound);
+    const int written = LZ4_compress_fast(
+        reinterpret_cast<const char *>(data),
+        reinterpret_cast<char *>(out.data() + offset), static_cast<int>(size),
+        bound, std::max(options.lz4_acceleration, 1));
+    out.resize(offset + std::max(written, 0));
+    return written > 0;
+  }
+#endif
+  (void)codec;
+  thread_local utils::Deflater deflater;
+  return deflater.compress(data, size, options.zlib_level, out, offset);
+}
+
+bool decompressLossless(LosslessCodec codec, const uint8_t *data, size_t size,
+                        std::vector<uint8_t> &out) {
+  switch (codec) {
+  case LosslessCodec::ZLIB: {
+    uLongf written = static_cast<uLongf>(out.size());
+    return uncompress(out.data(), &written, data, static_cast<uLong>(size)) ==
+               Z_OK &&
+           written == out.size();
+  }
+  case LosslessCodec::LZ4:
+#ifdef VISIONCORE_HAS_LZ4
+    return LZ4_decompress_safe(reinterpret_cast<const char *>(data),
+                               reinterpret_cast<char *>(out.data()),
+                               static_cast<int>(size),
+                               static_cast<int>(out.size())) ==
+           static_cast<int>(out.size());
+#else
+    return false;
+#endif
+  default:
+    return false;
+  }
+}
+
+} // namespace
+
+FrameEncoder::FrameEncoder(int jpeg_quality, const JpegOptions &options)
+    : quality_(jpeg_quality), options_(options) {
   params_ = {cv::IMWRITE_JPEG_QUALITY, jpeg_quality};
+  if (options_.optimize_huffman) {
+    params_.insert(params_.end(), {cv::IMWRITE_JPEG_OPTIMIZE, 1});
+  }
 }
 
 FrameEncoder::~FrameEncoder() = default;
 
+bool FrameEncoder::hasLibjpeg() {
+#ifdef VISIONCORE_HAS_LIBJPEG
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool FrameEncoder::hasLz4() {
+#ifdef VISIONCORE_HAS_LZ4
+  return true;
+#else
+  return false;
+#endif
+}
+
+JpegBackend FrameEncoder::getBackend() const {
+  return options_.backend != JpegBackend::OPENCV && hasLibjpeg()
+             ? JpegBackend::LIBJPEG
+             : JpegBackend::OPENCV;
+}
+
 bool FrameEncoder::encodeJPEG(const cv::Mat &frame,
-                              std::vector<uint8_t> &out_buffer) const {
-  if (frame.empty())
+                              std::vector<uint8_t> &out_buffer,
+                              size_t offset) const {
+  if (frame.empty() || offset > out_buffer.size())
+    return false;
+
+#ifdef VISIONCORE_HAS_LIBJPEG
+  const int channels = frame.channels();
+  if (getBackend() == JpegBackend::LIBJPEG && frame.depth() == CV_8U &&
+      (channels == 1 || channels == 3 || channels == 4)) {
+    if (options_.strips != 1 && encodeStrips(frame, quality_, options_,
+                                             out_buffer, offset)) {
+      return true;
+    }
+    return encodeLibjpeg(frame, quality_, options_, out_buffer, offset);
+  }
+#endif
+
+  if (offset == 0) {
+    return cv::imencode(".jpg", frame, out_buffer, params_);
+  }
+
+  // cv::imencode only writes whole vectors: one copy after the prefix
+  thread_local std::vector<uint8_t> encoded;
+  if (!cv::imencode(".jpg", frame, encoded, params_)) {
+    out_buffer.resize(offset);
+    return false;
+  }
+  out_buffer.resize(offset);
+  out_buffer.insert(out_buffer.end(), encoded.begin(), encoded.end());
+  return true;
+}
+
+void FrameEncoder::setLosslessOptions(const LosslessOptions &options) {
+  lossless_ = options;
+  requestLosslessKeyframe();
+}
+
+bool FrameEncoder::encodeLossless(const cv::Mat &frame,
+                                  std::vector<uint8_t> &out_buffer,
+                                  size_t offset, LosslessStats *stats) {
+  const int cn = frame.channels();
+  if (frame.empty() || frame.depth() != CV_8U ||
+      (cn != 1 && cn != 3 && cn != 4) || offset > out_buffer.size())
+    return false;
+
+  const auto start = std::chrono::steady_clock::now();
+  const size_t row_bytes = static_cast<size_t>(frame.cols) * cn;
+  const size_t raw_bytes = row_bytes * frame.rows;
+
+  // Delta frames need the previous frame, keyframes decode on their own
+  LosslessPredictor predictor = lossless_.predictor;
+  const bool delta = predictor == LosslessPredictor::FRAME_DELTA;
+  if (delta && (reference_type_ != frame.type() ||
+                reference_size_ != frame.size() ||
+                (lossless_.keyframe_interval > 0 &&
+                 since_keyframe_ >= lossless_.keyframe_interval))) {
+    predictor = LosslessPredictor::PAETH;
+  }
+
+  // Continuous frames without prediction are compressed in place
+  const uint8_t *source = frame.data;
+  if (predictor != LosslessPredictor::NONE || !frame.isContinuous()) {
+    residuals_.resize(raw_bytes);
+    const bool from_reference = predictor == LosslessPredictor::FRAME_DELTA;
+    for (int y = 0; y < frame.rows; ++y) {
+      predictRow(predictor, frame.ptr<uchar>(y),
+                 y > 0 ? frame.ptr<uchar>(y - 1) : nullptr,
+                 from_reference ? reference_.data() + y * row_bytes : nullptr,
+                 residuals_.data() + y * row_bytes, row_bytes, cn);
+    }
+    source = residuals_.data();
+  }
+
+  const LosslessCodec codec =
+      lossless_.codec != LosslessCodec::ZLIB && hasLz4() ? LosslessCodec::LZ4
+                                                         : LosslessCodec::ZLIB;
+  const size_t payload = offset + kLosslessHeaderBytes;
+  out_buffer.resize(payload);
+  if (!compressLossless(codec, lossless_, source, raw_bytes, out_buffer,
+                        payload)) {
+    out_buffer.resize(offset);
+    return false;
+  }
+
+  uint8_t *header = out_buffer.data() + offset;
+  std::memcpy(header, kLosslessMagic, sizeof(kLosslessMagic));
+  header[4] = kLosslessVersion;
+  header[5] = static_cast<uint8_t>(predictor);
+  header[6] = static_cast<uint8_t>(codec);
+  header[7] = static_cast<uint8_t>(cn);
+  put32(header + 8, static_cast<uint32_t>(frame.cols));
+  put32(header + 12, static_cast<uint32_t>(frame.rows));
+  put32(header + 16, static_cast<uint32_t>(out_buffer.size() - payload));
+
+  // Only frames actually written become the reference
+  if (delta) {
+    reference_.resize(raw_bytes);
+    for (int y = 0; y < frame.rows; ++y) {
+      std::memcpy(reference_.data() + y * row_bytes, frame.ptr<uchar>(y),
+                  row_bytes);
+    }
+    reference_type_ = frame.type();
+    reference_size_ = frame.size();
+    since_keyframe_ =
+        predictor == LosslessPredictor::FRAME_DELTA ? since_keyframe_ + 1 : 1;
+  }
+
+  if (stats) {
+    stats->raw_bytes = raw_bytes;
+    stats->encoded_bytes = out_buffer.size() - offset;
+    stats->ratio = static_cast<double>(raw_bytes) / stats->encoded_bytes;
+    stats->encode_ms = std::chrono::duration<double, std::milli>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+    stats->mb_per_s = stats->encode_ms > 0.0
+                          ? raw_bytes / (stats->encode_ms * 1000.0)
+                          : 0.0;
+    stats->predictor = predictor;
+    stats->codec = codec;
+  }
+  return true;
+}
+
+bool FrameEncoder::decodeLossless(const uint8_t *data, size_t size,
+                                  cv::Mat &frame) {
+  if (!data || size < kLosslessHeaderBytes ||
+      std::memcmp(data, kLosslessMagic, sizeof(kLosslessMagic)) != 0 ||
+      data[4] != kLosslessVersion)
     return false;
-  return cv::imencode(".jpg", frame, out_buffer, params_);
+
+  const auto predictor = static_cast<LosslessPredictor>(data[5]);
+  const auto codec = static_cast<LosslessCodec>(data[6]);
+  const int cn = data[7];
+  const uint32_t width = get32(data + 8);
+  const uint32_t height = get32(data + 12);
+  const uint32_t payload = get32(data + 16);
+  const size_t row_bytes = static_cast<size_t>(width) * cn;
+  const size_t raw_bytes = row_bytes * height;
+
+  if ((cn != 1 && cn != 3 && cn != 4) || width == 0 || height == 0 ||
+      raw_bytes > static_cast<size_t>(INT32_MAX) ||
+      predictor > LosslessPredictor::FRAME_DELTA ||
+      payload > size - kLosslessHeaderBytes)
+    return false;
+
+  const int type = CV_8UC(cn);
+  const cv::Size frame_size(static_cast<int>(width), static_cast<int>(height));
+  if (predictor == LosslessPredictor::FRAME_DELTA &&
+      (frame.type() != type || frame.size() != frame_size))
+    return false;
+
+  thread_local std::vector<uint8_t> residuals;
+  residuals.resize(raw_bytes);
+  if (!decompressLossless(codec, data + kLosslessHeaderBytes, payload,
+                          residuals))
+    return false;
+
+  frame.create(frame_size, type); // kept as is for FRAME_DELTA
+  for (int y = 0; y < frame.rows; ++y) {
+    unpredictRow(predictor, residuals.data() + y * row_bytes,
+                 y > 0 ? frame.ptr<uchar>(y - 1) : nullptr,
+                 frame.ptr<uchar>(y), row_bytes, cn);
+  }
+  return true;
 }
 
 } // namespace visioncore::processing
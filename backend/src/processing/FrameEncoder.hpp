@@ -1,6 +1,21 @@
 /**
  * @file FrameEncoder.hpp
  * @brief Header file for FrameEncoder class that encodes video frames.
+ *
+ * Two JPEG backends:
+ *  - LIBJPEG: libjpeg-turbo driven directly, one compressor per thread
+ *    kept for the thread's lifetime, output written straight into the
+ *    caller's buffer. Honours every JpegOptions field. Only available when
+ *    built with VISIONCORE_HAS_LIBJPEG.
+ *    Large frames can be split into horizontal strips encoded concurrently,
+ *    then joined with restart markers into one baseline JPEG that any
+ *    decoder reads.
+ *  - OPENCV: cv::imencode, used for other depths or without libjpeg.
+ *
+ * A lossless path is also provided for consumers that need exact pixels:
+ * each row is predicted (SIMD), then the residuals are compressed with LZ4
+ * or low-level zlib. It favours throughput over ratio. The result is a small
+ * "VCLS" container, read back with decodeLossless().
  */
 
 #include <opencv2/opencv.hpp>
@@ -12,14 +27,108 @@
 
 namespace visioncore::processing {
 
+/**
+ * @brief Chroma subsampling of color JPEGs (ignored for grayscale).
+ */
+enum class ChromaSubsampling {
+  S444, ///< Full chroma resolution
+  S422, ///< Half horizontal chroma resolution
+  S420  ///< Half horizontal and vertical chroma resolution
+};
+
+/**
+ * @brief Forward DCT implementation.
+ */
+enum class DctMethod {
+  ISLOW, ///< Accurate integer
+  IFAST, ///< Faster, less accurate integer
+  FLOAT  ///< Floating point
+};
+
+/**
+ * @brief Encoder implementation.
+ */
+enum class JpegBackend {
+  AUTO,    ///< LIBJPEG when available, OPENCV otherwise
+  OPENCV,  ///< cv::imencode
+  LIBJPEG  ///< Direct libjpeg-turbo, falls back to OPENCV if unavailable
+};
+
+/**
+ * @brief JPEG encoding options.
+ *
+ * subsampling, dct and strips are only honoured by the LIBJPEG backend.
+ */
+struct JpegOptions {
+  ChromaSubsampling subsampling = ChromaSubsampling::S420;
+  DctMethod dct = DctMethod::ISLOW;
+  bool optimize_huffman = false; ///< Smaller files, slower encode
+  JpegBackend backend = JpegBackend::AUTO;
+
+  /// Strips encoded in parallel: 1 = serial, 0 = automatic (one per core on
+  /// large frames). Strips share the standard Huffman tables, so
+  /// optimize_huffman is ignored when more than one strip is used.
+  int strips = 1;
+};
+
+/**
+ * @brief Prediction applied before lossless compression.
+ *
+ * Rows are stored as residuals modulo 256 against the prediction. Samples
+ * outside the frame predict as 0, as in PNG.
+ */
+enum class LosslessPredictor {
+  NONE,       ///< Pixels as they are
+  LEFT,       ///< Previous pixel of the row
+  UP,         ///< Same pixel of the previous row
+  PAETH,      ///< PNG Paeth of left, up and up-left
+  FRAME_DELTA ///< Same pixel of the previous frame, PAETH on keyframes
+};
+
+/**
+ * @brief Entropy coder of lossless frames.
+ */
+enum class LosslessCodec {
+  AUTO, ///< LZ4 when available, ZLIB otherwise
+  ZLIB, ///< deflate (RFC 1950) at zlib_level
+  LZ4   ///< LZ4 block, falls back to ZLIB if unavailable
+};
+
+/**
+ * @brief Lossless encoding options.
+ */
+struct LosslessOptions {
+  LosslessPredictor predictor = LosslessPredictor::UP;
+  LosslessCodec codec = LosslessCodec::AUTO;
+  int zlib_level = 1;       ///< 1 (fastest) to 9
+  int lz4_acceleration = 1; ///< Higher is faster and larger
+
+  /// FRAME_DELTA only: frames between keyframes, which decode on their own
+  int keyframe_interval = 60;
+};
+
+/**
+ * @brief Cost and gain of one lossless frame.
+ */
+struct LosslessStats {
+  size_t raw_bytes = 0;     ///< Pixel bytes of the frame
+  size_t encoded_bytes = 0; ///< Container size, header included
+  double ratio = 0.0;       ///< raw_bytes / encoded_bytes
+  double encode_ms = 0.0;
+  double mb_per_s = 0.0; ///< Raw megabytes encoded per second
+  LosslessPredictor predictor = LosslessPredictor::NONE; ///< Actually used
+  LosslessCodec codec = LosslessCodec::ZLIB;             ///< Actually used
+};
+
 class FrameEncoder {
 public:
   /**
    * @brief Constructs a FrameEncoder with specified quality.
    *
    * @param quality Compression quality (0-100).
+   * @param options Subsampling, DCT, Huffman and backend selection.
    */
-  FrameEncoder(int quality = 95);
+  FrameEncoder(int quality = 95, const JpegOptions &options = {});
 
   /**
    * @brief destructor
@@ -29,13 +138,91 @@ public:
   /**
    * @brief Encodes a video frame to a compressed format.
    *
+   * 1-channel frames give grayscale JPEGs, 3 and 4-channel frames are BGR
+   * and BGRA. The buffer's capacity is reused: pass the same vector on
+   * every frame to avoid allocations.
+   *
    * @param frame Input video frame as cv::Mat.
    * @param out_buffer Output buffer to hold the encoded data.
+   * @param offset Bytes of out_buffer kept before the JPEG (e.g. a message
+   *               header), the JPEG is written right after them.
+   */
+  bool encodeJPEG(const cv::Mat &frame, std::vector<uint8_t> &out_buffer,
+                  size_t offset = 0) const;
+
+  /**
+   * @brief Encodes a frame without loss.
+   *
+   * FRAME_DELTA keeps the frame as the next one's reference, so frames of a
+   * stream go through the same encoder, one caller at a time.
+   *
+   * @param frame 8-bit gray, BGR or BGRA frame.
+   * @param out_buffer Output buffer, capacity reused as for encodeJPEG.
+   * @param offset Bytes of out_buffer kept before the encoded frame.
+   * @param stats If set, receives the size, ratio and speed of this frame.
+   */
+  bool encodeLossless(const cv::Mat &frame, std::vector<uint8_t> &out_buffer,
+                      size_t offset = 0, LosslessStats *stats = nullptr);
+
+  /**
+   * @brief Decodes a frame written by encodeLossless.
+   *
+   * @param frame Output frame. For FRAME_DELTA frames it must hold the
+   *              previous decoded frame: pass the same Mat for a whole
+   *              stream.
+   * @return false if the data is corrupt, needs LZ4 support this build
+   *         lacks, or is a delta frame without its reference.
+   */
+  static bool decodeLossless(const uint8_t *data, size_t size,
+                             cv::Mat &frame);
+
+  /**
+   * @brief Sets the lossless options; the next FRAME_DELTA frame is a
+   *        keyframe.
+   */
+  void setLosslessOptions(const LosslessOptions &options);
+
+  /**
+   * @brief Makes the next FRAME_DELTA frame a keyframe, e.g. when a
+   *        decoder lost a frame.
+   */
+  void requestLosslessKeyframe() { reference_type_ = -1; }
+
+  const LosslessOptions &getLosslessOptions() const { return lossless_; }
+
+  /**
+   * @brief JPEG quality given at construction.
+   */
+  int getQuality() const { return quality_; }
+
+  const JpegOptions &getOptions() const { return options_; }
+
+  /**
+   * @brief Backend actually used for 8-bit frames.
+   */
+  JpegBackend getBackend() const;
+
+  /**
+   * @brief True if built with the direct libjpeg backend.
    */
-  bool encodeJPEG(const cv::Mat &frame, std::vector<uint8_t> &out_buffer) const;
+  static bool hasLibjpeg();
+
+  /**
+   * @brief True if built with the LZ4 lossless codec.
+   */
+  static bool hasLz4();
 
 private:
+  int quality_;
+  JpegOptions options_;
   std::vector<int> params_;
+
+  LosslessOptions lossless_;
+  std::vector<uint8_t> residuals_; ///< Predicted rows before compression
+  std::vector<uint8_t> reference_; ///< Previous frame for FRAME_DELTA
+  int reference_type_ = -1;
+  cv::Size reference_size_;
+  int since_keyframe_ = 0;
 };
 
 } // namespace visioncore::processing
@@ -0,0 +1,252 @@
+/**
+ * @file MjpegAviWriter.cpp
+ * @brief MjpegAviWriter implementation
+ */
+
+#include "processing/MjpegAviWriter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "utils/Logger.hpp"
+
+namespace visioncore::processing {
+
+namespace {
+
+constexpr uint32_t kAvifHasIndex = 0x10;
+constexpr uint32_t kAviifKeyframe = 0x10;
+constexpr uint32_t kFpsScale = 1000; ///< dwRate / dwScale = fps
+constexpr uint64_t kMaxFileSize = std::numeric_limits<uint32_t>::max();
+
+// Chunk sizes of the fixed header part
+constexpr uint32_t kAvihSize = 56;
+constexpr uint32_t kStrhSize = 56;
+constexpr uint32_t kStrfSize = 40;
+constexpr uint32_t kStrlSize = 4 + (8 + kStrhSize) + (8 + kStrfSize);
+constexpr uint32_t kHdrlSize = 4 + (8 + kAvihSize) + (8 + kStrlSize);
+
+} // namespace
+
+MjpegAviWriter::MjpegAviWriter() = default;
+
+MjpegAviWriter::~MjpegAviWriter() {
+  if (isOpened()) {
+    close();
+  }
+}
+
+bool MjpegAviWriter::open(const std::string &path, const cv::Size &frame_size,
+                          double fps) {
+  if (isOpened()) {
+    close();
+  }
+
+  if (frame_size.width <= 0 || frame_size.height <= 0 || fps <= 0.0) {
+    LOG_ERROR("Invalid AVI stream format for " + path);
+    return false;
+  }
+
+  out_.open(path, std::ios::binary | std::ios::trunc);
+  if (!out_) {
+    LOG_ERROR("Cannot create " + path);
+    return false;
+  }
+
+  path_ = path;
+  fps_ = fps;
+  index_.clear();
+  max_frame_size_ = 0;
+
+  const auto width = static_cast<uint32_t>(frame_size.width);
+  const auto height = static_cast<uint32_t>(frame_size.height);
+
+  writeFourcc("RIFF");
+  riff_size_pos_ = out_.tellp();
+  writeU32(0);
+  writeFourcc("AVI ");
+
+  writeFourcc("LIST");
+  writeU32(kHdrlSize);
+  writeFourcc("hdrl");
+
+  // Main header
+  writeFourcc("avih");
+  writeU32(kAvihSize);
+  writeU32(static_cast<uint32_t>(std::lround(1e6 / fps)));
+  max_bytes_per_sec_pos_ = out_.tellp();
+  writeU32(0);
+  writeU32(0); // padding granularity
+  writeU32(kAvifHasIndex);
+  total_frames_pos_ = out_.tellp();
+  writeU32(0);
+  writeU32(0); // initial frames
+  writeU32(1); // streams
+  avih_buffer_size_pos_ = out_.tellp();
+  writeU32(0);
+  writeU32(width);
+  writeU32(height);
+  for (int i = 0; i < 4; ++i) {
+    writeU32(0); // reserved
+  }
+
+  writeFourcc("LIST");
+  writeU32(kStrlSize);
+  writeFourcc("strl");
+
+  // Stream header
+  writeFourcc("strh");
+  writeU32(kStrhSize);
+  writeFourcc("vids");
+  writeFourcc("MJPG");
+  writeU32(0); // flags
+  writeU16(0); // priority
+  writeU16(0); // language
+  writeU32(0); // initial frames
+  writeU32(kFpsScale);
+  writeU32(static_cast<uint32_t>(std::lround(fps * kFpsScale)));
+  writeU32(0); // start
+  stream_length_pos_ = out_.tellp();
+  writeU32(0);
+  strh_buffer_size_pos_ = out_.tellp();
+  writeU32(0);
+  writeU32(0xFFFFFFFF); // default quality
+  writeU32(0);          // variable sample size
+  writeU16(0);
+  writeU16(0);
+  writeU16(static_cast<uint16_t>(width));
+  writeU16(static_cast<uint16_t>(height));
+
+  // Stream format (BITMAPINFOHEADER)
+  writeFourcc("strf");
+  writeU32(kStrfSize);
+  writeU32(kStrfSize);
+  writeU32(width);
+  writeU32(height);
+  writeU16(1);  // planes
+  writeU16(24); // bits per pixel once decoded
+  writeFourcc("MJPG");
+  writeU32(width * height * 3);
+  for (int i = 0; i < 4; ++i) {
+    writeU32(0); // resolution and palette
+  }
+
+  writeFourcc("LIST");
+  movi_size_pos_ = out_.tellp();
+  writeU32(0);
+  movi_start_ = out_.tellp();
+  writeFourcc("movi");
+
+  bytes_written_ = static_cast<uint64_t>(out_.tellp());
+
+  if (!out_) {
+    LOG_ERROR("Failed to write AVI header to " + path);
+    out_.close();
+    return false;
+  }
+  return true;
+}
+
+bool MjpegAviWriter::writeFrame(const std::vector<uint8_t> &jpeg) {
+  return writeFrame(jpeg.data(), jpeg.size());
+}
+
+bool MjpegAviWriter::writeFrame(const uint8_t *jpeg, size_t size) {
+  if (!isOpened() || jpeg == nullptr || size == 0) {
+    return false;
+  }
+
+  // Chunks are word aligned
+  const size_t padding = size & 1;
+  const uint64_t chunk_size = 8 + size + padding;
+  const uint64_t index_size = 8 + 16 * (index_.size() + 1);
+
+  if (bytes_written_ + chunk_size + index_size > kMaxFileSize) {
+    LOG_ERROR("AVI file size limit reached: " + path_);
+    return false;
+  }
+
+  const auto offset =
+      static_cast<uint32_t>(static_cast<std::streamoff>(bytes_written_) -
+                            movi_start_);
+
+  writeFourcc("00dc");
+  writeU32(static_cast<uint32_t>(size));
+  out_.write(reinterpret_cast<const char *>(jpeg),
+             static_cast<std::streamsize>(size));
+  if (padding) {
+    out_.put('\0');
+  }
+
+  if (!out_) {
+    LOG_ERROR("Failed to write frame to " + path_);
+    return false;
+  }
+
+  index_.push_back({offset, static_cast<uint32_t>(size)});
+  max_frame_size_ = std::max(max_frame_size_, static_cast<uint32_t>(size));
+  bytes_written_ += chunk_size;
+  return true;
+}
+
+bool MjpegAviWriter::close() {
+  if (!isOpened()) {
+    return false;
+  }
+
+  const auto movi_end = static_cast<std::streamoff>(bytes_written_);
+
+  writeFourcc("idx1");
+  writeU32(static_cast<uint32_t>(16 * index_.size()));
+  for (const auto &entry : index_) {
+    writeFourcc("00dc");
+    writeU32(kAviifKeyframe);
+    writeU32(entry.offset);
+    writeU32(entry.size);
+  }
+
+  const auto file_size = static_cast<uint64_t>(out_.tellp());
+  const auto frames = static_cast<uint32_t>(index_.size());
+
+  patchU32(riff_size_pos_, static_cast<uint32_t>(file_size - 8));
+  patchU32(max_bytes_per_sec_pos_,
+           static_cast<uint32_t>(std::lround(max_frame_size_ * fps_)));
+  patchU32(total_frames_pos_, frames);
+  patchU32(avih_buffer_size_pos_, max_frame_size_);
+  patchU32(stream_length_pos_, frames);
+  patchU32(strh_buffer_size_pos_, max_frame_size_);
+  patchU32(movi_size_pos_, static_cast<uint32_t>(movi_end - movi_start_));
+
+  const bool ok = static_cast<bool>(out_.flush());
+  out_.close();
+  bytes_written_ = file_size;
+
+  if (!ok) {
+    LOG_ERROR("Failed to finalize " + path_);
+  }
+  return ok;
+}
+
+void MjpegAviWriter::writeFourcc(const char *fourcc) { out_.write(fourcc, 4); }
+
+void MjpegAviWriter::writeU32(uint32_t value) {
+  const char bytes[4] = {static_cast<char>(value & 0xFF),
+                         static_cast<char>((value >> 8) & 0xFF),
+                         static_cast<char>((value >> 16) & 0xFF),
+                         static_cast<char>((value >> 24) & 0xFF)};
+  out_.write(bytes, 4);
+}
+
+void MjpegAviWriter::writeU16(uint16_t value) {
+  const char bytes[2] = {static_cast<char>(value & 0xFF),
+                         static_cast<char>((value >> 8) & 0xFF)};
+  out_.write(bytes, 2);
+}
+
+void MjpegAviWriter::patchU32(std::streamoff pos, uint32_t value) {
+  out_.seekp(pos);
+  writeU32(value);
+}
+
+} // namespace visioncore::processing
@@ -0,0 +1,100 @@
+/**
+ * @file MjpegAviWriter.hpp
+ * @brief Writes already encoded JPEG frames into an MJPEG AVI file
+ *
+ * Unlike cv::VideoWriter, frames are appended as they are: no decode and no
+ * re-encode. This lets several threads encode parts of a video with
+ * FrameEncoder and have the results assembled into a single file.
+ *
+ * Plain AVI 1.0 (RIFF + idx1), which limits a file to 4 GiB.
+ */
+
+#ifndef MJPEG_AVI_WRITER_HPP
+#define MJPEG_AVI_WRITER_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <opencv2/core.hpp>
+#include <string>
+#include <vector>
+
+namespace visioncore::processing {
+
+class MjpegAviWriter {
+public:
+  MjpegAviWriter();
+
+  /**
+   * @brief Destructor, finalizes the file if still open
+   */
+  ~MjpegAviWriter();
+
+  MjpegAviWriter(const MjpegAviWriter &) = delete;
+  MjpegAviWriter &operator=(const MjpegAviWriter &) = delete;
+
+  /**
+   * @brief Create the file and write the headers
+   *
+   * @param path Output file path (overwritten)
+   * @param frame_size Size of the encoded frames
+   * @param fps Playback frame rate
+   * @return false if the file cannot be created or arguments are invalid
+   */
+  bool open(const std::string &path, const cv::Size &frame_size, double fps);
+
+  /**
+   * @brief Append one JPEG image as the next frame
+   * @return false if not open, the write failed or the 4 GiB limit is hit
+   */
+  bool writeFrame(const uint8_t *jpeg, size_t size);
+  bool writeFrame(const std::vector<uint8_t> &jpeg);
+
+  /**
+   * @brief Write the index and patch the header sizes
+   * @return false if the file could not be finalized
+   */
+  bool close();
+
+  bool isOpened() const { return out_.is_open(); }
+  uint64_t getFrameCount() const { return index_.size(); }
+
+  /**
+   * @brief Size of the file written so far, in bytes
+   */
+  uint64_t getBytesWritten() const { return bytes_written_; }
+
+private:
+  /**
+   * @brief idx1 entry, offsets are relative to the 'movi' list
+   */
+  struct IndexEntry {
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  std::ofstream out_;
+  std::string path_;
+  std::vector<IndexEntry> index_;
+  uint64_t bytes_written_ = 0;
+  uint32_t max_frame_size_ = 0;
+  double fps_ = 0.0;
+
+  // Header fields patched by close(), as file offsets
+  std::streamoff riff_size_pos_ = 0;
+  std::streamoff total_frames_pos_ = 0;
+  std::streamoff max_bytes_per_sec_pos_ = 0;
+  std::streamoff avih_buffer_size_pos_ = 0;
+  std::streamoff stream_length_pos_ = 0;
+  std::streamoff strh_buffer_size_pos_ = 0;
+  std::streamoff movi_size_pos_ = 0;
+  std::streamoff movi_start_ = 0;
+
+  void writeFourcc(const char *fourcc);
+  void writeU32(uint32_t value);
+  void writeU16(uint16_t value);
+  void patchU32(std::streamoff pos, uint32_t value);
+};
+
+} // namespace visioncore::processing
+
+#endif // MJPEG_AVI_WRITER_HPP
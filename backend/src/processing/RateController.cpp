@@ -0,0 +1,192 @@
+/**
+ * @file RateController.cpp
+ * @brief RateController implementation
+ */
+
+#include "processing/RateController.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace visioncore::processing {
+
+namespace {
+
+constexpr double kAverageWeight = 0.2;  ///< Moving average smoothing
+constexpr double kDefaultFps = 30.0;    ///< Until the rate is measured
+constexpr double kQualityGain = 8.0;    ///< Quality steps per doubling
+constexpr double kMaxQualityDrop = 8.0; ///< Per frame
+constexpr double kMaxQualityRise = 3.0; ///< Per frame, recover slowly
+constexpr double kUpscaleStep = 1.1;    ///< Area grows by 21 %
+constexpr double kBackoff = 0.7;        ///< Congestion: target cut
+constexpr double kRecovery = 0.02;      ///< Per frame, share of the target
+constexpr size_t kHistory = 60;         ///< Samples, one per second
+const auto kBackoffInterval = std::chrono::milliseconds(250);
+
+double average(double current, double sample, uint64_t samples) {
+  return samples <= 1 ? sample
+                      : current + kAverageWeight * (sample - current);
+}
+
+} // namespace
+
+RateController::RateController(const RateControlOptions &options)
+    : options_(options),
+      quality_(std::clamp(options.initial_quality, options.min_quality,
+                          options.max_quality)),
+      effective_kbps_(options.target_kbps), created_(Clock::now()),
+      last_frame_(created_), window_start_(created_) {}
+
+bool RateController::admit(size_t backlog_bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  backlog_bytes_ = backlog_bytes;
+  if (backlog_bytes > 2 * options_.max_backlog_bytes) {
+    ++skipped_;
+    return false;
+  }
+  return true;
+}
+
+EncodeSpec RateController::next(const cv::Size &frame_size) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  EncodeSpec spec;
+  spec.codec = Codec::JPEG;
+  spec.quality = static_cast<int>(std::lround(quality_));
+  spec.jpeg = options_.jpeg;
+  if (scale_ < 1.0) {
+    // Even dimensions keep 4:2:0 chroma aligned
+    const int width =
+        std::max(16, static_cast<int>(frame_size.width * scale_) & ~1);
+    const int height =
+        std::max(16, static_cast<int>(frame_size.height * scale_) & ~1);
+    spec.size = cv::Size(width, height);
+  }
+  return spec;
+}
+
+void RateController::update(const EncodeSpec &spec, size_t bytes,
+                            double encode_ms, size_t backlog_bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto now = Clock::now();
+
+  ++frames_;
+  if (frames_ > 1) {
+    const double dt = std::chrono::duration<double>(now - last_frame_).count();
+    if (dt > 0.0) {
+      fps_ = average(fps_, 1.0 / dt, frames_ - 1);
+    }
+  }
+  last_frame_ = now;
+  encode_ms_ = average(encode_ms_, encode_ms, frames_);
+  backlog_bytes_ = backlog_bytes;
+
+  window_bytes_ += bytes;
+  if (now - window_start_ >= std::chrono::seconds(1)) {
+    sampleLocked(now);
+  }
+
+  // Congestion: clients drain slower than we send
+  if (backlog_bytes > options_.max_backlog_bytes) {
+    if (now - last_decrease_ >= kBackoffInterval) {
+      effective_kbps_ = std::max(effective_kbps_ * kBackoff,
+                                 options_.target_kbps * 0.05);
+      last_decrease_ = now;
+    }
+  } else {
+    effective_kbps_ = std::min(options_.target_kbps,
+                               effective_kbps_ +
+                                   options_.target_kbps * kRecovery);
+  }
+
+  if (bytes == 0) {
+    return;
+  }
+
+  // Size feedback: quality first, resolution once quality is at its floor
+  const double fps = options_.fps > 0.0 ? options_.fps
+                     : fps_ > 0.0     ? fps_
+                                      : kDefaultFps;
+  const double target_bytes = effective_kbps_ * 1000.0 / 8.0 / fps;
+  const double ratio = target_bytes / static_cast<double>(bytes);
+  const double log_ratio = std::log2(ratio);
+
+  quality_ = std::clamp(
+      static_cast<double>(spec.quality) +
+          std::clamp(kQualityGain * log_ratio, -kMaxQualityDrop,
+                     kMaxQualityRise),
+      static_cast<double>(options_.min_quality),
+      static_cast<double>(options_.max_quality));
+
+  const bool over_size =
+      ratio < 0.9 && quality_ <= options_.min_quality + 0.5;
+  const bool over_time = options_.encode_budget_ms > 0.0 &&
+                         encode_ms_ > options_.encode_budget_ms;
+
+  if (over_size || over_time) {
+    // Bytes and encode time both scale with the area
+    double factor = 1.0;
+    if (over_size) {
+      factor = std::sqrt(ratio);
+    }
+    if (over_time) {
+      factor = std::min(factor,
+                        std::sqrt(options_.encode_budget_ms / encode_ms_));
+    }
+    scale_ = std::max(options_.min_scale,
+                      scale_ * std::clamp(factor, 0.7, 0.95));
+  } else if (scale_ < 1.0) {
+    // Grow back only with headroom for the larger area on both budgets,
+    // more of it while quality can still absorb the spare bytes
+    const double growth = kUpscaleStep * kUpscaleStep;
+    const double size_room =
+        quality_ >= options_.max_quality - 0.5 ? growth : growth * 1.2;
+    const bool time_room = options_.encode_budget_ms <= 0.0 ||
+                           encode_ms_ * growth * 1.2 <
+                               options_.encode_budget_ms;
+    if (ratio > size_room && time_room) {
+      scale_ = std::min(1.0, scale_ * kUpscaleStep);
+    }
+  }
+}
+
+void RateController::sampleLocked(Clock::time_point now) {
+  const double seconds =
+      std::chrono::duration<double>(now - window_start_).count();
+  bitrate_kbps_ = static_cast<double>(window_bytes_) * 8.0 / 1000.0 / seconds;
+  window_start_ = now;
+  window_bytes_ = 0;
+
+  RateSample sample;
+  sample.time_s = std::chrono::duration<double>(now - created_).count();
+  sample.quality = static_cast<int>(std::lround(quality_));
+  sample.scale = scale_;
+  sample.bitrate_kbps = bitrate_kbps_;
+  sample.encode_ms = encode_ms_;
+  history_.push_back(sample);
+  if (history_.size() > kHistory) {
+    history_.pop_front();
+  }
+}
+
+RateStats RateController::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  RateStats stats;
+  stats.quality = static_cast<int>(std::lround(quality_));
+  stats.scale = scale_;
+  stats.bitrate_kbps = bitrate_kbps_;
+  stats.target_kbps = effective_kbps_;
+  stats.encode_ms = encode_ms_;
+  stats.fps = fps_;
+  stats.backlog_bytes = backlog_bytes_;
+  stats.frames = frames_;
+  stats.skipped = skipped_;
+  return stats;
+}
+
+std::vector<RateSample> RateController::getHistory() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return {history_.begin(), history_.end()};
+}
+
+} // namespace visioncore::processing
@@ -0,0 +1,143 @@
+/**
+ * @file RateController.hpp
+ * @brief Per-frame JPEG quality and resolution selection for streaming
+ *
+ * Picks the EncodeSpec of each streamed frame so the stream meets a target
+ * bitrate and each encode fits a time budget, from three feedback signals:
+ *  - output size: quality follows the ratio between the target frame size
+ *    (target bitrate / measured frame rate) and the last encoded size; once
+ *    quality hits its floor the frame is downscaled instead;
+ *  - encode time: when the average exceeds the budget the frame is
+ *    downscaled, encode time being roughly proportional to the area;
+ *  - send backlog: bytes queued by the server but not yet sent mean the
+ *    clients' links are slower than the target. The effective target is
+ *    then cut multiplicatively and recovers additively (AIMD), and frames
+ *    are skipped outright while the backlog is above a hard limit.
+ *
+ * Resolution only grows back when both budgets leave enough headroom, to
+ * avoid oscillating between two scales.
+ */
+
+#ifndef RATE_CONTROLLER_HPP
+#define RATE_CONTROLLER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "processing/EncodedFrameCache.hpp"
+
+namespace visioncore::processing {
+
+/**
+ * @brief Rate control targets and limits.
+ */
+struct RateControlOptions {
+  double target_kbps = 8000.0;   ///< Stream bitrate goal
+  double encode_budget_ms = 0.0; ///< Per-frame encode time limit, 0 = none
+  double fps = 0.0;              ///< Stream frame rate, 0 = measured
+  int initial_quality = 85;
+  int min_quality = 40;
+  int max_quality = 90;
+  double min_scale = 0.25;       ///< Smallest downscale factor
+  size_t max_backlog_bytes = size_t{1} << 20; ///< Congestion threshold
+  JpegOptions jpeg{};            ///< Passed through in every EncodeSpec
+};
+
+/**
+ * @brief Rate control state, averaged where noted.
+ */
+struct RateStats {
+  int quality = 0;             ///< Quality of the next frame
+  double scale = 1.0;          ///< Downscale of the next frame
+  double bitrate_kbps = 0.0;   ///< Achieved, over the last second
+  double target_kbps = 0.0;    ///< Effective target after congestion control
+  double encode_ms = 0.0;      ///< Moving average
+  double fps = 0.0;            ///< Moving average of sent frames
+  size_t backlog_bytes = 0;    ///< Last reported send backlog
+  uint64_t frames = 0;         ///< Frames encoded and sent
+  uint64_t skipped = 0;        ///< Frames not sent because of the backlog
+};
+
+/**
+ * @brief One-second history sample.
+ */
+struct RateSample {
+  double time_s = 0.0; ///< Since the controller was created
+  int quality = 0;
+  double scale = 1.0;
+  double bitrate_kbps = 0.0;
+  double encode_ms = 0.0;
+};
+
+class RateController {
+public:
+  explicit RateController(const RateControlOptions &options = {});
+
+  /**
+   * @brief Whether the next frame should be sent at all.
+   *
+   * Counts a skip when the backlog is above twice max_backlog_bytes.
+   */
+  bool admit(size_t backlog_bytes);
+
+  /**
+   * @brief Encoding settings for a frame of the given size.
+   */
+  EncodeSpec next(const cv::Size &frame_size) const;
+
+  /**
+   * @brief Feed back the result of encoding and sending a frame.
+   *
+   * @param spec          Settings returned by next()
+   * @param bytes         Encoded size
+   * @param encode_ms     Encode duration
+   * @param backlog_bytes Send backlog after queueing the frame
+   */
+  void update(const EncodeSpec &spec, size_t bytes, double encode_ms,
+              size_t backlog_bytes);
+
+  RateStats getStats() const;
+
+  /**
+   * @brief Per-second samples, oldest first (last minute).
+   */
+  std::vector<RateSample> getHistory() const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  const RateControlOptions options_;
+
+  mutable std::mutex mutex_;
+  double quality_;              ///< Fractional, rounded in next()
+  double scale_ = 1.0;
+  double effective_kbps_;       ///< Target after congestion control
+  double encode_ms_ = 0.0;
+  double fps_ = 0.0;
+  size_t backlog_bytes_ = 0;
+  uint64_t frames_ = 0;
+  uint64_t skipped_ = 0;
+
+  const Clock::time_point created_;
+  Clock::time_point last_frame_;
+  Clock::time_point last_decrease_{}; ///< First backoff is immediate
+
+  Clock::time_point window_start_; ///< Achieved bitrate window
+  size_t window_bytes_ = 0;
+  double bitrate_kbps_ = 0.0;
+  std::deque<RateSample> history_;
+
+  /**
+   * @brief Close the bitrate window and record a history sample.
+   */
+  void sampleLocked(Clock::time_point now);
+};
+
+} // namespace visioncore::processing
+
+#endif // RATE_CONTROLLER_HPP
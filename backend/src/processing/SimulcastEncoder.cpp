@@ -0,0 +1,185 @@
+/**
+ * @file SimulcastEncoder.cpp
+ * @brief Implementation of SimulcastEncoder
+ */
+
+#include "processing/SimulcastEncoder.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <future>
+#include <sstream>
+
+#include <opencv2/imgproc.hpp>
+
+namespace visioncore::processing {
+
+namespace {
+
+constexpr int kMaxRenditionHeight = 8192;
+
+/// Sort key: 0 means full size, which comes first
+int sortHeight(const Rendition &rendition) {
+  return rendition.height > 0 ? rendition.height : INT_MAX;
+}
+
+} // namespace
+
+SimulcastEncoder::SimulcastEncoder(std::vector<Rendition> renditions,
+                                   size_t threads)
+    : renditions_(std::move(renditions)),
+      pool_(threads > 0 ? threads : std::max<size_t>(renditions_.size(), 1)) {
+  order_.resize(renditions_.size());
+  for (size_t i = 0; i < order_.size(); ++i) {
+    order_[i] = i;
+  }
+  std::stable_sort(order_.begin(), order_.end(), [this](size_t a, size_t b) {
+    return sortHeight(renditions_[a]) > sortHeight(renditions_[b]);
+  });
+
+  levels_.resize(renditions_.size());
+  for (const auto &rendition : renditions_) {
+    encoders_.emplace_back(rendition.quality, rendition.jpeg);
+    stats_.push_back({rendition.name, {}, 0, 0.0, 0});
+  }
+}
+
+bool SimulcastEncoder::encode(
+    const cv::Mat &frame, const std::vector<std::vector<uint8_t> *> &outputs,
+    size_t offset) {
+  if (frame.empty() || outputs.size() != renditions_.size()) {
+    return false;
+  }
+
+  // Levels below the smallest requested rendition are not needed
+  size_t last = order_.size();
+  for (size_t i = 0; i < order_.size(); ++i) {
+    if (outputs[order_[i]]) {
+      last = i;
+    }
+  }
+  if (last == order_.size()) {
+    return true;
+  }
+
+  std::vector<std::future<bool>> pending;
+  cv::Mat previous = frame;
+  for (size_t i = 0; i <= last; ++i) {
+    const size_t index = order_[i];
+    const cv::Size size =
+        renditionSize(frame.size(), renditions_[index].height);
+
+    // Same size shares the previous level, otherwise the level owns its
+    // buffer, reused from frame to frame
+    cv::Mat level = previous;
+    if (size != previous.size()) {
+      cv::resize(previous, levels_[index], size, 0, 0, cv::INTER_AREA);
+      level = levels_[index];
+    }
+    previous = level;
+
+    std::vector<uint8_t> *out = outputs[index];
+    if (!out) {
+      continue;
+    }
+    pending.push_back(pool_.enqueue([this, index, level, out, offset] {
+      const auto start = std::chrono::steady_clock::now();
+      const bool ok = encoders_[index].encodeJPEG(level, *out, offset);
+      const double ms = std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+      if (!ok) {
+        out->resize(std::min(out->size(), offset));
+        return false;
+      }
+
+      std::lock_guard<std::mutex> lock(stats_mutex_);
+      RenditionStats &stats = stats_[index];
+      stats.size = level.size();
+      stats.bytes = out->size() - offset;
+      stats.encode_ms =
+          stats.frames == 0 ? ms : 0.9 * stats.encode_ms + 0.1 * ms;
+      ++stats.frames;
+      return true;
+    }));
+  }
+
+  // Wait for every task: they read the levels and the frame
+  bool ok = true;
+  for (auto &result : pending) {
+    ok = result.get() && ok;
+  }
+  return ok;
+}
+
+cv::Size SimulcastEncoder::renditionSize(const cv::Size &frame, int height) {
+  if (height <= 0 || height >= frame.height) {
+    return frame;
+  }
+  const int width = std::max(
+      1, static_cast<int>(std::lround(static_cast<double>(frame.width) *
+                                      height / frame.height)));
+  return {std::min(frame.width, width + (width & 1)), height};
+}
+
+std::optional<std::vector<Rendition>>
+SimulcastEncoder::parse(const std::string &spec) {
+  std::vector<Rendition> renditions;
+  std::stringstream list(spec);
+  std::string item;
+
+  while (std::getline(list, item, ',')) {
+    Rendition rendition;
+    try {
+      size_t used = 0;
+      rendition.height = std::stoi(item, &used);
+      if (used < item.size()) {
+        if (item[used] != ':') {
+          return std::nullopt;
+        }
+        const std::string quality = item.substr(used + 1);
+        rendition.quality = std::stoi(quality, &used);
+        if (used != quality.size()) {
+          return std::nullopt;
+        }
+      }
+    } catch (const std::exception &) {
+      return std::nullopt;
+    }
+
+    if (rendition.height <= 0 || rendition.height > kMaxRenditionHeight ||
+        rendition.quality < 1 || rendition.quality > 100) {
+      return std::nullopt;
+    }
+    rendition.name = std::to_string(rendition.height) + "p";
+    for (const auto &other : renditions) {
+      if (other.name == rendition.name) {
+        return std::nullopt;
+      }
+    }
+    renditions.push_back(rendition);
+  }
+
+  if (renditions.empty()) {
+    return std::nullopt;
+  }
+  return renditions;
+}
+
+int SimulcastEncoder::find(const std::string &name) const {
+  for (size_t i = 0; i < renditions_.size(); ++i) {
+    if (renditions_[i].name == name) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+std::vector<RenditionStats> SimulcastEncoder::getStats() const {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  return stats_;
+}
+
+} // namespace visioncore::processing
@@ -0,0 +1,127 @@
+/**
+ * @file SimulcastEncoder.hpp
+ * @brief Several resolution/quality renditions of each frame, in one pass
+ *
+ * Renditions are sorted from largest to smallest and a downscale pyramid is
+ * built from the processed frame: each level is resized (INTER_AREA) from
+ * the previous one rather than from the full frame, so every level only
+ * reads the pixels of a slightly larger image. A level is handed to the
+ * encode pool as soon as it exists, while the caller's thread goes on with
+ * the next level: resizing and the JPEG encodes of all renditions overlap.
+ *
+ * Renditions nobody needs (null output) are neither encoded nor, if no
+ * smaller rendition is needed either, resized.
+ */
+
+#ifndef SIMULCAST_ENCODER_HPP
+#define SIMULCAST_ENCODER_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "processing/FrameEncoder.hpp"
+#include "utils/ThreadPool.hpp"
+
+namespace visioncore::processing {
+
+/**
+ * @brief One output of the simulcast stage.
+ */
+struct Rendition {
+  std::string name; ///< What clients subscribe to, e.g. "540p"
+  int height = 0;   ///< Output height, width keeps the aspect ratio;
+                    ///< 0 or above the frame height = frame size
+  int quality = 85;
+  JpegOptions jpeg{};
+};
+
+/**
+ * @brief Counters of one rendition.
+ */
+struct RenditionStats {
+  std::string name;
+  cv::Size size;          ///< Of the last encoded frame
+  size_t bytes = 0;       ///< Of the last encoded frame
+  double encode_ms = 0.0; ///< Moving average
+  uint64_t frames = 0;    ///< Frames encoded
+};
+
+class SimulcastEncoder {
+public:
+  /**
+   * @param renditions Outputs, in the order used by encode()
+   * @param threads    Encode workers, 0 = one per rendition
+   */
+  explicit SimulcastEncoder(std::vector<Rendition> renditions,
+                            size_t threads = 0);
+
+  SimulcastEncoder(const SimulcastEncoder &) = delete;
+  SimulcastEncoder &operator=(const SimulcastEncoder &) = delete;
+
+  /**
+   * @brief Build the pyramid and JPEG-encode every requested rendition.
+   *
+   * One caller at a time.
+   *
+   * @param frame   Processed frame
+   * @param outputs One buffer per rendition, in rendition order; nullptr
+   *                skips the rendition
+   * @param offset  Bytes of each buffer kept before its JPEG
+   * @return false if a requested rendition failed; its buffer is left at
+   *         offset bytes
+   */
+  bool encode(const cv::Mat &frame,
+              const std::vector<std::vector<uint8_t> *> &outputs,
+              size_t offset = 0);
+
+  /**
+   * @brief Output size of a rendition for a given frame size.
+   *
+   * Never upscales; widths are rounded to even.
+   */
+  static cv::Size renditionSize(const cv::Size &frame, int height);
+
+  /**
+   * @brief Parse "1080:85,540:75,270:60" (height:quality) into renditions
+   *        named "1080p", "540p", "270p".
+   *
+   * @return std::nullopt on syntax errors or out of range values
+   */
+  static std::optional<std::vector<Rendition>>
+  parse(const std::string &spec);
+
+  const std::vector<Rendition> &getRenditions() const { return renditions_; }
+
+  /**
+   * @brief Index of the rendition with this name, -1 if none.
+   */
+  int find(const std::string &name) const;
+
+  /**
+   * @brief Index of the highest rendition (full size first), -1 if none.
+   */
+  int largest() const {
+    return order_.empty() ? -1 : static_cast<int>(order_.front());
+  }
+
+  std::vector<RenditionStats> getStats() const;
+
+private:
+  std::vector<Rendition> renditions_;
+  std::vector<FrameEncoder> encoders_; ///< One per rendition
+  std::vector<size_t> order_;          ///< Rendition indices, largest first
+  std::vector<cv::Mat> levels_;
+  utils::ThreadPool pool_;
+
+  mutable std::mutex stats_mutex_;
+  std::vector<RenditionStats> stats_;
+};
+
+} // namespace visioncore::processing
+
+#endif // SIMULCAST_ENCODER_HPP
@@ -0,0 +1,299 @@
+/**
+ * @file StreamEngine.cpp
+ * @brief StreamEngine implementation
+ */
+
+#include "processing/StreamEngine.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "utils/Logger.hpp"
+
+namespace visioncore::processing {
+
+namespace {
+
+double toMs(std::chrono::steady_clock::duration d) {
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+
+} // namespace
+
+StreamEngine::StreamEngine(size_t workers) {
+  if (workers == 0) {
+    workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  workers_.reserve(workers);
+  for (size_t i = 0; i < workers; ++i) {
+    workers_.emplace_back(&StreamEngine::workerLoop, this);
+  }
+}
+
+StreamEngine::~StreamEngine() { stop(); }
+
+StreamId StreamEngine::addStream(std::unique_ptr<core::VideoSource> source,
+                                 double target_fps, FrameCallback callback,
+                                 const PipelineSetup &setup) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+      throw std::runtime_error("StreamEngine is stopped");
+    }
+  }
+
+  if (!source || !source->open()) {
+    throw std::runtime_error("Failed to open video source");
+  }
+
+  auto stream = std::make_shared<Stream>();
+  stream->source = std::move(source);
+  stream->callback = std::move(callback);
+  if (target_fps > 0.0) {
+    stream->period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / target_fps));
+  }
+
+  StreamId id = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    id = next_id_++;
+  }
+  stream->id = id;
+  stream->pipeline =
+      std::make_shared<pipeline::FramePipeline>("stream" + std::to_string(id));
+  if (setup) {
+    setup(*stream->pipeline);
+  }
+  stream->added = stream->deadline = Clock::now();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+      stream->source->close();
+      throw std::runtime_error("StreamEngine is stopped");
+    }
+    streams_.emplace(id, stream);
+    run_queue_.push({stream->deadline, id});
+  }
+  work_cv_.notify_one();
+
+  LOG_INFO("Stream " + std::to_string(id) + " added: " +
+           stream->source->getName() + " at " +
+           (target_fps > 0.0 ? std::to_string(target_fps) + " FPS"
+                             : std::string("max speed")));
+  return id;
+}
+
+bool StreamEngine::removeStream(StreamId id) {
+  std::shared_ptr<Stream> stream;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = streams_.find(id);
+    if (it == streams_.end() || it->second->removed) {
+      return false;
+    }
+
+    // Its run-queue entry, if any, is dropped when a worker pops it
+    stream = it->second;
+    stream->removed = true;
+
+    // Called from the stream's own callback: waiting for the frame would
+    // wait for ourselves. The worker closes the source once the callback
+    // returns.
+    if (stream->busy && stream->worker == std::this_thread::get_id()) {
+      stream->detached = true;
+      streams_.erase(it);
+      return true;
+    }
+  }
+
+  // Outside the lock: interrupt() may block on the source's own locks
+  stream->source->interrupt();
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [&] { return !stream->busy; });
+    streams_.erase(id);
+  }
+
+  stream->source->close();
+  LOG_INFO("Stream " + std::to_string(id) + " removed after " +
+           std::to_string(stream->stats.frames) + " frames");
+  return true;
+}
+
+std::shared_ptr<pipeline::FramePipeline>
+StreamEngine::getPipeline(StreamId id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = streams_.find(id);
+  return it != streams_.end() ? it->second->pipeline : nullptr;
+}
+
+std::optional<StreamStats> StreamEngine::getStats(StreamId id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = streams_.find(id);
+  if (it == streams_.end()) {
+    return std::nullopt;
+  }
+  return it->second->stats;
+}
+
+std::vector<StreamId> StreamEngine::getStreams() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<StreamId> ids;
+  ids.reserve(streams_.size());
+  for (const auto &entry : streams_) {
+    ids.push_back(entry.first);
+  }
+  return ids;
+}
+
+void StreamEngine::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    for (auto &entry : streams_) {
+      entry.second->source->interrupt(); // a worker may be waiting in it
+    }
+  }
+  work_cv_.notify_all();
+
+  for (auto &worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+  workers_.clear();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto &entry : streams_) {
+    entry.second->source->close();
+  }
+  streams_.clear();
+  run_queue_ = {};
+}
+
+void StreamEngine::workerLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (!stopping_) {
+    if (run_queue_.empty()) {
+      work_cv_.wait(lock);
+      continue;
+    }
+
+    const Slot slot = run_queue_.top();
+    if (slot.deadline > Clock::now()) {
+      // Woken early if an earlier deadline is queued meanwhile
+      work_cv_.wait_until(lock, slot.deadline);
+      continue;
+    }
+    run_queue_.pop();
+
+    const auto it = streams_.find(slot.id);
+    if (it == streams_.end() || it->second->removed) {
+      continue; // stale entry of a removed stream
+    }
+
+    const std::shared_ptr<Stream> stream = it->second;
+    const uint64_t frame_id = stream->stats.frames;
+    stream->busy = true;
+    stream->worker = std::this_thread::get_id();
+    lock.unlock();
+
+    const auto started = Clock::now();
+    const bool ok = processFrame(*stream, frame_id);
+
+    lock.lock();
+    rescheduleLocked(*stream, started, ok);
+    stream->busy = false;
+    idle_cv_.notify_all();
+
+    if (stream->detached) {
+      // Removed by its own callback, nobody else holds it anymore
+      lock.unlock();
+      stream->source->close();
+      LOG_INFO("Stream " + std::to_string(stream->id) + " removed after " +
+               std::to_string(stream->stats.frames) + " frames");
+      lock.lock();
+    }
+  }
+}
+
+bool StreamEngine::processFrame(Stream &stream, uint64_t frame_id) {
+  try {
+    if (!stream.source->readFrame(stream.input, stream.info)) {
+      LOG_INFO("Stream " + std::to_string(stream.id) + ": end of stream");
+      return false;
+    }
+
+    const auto result = stream.pipeline->process(stream.input, stream.output);
+    if (result.isErr()) {
+      if (result.error != pipeline::PipelineError::EmptyPipeline) {
+        LOG_WARNING("Stream " + std::to_string(stream.id) + ": " +
+                    result.message);
+        return true; // frame skipped, the stream goes on
+      }
+      stream.output = stream.input; // no filter: deliver the source frame
+    }
+
+    if (stream.callback) {
+      stream.callback(stream.id, stream.input, stream.output, frame_id);
+    }
+    return true;
+  } catch (const std::exception &e) {
+    LOG_ERROR("Stream " + std::to_string(stream.id) + " failed: " + e.what());
+    return false;
+  }
+}
+
+void StreamEngine::rescheduleLocked(Stream &stream, Clock::time_point started,
+                                    bool ok) {
+  StreamStats &stats = stream.stats;
+
+  if (!ok) {
+    stats.finished = true;
+    if (!stream.removed) {
+      stream.source->close(); // otherwise closed by removeStream()
+    }
+    return;
+  }
+
+  const auto now = Clock::now();
+  ++stats.frames;
+  const auto n = static_cast<double>(stats.frames);
+  const double latency_ms = toMs(now - stream.info.capture_time);
+
+  stats.avg_process_ms += (toMs(now - started) - stats.avg_process_ms) / n;
+  stats.avg_start_lag_ms +=
+      (toMs(started - stream.deadline) - stats.avg_start_lag_ms) / n;
+  stats.avg_latency_ms += (latency_ms - stats.avg_latency_ms) / n;
+  stats.max_latency_ms = std::max(stats.max_latency_ms, latency_ms);
+  stats.fps = n / std::max(1e-9, std::chrono::duration<double>(
+                                     now - stream.added)
+                                     .count());
+
+  if (stream.removed) {
+    return;
+  }
+
+  if (stream.period == Clock::duration::zero()) {
+    stream.deadline = now;
+  } else {
+    stream.deadline += stream.period;
+    if (stream.deadline < now) {
+      // Behind schedule: skip the missed frame times rather than bursting,
+      // the stream queues behind those already waiting
+      stats.missed_slots +=
+          static_cast<uint64_t>((now - stream.deadline) / stream.period);
+      stream.deadline = now;
+    }
+  }
+
+  run_queue_.push({stream.deadline, stream.id});
+}
+
+} // namespace visioncore::processing
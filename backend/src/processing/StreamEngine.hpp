@@ -0,0 +1,210 @@
+/**
+ * @file StreamEngine.hpp
+ * @brief Multi-stream engine: many source + pipeline pairs on one worker pool
+ *
+ * FrameController dedicates a thread to its single source. StreamEngine
+ * instead runs any number of streams on a fixed set of workers:
+ *  - each stream has a deadline (its next frame time, from its target fps);
+ *  - an idle worker takes the stream with the earliest due deadline, reads
+ *    one frame, runs the stream's pipeline and callback, then reschedules it;
+ *  - a stream that falls behind is rescheduled "now" instead of bursting to
+ *    catch up, so when the pool is overloaded due streams are served in
+ *    deadline order, i.e. round-robin, and all slow down evenly.
+ *
+ * A stream is never processed by two workers at once, so its frames are
+ * delivered in order. Streams can be added and removed at any time without
+ * pausing the others.
+ */
+
+#ifndef STREAM_ENGINE_HPP
+#define STREAM_ENGINE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "core/VideoSource.hpp"
+#include "pipeline/FramePipeline.hpp"
+
+namespace visioncore::processing {
+
+using StreamId = uint64_t;
+
+/**
+ * @brief Per-stream counters, in milliseconds where applicable.
+ */
+struct StreamStats {
+  uint64_t frames = 0;        ///< Frames read and processed
+  uint64_t missed_slots = 0;  ///< Frame times skipped because it fell behind
+  double avg_process_ms = 0.0;  ///< Read + pipeline + callback, mean
+  double avg_start_lag_ms = 0.0; ///< Deadline to pick-up by a worker, mean
+  double avg_latency_ms = 0.0;   ///< Capture to end of callback, mean
+  double max_latency_ms = 0.0;   ///< Capture to end of callback, worst
+  double fps = 0.0;           ///< Delivered frames per second since added
+  bool finished = false;      ///< End of stream or error, no longer scheduled
+};
+
+class StreamEngine {
+public:
+  /**
+   * @brief Callback invoked for each processed frame of a stream.
+   *
+   * Called on a pool worker; frames of one stream never overlap.
+   *
+   * @param stream    Stream the frame belongs to
+   * @param original  Source frame, read-only
+   * @param processed Pipeline output
+   * @param frame_id  Monotonic frame identifier within the stream
+   */
+  using FrameCallback =
+      std::function<void(StreamId stream, const cv::Mat &original,
+                         const cv::Mat &processed, uint64_t frame_id)>;
+
+  /**
+   * @brief Configures the filters of a new stream before it is scheduled.
+   */
+  using PipelineSetup = std::function<void(pipeline::FramePipeline &)>;
+
+  /**
+   * @brief Start the worker pool.
+   *
+   * @param workers Number of worker threads, 0 = one per core
+   */
+  explicit StreamEngine(size_t workers = 0);
+
+  /**
+   * @brief Stops the engine and closes every source.
+   */
+  ~StreamEngine();
+
+  StreamEngine(const StreamEngine &) = delete;
+  StreamEngine &operator=(const StreamEngine &) = delete;
+
+  /**
+   * @brief Open a source and schedule it immediately.
+   *
+   * Filters are added by setup before the first frame, and can be changed
+   * later through getPipeline(). An empty pipeline delivers the source
+   * frames unchanged.
+   *
+   * @param source     Video source (ownership transferred)
+   * @param target_fps Frame rate of the stream (0 = as fast as the pool can)
+   * @param callback   Invoked for each processed frame
+   * @param setup      Optional pipeline configuration
+   * @return Identifier of the new stream
+   *
+   * @throws std::runtime_error if the engine is stopped or the source fails
+   */
+  StreamId addStream(std::unique_ptr<core::VideoSource> source,
+                     double target_fps, FrameCallback callback,
+                     const PipelineSetup &setup = {});
+
+  /**
+   * @brief Unschedule a stream and close its source.
+   *
+   * Waits for the frame being processed, if any; once this returns the
+   * callback is no longer invoked for the stream. May be called from the
+   * stream's own callback: the stream is then unscheduled at once and its
+   * source closed when the callback returns.
+   *
+   * @return false if the stream does not exist or is already being removed
+   */
+  bool removeStream(StreamId id);
+
+  /**
+   * @brief Processing pipeline of a stream, nullptr if it does not exist.
+   *
+   * The pipeline stays valid after the stream is removed.
+   */
+  std::shared_ptr<pipeline::FramePipeline> getPipeline(StreamId id) const;
+
+  /**
+   * @brief Counters of a stream, std::nullopt if it does not exist.
+   */
+  std::optional<StreamStats> getStats(StreamId id) const;
+
+  /**
+   * @brief Identifiers of the streams currently registered.
+   */
+  std::vector<StreamId> getStreams() const;
+
+  size_t getWorkerCount() const { return workers_.size(); }
+
+  /**
+   * @brief Stop the workers and close every source. Irreversible.
+   */
+  void stop();
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Stream {
+    StreamId id = 0;
+    std::unique_ptr<core::VideoSource> source;
+    std::shared_ptr<pipeline::FramePipeline> pipeline;
+    FrameCallback callback;
+    Clock::duration period{0}; ///< Zero for unpaced streams
+
+    Clock::time_point deadline; ///< Next frame time
+    Clock::time_point added;
+    bool busy = false;     ///< A worker is processing it
+    bool removed = false;  ///< removeStream() waiting or done
+    bool detached = false; ///< Removed from its own callback
+    std::thread::id worker; ///< Worker processing it while busy
+
+    cv::Mat input;  ///< Reused by the worker holding the stream
+    cv::Mat output;
+    core::FrameInfo info;
+    StreamStats stats;
+  };
+
+  /// Run-queue entry, earliest deadline first
+  struct Slot {
+    Clock::time_point deadline;
+    StreamId id;
+    bool operator>(const Slot &other) const {
+      return deadline > other.deadline;
+    }
+  };
+
+  mutable std::mutex mutex_;
+  std::condition_variable work_cv_; ///< Run queue changed or stopping
+  std::condition_variable idle_cv_; ///< A stream stopped being busy
+  std::unordered_map<StreamId, std::shared_ptr<Stream>> streams_;
+  std::priority_queue<Slot, std::vector<Slot>, std::greater<>> run_queue_;
+  StreamId next_id_ = 1;
+  bool stopping_ = false;
+
+  std::vector<std::thread> workers_;
+
+  /**
+   * @brief Worker thread body.
+   */
+  void workerLoop();
+
+  /**
+   * @brief Read, process and deliver one frame (without the lock held).
+   * @return false at end of stream or on error
+   */
+  static bool processFrame(Stream &stream, uint64_t frame_id);
+
+  /**
+   * @brief Update statistics and requeue a stream after a frame.
+   */
+  void rescheduleLocked(Stream &stream, Clock::time_point started,
+                        bool ok);
+};
+
+} // namespace visioncore::processing
+
+#endif // STREAM_ENGINE_HPP
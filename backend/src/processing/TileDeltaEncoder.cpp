@@ -0,0 +1,231 @@
+/**
+ * @file TileDeltaEncoder.cpp
+ * @brief TileDeltaEncoder implementation
+ */
+
+#include "processing/TileDeltaEncoder.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <opencv2/imgproc.hpp>
+
+#include "processing/FrameEncoder.hpp"
+
+namespace visioncore::processing {
+
+namespace {
+
+constexpr char kMagic[4] = {'V', 'C', 'T', 'D'};
+constexpr uint8_t kVersion = 1;
+constexpr uint8_t kKeyframeFlag = 0x01;
+constexpr size_t kHeaderBytes = 16;
+constexpr size_t kPatchHeaderBytes = 12;
+constexpr double kRatioWeight = 0.1; ///< changed_ratio smoothing
+
+TileDeltaOptions normalized(TileDeltaOptions options) {
+  // MCU aligned, so patch edges fall on the same blocks as a keyframe's
+  options.tile_size = std::max(16, options.tile_size / 16 * 16);
+  return options;
+}
+
+void put16(std::vector<uint8_t> &out, uint32_t value) {
+  out.push_back(static_cast<uint8_t>(value));
+  out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void put32(std::vector<uint8_t> &out, uint32_t value) {
+  put16(out, value & 0xFFFF);
+  put16(out, value >> 16);
+}
+
+void set32(std::vector<uint8_t> &out, size_t at, uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    out[at + i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+uint32_t get16(const uint8_t *p) { return p[0] | p[1] << 8; }
+
+uint32_t get32(const uint8_t *p) { return get16(p) | get16(p + 2) << 16; }
+
+} // namespace
+
+TileDeltaEncoder::TileDeltaEncoder(const TileDeltaOptions &options)
+    : options_(normalized(options)) {}
+
+bool TileDeltaEncoder::encode(const cv::Mat &frame, const EncodeSpec &spec,
+                              std::vector<uint8_t> &out, size_t offset) {
+  if (offset > out.size()) {
+    return false;
+  }
+  out.resize(offset);
+  if (frame.empty() || frame.depth() != CV_8U || frame.cols > 0xFFFF ||
+      frame.rows > 0xFFFF) {
+    return false;
+  }
+
+  const cv::Mat *source = &frame;
+  if (!spec.size.empty() && spec.size != frame.size()) {
+    const bool shrink = spec.size.area() < frame.size().area();
+    cv::resize(frame, scaled_, spec.size, 0, 0,
+               shrink ? cv::INTER_AREA : cv::INTER_LINEAR);
+    source = &scaled_;
+  }
+
+  bool keyframe = keyframe_requested_.exchange(false) || reference_.empty() ||
+                  reference_.size() != source->size() ||
+                  reference_.type() != source->type() ||
+                  (options_.keyframe_interval > 0 &&
+                   since_keyframe_ + 1 >= options_.keyframe_interval);
+
+  size_t changed = 0;
+  size_t total = 0;
+  if (!keyframe) {
+    changed = findChanges(*source, total);
+    const double ratio = static_cast<double>(changed) / total;
+    {
+      std::lock_guard<std::mutex> lock(stats_mutex_);
+      stats_.changed_ratio += kRatioWeight * (ratio - stats_.changed_ratio);
+    }
+    if (changed == 0) {
+      ++since_keyframe_;
+      std::lock_guard<std::mutex> lock(stats_mutex_);
+      ++stats_.unchanged;
+      return true;
+    }
+    keyframe = ratio > options_.keyframe_ratio;
+  }
+  if (keyframe) {
+    patches_.assign(1, cv::Rect(0, 0, source->cols, source->rows));
+  }
+
+  out.insert(out.end(), kMagic, kMagic + sizeof(kMagic));
+  out.push_back(kVersion);
+  out.push_back(keyframe ? kKeyframeFlag : 0);
+  put16(out, static_cast<uint32_t>(patches_.size()));
+  put32(out, sequence_);
+  put16(out, source->cols);
+  put16(out, source->rows);
+
+  // Each JPEG is written in place after its patch header
+  const FrameEncoder encoder(spec.quality, spec.jpeg);
+  for (const cv::Rect &rect : patches_) {
+    put16(out, rect.x);
+    put16(out, rect.y);
+    put16(out, rect.width);
+    put16(out, rect.height);
+    const size_t size_at = out.size();
+    put32(out, 0);
+
+    if (!encoder.encodeJPEG((*source)(rect), out, out.size())) {
+      // The clients may now miss tiles, start over from a keyframe
+      reference_.release();
+      out.resize(offset);
+      return false;
+    }
+    set32(out, size_at, static_cast<uint32_t>(out.size() - size_at - 4));
+  }
+
+  if (keyframe) {
+    source->copyTo(reference_);
+    since_keyframe_ = 0;
+  } else {
+    for (const cv::Rect &rect : patches_) {
+      (*source)(rect).copyTo(reference_(rect));
+    }
+    ++since_keyframe_;
+  }
+  ++sequence_;
+
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  ++stats_.frames;
+  if (keyframe) {
+    ++stats_.keyframes;
+  } else {
+    stats_.patches += patches_.size();
+  }
+  return true;
+}
+
+size_t TileDeltaEncoder::findChanges(const cv::Mat &frame,
+                                     size_t &total_tiles) {
+  const int tile = options_.tile_size;
+  size_t changed = 0;
+  total_tiles = 0;
+  patches_.clear();
+
+  for (int y = 0; y < frame.rows; y += tile) {
+    const int height = std::min(tile, frame.rows - y);
+    int run_start = -1; // first column of the current run of changed tiles
+
+    for (int x = 0; x < frame.cols; x += tile) {
+      const cv::Rect rect(x, y, std::min(tile, frame.cols - x), height);
+      ++total_tiles;
+
+      // Largest per-channel difference, SIMD in OpenCV, no temporaries
+      if (cv::norm(frame(rect), reference_(rect), cv::NORM_INF) >
+          options_.pixel_threshold) {
+        ++changed;
+        if (run_start < 0) {
+          run_start = x;
+        }
+      } else if (run_start >= 0) {
+        patches_.emplace_back(run_start, y, x - run_start, height);
+        run_start = -1;
+      }
+    }
+    if (run_start >= 0) {
+      patches_.emplace_back(run_start, y, frame.cols - run_start, height);
+    }
+  }
+  return changed;
+}
+
+TileDeltaStats TileDeltaEncoder::getStats() const {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  return stats_;
+}
+
+bool TileDeltaEncoder::isPacket(const uint8_t *data, size_t size) {
+  return size >= sizeof(kMagic) &&
+         std::memcmp(data, kMagic, sizeof(kMagic)) == 0;
+}
+
+bool TileDeltaEncoder::parse(const uint8_t *data, size_t size,
+                             TileDeltaHeader &header,
+                             std::vector<TilePatch> &patches) {
+  patches.clear();
+  if (size < kHeaderBytes || !isPacket(data, size) || data[4] != kVersion) {
+    return false;
+  }
+
+  header.keyframe = (data[5] & kKeyframeFlag) != 0;
+  const uint32_t count = get16(data + 6);
+  header.sequence = get32(data + 8);
+  header.frame_size = cv::Size(get16(data + 12), get16(data + 14));
+  const cv::Rect frame_rect(cv::Point(0, 0), header.frame_size);
+
+  size_t offset = kHeaderBytes;
+  for (uint32_t i = 0; i < count; ++i) {
+    if (size - offset < kPatchHeaderBytes) {
+      return false;
+    }
+    const uint8_t *p = data + offset;
+    TilePatch patch;
+    patch.rect = cv::Rect(get16(p), get16(p + 2), get16(p + 4), get16(p + 6));
+    patch.jpeg_size = get32(p + 8);
+    offset += kPatchHeaderBytes;
+
+    if (patch.rect.empty() || (patch.rect & frame_rect) != patch.rect ||
+        size - offset < patch.jpeg_size) {
+      return false;
+    }
+    patch.jpeg = data + offset;
+    offset += patch.jpeg_size;
+    patches.push_back(patch);
+  }
+  return offset == size;
+}
+
+} // namespace visioncore::processing
@@ -0,0 +1,158 @@
+/**
+ * @file TileDeltaEncoder.hpp
+ * @brief Stream only the regions of a frame that changed since the last send
+ *
+ * The frame is divided into fixed tiles. Each tile is compared with a
+ * reference holding what the clients last received for it (cv::norm,
+ * vectorized by OpenCV); tiles whose largest pixel difference exceeds the
+ * threshold are JPEG-encoded and sent with their position. Consecutive
+ * changed tiles of a row are merged into one patch, saving JPEG headers.
+ *
+ * The reference is only updated for tiles actually sent, so slow drift
+ * below the threshold accumulates until the tile is refreshed.
+ *
+ * A keyframe (one patch covering the whole frame) is sent on the first
+ * frame, on size or type changes, periodically, on request (new client,
+ * dropped message) and when most tiles changed anyway.
+ *
+ * Packet layout, little endian:
+ *
+ *   offset size
+ *    0     4   "VCTD"
+ *    4     1   version (1)
+ *    5     1   flags, bit 0 = keyframe
+ *    6     2   patch count
+ *    8     4   sequence number
+ *   12     2   frame width
+ *   14     2   frame height
+ *   then for each patch:
+ *    0     2   x
+ *    2     2   y
+ *    4     2   width
+ *    6     2   height
+ *    8     4   JPEG size
+ *   12     n   JPEG data
+ */
+
+#ifndef TILE_DELTA_ENCODER_HPP
+#define TILE_DELTA_ENCODER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "processing/EncodedFrameCache.hpp"
+
+namespace visioncore::processing {
+
+/**
+ * @brief Tile comparison and keyframe settings.
+ */
+struct TileDeltaOptions {
+  int tile_size = 64;          ///< Tile edge, rounded to a multiple of 16
+  int pixel_threshold = 16;    ///< Largest difference treated as noise
+  int keyframe_interval = 300; ///< Frames between keyframes, 0 = never
+  double keyframe_ratio = 0.6; ///< Changed tile share above which a
+                               ///< keyframe is cheaper than patches
+};
+
+/**
+ * @brief Delta encoder counters.
+ */
+struct TileDeltaStats {
+  uint64_t frames = 0;        ///< Packets produced
+  uint64_t keyframes = 0;     ///< Of which keyframes
+  uint64_t unchanged = 0;     ///< Frames with nothing to send
+  uint64_t patches = 0;       ///< JPEG patches in delta packets
+  double changed_ratio = 0.0; ///< Changed tile share, moving average
+};
+
+/**
+ * @brief One region of a parsed packet, pointing into the packet.
+ */
+struct TilePatch {
+  cv::Rect rect;
+  const uint8_t *jpeg = nullptr;
+  size_t jpeg_size = 0;
+};
+
+/**
+ * @brief Parsed packet header.
+ */
+struct TileDeltaHeader {
+  bool keyframe = false;
+  uint32_t sequence = 0;
+  cv::Size frame_size;
+};
+
+class TileDeltaEncoder {
+public:
+  explicit TileDeltaEncoder(const TileDeltaOptions &options = {});
+
+  TileDeltaEncoder(const TileDeltaEncoder &) = delete;
+  TileDeltaEncoder &operator=(const TileDeltaEncoder &) = delete;
+
+  /**
+   * @brief Encode the changes of a frame into a packet.
+   *
+   * Not thread-safe: one caller at a time. The frame is resized to
+   * spec.size when set; quality and JPEG options apply to every patch.
+   *
+   * @param frame  8-bit frame, 1, 3 or 4 channels
+   * @param spec   JPEG settings (codec is ignored)
+   * @param out    Packet, written after its first offset bytes; nothing is
+   *               added when no tile changed
+   * @param offset Bytes of out kept before the packet (e.g. a header)
+   * @return false if the frame is empty or a patch failed to encode (the
+   *         next frame is then a keyframe)
+   */
+  bool encode(const cv::Mat &frame, const EncodeSpec &spec,
+              std::vector<uint8_t> &out, size_t offset = 0);
+
+  /**
+   * @brief Make the next packet a keyframe. Safe from any thread.
+   */
+  void requestKeyframe() { keyframe_requested_ = true; }
+
+  TileDeltaStats getStats() const;
+
+  /**
+   * @brief Split a packet into its header and patches.
+   *
+   * @return false if the packet is truncated or not a tile delta packet
+   */
+  static bool parse(const uint8_t *data, size_t size, TileDeltaHeader &header,
+                    std::vector<TilePatch> &patches);
+
+  /**
+   * @brief True if the buffer starts with the packet magic.
+   */
+  static bool isPacket(const uint8_t *data, size_t size);
+
+private:
+  const TileDeltaOptions options_;
+
+  cv::Mat reference_; ///< Content of the last sent tiles
+  cv::Mat scaled_;    ///< Resize buffer
+  std::vector<cv::Rect> patches_;
+  uint32_t sequence_ = 0;
+  int since_keyframe_ = 0;
+  std::atomic<bool> keyframe_requested_{false};
+
+  mutable std::mutex stats_mutex_;
+  TileDeltaStats stats_;
+
+  /**
+   * @brief Collect the changed tiles, merged into row runs.
+   *
+   * @return Number of changed tiles
+   */
+  size_t findChanges(const cv::Mat &frame, size_t &total_tiles);
+};
+
+} // namespace visioncore::processing
+
+#endif // TILE_DELTA_ENCODER_HPP
@@ -0,0 +1,50 @@
+/**
+ * @file FrameSink.hpp
+ * @brief Interface for frame consumers that outlive the frame callback
+ *
+ * A sink receives the processed frames of a FrameController (typically from
+ * its frame callback) and persists or forwards them. write() is called on
+ * the processing thread and must not block it on I/O: implementations copy
+ * the frame and do the slow work elsewhere.
+ */
+
+#ifndef FRAME_SINK_HPP
+#define FRAME_SINK_HPP
+
+#include <opencv2/core.hpp>
+#include <string>
+
+namespace visioncore::sinks {
+
+class FrameSink {
+public:
+  virtual ~FrameSink() = default;
+
+  /**
+   * @brief Prepare the sink (create files, start threads)
+   * @return true on success
+   */
+  virtual bool open() = 0;
+
+  /**
+   * @brief Hand a frame to the sink
+   *
+   * The frame is not referenced after the call returns.
+   *
+   * @return false if the frame was rejected or dropped
+   */
+  virtual bool write(const cv::Mat &frame) = 0;
+
+  /**
+   * @brief Flush pending frames and release resources
+   */
+  virtual void close() = 0;
+
+  virtual bool isOpened() const = 0;
+
+  virtual std::string getName() const = 0;
+};
+
+} // namespace visioncore::sinks
+
+#endif // FRAME_SINK_HPP
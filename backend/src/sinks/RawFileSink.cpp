@@ -0,0 +1,207 @@
+/**
+ * @file RawFileSink.cpp
+ * @brief RawFileSink implementation
+ */
+
+#include "RawFileSink.hpp"
+#include "../utils/Logger.hpp"
+
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <opencv2/imgproc.hpp>
+#include <unistd.h>
+
+namespace visioncore::sinks {
+
+namespace {
+
+constexpr char kFrameMarker[] = "FRAME\n";
+
+bool hasY4MExtension(const std::string &path) {
+  const size_t dot = path.rfind('.');
+  if (dot == std::string::npos) {
+    return false;
+  }
+  std::string ext = path.substr(dot + 1);
+  for (char &c : ext) {
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  }
+  return ext == "y4m";
+}
+
+} // namespace
+
+RawFileSink::RawFileSink(const std::string &path, double fps,
+                         const RawSinkOptions &options)
+    : path_(path), fps_(fps), options_(options), y4m_(hasY4MExtension(path)),
+      pool_(options.queue_depth + 2) {}
+
+RawFileSink::~RawFileSink() { close(); }
+
+bool RawFileSink::open() {
+  if (isOpened()) {
+    close();
+  }
+
+  fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    LOG_ERROR("Cannot create " + path_ + ": " + std::strerror(errno));
+    return false;
+  }
+
+  has_format_ = false;
+  frame_type_ = -1;
+  failed_ = false;
+  written_ = 0;
+  dropped_ = 0;
+  bytes_ = 0;
+
+  queue_ = std::make_unique<utils::ThreadSafeQueue<cv::Mat>>(
+      options_.queue_depth > 0 ? options_.queue_depth : 1);
+  writer_ = std::thread(&RawFileSink::writerLoop, this);
+
+  LOG_INFO("Recording " + std::string(y4m_ ? "Y4M" : "VCRAW") + " to " +
+           path_);
+  return true;
+}
+
+bool RawFileSink::setFormat(const cv::Mat &frame) {
+  if (frame.depth() != CV_8U ||
+      (frame.channels() != 1 && frame.channels() != 3)) {
+    LOG_ERROR("Raw recording needs 8-bit gray or BGR frames");
+    return false;
+  }
+
+  header_.container = y4m_ ? core::RawVideoHeader::Container::Y4M
+                           : core::RawVideoHeader::Container::VCRAW;
+  if (frame.channels() == 1) {
+    header_.pixel = core::RawVideoHeader::Pixel::GRAY;
+  } else {
+    header_.pixel = y4m_ ? core::RawVideoHeader::Pixel::I420
+                         : core::RawVideoHeader::Pixel::BGR;
+  }
+
+  if (header_.pixel == core::RawVideoHeader::Pixel::I420 &&
+      (frame.cols % 2 != 0 || frame.rows % 2 != 0)) {
+    LOG_ERROR("Y4M 4:2:0 recording needs even frame dimensions");
+    return false;
+  }
+
+  header_.width = frame.cols;
+  header_.height = frame.rows;
+  core::fpsToRational(fps_, header_.fps_num, header_.fps_den);
+  header_text_ = core::formatRawHeader(header_);
+  frame_type_ = frame.type();
+  has_format_ = true;
+  return true;
+}
+
+bool RawFileSink::write(const cv::Mat &frame) {
+  if (!isOpened() || failed_ || frame.empty()) {
+    return false;
+  }
+
+  if (!has_format_ && !setFormat(frame)) {
+    ++dropped_;
+    return false;
+  }
+
+  if (frame.type() != frame_type_ || frame.cols != header_.width ||
+      frame.rows != header_.height) {
+    ++dropped_;
+    return false;
+  }
+
+  // Copy on the caller thread, everything else on the writer
+  cv::Mat &slot = pool_.acquire();
+  if (header_.pixel == core::RawVideoHeader::Pixel::I420) {
+    cv::cvtColor(frame, slot, cv::COLOR_BGR2YUV_I420);
+  } else {
+    frame.copyTo(slot);
+  }
+
+  const bool queued = options_.drop_when_full ? queue_->tryPush(slot)
+                                              : queue_->push(slot);
+  if (!queued) {
+    ++dropped_;
+  }
+  return queued;
+}
+
+void RawFileSink::writerLoop() {
+  bool header_written = false;
+  cv::Mat frame;
+
+  while (queue_->pop(frame)) {
+    if (failed_) {
+      ++dropped_;
+      continue; // keep draining so write() never blocks forever
+    }
+
+    bool ok = true;
+    if (!header_written) {
+      ok = writeAll(header_text_.data(), header_text_.size());
+      header_written = true;
+    }
+    if (ok && y4m_) {
+      ok = writeAll(kFrameMarker, sizeof(kFrameMarker) - 1);
+    }
+    if (ok) {
+      ok = writeAll(frame.data, frame.total() * frame.elemSize());
+    }
+
+    if (ok) {
+      ++written_;
+    } else {
+      LOG_ERROR("Failed to write frame to " + path_ + ": " +
+                std::strerror(errno));
+      failed_ = true;
+      ++dropped_;
+    }
+    frame.release(); // hand the buffer back to the pool
+  }
+}
+
+bool RawFileSink::writeAll(const void *data, size_t size) {
+  const char *bytes = static_cast<const char *>(data);
+
+  while (size > 0) {
+    const ssize_t n = ::write(fd_, bytes, size);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    bytes += n;
+    size -= static_cast<size_t>(n);
+    bytes_ += static_cast<uint64_t>(n);
+  }
+  return true;
+}
+
+void RawFileSink::close() {
+  if (!isOpened()) {
+    return;
+  }
+
+  queue_->close(); // the writer drains what is left, then exits
+  if (writer_.joinable()) {
+    writer_.join();
+  }
+  queue_.reset();
+
+  ::close(fd_);
+  fd_ = -1;
+
+  LOG_INFO("Recording to " + path_ + " closed: " + std::to_string(written_) +
+           " frames, " + std::to_string(dropped_) + " dropped");
+}
+
+bool RawFileSink::isOpened() const { return fd_ >= 0; }
+
+std::string RawFileSink::getName() const { return path_; }
+
+} // namespace visioncore::sinks
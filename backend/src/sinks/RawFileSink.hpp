@@ -0,0 +1,117 @@
+/**
+ * @file RawFileSink.hpp
+ * @brief Records frames to a Y4M or VCRAW file on a background thread
+ *
+ * The container is picked from the file extension: ".y4m" writes YUV4MPEG2
+ * (BGR frames converted to 4:2:0, gray frames as mono), anything else writes
+ * VCRAW, the raw BGR/gray dump that core::RawFileSource replays without any
+ * conversion. The frame size and type are fixed by the first frame.
+ *
+ * write() only copies the frame into a pooled buffer and queues it; a writer
+ * thread does the file I/O, so recording does not stall the pipeline.
+ */
+
+#ifndef RAW_FILE_SINK_HPP
+#define RAW_FILE_SINK_HPP
+
+#include "FrameSink.hpp"
+#include "../core/RawFormat.hpp"
+#include "../utils/FramePool.hpp"
+#include "../utils/ThreadSafeQueue.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+namespace visioncore::sinks {
+
+/**
+ * @brief Buffering settings for RawFileSink
+ */
+struct RawSinkOptions {
+  size_t queue_depth = 8;      ///< Frames buffered ahead of the writer
+  bool drop_when_full = false; ///< Drop instead of blocking the caller
+};
+
+class RawFileSink : public FrameSink {
+public:
+  /**
+   * @brief Constructs a raw file sink
+   *
+   * The file is not created until open() is called.
+   *
+   * @param path Output file, ".y4m" for Y4M, anything else for VCRAW
+   * @param fps Frame rate stored in the header
+   * @param options Buffering settings
+   */
+  RawFileSink(const std::string &path, double fps,
+              const RawSinkOptions &options = {});
+
+  ~RawFileSink() override;
+
+  RawFileSink(const RawFileSink &) = delete;
+  RawFileSink &operator=(const RawFileSink &) = delete;
+
+  // FrameSink implementation
+  bool open() override;
+  bool write(const cv::Mat &frame) override;
+  void close() override;
+  bool isOpened() const override;
+  std::string getName() const override;
+
+  /**
+   * @brief Frames written to the file so far
+   */
+  uint64_t getWrittenCount() const { return written_; }
+
+  /**
+   * @brief Frames rejected (size/type change) or dropped (queue full)
+   */
+  uint64_t getDroppedCount() const { return dropped_; }
+
+  /**
+   * @brief Bytes written to the file, header included
+   */
+  uint64_t getBytesWritten() const { return bytes_; }
+
+private:
+  std::string path_;
+  double fps_;
+  RawSinkOptions options_;
+  bool y4m_;
+
+  int fd_ = -1;
+  bool has_format_ = false; ///< Set by the first frame
+  core::RawVideoHeader header_;
+  std::string header_text_; ///< Written by the writer before frame 0
+  int frame_type_ = -1;
+
+  utils::FramePool pool_;
+  std::unique_ptr<utils::ThreadSafeQueue<cv::Mat>> queue_;
+  std::thread writer_;
+  std::atomic<bool> failed_{false};
+
+  std::atomic<uint64_t> written_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> bytes_{0};
+
+  /**
+   * @brief Fix the output format from the first frame
+   */
+  bool setFormat(const cv::Mat &frame);
+
+  /**
+   * @brief Writer thread body
+   */
+  void writerLoop();
+
+  /**
+   * @brief write() until everything is out or an error occurs
+   */
+  bool writeAll(const void *data, size_t size);
+};
+
+} // namespace visioncore::sinks
+
+#endif // RAW_FILE_SINK_HPP
@@ -0,0 +1,338 @@
+/**
+ * @file RecordingSink.cpp
+ * @brief RecordingSink implementation
+ */
+
+#include "RecordingSink.hpp"
+#include "../core/RawFormat.hpp"
+#include "../utils/Logger.hpp"
+
+#include <cctype>
+#include <cstdio>
+#include <opencv2/imgproc.hpp>
+
+namespace visioncore::sinks {
+
+namespace {
+
+constexpr char kFrameMarker[] = "FRAME\n";
+
+std::string lowerExtension(const std::string &path) {
+  const size_t dot = path.rfind('.');
+  if (dot == std::string::npos || path.find('/', dot) != std::string::npos) {
+    return {};
+  }
+  std::string ext = path.substr(dot + 1);
+  for (char &c : ext) {
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  }
+  return ext;
+}
+
+} // namespace
+
+RecordingSink::RecordingSink(const std::string &path, double fps,
+                             const RecordingOptions &options)
+    : path_(path), fps_(fps), options_(options),
+      y4m_(lowerExtension(path) == "y4m"),
+      rotate_(options.segment_bytes > 0 || options.segment_seconds > 0.0),
+      pool_(options.queue_depth + 2), encoder_(options.jpeg_quality) {
+  if (options_.queue_depth == 0) {
+    options_.queue_depth = 1;
+  }
+}
+
+RecordingSink::~RecordingSink() { close(); }
+
+bool RecordingSink::open() {
+  if (isOpened()) {
+    close();
+  }
+  if (fps_ <= 0.0) {
+    LOG_ERROR("Invalid recording frame rate for " + path_);
+    return false;
+  }
+
+  failed_ = false;
+  written_ = 0;
+  dropped_ = 0;
+  bytes_ = 0;
+  segments_ = 0;
+
+  queue_ = std::make_unique<utils::ThreadSafeQueue<Item>>(options_.queue_depth);
+  writer_ = std::thread(&RecordingSink::writerLoop, this);
+  opened_ = true;
+
+  LOG_INFO("Recording " + std::string(y4m_ ? "Y4M" : "MJPEG AVI") + " to " +
+           path_ + (rotate_ ? " (segmented)" : ""));
+  return true;
+}
+
+bool RecordingSink::write(const cv::Mat &frame) {
+  if (!isOpened() || failed_ || frame.empty()) {
+    return false;
+  }
+
+  // Formats the writer cannot store are rejected here, not queued
+  const bool gray = frame.channels() == 1;
+  if (frame.depth() != CV_8U || (!gray && frame.channels() != 3) ||
+      (y4m_ && !gray && (frame.cols % 2 != 0 || frame.rows % 2 != 0))) {
+    ++dropped_;
+    return false;
+  }
+
+  // Copy on the caller thread, encode and convert on the writer
+  cv::Mat &slot = pool_.acquire();
+  frame.copyTo(slot);
+
+  Item item;
+  item.frame = slot;
+  item.size = frame.size();
+  item.type = frame.type();
+  item.time = std::chrono::steady_clock::now();
+  return enqueue(std::move(item));
+}
+
+bool RecordingSink::writeEncoded(Buffer jpeg, size_t offset,
+                                 const cv::Size &size) {
+  if (!isOpened() || failed_) {
+    return false;
+  }
+  if (y4m_ || !jpeg || jpeg->size() <= offset || size.width <= 0 ||
+      size.height <= 0) {
+    ++dropped_;
+    return false;
+  }
+
+  Item item;
+  item.jpeg = std::move(jpeg);
+  item.offset = offset;
+  item.size = size;
+  item.time = std::chrono::steady_clock::now();
+  return enqueue(std::move(item));
+}
+
+bool RecordingSink::enqueue(Item item) {
+  switch (options_.drop) {
+  case DropPolicy::BLOCK:
+    if (queue_->push(std::move(item))) {
+      return true;
+    }
+    break;
+  case DropPolicy::DROP_NEWEST:
+    if (queue_->tryPush(std::move(item))) {
+      return true;
+    }
+    break;
+  case DropPolicy::DROP_OLDEST: {
+    // The writer may take an item meanwhile, so retry until it fits
+    Item oldest;
+    while (!queue_->tryPush(item)) {
+      if (queue_->isClosed()) {
+        ++dropped_;
+        return false;
+      }
+      if (queue_->tryPop(oldest)) {
+        ++dropped_;
+      }
+    }
+    return true;
+  }
+  }
+  ++dropped_;
+  return false;
+}
+
+void RecordingSink::writerLoop() {
+  Item item;
+
+  while (queue_->pop(item)) {
+    if (failed_) {
+      ++dropped_;
+      continue; // keep draining so write() never blocks forever
+    }
+
+    if (writeItem(item)) {
+      ++written_;
+    } else {
+      LOG_ERROR("Failed to record frame to " + path_);
+      failed_ = true;
+      ++dropped_;
+    }
+    item = Item{}; // hand the buffers back to their pools
+  }
+  closeSegment();
+}
+
+bool RecordingSink::writeItem(const Item &item) {
+  // Rotate on format change, duration or size
+  bool rotate = !segmentOpen() || item.size != segment_size_ ||
+                (y4m_ && item.type != segment_type_);
+  if (!rotate && options_.segment_seconds > 0.0) {
+    rotate = std::chrono::duration<double>(item.time - segment_start_)
+                 .count() >= options_.segment_seconds;
+  }
+
+  // JPEG bytes of the frame, encoded here if given as pixels
+  const uint8_t *data = nullptr;
+  size_t size = 0;
+  if (!y4m_) {
+    if (item.jpeg) {
+      data = item.jpeg->data() + item.offset;
+      size = item.jpeg->size() - item.offset;
+    } else {
+      if (!encoder_.encodeJPEG(item.frame, encoded_)) {
+        return false;
+      }
+      data = encoded_.data();
+      size = encoded_.size();
+    }
+  } else if (item.type == CV_8UC3) {
+    cv::cvtColor(item.frame, converted_, cv::COLOR_BGR2YUV_I420);
+    data = converted_.data;
+    size = converted_.total() * converted_.elemSize();
+  } else {
+    data = item.frame.data;
+    size = item.frame.total() * item.frame.elemSize();
+  }
+
+  if (!rotate && options_.segment_bytes > 0 && segment_bytes_ > 0) {
+    rotate = segment_bytes_ + size > options_.segment_bytes;
+  }
+  if (rotate && !startSegment(item)) {
+    return false;
+  }
+
+  uint64_t before = segment_bytes_;
+  if (y4m_) {
+    y4m_out_.write(kFrameMarker, sizeof(kFrameMarker) - 1);
+    y4m_out_.write(reinterpret_cast<const char *>(data),
+                   static_cast<std::streamsize>(size));
+    if (!y4m_out_) {
+      return false;
+    }
+    segment_bytes_ += sizeof(kFrameMarker) - 1 + size;
+  } else {
+    bool ok = avi_.writeFrame(data, size);
+    if (!ok && avi_.getFrameCount() > 0 && startSegment(item)) {
+      // Past the AVI 4 GiB limit, go on in a new segment
+      before = segment_bytes_;
+      ok = avi_.writeFrame(data, size);
+    }
+    if (!ok) {
+      return false;
+    }
+    segment_bytes_ = avi_.getBytesWritten();
+  }
+  bytes_ += segment_bytes_ - before;
+  return true;
+}
+
+bool RecordingSink::startSegment(const Item &item) {
+  closeSegment();
+
+  const uint32_t index = segments_;
+  const bool numbered = rotate_ || index > 0;
+  const std::string path = numbered ? segmentPath(path_, index) : path_;
+  if (index > 0 && !rotate_) {
+    LOG_WARNING("Frame format changed, recording continues in " + path);
+  }
+
+  if (y4m_) {
+    core::RawVideoHeader header;
+    header.container = core::RawVideoHeader::Container::Y4M;
+    header.pixel = item.type == CV_8UC1 ? core::RawVideoHeader::Pixel::GRAY
+                                        : core::RawVideoHeader::Pixel::I420;
+    header.width = item.size.width;
+    header.height = item.size.height;
+    core::fpsToRational(fps_, header.fps_num, header.fps_den);
+    const std::string text = core::formatRawHeader(header);
+
+    y4m_out_.open(path, std::ios::binary | std::ios::trunc);
+    y4m_out_.write(text.data(), static_cast<std::streamsize>(text.size()));
+    if (!y4m_out_) {
+      LOG_ERROR("Cannot create " + path);
+      y4m_out_.close();
+      return false;
+    }
+    segment_bytes_ = text.size();
+  } else {
+    if (!avi_.open(path, item.size, fps_)) {
+      return false;
+    }
+    segment_bytes_ = avi_.getBytesWritten();
+  }
+
+  bytes_ += segment_bytes_;
+  segment_size_ = item.size;
+  segment_type_ = item.type;
+  segment_start_ = item.time;
+  ++segments_;
+  return true;
+}
+
+void RecordingSink::closeSegment() {
+  if (y4m_out_.is_open()) {
+    y4m_out_.close();
+  } else if (avi_.isOpened()) {
+    // The index is written at close
+    const uint64_t before = avi_.getBytesWritten();
+    avi_.close();
+    bytes_ += avi_.getBytesWritten() - before;
+  }
+}
+
+bool RecordingSink::segmentOpen() const {
+  return y4m_out_.is_open() || avi_.isOpened();
+}
+
+void RecordingSink::close() {
+  if (!isOpened()) {
+    return;
+  }
+
+  queue_->close(); // the writer drains what is left, then exits
+  if (writer_.joinable()) {
+    writer_.join();
+  }
+  queue_.reset();
+  opened_ = false;
+
+  LOG_INFO("Recording to " + path_ + " closed: " + std::to_string(written_) +
+           " frames in " + std::to_string(segments_) + " segments, " +
+           std::to_string(dropped_) + " dropped");
+}
+
+bool RecordingSink::isOpened() const { return opened_; }
+
+std::string RecordingSink::getName() const { return path_; }
+
+RecordingStats RecordingSink::getStats() const {
+  RecordingStats stats;
+  stats.backlog = opened_ ? queue_->size() : 0;
+  stats.written = written_;
+  stats.dropped = dropped_;
+  stats.bytes = bytes_;
+  stats.segments = segments_;
+  return stats;
+}
+
+std::string RecordingSink::segmentPath(const std::string &path,
+                                       uint32_t index) {
+  char counter[16];
+  std::snprintf(counter, sizeof(counter), "_%04u", index);
+
+  const std::string ext = lowerExtension(path);
+  const size_t stem = ext.empty() ? path.size() : path.size() - ext.size() - 1;
+  return path.substr(0, stem) + counter + path.substr(stem);
+}
+
+bool RecordingSink::handles(const std::string &path,
+                            const RecordingOptions &options) {
+  const std::string ext = lowerExtension(path);
+  const bool segmented =
+      options.segment_bytes > 0 || options.segment_seconds > 0.0;
+  return ext == "avi" || (segmented && ext == "y4m");
+}
+
+} // namespace visioncore::sinks
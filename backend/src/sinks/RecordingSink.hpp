@@ -0,0 +1,192 @@
+/**
+ * @file RecordingSink.hpp
+ * @brief Archives frames into rotating MJPEG AVI or Y4M segments
+ *
+ * The container is picked from the file extension: ".y4m" writes YUV4MPEG2
+ * (as RawFileSink does), anything else an MJPEG AVI. A new segment starts
+ * when the current one reaches a size or duration limit, or when the frame
+ * format changes; segments are named after the path with a counter before
+ * the extension ("rec.avi" -> "rec_0000.avi", "rec_0001.avi"...). Without
+ * rotation the path is used as is, until a format change.
+ *
+ * The caller only copies the frame into a pooled buffer, or, for AVI, hands
+ * over an already encoded JPEG (e.g. a streamed message) without any copy.
+ * JPEG encoding, color conversion and file I/O happen on a writer thread.
+ * When the disk cannot keep up the bounded queue fills, and the drop policy
+ * decides which frame is lost, so recording never blocks the pipeline
+ * unless asked to.
+ */
+
+#ifndef RECORDING_SINK_HPP
+#define RECORDING_SINK_HPP
+
+#include "FrameSink.hpp"
+#include "../processing/FrameEncoder.hpp"
+#include "../processing/MjpegAviWriter.hpp"
+#include "../utils/FramePool.hpp"
+#include "../utils/ThreadSafeQueue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace visioncore::sinks {
+
+/**
+ * @brief What to do with a frame when the queue is full
+ */
+enum class DropPolicy {
+  DROP_NEWEST, ///< Reject the incoming frame
+  DROP_OLDEST, ///< Discard the oldest queued frame to make room
+  BLOCK        ///< Wait for the writer (stalls the caller)
+};
+
+/**
+ * @brief Settings for RecordingSink
+ */
+struct RecordingOptions {
+  size_t queue_depth = 16; ///< Frames buffered ahead of the writer
+  DropPolicy drop = DropPolicy::DROP_OLDEST;
+  uint64_t segment_bytes = 0;   ///< Rotate past this file size, 0 = no limit
+  double segment_seconds = 0.0; ///< Rotate after this long, 0 = no limit
+  int jpeg_quality = 85;        ///< AVI frames given as pixels
+};
+
+/**
+ * @brief Counters of a RecordingSink
+ */
+struct RecordingStats {
+  size_t backlog = 0;    ///< Frames queued, not yet written
+  uint64_t written = 0;  ///< Frames written to disk
+  uint64_t dropped = 0;  ///< Frames lost to the drop policy or rejected
+  uint64_t bytes = 0;    ///< Bytes written, all segments
+  uint32_t segments = 0; ///< Segment files started
+};
+
+class RecordingSink : public FrameSink {
+public:
+  using Buffer = std::shared_ptr<std::vector<uint8_t>>;
+
+  /**
+   * @brief Constructs a recording sink
+   *
+   * No file is created until the first frame is written.
+   *
+   * @param path Output file, ".y4m" for Y4M, anything else for MJPEG AVI;
+   *             numbered when segments rotate
+   * @param fps Frame rate stored in the headers
+   * @param options Queue, drop policy and rotation settings
+   */
+  RecordingSink(const std::string &path, double fps,
+                const RecordingOptions &options = {});
+
+  ~RecordingSink() override;
+
+  RecordingSink(const RecordingSink &) = delete;
+  RecordingSink &operator=(const RecordingSink &) = delete;
+
+  // FrameSink implementation
+  bool open() override;
+  bool write(const cv::Mat &frame) override;
+  void close() override;
+  bool isOpened() const override;
+  std::string getName() const override;
+
+  /**
+   * @brief Queue an already encoded JPEG frame (AVI only)
+   *
+   * The buffer is kept, not copied, until written: it must not change
+   * afterwards. Pooled buffers come back to their pool once written.
+   *
+   * @param jpeg Buffer holding the JPEG
+   * @param offset Bytes of the buffer before the JPEG (e.g. a header)
+   * @param size Size of the encoded image
+   * @return false if rejected or dropped
+   */
+  bool writeEncoded(Buffer jpeg, size_t offset, const cv::Size &size);
+
+  /**
+   * @brief True if writeEncoded() is accepted (AVI recordings)
+   */
+  bool acceptsEncoded() const { return !y4m_; }
+
+  RecordingStats getStats() const;
+
+  /**
+   * @brief File name of a segment: the counter goes before the extension
+   */
+  static std::string segmentPath(const std::string &path, uint32_t index);
+
+  /**
+   * @brief True if a recording to path takes a RecordingSink: AVI, or Y4M
+   * split into segments. Extensions are compared case-insensitively.
+   */
+  static bool handles(const std::string &path,
+                      const RecordingOptions &options);
+
+private:
+  /// Queued frame: pixels (pooled copy) or an encoded JPEG
+  struct Item {
+    cv::Mat frame;
+    Buffer jpeg;
+    size_t offset = 0;
+    cv::Size size;
+    int type = -1; ///< Pixel type, -1 for JPEG
+    std::chrono::steady_clock::time_point time;
+  };
+
+  std::string path_;
+  double fps_;
+  RecordingOptions options_;
+  bool y4m_;
+  bool rotate_;
+
+  bool opened_ = false;
+  utils::FramePool pool_;
+  std::unique_ptr<utils::ThreadSafeQueue<Item>> queue_;
+  std::thread writer_;
+  std::atomic<bool> failed_{false};
+
+  std::atomic<uint64_t> written_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> bytes_{0};
+  std::atomic<uint32_t> segments_{0};
+
+  // Writer thread state
+  processing::FrameEncoder encoder_;
+  processing::MjpegAviWriter avi_;
+  std::ofstream y4m_out_;
+  std::vector<uint8_t> encoded_;
+  cv::Mat converted_;
+  cv::Size segment_size_;
+  int segment_type_ = -1;
+  uint64_t segment_bytes_ = 0;
+  std::chrono::steady_clock::time_point segment_start_;
+
+  /**
+   * @brief Queue an item according to the drop policy
+   */
+  bool enqueue(Item item);
+
+  /**
+   * @brief Writer thread body
+   */
+  void writerLoop();
+
+  /**
+   * @brief Write one item, starting a new segment first if needed
+   */
+  bool writeItem(const Item &item);
+
+  bool startSegment(const Item &item);
+  void closeSegment();
+  bool segmentOpen() const;
+};
+
+} // namespace visioncore::sinks
+
+#endif // RECORDING_SINK_HPP
@@ -0,0 +1,71 @@
+/**
+ * @file SharedMemoryLayout.hpp
+ * @brief Layout of the shared-memory frame ring ("VCSM")
+ *
+ * One POSIX shared-memory object holds a ring header followed by a fixed
+ * number of slots, each a slot header and room for one frame:
+ *
+ *   [ShmRingHeader][ShmSlotHeader][pixels...][ShmSlotHeader][pixels...]...
+ *
+ * Frame n (counting from 0) goes to slot n % slot_count. A single writer
+ * publishes it with a per-slot sequence lock: the slot sequence is odd while
+ * the slot is rewritten and even once the frame is complete, and the ring's
+ * published counter is then raised to n + 1. Readers never lock or write:
+ * they read the sequence, the frame, then the sequence again, and retry or
+ * skip when it moved (the writer lapped them).
+ *
+ * Both sides run on the same host, so fields use the native byte order and
+ * timestamps are steady_clock (CLOCK_MONOTONIC) microseconds, comparable
+ * between processes.
+ */
+
+#ifndef SHARED_MEMORY_LAYOUT_HPP
+#define SHARED_MEMORY_LAYOUT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace visioncore::sinks {
+
+inline constexpr char kShmMagic[4] = {'V', 'C', 'S', 'M'};
+inline constexpr uint32_t kShmVersion = 1;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "ring counters must be lock-free to be shared between processes");
+
+struct alignas(64) ShmRingHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t slot_count;
+  uint32_t reserved;
+  uint64_t slot_bytes;     ///< Distance between slots, header included
+  uint64_t frame_capacity; ///< Largest frame a slot can hold, in bytes
+  std::atomic<uint64_t> published; ///< Frames published so far
+};
+
+struct alignas(64) ShmSlotHeader {
+  std::atomic<uint64_t> sequence; ///< Odd while the slot is being written
+  uint64_t index;                 ///< Publish counter of the frame (n)
+  uint64_t frame_id;              ///< Pipeline frame id
+  uint64_t capture_us;            ///< Source capture time, 0 if unknown
+  uint64_t publish_us;            ///< Time the frame was complete
+  int32_t width;
+  int32_t height;
+  int32_t type; ///< OpenCV type, e.g. CV_8UC3; rows are packed
+  uint32_t bytes;
+};
+
+/**
+ * @brief steady_clock time as microseconds, shared by writer and readers
+ */
+inline uint64_t shmMicros(std::chrono::steady_clock::time_point time) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          time.time_since_epoch())
+          .count());
+}
+
+} // namespace visioncore::sinks
+
+#endif // SHARED_MEMORY_LAYOUT_HPP
@@ -0,0 +1,203 @@
+/**
+ * @file SharedMemoryReader.cpp
+ * @brief SharedMemoryReader implementation
+ */
+
+#include "SharedMemoryReader.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace visioncore::sinks {
+
+namespace {
+
+constexpr int kLatestAttempts = 8;
+constexpr auto kPollInterval = std::chrono::microseconds(100);
+
+} // namespace
+
+SharedMemoryReader::SharedMemoryReader(const std::string &name)
+    : name_(name) {}
+
+SharedMemoryReader::~SharedMemoryReader() { close(); }
+
+bool SharedMemoryReader::open() {
+  close();
+
+  const int fd = ::shm_open(name_.c_str(), O_RDONLY | O_CLOEXEC, 0);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st {};
+  if (::fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(ShmRingHeader)) {
+    ::close(fd);
+    return false;
+  }
+
+  const size_t size = static_cast<size_t>(st.st_size);
+  void *base = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd); // the mapping keeps the object alive
+  if (base == MAP_FAILED) {
+    return false;
+  }
+
+  // Check the header, magic first: it is written last
+  const auto *header = static_cast<const ShmRingHeader *>(base);
+  bool valid = std::memcmp(header->magic, kShmMagic, sizeof(kShmMagic)) == 0;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  valid = valid && header->version == kShmVersion &&
+          header->slot_count >= 2 &&
+          header->slot_bytes >=
+              sizeof(ShmSlotHeader) + header->frame_capacity &&
+          sizeof(ShmRingHeader) + header->slot_bytes * header->slot_count <=
+              size;
+  if (!valid) {
+    ::munmap(base, size);
+    return false;
+  }
+
+  base_ = static_cast<const uint8_t *>(base);
+  mapped_bytes_ = size;
+  header_ = header;
+  return true;
+}
+
+void SharedMemoryReader::close() {
+  if (base_) {
+    ::munmap(const_cast<uint8_t *>(base_), mapped_bytes_);
+    base_ = nullptr;
+    header_ = nullptr;
+    mapped_bytes_ = 0;
+  }
+}
+
+uint64_t SharedMemoryReader::getPublishedCount() const {
+  return header_ ? header_->published.load(std::memory_order_acquire) : 0;
+}
+
+const ShmSlotHeader *SharedMemoryReader::slot(uint64_t index) const {
+  return reinterpret_cast<const ShmSlotHeader *>(
+      base_ + sizeof(ShmRingHeader) +
+      (index % header_->slot_count) * header_->slot_bytes);
+}
+
+SharedMemoryReader::ReadResult
+SharedMemoryReader::load(uint64_t index, cv::Mat &frame,
+                         SharedFrameInfo &info, bool copy) const {
+  if (index >= getPublishedCount()) {
+    return ReadResult::NOT_YET;
+  }
+
+  // A published slot only changes when the writer reuses it for a later
+  // frame, so any change of its sequence means the frame is gone
+  const ShmSlotHeader *s = slot(index);
+  const uint64_t sequence = s->sequence.load(std::memory_order_acquire);
+  if (sequence % 2 != 0 || s->index != index) {
+    return ReadResult::OVERWRITTEN;
+  }
+
+  const int width = s->width;
+  const int height = s->height;
+  const int type = s->type;
+  const uint32_t bytes = s->bytes;
+  const uint64_t frame_id = s->frame_id;
+  const uint64_t capture_us = s->capture_us;
+  const uint64_t publish_us = s->publish_us;
+
+  // Values torn by a rewrite are caught below, but must not be used to
+  // index outside the slot first
+  if (width <= 0 || height <= 0 || bytes > header_->frame_capacity ||
+      CV_MAT_DEPTH(type) > CV_64F ||
+      static_cast<uint64_t>(width) * height * CV_ELEM_SIZE(type) != bytes) {
+    return ReadResult::OVERWRITTEN;
+  }
+
+  const uint8_t *pixels = reinterpret_cast<const uint8_t *>(s) +
+                          sizeof(ShmSlotHeader);
+  if (copy) {
+    if (!frame.u) {
+      frame.release(); // may be a peeked view of the read-only mapping
+    }
+    frame.create(height, width, type);
+    std::memcpy(frame.data, pixels, bytes);
+  } else {
+    frame = cv::Mat(height, width, type, const_cast<uint8_t *>(pixels));
+  }
+
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (s->sequence.load(std::memory_order_relaxed) != sequence) {
+    return ReadResult::OVERWRITTEN;
+  }
+
+  info.index = index;
+  info.frame_id = frame_id;
+  info.capture_us = capture_us;
+  info.publish_us = publish_us;
+  info.sequence = sequence;
+  info.slot = static_cast<uint32_t>(index % header_->slot_count);
+  return ReadResult::OK;
+}
+
+SharedMemoryReader::ReadResult
+SharedMemoryReader::read(uint64_t index, cv::Mat &frame,
+                         SharedFrameInfo &info) {
+  if (!header_) {
+    return ReadResult::NOT_YET;
+  }
+  return load(index, frame, info, true);
+}
+
+bool SharedMemoryReader::readLatest(cv::Mat &frame, SharedFrameInfo &info) {
+  for (int attempt = 0; header_ && attempt < kLatestAttempts; ++attempt) {
+    const uint64_t published = getPublishedCount();
+    if (published == 0) {
+      return false;
+    }
+    if (load(published - 1, frame, info, true) == ReadResult::OK) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SharedMemoryReader::peekLatest(cv::Mat &frame, SharedFrameInfo &info) {
+  for (int attempt = 0; header_ && attempt < kLatestAttempts; ++attempt) {
+    const uint64_t published = getPublishedCount();
+    if (published == 0) {
+      return false;
+    }
+    if (load(published - 1, frame, info, false) == ReadResult::OK) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SharedMemoryReader::isCurrent(const SharedFrameInfo &info) const {
+  if (!header_) {
+    return false;
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot(info.index)->sequence.load(std::memory_order_relaxed) ==
+         info.sequence;
+}
+
+bool SharedMemoryReader::waitFor(uint64_t index,
+                                 std::chrono::milliseconds timeout) const {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (getPublishedCount() <= index) {
+    if (!header_ || std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(kPollInterval);
+  }
+  return true;
+}
+
+} // namespace visioncore::sinks
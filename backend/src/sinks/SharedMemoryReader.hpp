@@ -0,0 +1,119 @@
+/**
+ * @file SharedMemoryReader.hpp
+ * @brief Reads frames published by SharedMemorySink from another process
+ *
+ * The ring is mapped read-only: a reader cannot disturb the writer or the
+ * other readers. Frames can be copied out (read(), readLatest()), which
+ * validates the copy against concurrent rewrites, or looked at in place
+ * (peekLatest()) without any copy, in which case the caller checks with
+ * isCurrent() that the slot was not reused while it worked on the pixels.
+ *
+ * Linking: the reader only needs this class and SharedMemoryLayout.hpp.
+ */
+
+#ifndef SHARED_MEMORY_READER_HPP
+#define SHARED_MEMORY_READER_HPP
+
+#include "SharedMemoryLayout.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include <string>
+
+namespace visioncore::sinks {
+
+/**
+ * @brief Metadata of a frame read from the ring
+ */
+struct SharedFrameInfo {
+  uint64_t index = 0;      ///< Publish counter: consecutive, gaps = missed
+  uint64_t frame_id = 0;   ///< Pipeline frame id
+  uint64_t capture_us = 0; ///< steady_clock microseconds, 0 if unknown
+  uint64_t publish_us = 0; ///< steady_clock microseconds
+  uint64_t sequence = 0;   ///< Slot sequence, for isCurrent()
+  uint32_t slot = 0;
+};
+
+class SharedMemoryReader {
+public:
+  enum class ReadResult {
+    OK,
+    NOT_YET,    ///< Not published yet
+    OVERWRITTEN ///< The writer reused the slot: the frame is gone
+  };
+
+  /**
+   * @param name Shared-memory object name given to SharedMemorySink
+   */
+  explicit SharedMemoryReader(const std::string &name);
+  ~SharedMemoryReader();
+
+  SharedMemoryReader(const SharedMemoryReader &) = delete;
+  SharedMemoryReader &operator=(const SharedMemoryReader &) = delete;
+
+  /**
+   * @brief Map the ring read-only
+   * @return false if it does not exist (yet) or is not a VCSM ring
+   */
+  bool open();
+  void close();
+  bool isOpened() const { return header_ != nullptr; }
+
+  /**
+   * @brief Frames published so far; the next one gets this index
+   */
+  uint64_t getPublishedCount() const;
+
+  /**
+   * @brief Copy the frame with a given publish index
+   *
+   * To follow the stream, read index, index + 1... and on OVERWRITTEN
+   * jump to getPublishedCount() - 1.
+   */
+  ReadResult read(uint64_t index, cv::Mat &frame, SharedFrameInfo &info);
+
+  /**
+   * @brief Copy the newest frame
+   * @return false if nothing was published yet
+   */
+  bool readLatest(cv::Mat &frame, SharedFrameInfo &info);
+
+  /**
+   * @brief The newest frame, in place (no copy)
+   *
+   * The Mat points into the read-only mapping and may be rewritten by the
+   * writer at any time: check isCurrent(info) after using it, and drop the
+   * result if it returns false.
+   */
+  bool peekLatest(cv::Mat &frame, SharedFrameInfo &info);
+
+  /**
+   * @brief True while the slot of a peeked frame still holds that frame
+   */
+  bool isCurrent(const SharedFrameInfo &info) const;
+
+  /**
+   * @brief Wait until a frame with at least this index is published
+   * @return false on timeout
+   */
+  bool waitFor(uint64_t index, std::chrono::milliseconds timeout) const;
+
+private:
+  std::string name_;
+  const uint8_t *base_ = nullptr;
+  size_t mapped_bytes_ = 0;
+  const ShmRingHeader *header_ = nullptr;
+
+  const ShmSlotHeader *slot(uint64_t index) const;
+
+  /**
+   * @brief Read a slot header and, if copy, its pixels, consistently
+   */
+  ReadResult load(uint64_t index, cv::Mat &frame, SharedFrameInfo &info,
+                  bool copy) const;
+};
+
+} // namespace visioncore::sinks
+
+#endif // SHARED_MEMORY_READER_HPP
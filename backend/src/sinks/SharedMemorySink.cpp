@@ -0,0 +1,182 @@
+/**
+ * @file SharedMemorySink.cpp
+ * @brief SharedMemorySink implementation
+ */
+
+#include "SharedMemorySink.hpp"
+#include "../utils/Logger.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace visioncore::sinks {
+
+namespace {
+
+constexpr uint64_t roundUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+SharedMemorySink::SharedMemorySink(const std::string &name,
+                                   const SharedMemoryOptions &options)
+    : name_(name), options_(options) {}
+
+SharedMemorySink::~SharedMemorySink() { close(); }
+
+bool SharedMemorySink::open() {
+  if (isOpened()) {
+    close();
+  }
+  if (options_.slots < 2 || options_.frame_capacity == 0 ||
+      options_.frame_capacity > UINT32_MAX) {
+    LOG_ERROR("Invalid shared-memory ring geometry for " + name_);
+    return false;
+  }
+
+  const uint64_t slot_bytes =
+      sizeof(ShmSlotHeader) + roundUp(options_.frame_capacity, 64);
+  const size_t size = sizeof(ShmRingHeader) + slot_bytes * options_.slots;
+
+  // A stale object may be mapped by old readers: give it up, start fresh
+  ::shm_unlink(name_.c_str());
+  fd_ = ::shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC,
+                   0644);
+  if (fd_ < 0) {
+    LOG_ERROR("Cannot create shared memory " + name_ + ": " +
+              std::strerror(errno));
+    return false;
+  }
+  if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+    LOG_ERROR("Cannot size shared memory " + name_ + ": " +
+              std::strerror(errno));
+    close();
+    return false;
+  }
+
+  // tmpfs objects are sparse: without reserving the pages now, a full
+  // /dev/shm (64 MB in Docker by default) turns the first large frame
+  // copy into SIGBUS instead of an error here
+  const int reserved = ::posix_fallocate(fd_, 0, static_cast<off_t>(size));
+  if (reserved != 0) {
+    LOG_ERROR("Cannot reserve " + std::to_string(size / (1024 * 1024)) +
+              " MB of shared memory for " + name_ + ": " +
+              std::strerror(reserved));
+    close();
+    return false;
+  }
+
+  void *base =
+      ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (base == MAP_FAILED) {
+    LOG_ERROR("Cannot map shared memory " + name_ + ": " +
+              std::strerror(errno));
+    close();
+    return false;
+  }
+  base_ = static_cast<uint8_t *>(base);
+  mapped_bytes_ = size;
+
+  // Fresh pages are zero: slots start at sequence 0, nothing published
+  for (uint32_t i = 0; i < options_.slots; ++i) {
+    new (base_ + sizeof(ShmRingHeader) + i * slot_bytes) ShmSlotHeader{};
+  }
+  header_ = new (base_) ShmRingHeader{};
+  header_->version = kShmVersion;
+  header_->slot_count = options_.slots;
+  header_->slot_bytes = slot_bytes;
+  header_->frame_capacity = options_.frame_capacity;
+  header_->published.store(0, std::memory_order_relaxed);
+
+  // The magic goes last: readers only trust a complete header
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(header_->magic, kShmMagic, sizeof(kShmMagic));
+
+  published_ = 0;
+  dropped_ = 0;
+  next_id_ = 0;
+
+  LOG_INFO("Publishing frames to shared memory " + name_ + " (" +
+           std::to_string(options_.slots) + " slots of " +
+           std::to_string(options_.frame_capacity / 1024) + " KB)");
+  return true;
+}
+
+bool SharedMemorySink::write(const cv::Mat &frame) {
+  return publish(frame, next_id_++, std::chrono::steady_clock::now());
+}
+
+bool SharedMemorySink::publish(const cv::Mat &frame, uint64_t frame_id,
+                               std::chrono::steady_clock::time_point
+                                   capture_time) {
+  if (!isOpened()) {
+    return false;
+  }
+  const size_t row_bytes = frame.cols * frame.elemSize();
+  const size_t bytes = row_bytes * frame.rows;
+  if (frame.empty() || frame.dims > 2 || bytes > options_.frame_capacity) {
+    ++dropped_;
+    return false;
+  }
+
+  const uint64_t index = header_->published.load(std::memory_order_relaxed);
+  uint8_t *slot_base = base_ + sizeof(ShmRingHeader) +
+                       (index % options_.slots) * header_->slot_bytes;
+  auto *slot = reinterpret_cast<ShmSlotHeader *>(slot_base);
+
+  // Odd: readers of this slot retry or skip until it is even again
+  const uint64_t sequence = slot->sequence.load(std::memory_order_relaxed);
+  slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  uint8_t *dst = slot_base + sizeof(ShmSlotHeader);
+  if (frame.isContinuous()) {
+    std::memcpy(dst, frame.data, bytes);
+  } else {
+    for (int y = 0; y < frame.rows; ++y, dst += row_bytes) {
+      std::memcpy(dst, frame.ptr(y), row_bytes);
+    }
+  }
+  slot->index = index;
+  slot->frame_id = frame_id;
+  slot->capture_us = capture_time == std::chrono::steady_clock::time_point{}
+                         ? 0
+                         : shmMicros(capture_time);
+  slot->publish_us = shmMicros(std::chrono::steady_clock::now());
+  slot->width = frame.cols;
+  slot->height = frame.rows;
+  slot->type = frame.type();
+  slot->bytes = static_cast<uint32_t>(bytes);
+
+  slot->sequence.store(sequence + 2, std::memory_order_release);
+  header_->published.store(index + 1, std::memory_order_release);
+  ++published_;
+  return true;
+}
+
+void SharedMemorySink::close() {
+  if (base_) {
+    ::munmap(base_, mapped_bytes_);
+    base_ = nullptr;
+    header_ = nullptr;
+    mapped_bytes_ = 0;
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+    ::shm_unlink(name_.c_str());
+    LOG_INFO("Shared memory " + name_ + " closed: " +
+             std::to_string(published_) + " frames published");
+  }
+}
+
+bool SharedMemorySink::isOpened() const { return base_ != nullptr; }
+
+std::string SharedMemorySink::getName() const { return name_; }
+
+} // namespace visioncore::sinks
@@ -0,0 +1,114 @@
+/**
+ * @file SharedMemorySink.hpp
+ * @brief Publishes processed frames into a POSIX shared-memory ring
+ *
+ * Local consumers (analytics, recorders in other processes) map the ring
+ * read-only with SharedMemoryReader and get raw pixels without a socket,
+ * an encode or a decode. Publishing is one row copy into the next slot and
+ * never waits for readers: a slow reader skips frames, it cannot hold the
+ * writer back. See SharedMemoryLayout.hpp for the format.
+ *
+ * One writer per ring. The object is created by open() (replacing a stale
+ * one with the same name), with all of its memory reserved up front, and
+ * unlinked by close(); readers that still map it keep the last frames.
+ */
+
+#ifndef SHARED_MEMORY_SINK_HPP
+#define SHARED_MEMORY_SINK_HPP
+
+#include "FrameSink.hpp"
+#include "SharedMemoryLayout.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace visioncore::sinks {
+
+/**
+ * @brief Geometry of the ring
+ */
+struct SharedMemoryOptions {
+  uint32_t slots = 4; ///< Frames kept; readers have slots-1 frame times
+  uint64_t frame_capacity = 3840ull * 2160 * 4; ///< Largest frame, bytes
+
+  /**
+   * @brief Ring for frames up to a given size, 8-bit gray to BGRA
+   *
+   * The whole ring is reserved in /dev/shm, so size it from the actual
+   * frames rather than the 4K default. An empty size keeps the default.
+   */
+  static SharedMemoryOptions forFrameSize(const cv::Size &size,
+                                          uint32_t slots = 4) {
+    SharedMemoryOptions options;
+    options.slots = slots;
+    if (size.width > 0 && size.height > 0) {
+      options.frame_capacity = static_cast<uint64_t>(size.area()) * 4;
+    }
+    return options;
+  }
+};
+
+class SharedMemorySink : public FrameSink {
+public:
+  /**
+   * @param name Shared-memory object name, e.g. "/visioncore"
+   * @param options Slot count and size
+   */
+  explicit SharedMemorySink(const std::string &name,
+                            const SharedMemoryOptions &options = {});
+
+  ~SharedMemorySink() override;
+
+  SharedMemorySink(const SharedMemorySink &) = delete;
+  SharedMemorySink &operator=(const SharedMemorySink &) = delete;
+
+  // FrameSink implementation
+  bool open() override;
+  bool write(const cv::Mat &frame) override;
+  void close() override;
+  bool isOpened() const override;
+  std::string getName() const override;
+
+  /**
+   * @brief Copy a frame into the next slot and publish it
+   *
+   * Called from one thread at a time.
+   *
+   * @param frame Any OpenCV type, at most frame_capacity bytes
+   * @param frame_id Pipeline frame id handed to readers
+   * @param capture_time Source capture time, default = unknown
+   * @return false if not open or the frame does not fit
+   */
+  bool publish(const cv::Mat &frame, uint64_t frame_id,
+               std::chrono::steady_clock::time_point capture_time = {});
+
+  uint64_t getPublishedCount() const { return published_; }
+
+  /**
+   * @brief Frames rejected because empty or larger than a slot
+   */
+  uint64_t getDroppedCount() const { return dropped_; }
+
+  /**
+   * @brief Size of the shared-memory object, in bytes
+   */
+  size_t getMappedBytes() const { return mapped_bytes_; }
+
+private:
+  std::string name_;
+  SharedMemoryOptions options_;
+
+  int fd_ = -1;
+  uint8_t *base_ = nullptr;
+  size_t mapped_bytes_ = 0;
+  ShmRingHeader *header_ = nullptr;
+
+  std::atomic<uint64_t> published_{0};
+  std::atomic<uint64_t> dropped_{0};
+  uint64_t next_id_ = 0; ///< Frame ids of write()
+};
+
+} // namespace visioncore::sinks
+
+#endif // SHARED_MEMORY_SINK_HPP
@@ -0,0 +1,87 @@
+/**
+ * @file BufferPool.hpp
+ * @brief Fixed set of reusable byte buffers
+ *
+ * Same scheme as FramePool, for encoded messages: a buffer is free when the
+ * pool holds the only reference to it, so it can be handed to any number of
+ * senders and comes back once they all dropped it. Buffers keep their
+ * capacity, so after a few messages building one no longer allocates.
+ */
+
+#ifndef BUFFER_POOL_HPP
+#define BUFFER_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace visioncore::utils {
+
+class BufferPool {
+public:
+  using Buffer = std::shared_ptr<std::vector<uint8_t>>;
+
+  /**
+   * @brief Construct the pool
+   * @param capacity Number of buffers kept for reuse (>= 1)
+   */
+  explicit BufferPool(size_t capacity) : slots_(capacity > 0 ? capacity : 1) {}
+
+  BufferPool(const BufferPool &) = delete;
+  BufferPool &operator=(const BufferPool &) = delete;
+
+  /**
+   * @brief Get an empty buffer nobody else references
+   *
+   * If every buffer is still referenced, the oldest slot is detached (its
+   * holders keep it) and replaced by a new buffer.
+   */
+  Buffer acquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (size_t i = 0; i < slots_.size(); ++i) {
+      Buffer &slot = slots_[(next_ + i) % slots_.size()];
+
+      if (!slot || slot.use_count() == 1) {
+        next_ = (next_ + i + 1) % slots_.size();
+        if (!slot) {
+          slot = std::make_shared<std::vector<uint8_t>>();
+          ++allocations_;
+        }
+        slot->clear();
+        return slot;
+      }
+    }
+
+    Buffer &slot = slots_[next_];
+    next_ = (next_ + 1) % slots_.size();
+    slot = std::make_shared<std::vector<uint8_t>>();
+    ++allocations_;
+    return slot;
+  }
+
+  /**
+   * @brief Number of buffers kept by the pool
+   */
+  size_t capacity() const { return slots_.size(); }
+
+  /**
+   * @brief Number of buffers created, including the initial fill
+   */
+  uint64_t allocations() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return allocations_;
+  }
+
+private:
+  std::vector<Buffer> slots_;
+  size_t next_ = 0;
+  uint64_t allocations_ = 0;
+  mutable std::mutex mutex_;
+};
+
+} // namespace visioncore::utils
+
+#endif // BUFFER_POOL_HPP
@@ -0,0 +1,119 @@
+/**
+ * @file Deflater.hpp
+ * @brief zlib stream reused across frames
+ *
+ * deflateInit() allocates a few hundred KB of state; a Deflater keeps one
+ * stream and resets it for each frame instead. The stream is re-created
+ * only when the compression level changes. The output is plain zlib
+ * (RFC 1950), written after a caller-chosen offset so a header can go in
+ * front of it in the same buffer.
+ *
+ * One Deflater per thread: callers own one or keep it thread_local.
+ */
+
+#ifndef DEFLATER_HPP
+#define DEFLATER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include <vector>
+#include <zlib.h>
+
+namespace visioncore::utils {
+
+class Deflater {
+public:
+  Deflater() = default;
+  ~Deflater() {
+    if (level_ != 0) {
+      deflateEnd(&stream_);
+    }
+  }
+
+  Deflater(const Deflater &) = delete;
+  Deflater &operator=(const Deflater &) = delete;
+
+  /**
+   * @brief Compress a block after the first offset bytes of out
+   *
+   * @param level 1 (fastest) to 9, clamped
+   * @return false if zlib failed; out is then unspecified
+   */
+  bool compress(const uint8_t *data, size_t size, int level,
+                std::vector<uint8_t> &out, size_t offset) {
+    return compressRows(data, 1, size, size, level, out, offset);
+  }
+
+  /**
+   * @brief Compress the pixel rows of a frame, packed (no row padding)
+   *
+   * A continuous frame is one block, otherwise rows are fed one by one.
+   */
+  bool compress(const cv::Mat &frame, int level, std::vector<uint8_t> &out,
+                size_t offset) {
+    if (frame.isContinuous()) {
+      return compress(frame.data, frame.total() * frame.elemSize(), level,
+                      out, offset);
+    }
+    return compressRows(frame.data, frame.rows, frame.cols * frame.elemSize(),
+                        frame.step[0], level, out, offset);
+  }
+
+private:
+  z_stream stream_{};
+  int level_ = 0; ///< 0 = not initialized
+
+  bool reset(int level) {
+    level = std::clamp(level, 1, 9);
+    if (level == level_) {
+      return deflateReset(&stream_) == Z_OK;
+    }
+    if (level_ != 0) {
+      deflateEnd(&stream_);
+    }
+    stream_ = z_stream{};
+    level_ = deflateInit(&stream_, level) == Z_OK ? level : 0;
+    return level_ != 0;
+  }
+
+  bool compressRows(const uint8_t *first, int rows, size_t row_bytes,
+                    size_t stride, int level, std::vector<uint8_t> &out,
+                    size_t offset) {
+    if (!reset(level)) {
+      return false;
+    }
+
+    // deflateBound() covers the whole input; grown only as a safety net
+    out.resize(offset + deflateBound(&stream_,
+                                     static_cast<uLong>(row_bytes * rows)));
+    size_t written = offset;
+    for (int y = 0; y < rows; ++y) {
+      stream_.next_in = const_cast<Bytef *>(first + y * stride);
+      stream_.avail_in = static_cast<uInt>(row_bytes);
+      const int flush = y + 1 == rows ? Z_FINISH : Z_NO_FLUSH;
+
+      int status = Z_OK;
+      do {
+        if (written == out.size()) {
+          out.resize(out.size() + out.size() / 2);
+        }
+        stream_.next_out = out.data() + written;
+        stream_.avail_out = static_cast<uInt>(out.size() - written);
+        status = deflate(&stream_, flush);
+        written = out.size() - stream_.avail_out;
+        if (status == Z_STREAM_ERROR) {
+          return false;
+        }
+      } while (stream_.avail_in > 0 ||
+               (flush == Z_FINISH && status != Z_STREAM_END));
+    }
+    out.resize(written);
+    return true;
+  }
+};
+
+} // namespace visioncore::utils
+
+#endif // DEFLATER_HPP
@@ -0,0 +1,112 @@
+/**
+ * @file FramePool.hpp
+ * @brief Fixed set of reusable frame buffers
+ *
+ * A slot is free when the pool holds the only reference to its buffer, so
+ * frames can be handed out as plain cv::Mat (shared, zero-copy) and come back
+ * to the pool automatically once every consumer has released them. Writing
+ * into a slot that is still referenced downstream never happens: if every
+ * slot is busy, one is detached from its buffer and a new one gets allocated.
+ *
+ * Slots are meant to be filled by a single producer thread; consumers only
+ * ever see copies of the Mat header.
+ */
+
+#ifndef FRAME_POOL_HPP
+#define FRAME_POOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <opencv2/core.hpp>
+#include <vector>
+
+namespace visioncore::utils {
+
+class FramePool {
+public:
+  /**
+   * @brief Construct the pool
+   * @param capacity Number of buffers kept for reuse (>= 1)
+   */
+  explicit FramePool(size_t capacity) : slots_(capacity > 0 ? capacity : 1) {}
+
+  FramePool(const FramePool &) = delete;
+  FramePool &operator=(const FramePool &) = delete;
+
+  /**
+   * @brief Get a slot whose buffer is not referenced anywhere else
+   *
+   * The returned Mat belongs to the pool and stays valid until the next
+   * acquire() from the same thread. Fill it in place (readers such as
+   * cv::VideoCapture::read or copyTo reuse the buffer when size and type
+   * match), then hand out a copy of the header to consumers.
+   */
+  cv::Mat &acquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (size_t i = 0; i < slots_.size(); ++i) {
+      cv::Mat &slot = slots_[(next_ + i) % slots_.size()];
+
+      if (isFree(slot)) {
+        next_ = (next_ + i + 1) % slots_.size();
+        if (slot.empty()) {
+          ++allocations_;
+        }
+        return slot;
+      }
+    }
+
+    // Every buffer is still used downstream: detach the oldest slot, its
+    // consumers keep their reference and the slot gets a fresh buffer
+    cv::Mat &slot = slots_[next_];
+    next_ = (next_ + 1) % slots_.size();
+    slot.release();
+    ++allocations_;
+    return slot;
+  }
+
+  /**
+   * @brief Get a free slot allocated with the given geometry
+   */
+  cv::Mat &acquire(const cv::Size &size, int type) {
+    cv::Mat &slot = acquire();
+    slot.create(size, type);
+    return slot;
+  }
+
+  /**
+   * @brief Number of buffers kept by the pool
+   */
+  size_t capacity() const { return slots_.size(); }
+
+  /**
+   * @brief Number of acquisitions that could not reuse a buffer
+   *
+   * Reading into a slot of a different size also reallocates; that is not
+   * counted here.
+   */
+  uint64_t allocations() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return allocations_;
+  }
+
+private:
+  std::vector<cv::Mat> slots_;
+  size_t next_ = 0;
+  uint64_t allocations_ = 0;
+  mutable std::mutex mutex_;
+
+  static bool isFree(const cv::Mat &slot) {
+    // Consumers on other threads drop their references with an atomic
+    // decrement (CV_XADD), so the count must be read atomically too
+    return slot.u == nullptr ||
+           std::atomic_ref<int>(slot.u->refcount)
+                   .load(std::memory_order_acquire) == 1;
+  }
+};
+
+} // namespace visioncore::utils
+
+#endif // FRAME_POOL_HPP
@@ -0,0 +1,129 @@
+/**
+ * @file ThreadPool.hpp
+ * @brief Fixed-size pool of worker threads running queued tasks
+ *
+ * Tasks run in submission order (FIFO), each on whichever worker is free.
+ * enqueue() returns a future for the task result. Destroying the pool
+ * finishes the tasks already running and discards the ones still queued:
+ * their futures report std::future_error (broken_promise).
+ */
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace visioncore::utils {
+
+class ThreadPool {
+public:
+  /**
+   * @brief Start the workers
+   * @param threads Number of workers, 0 for one per hardware thread
+   */
+  explicit ThreadPool(size_t threads = 0) {
+    if (threads == 0) {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+      workers_.emplace_back([this] { workerLoop(); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+      std::queue<std::function<void()>>().swap(tasks_);
+    }
+    cv_.notify_all();
+
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * @brief Queue a task
+   * @return Future holding the task result (or its exception)
+   * @throws std::runtime_error if the pool is being destroyed
+   */
+  template <typename F>
+  auto enqueue(F &&task) -> std::future<std::invoke_result_t<F>> {
+    using Result = std::invoke_result_t<F>;
+
+    // std::function needs a copyable callable: share the packaged_task
+    auto packaged =
+        std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+    std::future<Result> result = packaged->get_future();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopping_) {
+        throw std::runtime_error("ThreadPool is stopping");
+      }
+      tasks_.emplace([packaged] { (*packaged)(); });
+    }
+    cv_.notify_one();
+
+    return result;
+  }
+
+  /**
+   * @brief Number of worker threads
+   */
+  size_t size() const { return workers_.size(); }
+
+  /**
+   * @brief Number of tasks waiting for a worker
+   */
+  size_t pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tasks_.size();
+  }
+
+private:
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> tasks_;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopping_ = false;
+
+  void workerLoop() {
+    for (;;) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+
+        if (stopping_) {
+          return;
+        }
+
+        task = std::move(tasks_.front());
+        tasks_.pop();
+      }
+      task();
+    }
+  }
+};
+
+} // namespace visioncore::utils
+
+#endif // THREAD_POOL_HPP
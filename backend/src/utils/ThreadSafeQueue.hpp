@@ -0,0 +1,177 @@
+/**
+ * @file ThreadSafeQueue.hpp
+ * @brief Bounded blocking queue used to hand data between threads
+ *
+ * push() blocks while the queue is full (backpressure), pop() blocks while
+ * it is empty. close() wakes every waiting thread: pushes fail from then on
+ * and pops drain the remaining items before failing.
+ */
+
+#ifndef THREAD_SAFE_QUEUE_HPP
+#define THREAD_SAFE_QUEUE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <queue>
+
+namespace visioncore::utils {
+
+template <typename T> class ThreadSafeQueue {
+public:
+  /**
+   * @brief Construct the queue
+   * @param max_capacity Maximum number of items, 0 for unbounded
+   */
+  explicit ThreadSafeQueue(size_t max_capacity = 0)
+      : max_capacity_(max_capacity) {}
+
+  ~ThreadSafeQueue() = default;
+
+  ThreadSafeQueue(const ThreadSafeQueue &) = delete;
+  ThreadSafeQueue &operator=(const ThreadSafeQueue &) = delete;
+
+  /**
+   * @brief Add an item, blocking while the queue is full
+   * @return false if the queue is closed
+   */
+  bool push(T item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_not_full_.wait(lock, [this] { return !isFull() || closed_; });
+
+    if (closed_) {
+      return false;
+    }
+
+    queue_.push(std::move(item));
+    lock.unlock();
+    cv_not_empty_.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief Add an item without blocking
+   * @return false if the queue is full or closed
+   */
+  bool tryPush(T item) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (closed_ || isFull()) {
+        return false;
+      }
+      queue_.push(std::move(item));
+    }
+    cv_not_empty_.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief Remove an item, blocking while the queue is empty
+   * @return false if the queue is closed and empty
+   */
+  bool pop(T &item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_not_empty_.wait(lock, [this] { return !queue_.empty() || closed_; });
+    return popLocked(item, lock);
+  }
+
+  /**
+   * @brief Remove an item without blocking
+   * @return false if the queue is empty
+   */
+  bool tryPop(T &item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return popLocked(item, lock);
+  }
+
+  /**
+   * @brief Remove an item, waiting at most timeout
+   * @return false on timeout, or if the queue is closed and empty
+   */
+  template <typename Rep, typename Period>
+  bool popFor(T &item, const std::chrono::duration<Rep, Period> &timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_not_empty_.wait_for(lock, timeout,
+                           [this] { return !queue_.empty() || closed_; });
+    return popLocked(item, lock);
+  }
+
+  /**
+   * @brief Number of queued items
+   */
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+  }
+
+  /**
+   * @brief True if no item is queued
+   */
+  bool empty() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.empty();
+  }
+
+  /**
+   * @brief Maximum number of items, 0 for unbounded
+   */
+  size_t capacity() const { return max_capacity_; }
+
+  /**
+   * @brief Close the queue and wake every waiting thread
+   */
+  void close() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+    }
+    cv_not_empty_.notify_all();
+    cv_not_full_.notify_all();
+  }
+
+  /**
+   * @brief True once close() has been called
+   */
+  bool isClosed() const { return closed_; }
+
+  /**
+   * @brief Drop every queued item
+   */
+  void clear() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::queue<T>().swap(queue_);
+    }
+    cv_not_full_.notify_all();
+  }
+
+private:
+  std::queue<T> queue_;
+  size_t max_capacity_;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_not_empty_;
+  std::condition_variable cv_not_full_;
+  std::atomic<bool> closed_{false};
+
+  bool isFull() const {
+    return max_capacity_ > 0 && queue_.size() >= max_capacity_;
+  }
+
+  bool popLocked(T &item, std::unique_lock<std::mutex> &lock) {
+    if (queue_.empty()) {
+      return false;
+    }
+
+    item = std::move(queue_.front());
+    queue_.pop();
+    lock.unlock();
+    cv_not_full_.notify_one();
+    return true;
+  }
+};
+
+} // namespace visioncore::utils
+
+#endif // THREAD_SAFE_QUEUE_HPP
@@ -0,0 +1,204 @@
+// tests/test_batch_transcoder.cpp
+#include "filters/GrayscaleFilter.hpp"
+#include "processing/BatchTranscoder.hpp"
+#include "processing/FrameEncoder.hpp"
+#include "processing/MjpegAviWriter.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <opencv2/opencv.hpp>
+#include <stdexcept>
+
+using namespace visioncore::processing;
+using namespace visioncore::filters;
+
+namespace {
+
+std::vector<char> readFile(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+} // namespace
+
+// ==================== Segment Planning Tests ====================
+
+TEST(BatchPlanTest, SplitsEvenlyOnKeyframes) {
+  const std::vector<int64_t> keyframes{0, 12, 24, 36, 48};
+  const auto plan = BatchTranscoder::planSegments(keyframes, 60, 4);
+
+  ASSERT_EQ(plan.size(), 4u);
+  EXPECT_EQ(plan.front().begin, 0);
+  EXPECT_EQ(plan.back().end, 60);
+  for (size_t i = 0; i + 1 < plan.size(); ++i) {
+    EXPECT_EQ(plan[i].end, plan[i + 1].begin);
+    EXPECT_NE(std::find(keyframes.begin(), keyframes.end(), plan[i].end),
+              keyframes.end());
+  }
+}
+
+TEST(BatchPlanTest, FewerSegmentsThanKeyframes) {
+  // Only two keyframes: at most two segments whatever is requested
+  const auto plan = BatchTranscoder::planSegments({0, 30}, 60, 8);
+
+  ASSERT_EQ(plan.size(), 2u);
+  EXPECT_EQ(plan[0].begin, 0);
+  EXPECT_EQ(plan[0].end, 30);
+  EXPECT_EQ(plan[1].begin, 30);
+  EXPECT_EQ(plan[1].end, 60);
+}
+
+TEST(BatchPlanTest, MinimumSegmentLength) {
+  const std::vector<int64_t> keyframes{0, 10, 20, 30, 40, 50};
+  const auto plan = BatchTranscoder::planSegments(keyframes, 60, 6, 25);
+
+  ASSERT_FALSE(plan.empty());
+  for (const auto &segment : plan) {
+    EXPECT_GE(segment.end - segment.begin, 25);
+  }
+}
+
+TEST(BatchPlanTest, EmptyInput) {
+  EXPECT_TRUE(BatchTranscoder::planSegments({0}, 0, 4).empty());
+
+  const auto plan = BatchTranscoder::planSegments({0}, 60, 4);
+  ASSERT_EQ(plan.size(), 1u);
+  EXPECT_EQ(plan[0].end, 60);
+}
+
+// ==================== MjpegAviWriter Tests ====================
+
+TEST(MjpegAviWriterTest, WrittenFileIsPlayable) {
+  const std::string path = "/tmp/test_mjpeg_writer.avi";
+  FrameEncoder encoder(90);
+  MjpegAviWriter writer;
+
+  ASSERT_TRUE(writer.open(path, cv::Size(64, 48), 25.0));
+  std::vector<uint8_t> jpeg;
+  for (int i = 0; i < 10; ++i) {
+    cv::Mat frame(48, 64, CV_8UC3, cv::Scalar(i * 20, i * 20, i * 20));
+    ASSERT_TRUE(encoder.encodeJPEG(frame, jpeg));
+    ASSERT_TRUE(writer.writeFrame(jpeg));
+  }
+  EXPECT_EQ(writer.getFrameCount(), 10u);
+  ASSERT_TRUE(writer.close());
+  EXPECT_EQ(writer.getBytesWritten(), std::filesystem::file_size(path));
+
+  cv::VideoCapture capture(path);
+  ASSERT_TRUE(capture.isOpened());
+  EXPECT_NEAR(capture.get(cv::CAP_PROP_FPS), 25.0, 0.01);
+
+  cv::Mat frame;
+  int count = 0;
+  while (capture.read(frame)) {
+    EXPECT_EQ(frame.cols, 64);
+    EXPECT_EQ(frame.rows, 48);
+    EXPECT_NEAR(cv::mean(frame)[0], count * 20.0, 3.0);
+    ++count;
+  }
+  EXPECT_EQ(count, 10);
+}
+
+TEST(MjpegAviWriterTest, RejectsInvalidUse) {
+  MjpegAviWriter writer;
+  const std::vector<uint8_t> jpeg{0xFF, 0xD8};
+
+  EXPECT_FALSE(writer.writeFrame(jpeg)); // not opened
+  EXPECT_FALSE(writer.close());
+  EXPECT_FALSE(writer.open("/tmp/test_mjpeg_writer.avi", cv::Size(0, 48), 25));
+  EXPECT_FALSE(writer.open("/tmp/test_mjpeg_writer.avi", cv::Size(64, 48), 0));
+}
+
+// ==================== BatchTranscoder Tests ====================
+
+class BatchTranscoderTest : public ::testing::Test {
+protected:
+  const std::string input_ = "/tmp/test_batch_input.mp4";
+
+  void SetUp() override {
+    // mp4v keyframes are close enough to split 60 frames in segments
+    cv::VideoWriter writer(input_, cv::VideoWriter::fourcc('m', 'p', '4', 'v'),
+                           30, cv::Size(96, 64));
+    for (int i = 0; i < 60; ++i) {
+      cv::Mat frame(64, 96, CV_8UC3, cv::Scalar(i * 4, 255 - i * 4, 128));
+      writer.write(frame);
+    }
+    writer.release();
+  }
+
+  static void grayscale(visioncore::pipeline::FramePipeline &pipeline) {
+    pipeline.addFilter(std::make_shared<GrayscaleFilter>());
+  }
+};
+
+TEST_F(BatchTranscoderTest, ConstructorRejectsInvalidQuality) {
+  BatchOptions options;
+  options.quality = 101;
+  EXPECT_THROW(BatchTranscoder(input_, "/tmp/out.avi", nullptr, options),
+               std::invalid_argument);
+}
+
+TEST_F(BatchTranscoderTest, MissingInputThrows) {
+  BatchTranscoder transcoder("nonexistent_file.mp4", "/tmp/out.avi", nullptr);
+  EXPECT_THROW(transcoder.run(), std::runtime_error);
+}
+
+TEST_F(BatchTranscoderTest, ProcessesEveryFrame) {
+  const std::string output = "/tmp/test_batch_output.avi";
+  BatchOptions options;
+  options.segments = 4;
+  BatchTranscoder transcoder(input_, output, grayscale, options);
+
+  const BatchReport report = transcoder.run();
+
+  EXPECT_EQ(report.frames, 60u);
+  EXPECT_GT(report.fps, 0.0);
+  EXPECT_GT(report.cpu_seconds, 0.0);
+  EXPECT_GT(report.core_utilization, 0.0);
+  EXPECT_EQ(report.output_bytes, std::filesystem::file_size(output));
+
+  uint64_t segment_frames = 0;
+  for (const auto &segment : report.segments) {
+    segment_frames += segment.frames;
+  }
+  EXPECT_EQ(segment_frames, 60u);
+
+  // Frames come out in order, processed
+  cv::VideoCapture capture(output);
+  ASSERT_TRUE(capture.isOpened());
+  cv::Mat frame;
+  for (int i = 0; i < 60; ++i) {
+    ASSERT_TRUE(capture.read(frame));
+    EXPECT_EQ(frame.cols, 96);
+    EXPECT_EQ(frame.rows, 64);
+  }
+  EXPECT_FALSE(capture.read(frame));
+
+  // Spool files are cleaned up
+  for (size_t i = 0; i < report.segments.size(); ++i) {
+    EXPECT_FALSE(std::filesystem::exists(output + ".seg" + std::to_string(i) +
+                                         ".tmp"));
+  }
+}
+
+TEST_F(BatchTranscoderTest, ParallelOutputMatchesSerial) {
+  BatchOptions serial_options;
+  serial_options.segments = 1;
+  BatchTranscoder serial(input_, "/tmp/test_batch_serial.avi", grayscale,
+                         serial_options);
+  const BatchReport serial_report = serial.run();
+  ASSERT_EQ(serial_report.segments.size(), 1u);
+
+  BatchOptions parallel_options;
+  parallel_options.segments = 4;
+  BatchTranscoder parallel(input_, "/tmp/test_batch_parallel.avi", grayscale,
+                           parallel_options);
+  const BatchReport parallel_report = parallel.run();
+
+  EXPECT_EQ(parallel_report.frames, serial_report.frames);
+  EXPECT_EQ(readFile("/tmp/test_batch_parallel.avi"),
+            readFile("/tmp/test_batch_serial.avi"));
+}
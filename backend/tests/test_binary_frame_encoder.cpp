@@ -0,0 +1,272 @@
+// tests/test_binary_frame_encoder.cpp
+#include "network/BinaryFrameEncoder.hpp"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstring>
+#include <opencv2/opencv.hpp>
+#include <zlib.h>
+
+using namespace visioncore;
+using network::BinaryFrameEncoder;
+using network::FrameHeader;
+using network::PayloadType;
+using network::PixelFormat;
+
+namespace {
+
+cv::Mat makeFrame(int type = CV_8UC3) {
+  cv::Mat frame(120, 160, type);
+  cv::RNG rng(3);
+  rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+  cv::GaussianBlur(frame, frame, cv::Size(7, 7), 0);
+  return frame;
+}
+
+network::FrameMetadata makeMetadata(uint64_t frame_id) {
+  const auto now = std::chrono::steady_clock::now();
+  network::FrameMetadata meta;
+  meta.frame_id = frame_id;
+  meta.capture_time = now - std::chrono::milliseconds(30);
+  meta.processed_time = now - std::chrono::milliseconds(10);
+  return meta;
+}
+
+FrameHeader header(const BinaryFrameEncoder::Buffer &message) {
+  FrameHeader parsed;
+  EXPECT_TRUE(BinaryFrameEncoder::parseHeader(message->data(),
+                                              message->size(), parsed));
+  return parsed;
+}
+
+cv::Mat payloadMat(const BinaryFrameEncoder::Buffer &message) {
+  const FrameHeader parsed = header(message);
+  return cv::Mat(1, static_cast<int>(parsed.payload_bytes), CV_8UC1,
+                 message->data() + parsed.header_bytes);
+}
+
+} // namespace
+
+TEST(BinaryFrameEncoderTest, HeaderCarriesMetadata) {
+  BinaryFrameEncoder encoder;
+  const auto message = encoder.encodeRaw(makeFrame(), makeMetadata(42), false);
+  ASSERT_NE(message, nullptr);
+  ASSERT_EQ(std::memcmp(message->data(), "VCF1", 4), 0);
+
+  const FrameHeader parsed = header(message);
+  EXPECT_EQ(parsed.header_bytes, network::kFrameHeaderBytes);
+  EXPECT_EQ(parsed.payload, PayloadType::RAW);
+  EXPECT_EQ(parsed.format, PixelFormat::BGR8);
+  EXPECT_EQ(parsed.frame_id, 42u);
+  EXPECT_EQ(parsed.width, 160);
+  EXPECT_EQ(parsed.height, 120);
+  EXPECT_EQ(parsed.payload_bytes + network::kFrameHeaderBytes,
+            message->size());
+
+  // Wall-clock microseconds, in pipeline order
+  EXPECT_GT(parsed.capture_us, 0u);
+  EXPECT_NEAR(static_cast<double>(parsed.processed_us - parsed.capture_us),
+              20000.0, 5000.0);
+  EXPECT_GE(parsed.encoded_us, parsed.processed_us);
+
+  // Unknown times are 0
+  const auto unknown = encoder.encodeRaw(makeFrame(), {}, false);
+  EXPECT_EQ(header(unknown).capture_us, 0u);
+  EXPECT_EQ(header(unknown).processed_us, 0u);
+}
+
+TEST(BinaryFrameEncoderTest, RawPayloadPacksRows) {
+  BinaryFrameEncoder encoder;
+  const cv::Mat frame = makeFrame(CV_8UC1);
+  const cv::Mat roi = frame(cv::Rect(10, 20, 50, 40)); // not continuous
+
+  const auto message = encoder.encodeRaw(roi, makeMetadata(1), false);
+  ASSERT_NE(message, nullptr);
+  EXPECT_EQ(header(message).format, PixelFormat::GRAY8);
+
+  const cv::Mat pixels(40, 50, CV_8UC1,
+                       message->data() + network::kFrameHeaderBytes);
+  EXPECT_EQ(cv::norm(pixels, roi, cv::NORM_INF), 0.0);
+}
+
+TEST(BinaryFrameEncoderTest, ZlibPayloadInflatesToRaw) {
+  BinaryFrameEncoder encoder;
+  const cv::Mat frame = makeFrame(CV_8UC4);
+  for (const cv::Mat &source : {frame, frame(cv::Rect(5, 5, 100, 60))}) {
+    const auto message = encoder.encodeRaw(source, makeMetadata(2), true);
+    ASSERT_NE(message, nullptr);
+    const FrameHeader parsed = header(message);
+    EXPECT_EQ(parsed.payload, PayloadType::RAW_ZLIB);
+    EXPECT_EQ(parsed.format, PixelFormat::BGRA8);
+
+    cv::Mat inflated(source.size(), source.type());
+    uLongf size = static_cast<uLongf>(inflated.total() * inflated.elemSize());
+    ASSERT_EQ(uncompress(inflated.data, &size,
+                         message->data() + parsed.header_bytes,
+                         parsed.payload_bytes),
+              Z_OK);
+    EXPECT_EQ(size, inflated.total() * inflated.elemSize());
+    EXPECT_EQ(cv::norm(inflated, source, cv::NORM_INF), 0.0);
+  }
+}
+
+TEST(BinaryFrameEncoderTest, JpegPayloadDecodes) {
+  BinaryFrameEncoder encoder;
+  processing::EncodeSpec spec;
+  spec.quality = 90;
+  spec.size = cv::Size(80, 60);
+
+  const auto message = encoder.encodeJpeg(makeFrame(), makeMetadata(3), spec);
+  ASSERT_NE(message, nullptr);
+  EXPECT_EQ(header(message).payload, PayloadType::JPEG);
+  EXPECT_EQ(header(message).width, 80);
+
+  const cv::Mat decoded =
+      cv::imdecode(payloadMat(message), cv::IMREAD_UNCHANGED);
+  EXPECT_EQ(decoded.size(), spec.size);
+}
+
+TEST(BinaryFrameEncoderTest, CachedJpegIsEncodedOnce) {
+  BinaryFrameEncoder encoder;
+  processing::EncodedFrameCache cache;
+  processing::EncodeSpec spec;
+  spec.quality = 80;
+  spec.size = cv::Size(80, 60);
+  const cv::Mat frame = makeFrame();
+
+  // Another consumer of the same frame and spec encoded it first
+  const processing::EncodedBuffer jpeg = cache.get(7, frame, spec);
+  ASSERT_NE(jpeg, nullptr);
+
+  const auto message = encoder.encodeJpeg(frame, makeMetadata(7), spec, cache);
+  ASSERT_NE(message, nullptr);
+  EXPECT_EQ(cache.getStats().encodes, 1u);
+
+  const FrameHeader parsed = header(message);
+  EXPECT_EQ(parsed.payload, PayloadType::JPEG);
+  EXPECT_EQ(parsed.frame_id, 7u);
+  EXPECT_EQ(parsed.width, 80);
+  EXPECT_EQ(parsed.height, 60);
+  ASSERT_EQ(parsed.payload_bytes, jpeg->size());
+  EXPECT_EQ(std::memcmp(message->data() + parsed.header_bytes, jpeg->data(),
+                        jpeg->size()),
+            0);
+}
+
+TEST(BinaryFrameEncoderTest, TileDeltaPayload) {
+  BinaryFrameEncoder encoder;
+  processing::TileDeltaEncoder delta;
+  const cv::Mat frame = makeFrame();
+
+  const auto keyframe =
+      encoder.encodeTileDelta(frame, makeMetadata(4), delta, {});
+  ASSERT_NE(keyframe, nullptr);
+  EXPECT_EQ(header(keyframe).payload, PayloadType::TILE_DELTA);
+
+  const cv::Mat payload = payloadMat(keyframe);
+  processing::TileDeltaHeader packet;
+  std::vector<processing::TilePatch> patches;
+  ASSERT_TRUE(processing::TileDeltaEncoder::parse(
+      payload.data, payload.total(), packet, patches));
+  EXPECT_TRUE(packet.keyframe);
+
+  // Nothing changed, nothing to send
+  EXPECT_EQ(encoder.encodeTileDelta(frame, makeMetadata(5), delta, {}),
+            nullptr);
+}
+
+TEST(BinaryFrameEncoderTest, LosslessPayload) {
+  processing::LosslessOptions options;
+  options.predictor = processing::LosslessPredictor::FRAME_DELTA;
+  BinaryFrameEncoder encoder(4, 1, options);
+  const cv::Mat frame = makeFrame();
+
+  cv::Mat decoded;
+  processing::LosslessStats stats;
+  for (int i = 0; i < 3; ++i) {
+    if (i == 2) {
+      encoder.requestKeyframe(); // e.g. a client joined
+    }
+    const auto message = encoder.encodeLossless(frame, makeMetadata(i), &stats);
+    ASSERT_NE(message, nullptr);
+    EXPECT_EQ(header(message).payload, PayloadType::LOSSLESS);
+    EXPECT_EQ(stats.predictor == processing::LosslessPredictor::FRAME_DELTA,
+              i == 1);
+
+    const cv::Mat payload = payloadMat(message);
+    ASSERT_TRUE(processing::FrameEncoder::decodeLossless(
+        payload.data, payload.total(), decoded));
+    EXPECT_EQ(cv::norm(decoded, frame, cv::NORM_INF), 0.0);
+  }
+}
+
+TEST(BinaryFrameEncoderTest, SimulcastPayloads) {
+  BinaryFrameEncoder encoder(8);
+  processing::SimulcastEncoder simulcast(
+      *processing::SimulcastEncoder::parse("120:90,60:70"));
+
+  const auto messages = encoder.encodeSimulcast(makeFrame(), makeMetadata(6),
+                                                simulcast, {false, true});
+  ASSERT_EQ(messages.size(), 2u);
+  EXPECT_EQ(messages[0], nullptr); // nobody watches it
+  ASSERT_NE(messages[1], nullptr);
+
+  const FrameHeader parsed = header(messages[1]);
+  EXPECT_EQ(parsed.payload, PayloadType::JPEG);
+  EXPECT_EQ(parsed.frame_id, 6u);
+  EXPECT_EQ(parsed.width, 80);
+  EXPECT_EQ(parsed.height, 60);
+  const cv::Mat decoded =
+      cv::imdecode(payloadMat(messages[1]), cv::IMREAD_UNCHANGED);
+  EXPECT_EQ(decoded.size(), cv::Size(80, 60));
+}
+
+TEST(BinaryFrameEncoderTest, RejectsBadInput) {
+  BinaryFrameEncoder encoder;
+  EXPECT_EQ(encoder.encodeRaw(cv::Mat(), {}, false), nullptr);
+  EXPECT_EQ(encoder.encodeRaw(cv::Mat(8, 8, CV_32FC1), {}, false), nullptr);
+  EXPECT_EQ(encoder.encodeJpeg(cv::Mat(), {}, {}), nullptr);
+
+  const auto message = encoder.encodeRaw(makeFrame(), {}, false);
+  FrameHeader parsed;
+  EXPECT_FALSE(BinaryFrameEncoder::parseHeader(message->data(),
+                                               message->size() - 1, parsed));
+  EXPECT_FALSE(BinaryFrameEncoder::parseHeader(message->data(), 20, parsed));
+  (*message)[0] = 'X';
+  EXPECT_FALSE(BinaryFrameEncoder::parseHeader(message->data(),
+                                               message->size(), parsed));
+}
+
+TEST(BinaryFrameEncoderTest, FrameSizeLimitedToHeaderFields) {
+  BinaryFrameEncoder encoder;
+
+  // Width and height are 16-bit header fields
+  const cv::Mat widest(1, network::kMaxFrameDimension, CV_8UC1,
+                       cv::Scalar(7));
+  const auto message = encoder.encodeRaw(widest, {}, false);
+  ASSERT_NE(message, nullptr);
+  EXPECT_EQ(header(message).width, network::kMaxFrameDimension);
+  EXPECT_EQ(header(message).height, 1);
+
+  const cv::Mat too_wide(1, network::kMaxFrameDimension + 1, CV_8UC1,
+                         cv::Scalar(7));
+  EXPECT_EQ(encoder.encodeRaw(too_wide, {}, false), nullptr);
+  EXPECT_EQ(encoder.encodeRaw(too_wide.t(), {}, true), nullptr);
+  EXPECT_EQ(encoder.encodeLossless(too_wide, {}), nullptr);
+
+  // The limit applies to the encoded size, not to the source frame
+  processing::EncodeSpec spec;
+  spec.size = cv::Size(64, 1);
+  EXPECT_NE(encoder.encodeJpeg(too_wide, {}, spec), nullptr);
+  spec.size = cv::Size(network::kMaxFrameDimension + 1, 1);
+  EXPECT_EQ(encoder.encodeJpeg(makeFrame(), {}, spec), nullptr);
+}
+
+TEST(BinaryFrameEncoderTest, BuffersComeBackToThePool) {
+  BinaryFrameEncoder encoder(2);
+  const cv::Mat frame = makeFrame();
+  for (int i = 0; i < 20; ++i) {
+    const auto message = encoder.encodeJpeg(frame, makeMetadata(i), {});
+    ASSERT_NE(message, nullptr);
+  }
+  EXPECT_EQ(encoder.getPoolAllocations(), 2u);
+}
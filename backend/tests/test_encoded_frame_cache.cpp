@@ -0,0 +1,204 @@
+// tests/test_encoded_frame_cache.cpp
+#include "core/SyntheticSource.hpp"
+#include "processing/EncodedFrameCache.hpp"
+#include "processing/FrameController.hpp"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <memory>
+#include <opencv2/opencv.hpp>
+#include <thread>
+#include <vector>
+
+using namespace visioncore::processing;
+using namespace visioncore::core;
+
+namespace {
+
+cv::Mat makeFrame(uchar value) {
+  return cv::Mat(48, 64, CV_8UC3, cv::Scalar::all(value));
+}
+
+} // namespace
+
+TEST(EncodedFrameCacheTest, SameVariantEncodedOnce) {
+  EncodedFrameCache cache;
+  const cv::Mat frame = makeFrame(100);
+  EncodeSpec spec;
+
+  const EncodedBuffer first = cache.get(0, frame, spec);
+  const EncodedBuffer second = cache.get(0, frame, spec);
+
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(first, second); // the very same buffer
+  EXPECT_FALSE(first->empty());
+
+  const EncodedCacheStats stats = cache.getStats();
+  EXPECT_EQ(stats.requests, 2u);
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.encodes, 1u);
+  EXPECT_EQ(stats.entries, 1u);
+  EXPECT_EQ(stats.bytes, first->size());
+}
+
+TEST(EncodedFrameCacheTest, VariantsAreDistinct) {
+  EncodedFrameCache cache;
+  const cv::Mat frame = makeFrame(100);
+
+  EncodeSpec high;
+  high.quality = 95;
+  EncodeSpec low;
+  low.quality = 40;
+  EncodeSpec small;
+  small.size = cv::Size(32, 24);
+  EncodeSpec png;
+  png.codec = Codec::PNG;
+  png.quality = 3;
+
+  const EncodedBuffer a = cache.get(0, frame, high);
+  const EncodedBuffer b = cache.get(0, frame, low);
+  const EncodedBuffer c = cache.get(0, frame, small);
+  const EncodedBuffer d = cache.get(0, frame, png);
+  EXPECT_NE(a, b);
+  EXPECT_NE(a, c);
+  EXPECT_NE(a, d);
+  EXPECT_EQ(cache.getStats().encodes, 4u);
+
+  const cv::Mat decoded = cv::imdecode(*c, cv::IMREAD_COLOR);
+  EXPECT_EQ(decoded.size(), cv::Size(32, 24));
+
+  const cv::Mat lossless = cv::imdecode(*d, cv::IMREAD_COLOR);
+  EXPECT_EQ(cv::norm(lossless, frame, cv::NORM_INF), 0.0);
+}
+
+TEST(EncodedFrameCacheTest, ExplicitSizeMatchingFrameSharesEntry) {
+  EncodedFrameCache cache;
+  const cv::Mat frame = makeFrame(100);
+
+  EncodeSpec native;
+  EncodeSpec explicitSize;
+  explicitSize.size = frame.size();
+
+  EXPECT_EQ(cache.get(0, frame, native), cache.get(0, frame, explicitSize));
+}
+
+TEST(EncodedFrameCacheTest, OldFramesEvictedButBuffersStayValid) {
+  EncodedFrameCache cache(2);
+  EncodeSpec spec;
+
+  const EncodedBuffer held = cache.get(0, makeFrame(10), spec);
+  const std::vector<uint8_t> copy = *held;
+
+  cache.get(1, makeFrame(20), spec);
+  cache.get(2, makeFrame(30), spec);
+
+  // Frame 0 left the window, the consumer still owns its reference
+  EXPECT_EQ(cache.getStats().entries, 2u);
+  EXPECT_EQ(*held, copy);
+  EXPECT_EQ(held.use_count(), 1);
+
+  // Requests for a frame outside the window are encoded but not cached
+  const EncodedBuffer late = cache.get(0, makeFrame(10), spec);
+  ASSERT_NE(late, nullptr);
+  EXPECT_NE(late, held);
+  EXPECT_EQ(cache.getStats().entries, 2u);
+}
+
+TEST(EncodedFrameCacheTest, EmptyFrameFailsAndIsNotCached) {
+  EncodedFrameCache cache;
+  EncodeSpec spec;
+
+  EXPECT_EQ(cache.get(0, cv::Mat(), spec), nullptr);
+  EXPECT_EQ(cache.getStats().failures, 1u);
+  EXPECT_EQ(cache.getStats().entries, 0u);
+
+  // Retried on the next request
+  EXPECT_NE(cache.get(0, makeFrame(50), spec), nullptr);
+}
+
+TEST(EncodedFrameCacheTest, ThrowingEncodeFailsAndIsNotCached) {
+  EncodedFrameCache cache;
+  EncodeSpec spec;
+  spec.codec = Codec::PNG;
+
+  // The PNG encoder throws on 2-channel frames
+  const cv::Mat two_channels(16, 16, CV_8UC2, cv::Scalar(1, 2));
+  EXPECT_EQ(cache.get(0, two_channels, spec), nullptr);
+  EXPECT_EQ(cache.getStats().failures, 1u);
+  EXPECT_EQ(cache.getStats().entries, 0u);
+
+  EXPECT_NE(cache.get(0, makeFrame(50), spec), nullptr);
+}
+
+TEST(EncodedFrameCacheTest, ConcurrentConsumersShareOneEncode) {
+  EncodedFrameCache cache;
+  const cv::Mat frame(720, 1280, CV_8UC3, cv::Scalar(10, 80, 160));
+  EncodeSpec spec;
+
+  constexpr int kConsumers = 8;
+  std::vector<EncodedBuffer> results(kConsumers);
+  std::atomic<bool> go{false};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kConsumers; ++i) {
+    threads.emplace_back([&, i] {
+      while (!go) {
+        std::this_thread::yield();
+      }
+      results[i] = cache.get(42, frame, spec);
+    });
+  }
+  go = true;
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  for (const auto &result : results) {
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(result, results.front());
+  }
+  EXPECT_EQ(cache.getStats().encodes, 1u);
+  EXPECT_EQ(cache.getStats().hits, kConsumers - 1u);
+}
+
+TEST(EncodedFrameCacheTest, ClearKeepsHandedOutBuffers) {
+  EncodedFrameCache cache;
+  const EncodedBuffer held = cache.get(0, makeFrame(10), EncodeSpec{});
+  cache.clear();
+
+  EXPECT_EQ(cache.getStats().entries, 0u);
+  EXPECT_EQ(cache.getStats().bytes, 0u);
+  EXPECT_FALSE(held->empty());
+}
+
+TEST(EncodedFrameCacheTest, ControllerSharesEncodeWithFrameCallback) {
+  FrameController controller;
+  const auto cache = controller.getEncodedFrameCache();
+
+  EncodeSpec spec;
+  spec.quality = 70;
+  controller.setEncodeSpec(spec);
+
+  std::vector<EncodedBuffer> fromFrameCallback;
+  std::vector<const uint8_t *> fromEncodedCallback;
+  controller.setFrameCallback(
+      [&](const cv::Mat &, const cv::Mat &processed, uint64_t frame_id) {
+        fromFrameCallback.push_back(cache->get(frame_id, processed, spec));
+      });
+  controller.setEncodedFrameCallback(
+      [&](const std::vector<uint8_t> &data) {
+        fromEncodedCallback.push_back(data.data());
+      });
+
+  SyntheticOptions options;
+  options.width = 160;
+  options.height = 120;
+  options.frame_count = 10;
+  controller.start(std::make_unique<SyntheticSource>(options), 0.0);
+  controller.wait();
+
+  ASSERT_EQ(fromFrameCallback.size(), 10u);
+  ASSERT_EQ(fromEncodedCallback.size(), 10u);
+  for (size_t i = 0; i < fromFrameCallback.size(); ++i) {
+    EXPECT_EQ(fromFrameCallback[i]->data(), fromEncodedCallback[i]);
+  }
+  EXPECT_EQ(cache->getStats().encodes, 10u);
+}
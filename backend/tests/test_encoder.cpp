@@ -0,0 +1,421 @@
+// tests/test_encoder.cpp
+#include "processing/FrameEncoder.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+#include <opencv2/opencv.hpp>
+#include <thread>
+#include <vector>
+
+using namespace visioncore::processing;
+
+namespace {
+
+cv::Mat makeColorFrame() {
+  cv::Mat frame(240, 320, CV_8UC3);
+  cv::RNG rng(7);
+  rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+  cv::GaussianBlur(frame, frame, cv::Size(5, 5), 0);
+  return frame;
+}
+
+// Smooth gradients, where prediction pays off
+cv::Mat makeSmoothFrame() {
+  cv::Mat frame(240, 320, CV_8UC3);
+  for (int y = 0; y < frame.rows; ++y) {
+    uchar *row = frame.ptr<uchar>(y);
+    for (int x = 0; x < frame.cols; ++x) {
+      const double v = 60.0 * std::sin(x * 0.05) * std::cos(y * 0.07);
+      row[3 * x] = cv::saturate_cast<uchar>(128 + v);
+      row[3 * x + 1] = cv::saturate_cast<uchar>(100 + v / 2 + y / 4);
+      row[3 * x + 2] = cv::saturate_cast<uchar>(200 - v + x / 8);
+    }
+  }
+  return frame;
+}
+
+JpegOptions withBackend(JpegBackend backend) {
+  JpegOptions options;
+  options.backend = backend;
+  return options;
+}
+
+} // namespace
+
+TEST(FrameEncoderTest, EmptyFrameFails) {
+  FrameEncoder encoder;
+  std::vector<uint8_t> buffer;
+  EXPECT_FALSE(encoder.encodeJPEG(cv::Mat(), buffer));
+}
+
+TEST(FrameEncoderTest, BackendSelection) {
+  EXPECT_EQ(FrameEncoder(90, withBackend(JpegBackend::OPENCV)).getBackend(),
+            JpegBackend::OPENCV);
+
+  const JpegBackend expected = FrameEncoder::hasLibjpeg()
+                                   ? JpegBackend::LIBJPEG
+                                   : JpegBackend::OPENCV;
+  EXPECT_EQ(FrameEncoder(90).getBackend(), expected);
+  EXPECT_EQ(FrameEncoder(90, withBackend(JpegBackend::LIBJPEG)).getBackend(),
+            expected);
+  EXPECT_EQ(FrameEncoder(42).getQuality(), 42);
+}
+
+TEST(FrameEncoderTest, ColorRoundTrip) {
+  const cv::Mat frame = makeColorFrame();
+  std::vector<uint8_t> buffer;
+  ASSERT_TRUE(FrameEncoder(95).encodeJPEG(frame, buffer));
+
+  const cv::Mat decoded = cv::imdecode(buffer, cv::IMREAD_UNCHANGED);
+  ASSERT_EQ(decoded.size(), frame.size());
+  ASSERT_EQ(decoded.type(), CV_8UC3);
+  EXPECT_GT(cv::PSNR(decoded, frame), 30.0);
+}
+
+TEST(FrameEncoderTest, GrayInputGivesGrayJpeg) {
+  cv::Mat gray;
+  cv::cvtColor(makeColorFrame(), gray, cv::COLOR_BGR2GRAY);
+  std::vector<uint8_t> buffer;
+  ASSERT_TRUE(FrameEncoder(95).encodeJPEG(gray, buffer));
+
+  const cv::Mat decoded = cv::imdecode(buffer, cv::IMREAD_UNCHANGED);
+  ASSERT_EQ(decoded.type(), CV_8UC1);
+  EXPECT_GT(cv::PSNR(decoded, gray), 30.0);
+}
+
+TEST(FrameEncoderTest, BgraInputEncodesColor) {
+  cv::Mat bgra;
+  cv::cvtColor(makeColorFrame(), bgra, cv::COLOR_BGR2BGRA);
+  std::vector<uint8_t> buffer;
+  ASSERT_TRUE(FrameEncoder(95).encodeJPEG(bgra, buffer));
+
+  const cv::Mat decoded = cv::imdecode(buffer, cv::IMREAD_UNCHANGED);
+  EXPECT_EQ(decoded.type(), CV_8UC3);
+  EXPECT_EQ(decoded.size(), bgra.size());
+}
+
+TEST(FrameEncoderTest, NonContinuousRoi) {
+  const cv::Mat frame = makeColorFrame();
+  const cv::Mat roi = frame(cv::Rect(13, 7, 101, 77));
+  ASSERT_FALSE(roi.isContinuous());
+
+  std::vector<uint8_t> buffer;
+  ASSERT_TRUE(FrameEncoder(95).encodeJPEG(roi, buffer));
+  const cv::Mat decoded = cv::imdecode(buffer, cv::IMREAD_COLOR);
+  ASSERT_EQ(decoded.size(), roi.size());
+  EXPECT_GT(cv::PSNR(decoded, roi), 30.0);
+}
+
+TEST(FrameEncoderTest, BackendsAgree) {
+  const cv::Mat frame = makeColorFrame();
+  std::vector<uint8_t> a;
+  std::vector<uint8_t> b;
+  ASSERT_TRUE(
+      FrameEncoder(90, withBackend(JpegBackend::OPENCV)).encodeJPEG(frame, a));
+  ASSERT_TRUE(FrameEncoder(90).encodeJPEG(frame, b));
+
+  const cv::Mat da = cv::imdecode(a, cv::IMREAD_COLOR);
+  const cv::Mat db = cv::imdecode(b, cv::IMREAD_COLOR);
+  EXPECT_GT(cv::PSNR(da, db), 40.0);
+}
+
+TEST(FrameEncoderTest, BufferCapacityReused) {
+  if (!FrameEncoder::hasLibjpeg()) {
+    GTEST_SKIP() << "libjpeg backend not built";
+  }
+
+  const cv::Mat frame = makeColorFrame();
+  const FrameEncoder encoder(85);
+  std::vector<uint8_t> buffer;
+  ASSERT_TRUE(encoder.encodeJPEG(frame, buffer));
+  const uint8_t *data = buffer.data();
+  const size_t size = buffer.size();
+
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(encoder.encodeJPEG(frame, buffer));
+    EXPECT_EQ(buffer.data(), data); // no reallocation
+    EXPECT_EQ(buffer.size(), size);
+  }
+}
+
+TEST(FrameEncoderTest, SmallBufferGrows) {
+  std::vector<uint8_t> buffer;
+  buffer.reserve(8);
+  ASSERT_TRUE(FrameEncoder(100).encodeJPEG(makeColorFrame(), buffer));
+  EXPECT_FALSE(cv::imdecode(buffer, cv::IMREAD_COLOR).empty());
+}
+
+TEST(FrameEncoderTest, OffsetKeepsPrefix) {
+  const cv::Mat frame = makeColorFrame();
+  for (const JpegBackend backend : {JpegBackend::AUTO, JpegBackend::OPENCV}) {
+    const FrameEncoder encoder(85, withBackend(backend));
+    std::vector<uint8_t> plain;
+    ASSERT_TRUE(encoder.encodeJPEG(frame, plain));
+
+    std::vector<uint8_t> framed(48, 0xAB); // e.g. a message header
+    ASSERT_TRUE(encoder.encodeJPEG(frame, framed, 48));
+    ASSERT_EQ(framed.size(), 48 + plain.size());
+    EXPECT_EQ(std::count(framed.begin(), framed.begin() + 48, 0xAB), 48);
+    EXPECT_TRUE(std::equal(plain.begin(), plain.end(), framed.begin() + 48));
+  }
+}
+
+TEST(FrameEncoderTest, SubsamplingModes) {
+  if (!FrameEncoder::hasLibjpeg()) {
+    GTEST_SKIP() << "libjpeg backend not built";
+  }
+
+  const cv::Mat frame = makeColorFrame();
+  size_t sizes[3];
+  const ChromaSubsampling modes[3] = {ChromaSubsampling::S444,
+                                      ChromaSubsampling::S422,
+                                      ChromaSubsampling::S420};
+  for (int i = 0; i < 3; ++i) {
+    JpegOptions options;
+    options.subsampling = modes[i];
+    std::vector<uint8_t> buffer;
+    ASSERT_TRUE(FrameEncoder(90, options).encodeJPEG(frame, buffer));
+    EXPECT_FALSE(cv::imdecode(buffer, cv::IMREAD_COLOR).empty());
+    sizes[i] = buffer.size();
+  }
+
+  // Less chroma, fewer bytes
+  EXPECT_GT(sizes[0], sizes[1]);
+  EXPECT_GT(sizes[1], sizes[2]);
+}
+
+TEST(FrameEncoderTest, DctMethodsDecode) {
+  const cv::Mat frame = makeColorFrame();
+  for (const DctMethod dct :
+       {DctMethod::ISLOW, DctMethod::IFAST, DctMethod::FLOAT}) {
+    JpegOptions options;
+    options.dct = dct;
+    std::vector<uint8_t> buffer;
+    ASSERT_TRUE(FrameEncoder(90, options).encodeJPEG(frame, buffer));
+    EXPECT_GT(cv::PSNR(cv::imdecode(buffer, cv::IMREAD_COLOR), frame), 30.0);
+  }
+}
+
+TEST(FrameEncoderTest, OptimizedHuffmanDoesNotLeakIntoNextEncode) {
+  const cv::Mat frame = makeColorFrame();
+  std::vector<uint8_t> before;
+  ASSERT_TRUE(FrameEncoder(90).encodeJPEG(frame, before));
+
+  JpegOptions optimized;
+  optimized.optimize_huffman = true;
+  std::vector<uint8_t> small;
+  ASSERT_TRUE(FrameEncoder(90, optimized).encodeJPEG(frame, small));
+  EXPECT_LT(small.size(), before.size());
+
+  // A different image after the optimized one, then the original again
+  cv::Mat other(64, 64, CV_8UC3, cv::Scalar(0, 0, 255));
+  std::vector<uint8_t> buffer;
+  ASSERT_TRUE(FrameEncoder(90).encodeJPEG(other, buffer));
+  EXPECT_FALSE(cv::imdecode(buffer, cv::IMREAD_COLOR).empty());
+
+  std::vector<uint8_t> after;
+  ASSERT_TRUE(FrameEncoder(90).encodeJPEG(frame, after));
+  EXPECT_EQ(after, before);
+}
+
+TEST(FrameEncoderTest, SameOutputOnEveryThread) {
+  const cv::Mat frame = makeColorFrame();
+  std::vector<uint8_t> reference;
+  ASSERT_TRUE(FrameEncoder(80).encodeJPEG(frame, reference));
+
+  std::vector<std::vector<uint8_t>> results(4);
+  std::vector<std::thread> threads;
+  for (auto &result : results) {
+    threads.emplace_back(
+        [&frame, &result] { FrameEncoder(80).encodeJPEG(frame, result); });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  for (const auto &result : results) {
+    EXPECT_EQ(result, reference);
+  }
+}
+
+TEST(FrameEncoderTest, StripsDecodeLikeSerial) {
+  // Odd sizes: partial MCUs at the right and bottom edges
+  cv::Mat frame(481, 643, CV_8UC3);
+  cv::RNG rng(3);
+  rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+
+  for (const ChromaSubsampling subsampling :
+       {ChromaSubsampling::S444, ChromaSubsampling::S422,
+        ChromaSubsampling::S420}) {
+    JpegOptions options;
+    options.subsampling = subsampling;
+    std::vector<uint8_t> serial;
+    ASSERT_TRUE(FrameEncoder(85, options).encodeJPEG(frame, serial));
+
+    options.strips = 5;
+    std::vector<uint8_t> parallel;
+    ASSERT_TRUE(FrameEncoder(85, options).encodeJPEG(frame, parallel));
+
+    // Same coefficients, only the entropy-coded layout differs
+    const cv::Mat a = cv::imdecode(serial, cv::IMREAD_COLOR);
+    const cv::Mat b = cv::imdecode(parallel, cv::IMREAD_COLOR);
+    ASSERT_EQ(b.size(), frame.size());
+    EXPECT_EQ(cv::norm(a, b, cv::NORM_INF), 0.0);
+  }
+}
+
+TEST(FrameEncoderTest, StripsUseRestartMarkers) {
+  if (!FrameEncoder::hasLibjpeg()) {
+    GTEST_SKIP() << "libjpeg backend not built";
+  }
+
+  cv::Mat gray(400, 300, CV_8UC1);
+  cv::randu(gray, 0, 256);
+  JpegOptions options;
+  options.strips = 4;
+  std::vector<uint8_t> buffer;
+  ASSERT_TRUE(FrameEncoder(90, options).encodeJPEG(gray, buffer));
+
+  int dri = 0;
+  int restarts = 0;
+  for (size_t i = 0; i + 1 < buffer.size(); ++i) {
+    if (buffer[i] == 0xFF && buffer[i + 1] == 0xDD) {
+      ++dri;
+    } else if (buffer[i] == 0xFF && buffer[i + 1] >= 0xD0 &&
+               buffer[i + 1] <= 0xD7) {
+      ++restarts;
+    }
+  }
+  EXPECT_EQ(dri, 1);
+  EXPECT_EQ(restarts, 3); // between the 4 strips
+
+  const cv::Mat decoded = cv::imdecode(buffer, cv::IMREAD_UNCHANGED);
+  ASSERT_EQ(decoded.size(), gray.size());
+  EXPECT_GT(cv::PSNR(decoded, gray), 30.0);
+}
+
+TEST(FrameEncoderTest, TooSmallForStripsEncodesSerially) {
+  const cv::Mat frame(16, 16, CV_8UC3, cv::Scalar(1, 2, 3));
+  JpegOptions options;
+  options.strips = 8;
+  std::vector<uint8_t> strips;
+  std::vector<uint8_t> serial;
+  ASSERT_TRUE(FrameEncoder(90, options).encodeJPEG(frame, strips));
+  ASSERT_TRUE(FrameEncoder(90).encodeJPEG(frame, serial));
+  EXPECT_EQ(strips, serial);
+}
+
+TEST(FrameEncoderTest, LosslessRoundTrip) {
+  const cv::Mat color = makeColorFrame();
+  cv::Mat gray;
+  cv::cvtColor(color, gray, cv::COLOR_BGR2GRAY);
+
+  for (const cv::Mat &frame :
+       {color, gray, color(cv::Rect(3, 5, 101, 60))}) { // ROI not continuous
+    for (const LosslessCodec codec :
+         {LosslessCodec::ZLIB, LosslessCodec::AUTO}) {
+      for (const LosslessPredictor predictor :
+           {LosslessPredictor::NONE, LosslessPredictor::LEFT,
+            LosslessPredictor::UP, LosslessPredictor::PAETH,
+            LosslessPredictor::FRAME_DELTA}) {
+        LosslessOptions options;
+        options.predictor = predictor;
+        options.codec = codec;
+        FrameEncoder encoder;
+        encoder.setLosslessOptions(options);
+
+        std::vector<uint8_t> buffer(16, 0xAB);
+        LosslessStats stats;
+        ASSERT_TRUE(encoder.encodeLossless(frame, buffer, 16, &stats));
+        EXPECT_EQ(std::count(buffer.begin(), buffer.begin() + 16, 0xAB), 16);
+        EXPECT_EQ(stats.raw_bytes, frame.total() * frame.elemSize());
+        EXPECT_EQ(stats.encoded_bytes, buffer.size() - 16);
+        EXPECT_DOUBLE_EQ(stats.ratio, static_cast<double>(stats.raw_bytes) /
+                                          stats.encoded_bytes);
+        EXPECT_GT(stats.mb_per_s, 0.0);
+
+        cv::Mat decoded;
+        ASSERT_TRUE(FrameEncoder::decodeLossless(buffer.data() + 16,
+                                                 buffer.size() - 16, decoded));
+        ASSERT_EQ(decoded.size(), frame.size());
+        ASSERT_EQ(decoded.type(), frame.type());
+        EXPECT_EQ(cv::norm(decoded, frame, cv::NORM_INF), 0.0);
+      }
+    }
+  }
+}
+
+TEST(FrameEncoderTest, LosslessPredictionHelpsSmoothFrames) {
+  const cv::Mat frame = makeSmoothFrame();
+  auto encodedSize = [&](LosslessPredictor predictor, LosslessCodec codec) {
+    LosslessOptions options;
+    options.predictor = predictor;
+    options.codec = codec;
+    FrameEncoder encoder;
+    encoder.setLosslessOptions(options);
+    std::vector<uint8_t> buffer;
+    EXPECT_TRUE(encoder.encodeLossless(frame, buffer));
+    return buffer.size();
+  };
+  for (const LosslessCodec codec : {LosslessCodec::ZLIB, LosslessCodec::LZ4}) {
+    const size_t none = encodedSize(LosslessPredictor::NONE, codec);
+    EXPECT_LT(encodedSize(LosslessPredictor::LEFT, codec), none);
+    EXPECT_LT(encodedSize(LosslessPredictor::UP, codec), none);
+    EXPECT_LT(encodedSize(LosslessPredictor::PAETH, codec), none);
+  }
+}
+
+TEST(FrameEncoderTest, LosslessFrameDeltaStream) {
+  LosslessOptions options;
+  options.predictor = LosslessPredictor::FRAME_DELTA;
+  options.keyframe_interval = 3;
+  FrameEncoder encoder;
+  encoder.setLosslessOptions(options);
+
+  cv::Mat frame = makeColorFrame();
+  cv::Mat decoded;
+  std::vector<uint8_t> buffer;
+  std::vector<bool> keyframes;
+  for (int i = 0; i < 7; ++i) {
+    frame(cv::Rect(10 * i, 20, 8, 8)).setTo(cv::Scalar(i, 2 * i, 3 * i));
+    LosslessStats stats;
+    ASSERT_TRUE(encoder.encodeLossless(frame, buffer, 0, &stats));
+    keyframes.push_back(stats.predictor != LosslessPredictor::FRAME_DELTA);
+
+    ASSERT_TRUE(
+        FrameEncoder::decodeLossless(buffer.data(), buffer.size(), decoded));
+    EXPECT_EQ(cv::norm(decoded, frame, cv::NORM_INF), 0.0);
+  }
+  EXPECT_EQ(keyframes, std::vector<bool>({true, false, false, true, false,
+                                          false, true}));
+
+  // A delta frame cannot be decoded without the previous frame
+  ASSERT_TRUE(encoder.encodeLossless(frame, buffer));
+  cv::Mat fresh;
+  EXPECT_FALSE(
+      FrameEncoder::decodeLossless(buffer.data(), buffer.size(), fresh));
+
+  // Unless a keyframe was requested
+  encoder.requestLosslessKeyframe();
+  ASSERT_TRUE(encoder.encodeLossless(frame, buffer));
+  EXPECT_TRUE(
+      FrameEncoder::decodeLossless(buffer.data(), buffer.size(), fresh));
+}
+
+TEST(FrameEncoderTest, LosslessRejectsBadInput) {
+  FrameEncoder encoder;
+  std::vector<uint8_t> buffer;
+  EXPECT_FALSE(encoder.encodeLossless(cv::Mat(), buffer));
+  EXPECT_FALSE(encoder.encodeLossless(cv::Mat(8, 8, CV_32FC1), buffer));
+  EXPECT_FALSE(encoder.encodeLossless(cv::Mat(8, 8, CV_8UC2), buffer));
+
+  ASSERT_TRUE(encoder.encodeLossless(makeColorFrame(), buffer));
+  cv::Mat decoded;
+  EXPECT_FALSE(
+      FrameEncoder::decodeLossless(buffer.data(), buffer.size() - 1, decoded));
+  EXPECT_FALSE(FrameEncoder::decodeLossless(buffer.data(), 12, decoded));
+
+  buffer[0] = 'X';
+  EXPECT_FALSE(
+      FrameEncoder::decodeLossless(buffer.data(), buffer.size(), decoded));
+}
@@ -1,6 +1,11 @@
+#include "../src/filters/CLAHEFilter.hpp"
+#include "../src/filters/CropFilter.hpp"
 #include "../src/filters/GrayscaleFilter.hpp"
+#include "../src/filters/GuidedFilter.hpp"
 #include "../src/filters/LUTFilter.hpp"
+#include "../src/filters/OverlayFilter.hpp"
 #include "../src/filters/ResizeFilter.hpp"
+#include "../src/filters/WarpFilter.hpp"
 #include <gtest/gtest.h>
 #include <opencv2/opencv.hpp>
 #include <string>
@@ -534,3 +539,578 @@ TEST_F(LUTFilterTest, AllLUTTypeStrings) {
     EXPECT_EQ(filter.getParameters()["lut_type"], c.expected);
   }
 }
+
+// ==================== CLAHEFilter Tests ====================
+
+class CLAHEFilterTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    // Low contrast horizontal gradient in [100, 131]
+    test_image_gray_ = cv::Mat(120, 160, CV_8UC1);
+    for (int y = 0; y < test_image_gray_.rows; ++y)
+      for (int x = 0; x < test_image_gray_.cols; ++x)
+        test_image_gray_.at<uint8_t>(y, x) = static_cast<uint8_t>(100 + x / 5);
+
+    cv::cvtColor(test_image_gray_, test_image_, cv::COLOR_GRAY2BGR);
+  }
+
+  cv::Mat test_image_;
+  cv::Mat test_image_gray_;
+};
+
+TEST_F(CLAHEFilterTest, Constructor) {
+  CLAHEFilter filter;
+  EXPECT_EQ(filter.getName(), "clahe");
+  EXPECT_TRUE(filter.isEnabled());
+  EXPECT_DOUBLE_EQ(filter.getParameters()["clip_limit"], 2.0);
+  EXPECT_EQ(filter.getParameters()["tiles_x"], 8);
+  EXPECT_EQ(filter.getParameters()["tiles_y"], 8);
+}
+
+TEST_F(CLAHEFilterTest, InvalidConstructorArguments) {
+  EXPECT_THROW(CLAHEFilter(0.0), std::invalid_argument);
+  EXPECT_THROW(CLAHEFilter(2.0, 0, 8), std::invalid_argument);
+  EXPECT_THROW(CLAHEFilter(2.0, 8, 65), std::invalid_argument);
+}
+
+TEST_F(CLAHEFilterTest, IncreasesLocalContrast) {
+  CLAHEFilter filter(4.0, 4, 4);
+  cv::Mat output;
+
+  filter.apply(test_image_gray_, output);
+
+  ASSERT_EQ(output.type(), CV_8UC1);
+  EXPECT_EQ(output.size(), test_image_gray_.size());
+
+  double in_min, in_max, out_min, out_max;
+  cv::minMaxLoc(test_image_gray_, &in_min, &in_max);
+  cv::minMaxLoc(output, &out_min, &out_max);
+  EXPECT_GT(out_max - out_min, in_max - in_min);
+}
+
+TEST_F(CLAHEFilterTest, ApplyToColorImage) {
+  CLAHEFilter filter;
+  cv::Mat output;
+
+  filter.apply(test_image_, output);
+
+  EXPECT_EQ(output.type(), CV_8UC3);
+  EXPECT_EQ(output.size(), test_image_.size());
+}
+
+TEST_F(CLAHEFilterTest, ApplyToNonContinuousROI) {
+  CLAHEFilter filter(2.0, 2, 2);
+  cv::Mat roi = test_image_gray_(cv::Rect(10, 10, 61, 47));
+  ASSERT_FALSE(roi.isContinuous());
+
+  cv::Mat output;
+  filter.apply(roi, output);
+
+  EXPECT_EQ(output.size(), roi.size());
+}
+
+TEST_F(CLAHEFilterTest, ReuseLUTsOnStableScene) {
+  CLAHEFilter filter;
+  filter.setParameter("reuse_luts", true);
+
+  cv::Mat first, second;
+  filter.apply(test_image_gray_, first);
+  filter.apply(test_image_gray_, second);
+
+  EXPECT_EQ(filter.getLUTBuildCount(), 1u);
+  EXPECT_EQ(filter.getLUTReuseCount(), 1u);
+  EXPECT_EQ(cv::norm(first, second, cv::NORM_INF), 0.0);
+
+  // A large change in the scene must trigger a rebuild
+  cv::Mat brighter = test_image_gray_ + cv::Scalar(80);
+  filter.apply(brighter, second);
+  EXPECT_EQ(filter.getLUTBuildCount(), 2u);
+}
+
+TEST_F(CLAHEFilterTest, InvalidParametersIgnored) {
+  CLAHEFilter filter;
+
+  filter.setParameter("clip_limit", -1.0);
+  filter.setParameter("tiles_x", 0);
+  filter.setParameter("tiles_y", 100);
+  filter.setParameter("unknown_param", 42);
+
+  auto params = filter.getParameters();
+  EXPECT_DOUBLE_EQ(params["clip_limit"], 2.0);
+  EXPECT_EQ(params["tiles_x"], 8);
+  EXPECT_EQ(params["tiles_y"], 8);
+}
+
+TEST_F(CLAHEFilterTest, DisabledFilter) {
+  CLAHEFilter filter;
+  filter.setEnabled(false);
+
+  cv::Mat output;
+  filter.apply(test_image_gray_, output);
+
+  EXPECT_EQ(cv::norm(output, test_image_gray_, cv::NORM_INF), 0.0);
+}
+
+// ==================== WarpFilter Tests ====================
+
+class WarpFilterTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    // Non symmetric 3x2 pattern so that every orientation is distinguishable
+    test_image_ = (cv::Mat_<uint8_t>(2, 3) << 1, 2, 3, 4, 5, 6);
+
+    test_image_large_ = cv::Mat(120, 160, CV_8UC3);
+    cv::randu(test_image_large_, cv::Scalar::all(0), cv::Scalar::all(255));
+  }
+
+  cv::Mat test_image_;
+  cv::Mat test_image_large_;
+};
+
+TEST_F(WarpFilterTest, Constructor) {
+  WarpFilter filter;
+  EXPECT_EQ(filter.getName(), "warp");
+  EXPECT_TRUE(filter.isEnabled());
+  EXPECT_EQ(filter.getParameters()["mode"], "none");
+}
+
+TEST_F(WarpFilterTest, Rotate90UsesTransposeKernel) {
+  WarpFilter filter(WarpFilter::WarpMode::ROTATE_90);
+  cv::Mat output;
+
+  filter.apply(test_image_, output);
+
+  ASSERT_EQ(output.rows, 3);
+  ASSERT_EQ(output.cols, 2);
+  EXPECT_EQ(output.at<uint8_t>(0, 0), 4);
+  EXPECT_EQ(output.at<uint8_t>(0, 1), 1);
+  EXPECT_EQ(filter.getMapBuildCount(), 0u);
+}
+
+TEST_F(WarpFilterTest, RotateAngleMultipleOf90IsFastPath) {
+  WarpFilter filter(WarpFilter::WarpMode::ROTATE);
+  filter.setParameter("angle", 180.0);
+
+  cv::Mat output, expected;
+  filter.apply(test_image_, output);
+  cv::flip(test_image_, expected, -1);
+
+  EXPECT_EQ(cv::norm(output, expected, cv::NORM_INF), 0.0);
+  EXPECT_EQ(filter.getMapBuildCount(), 0u);
+}
+
+TEST_F(WarpFilterTest, RotateKeepsFrameSizeAcrossQuarterTurns) {
+  WarpFilter filter(WarpFilter::WarpMode::ROTATE);
+  cv::Mat output;
+
+  for (const double angle : {89.0, 90.0, 91.0, 270.0}) {
+    filter.setParameter("angle", angle);
+    filter.apply(test_image_large_, output);
+    EXPECT_EQ(output.size(), test_image_large_.size()) << angle;
+  }
+
+  // Square frames still take the transpose kernel
+  cv::Mat square = test_image_large_(cv::Rect(0, 0, 120, 120)).clone();
+  const uint64_t builds = filter.getMapBuildCount();
+  filter.setParameter("angle", 90.0);
+  filter.apply(square, output);
+
+  cv::Mat expected;
+  cv::rotate(square, expected, cv::ROTATE_90_COUNTERCLOCKWISE);
+  EXPECT_EQ(cv::norm(output, expected, cv::NORM_INF), 0.0);
+  EXPECT_EQ(filter.getMapBuildCount(), builds);
+}
+
+TEST_F(WarpFilterTest, FlipModes) {
+  WarpFilter filter;
+  cv::Mat output;
+
+  filter.setParameter("mode", "flip_horizontal");
+  filter.apply(test_image_, output);
+  EXPECT_EQ(output.at<uint8_t>(0, 0), 3);
+
+  filter.setParameter("mode", "flip_vertical");
+  filter.apply(test_image_, output);
+  EXPECT_EQ(output.at<uint8_t>(0, 0), 4);
+}
+
+TEST_F(WarpFilterTest, MapsBuiltOncePerParameterChange) {
+  WarpFilter filter(WarpFilter::WarpMode::ROTATE);
+  filter.setParameter("angle", 10.0);
+
+  cv::Mat output;
+  filter.apply(test_image_large_, output);
+  filter.apply(test_image_large_, output);
+  EXPECT_EQ(filter.getMapBuildCount(), 1u);
+  EXPECT_EQ(output.size(), test_image_large_.size());
+  EXPECT_EQ(output.type(), test_image_large_.type());
+
+  filter.setParameter("angle", 20.0);
+  filter.apply(test_image_large_, output);
+  EXPECT_EQ(filter.getMapBuildCount(), 2u);
+
+  // A new frame size invalidates the maps too
+  cv::Mat smaller = test_image_large_(cv::Rect(0, 0, 80, 60)).clone();
+  filter.apply(smaller, output);
+  EXPECT_EQ(filter.getMapBuildCount(), 3u);
+  EXPECT_EQ(output.size(), smaller.size());
+}
+
+TEST_F(WarpFilterTest, IdentityTransformsPreserveImage) {
+  cv::Mat output;
+
+  WarpFilter undistort(WarpFilter::WarpMode::UNDISTORT);
+  undistort.apply(test_image_large_, output);
+  EXPECT_EQ(cv::norm(output, test_image_large_, cv::NORM_INF), 0.0);
+
+  WarpFilter perspective(WarpFilter::WarpMode::PERSPECTIVE);
+  perspective.apply(test_image_large_, output);
+  EXPECT_EQ(cv::norm(output, test_image_large_, cv::NORM_INF), 0.0);
+}
+
+TEST_F(WarpFilterTest, PerspectiveTranslation) {
+  WarpFilter filter(WarpFilter::WarpMode::PERSPECTIVE);
+  filter.setParameter("matrix", nlohmann::json::array({1, 0, 5, 0, 1, 3, 0, 0, 1}));
+
+  cv::Mat output;
+  filter.apply(test_image_large_, output);
+
+  EXPECT_EQ(output.at<cv::Vec3b>(13, 25), test_image_large_.at<cv::Vec3b>(10, 20));
+  EXPECT_EQ(output.at<cv::Vec3b>(0, 0), cv::Vec3b(0, 0, 0)); // outside source
+}
+
+TEST_F(WarpFilterTest, InvalidParametersIgnored) {
+  WarpFilter filter;
+
+  filter.setParameter("mode", "unknown_mode");
+  filter.setParameter("scale", -1.0);
+  filter.setParameter("matrix", nlohmann::json::array({1, 2, 3}));
+  filter.setParameter("fx", -10.0);
+
+  auto params = filter.getParameters();
+  EXPECT_EQ(params["mode"], "none");
+  EXPECT_DOUBLE_EQ(params["scale"], 1.0);
+  EXPECT_DOUBLE_EQ(params["fx"], 0.0);
+}
+
+TEST_F(WarpFilterTest, SingularHomographyPassThrough) {
+  WarpFilter filter(WarpFilter::WarpMode::PERSPECTIVE);
+  filter.setParameter("matrix", nlohmann::json::array({0, 0, 0, 0, 0, 0, 0, 0, 0}));
+
+  cv::Mat output;
+  filter.apply(test_image_large_, output);
+  EXPECT_EQ(output.size(), test_image_large_.size());
+}
+
+// ==================== CropFilter Tests ====================
+
+class CropFilterTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    test_image_ = cv::Mat(480, 640, CV_8UC3, cv::Scalar(0, 255, 0));
+  }
+
+  cv::Mat test_image_;
+};
+
+TEST_F(CropFilterTest, Constructor) {
+  CropFilter filter(cv::Rect(10, 20, 100, 50));
+  EXPECT_EQ(filter.getName(), "crop");
+  EXPECT_TRUE(filter.isEnabled());
+  EXPECT_EQ(filter.getParameters()["width"], 100);
+  EXPECT_THROW(CropFilter(cv::Rect(0, 0, 0, 10)), std::invalid_argument);
+}
+
+TEST_F(CropFilterTest, OutputIsViewWithoutCopy) {
+  CropFilter filter(cv::Rect(10, 20, 100, 50));
+  cv::Mat output;
+
+  filter.apply(test_image_, output);
+
+  EXPECT_EQ(output.cols, 100);
+  EXPECT_EQ(output.rows, 50);
+  EXPECT_EQ(output.data, test_image_.ptr(20) + 10 * test_image_.elemSize());
+}
+
+TEST_F(CropFilterTest, RegionClippedToFrame) {
+  CropFilter filter(cv::Rect(600, 400, 100, 100));
+  cv::Mat output;
+
+  filter.apply(test_image_, output);
+
+  EXPECT_EQ(output.cols, 40);
+  EXPECT_EQ(output.rows, 80);
+}
+
+TEST_F(CropFilterTest, RegionOutsideFramePassThrough) {
+  CropFilter filter(cv::Rect(1000, 1000, 10, 10));
+  cv::Mat output;
+
+  filter.apply(test_image_, output);
+
+  EXPECT_EQ(output.size(), test_image_.size());
+}
+
+TEST_F(CropFilterTest, InvalidParametersIgnored) {
+  CropFilter filter(cv::Rect(0, 0, 10, 10));
+
+  filter.setParameter("x", -1);
+  filter.setParameter("width", 0);
+  filter.setParameter("unknown_param", "value");
+
+  auto params = filter.getParameters();
+  EXPECT_EQ(params["x"], 0);
+  EXPECT_EQ(params["width"], 10);
+}
+
+// ==================== OverlayFilter Tests ====================
+
+class OverlayFilterTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    test_image_ = cv::Mat(120, 160, CV_8UC3, cv::Scalar(40, 80, 120));
+  }
+
+  cv::Mat test_image_;
+};
+
+TEST_F(OverlayFilterTest, Constructor) {
+  OverlayFilter filter;
+  EXPECT_EQ(filter.getName(), "overlay");
+  EXPECT_TRUE(filter.isEnabled());
+  EXPECT_EQ(filter.getLayerCount(), 0u);
+  EXPECT_FALSE(filter.getParameters()["timestamp"].get<bool>());
+}
+
+TEST_F(OverlayFilterTest, OpaqueImageLayerOnlyTouchesItsArea) {
+  OverlayFilter filter;
+  // 37 columns: vector body plus scalar tail
+  cv::Mat logo(10, 37, CV_8UC3, cv::Scalar(255, 0, 0));
+  filter.setImageLayer("logo", logo, cv::Point(5, 7));
+
+  cv::Mat output;
+  filter.apply(test_image_, output);
+
+  EXPECT_EQ(output.at<cv::Vec3b>(7, 5), cv::Vec3b(255, 0, 0));
+  EXPECT_EQ(output.at<cv::Vec3b>(16, 41), cv::Vec3b(255, 0, 0));
+  EXPECT_EQ(output.at<cv::Vec3b>(6, 5), cv::Vec3b(40, 80, 120));
+  EXPECT_EQ(output.at<cv::Vec3b>(7, 42), cv::Vec3b(40, 80, 120));
+
+  // Input untouched
+  EXPECT_EQ(test_image_.at<cv::Vec3b>(7, 5), cv::Vec3b(40, 80, 120));
+}
+
+TEST_F(OverlayFilterTest, HalfTransparentBlend) {
+  OverlayFilter filter;
+  cv::Mat logo(4, 40, CV_8UC4, cv::Scalar(200, 200, 200, 128));
+  filter.setImageLayer("logo", logo, cv::Point(0, 0));
+
+  cv::Mat output;
+  filter.apply(test_image_, output);
+
+  // 200 * 128/255 + base * 127/255
+  for (int x : {0, 17, 39}) {
+    cv::Vec3b px = output.at<cv::Vec3b>(2, x);
+    EXPECT_NEAR(px[0], 120, 1);
+    EXPECT_NEAR(px[1], 140, 1);
+    EXPECT_NEAR(px[2], 160, 1);
+  }
+}
+
+TEST_F(OverlayFilterTest, GrayscaleAndBGRAFrames) {
+  OverlayFilter filter;
+  cv::Mat logo(8, 20, CV_8UC3, cv::Scalar(255, 255, 255));
+  filter.setImageLayer("logo", logo, cv::Point(2, 2));
+
+  cv::Mat gray(50, 50, CV_8UC1, cv::Scalar(10));
+  cv::Mat output;
+  filter.apply(gray, output);
+  EXPECT_EQ(output.channels(), 1);
+  EXPECT_EQ(output.at<uchar>(5, 10), 255);
+  EXPECT_EQ(output.at<uchar>(20, 10), 10);
+
+  cv::Mat bgra(50, 50, CV_8UC4, cv::Scalar(0, 0, 0, 0));
+  filter.apply(bgra, output);
+  EXPECT_EQ(output.at<cv::Vec4b>(5, 10), cv::Vec4b(255, 255, 255, 255));
+  EXPECT_EQ(output.at<cv::Vec4b>(20, 10), cv::Vec4b(0, 0, 0, 0));
+}
+
+TEST_F(OverlayFilterTest, TextLayerRasterizedOnlyOnChange) {
+  OverlayFilter filter;
+  filter.setTextLayer("stats", "Clients: 1", cv::Point(10, 30));
+  EXPECT_EQ(filter.getRasterizeCount(), 1u);
+
+  filter.setTextLayer("stats", "Clients: 1", cv::Point(10, 30));
+  filter.setTextLayer("stats", "Clients: 1", cv::Point(12, 40)); // move only
+  EXPECT_EQ(filter.getRasterizeCount(), 1u);
+
+  filter.setTextLayer("stats", "Clients: 2", cv::Point(12, 40));
+  EXPECT_EQ(filter.getRasterizeCount(), 2u);
+  EXPECT_EQ(filter.getLayerCount(), 1u);
+
+  cv::Mat output;
+  filter.apply(test_image_, output);
+  EXPECT_GT(cv::norm(output, test_image_, cv::NORM_L1), 0.0);
+}
+
+TEST_F(OverlayFilterTest, BoxesLayerDrawsOutlinesOnly) {
+  OverlayFilter filter;
+  filter.setBoxesLayer("detections",
+                       {cv::Rect(10, 10, 40, 30), cv::Rect(150, 100, 40, 40)},
+                       cv::Scalar(0, 0, 255), 2);
+
+  cv::Mat output;
+  filter.apply(test_image_, output);
+
+  EXPECT_EQ(output.at<cv::Vec3b>(10, 10), cv::Vec3b(0, 0, 255));
+  EXPECT_EQ(output.at<cv::Vec3b>(39, 49), cv::Vec3b(0, 0, 255));
+  EXPECT_EQ(output.at<cv::Vec3b>(25, 30), cv::Vec3b(40, 80, 120));
+  // Second box is clipped by the frame border
+  EXPECT_EQ(output.at<cv::Vec3b>(100, 155), cv::Vec3b(0, 0, 255));
+}
+
+TEST_F(OverlayFilterTest, TimestampUsesGlyphAtlas) {
+  OverlayFilter filter;
+  std::string stamp = "12:34:56";
+  filter.setTimestampProvider([&stamp]() { return stamp; });
+  filter.enableTimestamp(cv::Point(5, 30));
+
+  cv::Mat first;
+  filter.apply(test_image_, first);
+  EXPECT_EQ(filter.getRasterizeCount(), 1u);
+  EXPECT_GT(cv::norm(first, test_image_, cv::NORM_L1), 0.0);
+
+  stamp = "12:34:57";
+  cv::Mat second;
+  filter.apply(test_image_, second);
+  EXPECT_EQ(filter.getRasterizeCount(), 1u); // no new rasterization
+  EXPECT_GT(cv::norm(first, second, cv::NORM_L1), 0.0);
+
+  filter.setParameter("timestamp_scale", 1.0);
+  filter.apply(test_image_, second);
+  EXPECT_EQ(filter.getRasterizeCount(), 2u);
+}
+
+TEST_F(OverlayFilterTest, RemoveAndClearLayers) {
+  OverlayFilter filter;
+  cv::Mat logo(4, 4, CV_8UC3, cv::Scalar(255, 255, 255));
+  filter.setImageLayer("a", logo, cv::Point(0, 0));
+  filter.setImageLayer("b", logo, cv::Point(-2, -2)); // partly outside
+
+  EXPECT_EQ(filter.getLayerCount(), 2u);
+  EXPECT_TRUE(filter.removeLayer("a"));
+  EXPECT_FALSE(filter.removeLayer("a"));
+
+  cv::Mat output;
+  EXPECT_NO_THROW(filter.apply(test_image_, output));
+  EXPECT_EQ(output.at<cv::Vec3b>(1, 1), cv::Vec3b(255, 255, 255));
+
+  filter.clearLayers();
+  EXPECT_EQ(filter.getLayerCount(), 0u);
+}
+
+TEST_F(OverlayFilterTest, InvalidParametersIgnored) {
+  OverlayFilter filter;
+
+  filter.setParameter("timestamp_scale", -1.0);
+  filter.setParameter("timestamp_thickness", 0);
+  filter.setParameter("unknown_param", 1);
+
+  auto params = filter.getParameters();
+  EXPECT_DOUBLE_EQ(params["timestamp_scale"].get<double>(), 0.6);
+  EXPECT_EQ(params["timestamp_thickness"], 1);
+}
+
+// ==================== GuidedFilter Tests ====================
+
+class GuidedFilterTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    // Vertical step edge with additive noise
+    clean_ = cv::Mat(240, 320, CV_8UC1, cv::Scalar(60));
+    clean_(cv::Rect(160, 0, 160, 240)).setTo(cv::Scalar(190));
+
+    cv::Mat noise(clean_.size(), CV_16SC1);
+    cv::randn(noise, 0, 12);
+    cv::Mat noisy16;
+    clean_.convertTo(noisy16, CV_16SC1);
+    noisy16 += noise;
+    noisy16.convertTo(noisy_, CV_8UC1);
+  }
+
+  cv::Mat clean_;
+  cv::Mat noisy_;
+};
+
+TEST_F(GuidedFilterTest, Constructor) {
+  GuidedFilter filter;
+  EXPECT_EQ(filter.getName(), "guided");
+  EXPECT_TRUE(filter.isEnabled());
+  EXPECT_THROW(GuidedFilter(0), std::invalid_argument);
+  EXPECT_THROW(GuidedFilter(4, 0.0), std::invalid_argument);
+  EXPECT_THROW(GuidedFilter(4, 0.01, 9), std::invalid_argument);
+}
+
+TEST_F(GuidedFilterTest, ReducesNoiseAndKeepsEdge) {
+  GuidedFilter filter(8, 0.01, 4);
+  cv::Mat output;
+
+  filter.apply(noisy_, output);
+
+  ASSERT_EQ(output.size(), noisy_.size());
+  ASSERT_EQ(output.type(), CV_8UC1);
+
+  cv::Scalar mean_in, std_in, mean_out, std_out;
+  const cv::Rect flat(20, 20, 100, 200);
+  cv::meanStdDev(noisy_(flat), mean_in, std_in);
+  cv::meanStdDev(output(flat), mean_out, std_out);
+  EXPECT_LT(std_out[0], std_in[0] * 0.5);
+
+  // Edge stays sharp: a few pixels each side keep their plateau level
+  const double left = cv::mean(output(cv::Rect(150, 20, 6, 200)))[0];
+  const double right = cv::mean(output(cv::Rect(164, 20, 6, 200)))[0];
+  EXPECT_GT(right - left, 100.0);
+}
+
+TEST_F(GuidedFilterTest, ColorFrame) {
+  GuidedFilter filter;
+  cv::Mat color;
+  cv::cvtColor(noisy_, color, cv::COLOR_GRAY2BGR);
+  cv::Mat output;
+
+  filter.apply(color, output);
+
+  EXPECT_EQ(output.size(), color.size());
+  EXPECT_EQ(output.type(), CV_8UC3);
+}
+
+TEST_F(GuidedFilterTest, BandsMatchSingleThread) {
+  GuidedFilter filter(6, 0.02, 2);
+  cv::Mat parallel_out, serial_out;
+
+  filter.apply(noisy_, parallel_out);
+
+  const int threads = cv::getNumThreads();
+  cv::setNumThreads(1);
+  filter.apply(noisy_, serial_out);
+  cv::setNumThreads(threads);
+
+  EXPECT_LE(cv::norm(parallel_out, serial_out, cv::NORM_INF), 1.0);
+}
+
+TEST_F(GuidedFilterTest, InvalidParametersIgnored) {
+  GuidedFilter filter(8, 0.01, 4);
+
+  filter.setParameter("radius", 0);
+  filter.setParameter("eps", -1.0);
+  filter.setParameter("subsample", 16);
+  filter.setParameter("unknown_param", 1);
+
+  auto params = filter.getParameters();
+  EXPECT_EQ(params["radius"], 8);
+  EXPECT_DOUBLE_EQ(params["eps"].get<double>(), 0.01);
+  EXPECT_EQ(params["subsample"], 4);
+
+  filter.setParameter("radius", 16);
+  EXPECT_EQ(filter.getParameters()["radius"], 16);
+}
@@ -45,6 +45,28 @@ TEST(FrameControllerTest, FrameCallbackCalled) {
   EXPECT_GT(callback_count, 0);
 }
 
+TEST(FrameControllerTest, FrameTimingDuringCallback) {
+  FrameController controller;
+  auto source = std::make_unique<VideoFileSource>("../assets/video.mp4");
+
+  int callback_count = 0;
+  controller.setFrameCallback(
+      [&](const cv::Mat &, const cv::Mat &, uint64_t) {
+        const FrameTiming &timing = controller.getFrameTiming();
+        EXPECT_NE(timing.capture_time,
+                  std::chrono::steady_clock::time_point{});
+        EXPECT_LE(timing.capture_time, timing.processed_time);
+        EXPECT_LE(timing.processed_time, std::chrono::steady_clock::now());
+        ++callback_count;
+      });
+
+  controller.start(std::move(source), 0.0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  controller.stop();
+
+  EXPECT_GT(callback_count, 0);
+}
+
 TEST(FrameControllerTest, PipelineProcessing) {
   FrameController controller;
   auto source = std::make_unique<VideoFileSource>("../assets/video.mp4");
@@ -92,3 +114,21 @@ TEST(FrameControllerTest, FPSLimiting) {
                       .count();
   EXPECT_GE(duration, 500); // at least ~0.5s for 1 frame at 2 FPS
 }
+
+TEST(FrameControllerTest, CaptureLatencyMeasured) {
+  FrameController controller;
+  auto source = std::make_unique<VideoFileSource>("../assets/video.mp4");
+
+  controller.setFrameCallback([](const cv::Mat &, const cv::Mat &, uint64_t) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  });
+
+  controller.start(std::move(source), 0.0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  controller.stop();
+
+  const LatencyStats latency = controller.getCaptureLatency();
+  EXPECT_GT(latency.samples, 0u);
+  EXPECT_GE(latency.last_ms, 5.0); // includes the callback
+  EXPECT_GE(latency.max_ms, latency.avg_ms);
+}
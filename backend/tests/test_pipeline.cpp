@@ -1,6 +1,9 @@
 
 // tests/test_framepipeline_full.cpp
+#include "filters/CropFilter.hpp"
 #include "filters/GrayscaleFilter.hpp"
+#include "filters/LUTFilter.hpp"
+#include "filters/ResizeFilter.hpp"
 #include "pipeline/FramePipeline.hpp"
 #include "pipeline/PipelineError.hpp"
 #include "gtest/gtest.h"
@@ -133,6 +136,29 @@ TEST(FramePipelineFullTest, ProcessErrors) {
   EXPECT_EQ(res2.error, PipelineError::EmptyPipeline);
 }
 
+TEST(FramePipelineFullTest, OutputNeverSharesInput) {
+  FramePipeline pipeline("pipeline_cow");
+  pipeline.addFilter(std::make_shared<GrayscaleFilter>());
+  pipeline.addFilter(std::make_shared<CropFilter>(cv::Rect(2, 2, 4, 4)));
+
+  cv::Mat input(10, 10, CV_8UC3, cv::Scalar(10, 20, 30));
+  cv::Mat output;
+
+  // Crop returns a view of its input: the result must still be a copy
+  EXPECT_TRUE(pipeline.setFilterEnabled(0, false).isOk());
+  ASSERT_TRUE(pipeline.process(input, output).isOk());
+  EXPECT_EQ(output.size(), cv::Size(4, 4));
+  EXPECT_NE(output.datastart, input.datastart);
+  output.setTo(cv::Scalar(255, 255, 255));
+  EXPECT_EQ(input.at<cv::Vec3b>(3, 3), cv::Vec3b(10, 20, 30));
+
+  // No filter ran at all
+  EXPECT_TRUE(pipeline.setFilterEnabled(1, false).isOk());
+  ASSERT_TRUE(pipeline.process(input, output).isOk());
+  EXPECT_NE(output.datastart, input.datastart);
+  EXPECT_EQ(cv::norm(output, input, cv::NORM_INF), 0.0);
+}
+
 TEST(FramePipelineFullTest, AccessorsAndPipelineName) {
   FramePipeline pipeline("pipeline5");
   EXPECT_EQ(pipeline.getName(), "pipeline5");
@@ -140,6 +166,110 @@ TEST(FramePipelineFullTest, AccessorsAndPipelineName) {
   EXPECT_EQ(pipeline.size(), 0u);
 }
 
+TEST(FramePipelineFullTest, ROIRestrictsProcessing) {
+  FramePipeline pipeline("pipeline_roi");
+  pipeline.addFilter(
+      std::make_shared<LUTFilter>(LUTFilter::LUTType::INVERT));
+
+  cv::Mat input(100, 100, CV_8UC3, cv::Scalar(10, 10, 10));
+  ASSERT_TRUE(pipeline.setROI(cv::Rect(20, 30, 40, 20)).isOk());
+  ASSERT_TRUE(pipeline.getROI().has_value());
+
+  cv::Mat output;
+  ASSERT_TRUE(pipeline.process(input, output).isOk());
+
+  EXPECT_EQ(output.size(), input.size());
+  EXPECT_EQ(output.at<cv::Vec3b>(35, 25), cv::Vec3b(245, 245, 245));
+  EXPECT_EQ(output.at<cv::Vec3b>(0, 0), cv::Vec3b(10, 10, 10));
+  EXPECT_EQ(output.at<cv::Vec3b>(99, 99), cv::Vec3b(10, 10, 10));
+
+  // Input must be left untouched
+  EXPECT_EQ(input.at<cv::Vec3b>(35, 25), cv::Vec3b(10, 10, 10));
+
+  pipeline.clearROI();
+  EXPECT_FALSE(pipeline.getROI().has_value());
+  ASSERT_TRUE(pipeline.process(input, output).isOk());
+  EXPECT_EQ(output.at<cv::Vec3b>(0, 0), cv::Vec3b(245, 245, 245));
+}
+
+TEST(FramePipelineFullTest, ROICompositeFollowsFilterOutput) {
+  FramePipeline pipeline("pipeline_roi_composite");
+  pipeline.addFilter(std::make_shared<GrayscaleFilter>());
+  pipeline.addFilter(std::make_shared<ResizeFilter>(0.5));
+
+  cv::Mat input(100, 100, CV_8UC3, cv::Scalar(0, 0, 255));
+  ASSERT_TRUE(pipeline.setROI(cv::Rect(50, 50, 80, 80)).isOk()); // clipped
+
+  cv::Mat output;
+  ASSERT_TRUE(pipeline.process(input, output).isOk());
+
+  // Full frame, grayscale everywhere, region resized back to 50x50
+  EXPECT_EQ(output.size(), input.size());
+  EXPECT_EQ(output.channels(), 1);
+}
+
+TEST(FramePipelineFullTest, ROIInvalidAndOutsideFrame) {
+  FramePipeline pipeline("pipeline_roi_invalid");
+  pipeline.addFilter(std::make_shared<GrayscaleFilter>());
+
+  auto err = pipeline.setROI(cv::Rect(0, 0, 0, 10));
+  EXPECT_TRUE(err.isErr());
+  EXPECT_EQ(err.error, PipelineError::InvalidROI);
+  EXPECT_FALSE(pipeline.getROI().has_value());
+
+  // ROI not intersecting the frame: whole frame is processed
+  ASSERT_TRUE(pipeline.setROI(cv::Rect(500, 500, 10, 10)).isOk());
+  cv::Mat input(20, 20, CV_8UC3, cv::Scalar(1, 2, 3));
+  cv::Mat output;
+  ASSERT_TRUE(pipeline.process(input, output).isOk());
+  EXPECT_EQ(output.size(), input.size());
+  EXPECT_EQ(output.channels(), 1);
+}
+
+TEST(FramePipelineFullTest, ROIOnGrayFrame) {
+  FramePipeline pipeline("pipeline_roi_gray");
+  pipeline.addFilter(std::make_shared<GrayscaleFilter>());
+  pipeline.addFilter(
+      std::make_shared<LUTFilter>(LUTFilter::LUTType::INVERT));
+
+  cv::Mat input(40, 40, CV_8UC1, cv::Scalar(10));
+  ASSERT_TRUE(pipeline.setROI(cv::Rect(10, 10, 10, 10)).isOk());
+
+  cv::Mat output;
+  ASSERT_TRUE(pipeline.process(input, output).isOk());
+
+  EXPECT_EQ(output.size(), input.size());
+  EXPECT_EQ(output.channels(), 1);
+  EXPECT_EQ(output.at<uchar>(15, 15), 245);
+  EXPECT_EQ(output.at<uchar>(0, 0), 10);
+}
+
+namespace {
+// Keeps the first channel only: turns a 2-channel region into gray
+class FirstChannelFilter : public IFilter {
+public:
+  void apply(const cv::Mat &input, cv::Mat &output) override {
+    cv::extractChannel(input, output, 0);
+  }
+  void setParameter(const std::string &, const nlohmann::json &) override {}
+  nlohmann::json getParameters() const override { return {}; }
+  std::string getName() const override { return "FirstChannel"; }
+};
+} // namespace
+
+TEST(FramePipelineFullTest, ROIUnsupportedChannelLayoutFails) {
+  FramePipeline pipeline("pipeline_roi_two_channels");
+  pipeline.addFilter(std::make_shared<FirstChannelFilter>());
+
+  cv::Mat input(20, 20, CV_8UC2, cv::Scalar(1, 2));
+  ASSERT_TRUE(pipeline.setROI(cv::Rect(5, 5, 5, 5)).isOk());
+
+  cv::Mat output;
+  auto result = pipeline.process(input, output);
+  EXPECT_TRUE(result.isErr());
+  EXPECT_EQ(result.error, PipelineError::InvalidFilter);
+}
+
 // -------------------- PipelineResult Tests --------------------
 
 TEST(PipelineResultFullTest, VoidOkAndErr) {
@@ -189,4 +319,5 @@ TEST(PipelineResultFullTest, ToHttpCodeMapping) {
   EXPECT_EQ(toHttpCode(PipelineError::NullPointer), 400);
   EXPECT_EQ(toHttpCode(PipelineError::EmptyPipeline), 404);
   EXPECT_EQ(toHttpCode(PipelineError::ThreadLockFailed), 500);
+  EXPECT_EQ(toHttpCode(PipelineError::InvalidROI), 400);
 }
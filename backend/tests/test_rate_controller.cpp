@@ -0,0 +1,185 @@
+// tests/test_rate_controller.cpp
+#include "processing/RateController.hpp"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+using namespace visioncore::processing;
+
+namespace {
+
+const cv::Size kFrame(1920, 1080);
+
+/// Encoded size model: proportional to the area, steeper at high quality
+size_t modelBytes(const EncodeSpec &spec, double complexity = 1.0) {
+  const cv::Size size = spec.size.empty() ? kFrame : spec.size;
+  const double q = spec.quality / 100.0;
+  return static_cast<size_t>(complexity * size.area() * 0.15 *
+                             std::exp(3.0 * (q - 0.5)));
+}
+
+/// Encode time model: proportional to the area
+double modelMs(const EncodeSpec &spec, double ms_at_full) {
+  const cv::Size size = spec.size.empty() ? kFrame : spec.size;
+  return ms_at_full * size.area() / kFrame.area();
+}
+
+RateControlOptions fixedRate(double kbps) {
+  RateControlOptions options;
+  options.target_kbps = kbps;
+  options.fps = 30.0;
+  return options;
+}
+
+/// Runs frames through the models, returns the last spec
+EncodeSpec run(RateController &rate, int frames, double complexity = 1.0,
+               double ms_at_full = 1.0, size_t backlog = 0) {
+  EncodeSpec spec;
+  for (int i = 0; i < frames; ++i) {
+    spec = rate.next(kFrame);
+    rate.update(spec, modelBytes(spec, complexity), modelMs(spec, ms_at_full),
+                backlog);
+  }
+  return spec;
+}
+
+double frameKbps(const EncodeSpec &spec, double complexity = 1.0) {
+  return modelBytes(spec, complexity) * 8.0 * 30.0 / 1000.0;
+}
+
+} // namespace
+
+TEST(RateControllerTest, StartsFromInitialQuality) {
+  RateControlOptions options = fixedRate(8000.0);
+  options.initial_quality = 70;
+  RateController rate(options);
+
+  const EncodeSpec spec = rate.next(kFrame);
+  EXPECT_EQ(spec.quality, 70);
+  EXPECT_TRUE(spec.size.empty());
+  EXPECT_EQ(spec.codec, Codec::JPEG);
+}
+
+TEST(RateControllerTest, InitialQualityClampedToRange) {
+  RateControlOptions options = fixedRate(8000.0);
+  options.initial_quality = 100;
+  options.max_quality = 90;
+  RateController rate(options);
+  EXPECT_EQ(rate.next(kFrame).quality, 90);
+}
+
+TEST(RateControllerTest, QualityConvergesToBitrate) {
+  const double target = 60000.0;
+  RateController rate(fixedRate(target));
+
+  const EncodeSpec spec = run(rate, 200);
+  EXPECT_TRUE(spec.size.empty()) << "quality alone is enough";
+  EXPECT_LT(spec.quality, 85);
+  EXPECT_GT(spec.quality, 40);
+  EXPECT_NEAR(frameKbps(spec), target, target * 0.15);
+}
+
+TEST(RateControllerTest, QualityRisesWithSpareBandwidth) {
+  RateController rate(fixedRate(1e6));
+  const EncodeSpec spec = run(rate, 50);
+  EXPECT_EQ(spec.quality, 90); // max_quality
+  EXPECT_TRUE(spec.size.empty());
+}
+
+TEST(RateControllerTest, DownscalesBelowQualityFloor) {
+  const double target = 8000.0;
+  RateController rate(fixedRate(target));
+
+  const EncodeSpec spec = run(rate, 300);
+  EXPECT_EQ(spec.quality, 40);
+  ASSERT_FALSE(spec.size.empty());
+  EXPECT_LT(spec.size.width, kFrame.width);
+  EXPECT_EQ(spec.size.width % 2, 0);
+  EXPECT_EQ(spec.size.height % 2, 0);
+  EXPECT_LT(frameKbps(spec), target * 1.2);
+}
+
+TEST(RateControllerTest, ScaleNeverBelowMinimum) {
+  RateControlOptions options = fixedRate(10.0);
+  options.min_scale = 0.5;
+  RateController rate(options);
+
+  const EncodeSpec spec = run(rate, 300);
+  EXPECT_GE(spec.size.width, kFrame.width / 2 - 2);
+  EXPECT_DOUBLE_EQ(rate.getStats().scale, 0.5);
+}
+
+TEST(RateControllerTest, EncodeBudgetDownscales) {
+  RateControlOptions options = fixedRate(1e6);
+  options.encode_budget_ms = 10.0;
+  RateController rate(options);
+
+  // 40 ms at full resolution: about half the width fits the budget
+  const EncodeSpec spec = run(rate, 200, 1.0, 40.0);
+  ASSERT_FALSE(spec.size.empty());
+  EXPECT_LE(modelMs(spec, 40.0), 10.0 * 1.05);
+  EXPECT_GT(modelMs(spec, 40.0), 10.0 * 0.5);
+}
+
+TEST(RateControllerTest, ResolutionRecoversWhenContentGetsSimpler) {
+  RateController rate(fixedRate(8000.0));
+  ASSERT_FALSE(run(rate, 300).size.empty());
+
+  const EncodeSpec spec = run(rate, 400, 0.01);
+  EXPECT_TRUE(spec.size.empty());
+}
+
+TEST(RateControllerTest, BacklogCutsEffectiveTarget) {
+  RateControlOptions options = fixedRate(60000.0);
+  options.max_backlog_bytes = 1000;
+  RateController rate(options);
+
+  run(rate, 10, 1.0, 1.0, 5000);
+  const RateStats congested = rate.getStats();
+  EXPECT_LT(congested.target_kbps, 60000.0);
+  EXPECT_EQ(congested.backlog_bytes, 5000u);
+
+  // Recovers once the clients catch up
+  run(rate, 200, 1.0, 1.0, 0);
+  EXPECT_DOUBLE_EQ(rate.getStats().target_kbps, 60000.0);
+}
+
+TEST(RateControllerTest, AdmitSkipsAboveHardLimit) {
+  RateControlOptions options = fixedRate(8000.0);
+  options.max_backlog_bytes = 1000;
+  RateController rate(options);
+
+  EXPECT_TRUE(rate.admit(0));
+  EXPECT_TRUE(rate.admit(1500));
+  EXPECT_FALSE(rate.admit(2500));
+  EXPECT_EQ(rate.getStats().skipped, 1u);
+}
+
+TEST(RateControllerTest, JpegOptionsPassedThrough) {
+  RateControlOptions options = fixedRate(8000.0);
+  options.jpeg.strips = 4;
+  options.jpeg.subsampling = ChromaSubsampling::S444;
+  RateController rate(options);
+
+  const EncodeSpec spec = rate.next(kFrame);
+  EXPECT_EQ(spec.jpeg.strips, 4);
+  EXPECT_EQ(spec.jpeg.subsampling, ChromaSubsampling::S444);
+}
+
+TEST(RateControllerTest, HistoryRecordsBitrate) {
+  RateController rate(fixedRate(8000.0));
+  EncodeSpec spec = rate.next(kFrame);
+  rate.update(spec, 10000, 1.0, 0);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(1050));
+  spec = rate.next(kFrame);
+  rate.update(spec, 10000, 1.0, 0);
+
+  const auto history = rate.getHistory();
+  ASSERT_EQ(history.size(), 1u);
+  EXPECT_NEAR(history[0].bitrate_kbps, 160.0, 10.0); // 20 kB in ~1 s
+  EXPECT_GT(history[0].time_s, 1.0);
+  EXPECT_DOUBLE_EQ(rate.getStats().bitrate_kbps, history[0].bitrate_kbps);
+  EXPECT_EQ(rate.getStats().frames, 2u);
+}
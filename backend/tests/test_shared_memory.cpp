@@ -0,0 +1,206 @@
+// tests/test_shared_memory.cpp
+#include "sinks/SharedMemoryReader.hpp"
+#include "sinks/SharedMemorySink.hpp"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace visioncore::sinks;
+using ReadResult = SharedMemoryReader::ReadResult;
+
+namespace {
+
+std::string ringName() {
+  return "/visioncore_test_" + std::to_string(::getpid());
+}
+
+// Every byte of frame i is i % 251: a torn read mixes two values
+cv::Mat makeFrame(uint64_t i, int type = CV_8UC3) {
+  return cv::Mat(48, 64, type, cv::Scalar::all(static_cast<double>(i % 251)));
+}
+
+bool isFrame(const cv::Mat &frame, uint64_t i) {
+  return frame.size() == cv::Size(64, 48) && frame.type() == CV_8UC3 &&
+         cv::norm(frame, makeFrame(i), cv::NORM_INF) == 0.0;
+}
+
+SharedMemoryOptions smallRing() {
+  SharedMemoryOptions options;
+  options.slots = 4;
+  options.frame_capacity = 64 * 48 * 4;
+  return options;
+}
+
+} // namespace
+
+TEST(SharedMemoryTest, ReaderSeesPublishedFrames) {
+  SharedMemorySink sink(ringName(), smallRing());
+  ASSERT_TRUE(sink.open());
+
+  SharedMemoryReader reader(ringName());
+  ASSERT_TRUE(reader.open());
+  cv::Mat frame;
+  SharedFrameInfo info;
+  EXPECT_FALSE(reader.readLatest(frame, info));
+  EXPECT_EQ(reader.read(0, frame, info), ReadResult::NOT_YET);
+
+  const auto capture = std::chrono::steady_clock::now();
+  ASSERT_TRUE(sink.publish(makeFrame(7), 7, capture));
+  ASSERT_TRUE(reader.readLatest(frame, info));
+  EXPECT_TRUE(isFrame(frame, 7));
+  EXPECT_EQ(info.index, 0u);
+  EXPECT_EQ(info.frame_id, 7u);
+  EXPECT_EQ(info.capture_us, shmMicros(capture));
+  EXPECT_GE(info.publish_us, info.capture_us);
+
+  // Views of a non-continuous frame are packed
+  const cv::Mat big(100, 100, CV_8UC3, cv::Scalar::all(9));
+  ASSERT_TRUE(sink.publish(big(cv::Rect(3, 3, 64, 48)), 9));
+  ASSERT_TRUE(reader.readLatest(frame, info));
+  EXPECT_TRUE(isFrame(frame, 9));
+}
+
+TEST(SharedMemoryTest, OldFramesAreOverwritten) {
+  SharedMemorySink sink(ringName(), smallRing());
+  ASSERT_TRUE(sink.open());
+  for (uint64_t i = 0; i < 10; ++i) {
+    ASSERT_TRUE(sink.write(makeFrame(i)));
+  }
+  EXPECT_EQ(sink.getPublishedCount(), 10u);
+
+  SharedMemoryReader reader(ringName());
+  ASSERT_TRUE(reader.open());
+  EXPECT_EQ(reader.getPublishedCount(), 10u);
+
+  cv::Mat frame;
+  SharedFrameInfo info;
+  EXPECT_EQ(reader.read(5, frame, info), ReadResult::OVERWRITTEN);
+  EXPECT_EQ(reader.read(6, frame, info), ReadResult::OK);
+  EXPECT_TRUE(isFrame(frame, 6));
+  EXPECT_EQ(reader.read(9, frame, info), ReadResult::OK);
+  EXPECT_EQ(reader.read(10, frame, info), ReadResult::NOT_YET);
+}
+
+TEST(SharedMemoryTest, PeekedViewIsInvalidatedByReuse) {
+  SharedMemorySink sink(ringName(), smallRing());
+  ASSERT_TRUE(sink.open());
+  ASSERT_TRUE(sink.write(makeFrame(1)));
+
+  SharedMemoryReader reader(ringName());
+  ASSERT_TRUE(reader.open());
+  cv::Mat view;
+  SharedFrameInfo info;
+  ASSERT_TRUE(reader.peekLatest(view, info));
+  EXPECT_TRUE(isFrame(view, 1));
+  EXPECT_TRUE(reader.isCurrent(info));
+
+  // Slot 0 comes back after 4 frames
+  for (uint64_t i = 2; i <= 4; ++i) {
+    sink.write(makeFrame(i));
+  }
+  EXPECT_TRUE(reader.isCurrent(info));
+  sink.write(makeFrame(5));
+  EXPECT_FALSE(reader.isCurrent(info));
+
+  // Copying into the Mat that held the view must not write to the mapping
+  cv::Mat copy = view;
+  ASSERT_TRUE(reader.readLatest(copy, info));
+  EXPECT_TRUE(isFrame(copy, 5));
+}
+
+TEST(SharedMemoryTest, RejectsBadInput) {
+  SharedMemoryReader missing("/visioncore_test_missing");
+  EXPECT_FALSE(missing.open());
+
+  SharedMemoryOptions invalid;
+  invalid.slots = 1;
+  EXPECT_FALSE(SharedMemorySink(ringName(), invalid).open());
+
+  SharedMemorySink sink(ringName(), smallRing());
+  EXPECT_FALSE(sink.write(makeFrame(0))); // not open
+  ASSERT_TRUE(sink.open());
+  EXPECT_FALSE(sink.write(cv::Mat()));
+  EXPECT_FALSE(sink.write(cv::Mat(480, 640, CV_8UC3))); // too large
+  EXPECT_EQ(sink.getDroppedCount(), 2u);
+
+  // Unlinked on close
+  sink.close();
+  SharedMemoryReader reader(ringName());
+  EXPECT_FALSE(reader.open());
+}
+
+TEST(SharedMemoryTest, OpenFailsWhenMemoryCannotBeReserved) {
+  // Far more than any /dev/shm: open() fails instead of a later SIGBUS
+  SharedMemoryOptions huge;
+  huge.slots = 1u << 20;
+  huge.frame_capacity = UINT32_MAX;
+  SharedMemorySink sink(ringName(), huge);
+  EXPECT_FALSE(sink.open());
+  EXPECT_FALSE(sink.isOpened());
+
+  SharedMemoryReader reader(ringName());
+  EXPECT_FALSE(reader.open());
+}
+
+TEST(SharedMemoryTest, RingIsSizedFromTheFrames) {
+  const auto options = SharedMemoryOptions::forFrameSize(cv::Size(640, 480));
+  EXPECT_EQ(options.frame_capacity, 640u * 480 * 4);
+  EXPECT_EQ(SharedMemoryOptions::forFrameSize({}).frame_capacity,
+            SharedMemoryOptions{}.frame_capacity);
+}
+
+TEST(SharedMemoryTest, ReaderProcessNeverSeesTornFrames) {
+  constexpr uint64_t kFrames = 2000;
+  SharedMemorySink sink(ringName(), smallRing());
+  ASSERT_TRUE(sink.open());
+
+  const pid_t pid = ::fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    // Reader process: follow the stream, check every frame it gets
+    SharedMemoryReader reader(ringName());
+    if (!reader.open()) {
+      ::_exit(2);
+    }
+    cv::Mat frame;
+    SharedFrameInfo info;
+    uint64_t index = 0;
+    uint64_t received = 0;
+    while (reader.waitFor(index, std::chrono::seconds(5))) {
+      switch (reader.read(index, frame, info)) {
+      case ReadResult::OK:
+        if (!isFrame(frame, info.frame_id) || info.index != index) {
+          ::_exit(1);
+        }
+        ++received;
+        if (info.frame_id == kFrames - 1) {
+          ::_exit(received > 0 ? 0 : 3);
+        }
+        ++index;
+        break;
+      case ReadResult::OVERWRITTEN:
+        index = reader.getPublishedCount() - 1; // lapped, catch up
+        break;
+      case ReadResult::NOT_YET:
+        break;
+      }
+    }
+    ::_exit(4);
+  }
+
+  for (uint64_t i = 0; i < kFrames; ++i) {
+    ASSERT_TRUE(sink.publish(makeFrame(i), i));
+    if (i % 16 == 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+  }
+
+  int status = 0;
+  ASSERT_EQ(::waitpid(pid, &status, 0), pid);
+  ASSERT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+}
@@ -0,0 +1,123 @@
+// tests/test_simulcast.cpp
+#include "processing/SimulcastEncoder.hpp"
+#include "gtest/gtest.h"
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+using namespace visioncore::processing;
+
+namespace {
+
+cv::Mat makeFrame() {
+  cv::Mat frame(360, 640, CV_8UC3);
+  cv::RNG rng(11);
+  rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+  cv::GaussianBlur(frame, frame, cv::Size(9, 9), 0);
+  return frame;
+}
+
+std::vector<Rendition> threeRenditions() {
+  return *SimulcastEncoder::parse("360:90,180:75,90:60");
+}
+
+} // namespace
+
+TEST(SimulcastEncoderTest, ParsesRenditions) {
+  const auto renditions = SimulcastEncoder::parse("1080:85,540:75,270");
+  ASSERT_TRUE(renditions.has_value());
+  ASSERT_EQ(renditions->size(), 3u);
+  EXPECT_EQ((*renditions)[0].name, "1080p");
+  EXPECT_EQ((*renditions)[0].height, 1080);
+  EXPECT_EQ((*renditions)[0].quality, 85);
+  EXPECT_EQ((*renditions)[1].quality, 75);
+  EXPECT_EQ((*renditions)[2].quality, 85); // default
+
+  EXPECT_FALSE(SimulcastEncoder::parse("").has_value());
+  EXPECT_FALSE(SimulcastEncoder::parse("abc").has_value());
+  EXPECT_FALSE(SimulcastEncoder::parse("540:75x").has_value());
+  EXPECT_FALSE(SimulcastEncoder::parse("540:0").has_value());
+  EXPECT_FALSE(SimulcastEncoder::parse("-1:50").has_value());
+  EXPECT_FALSE(SimulcastEncoder::parse("540:75,540:60").has_value());
+}
+
+TEST(SimulcastEncoderTest, LargestIgnoresSpecOrder) {
+  SimulcastEncoder ascending(*SimulcastEncoder::parse("270:60,1080:85"));
+  ASSERT_EQ(ascending.largest(), 1);
+  EXPECT_EQ(ascending.getRenditions()[ascending.largest()].name, "1080p");
+
+  // Full size (height 0) beats any height
+  SimulcastEncoder full({{"270p", 270, 60, {}}, {"full", 0, 85, {}}});
+  EXPECT_EQ(full.largest(), 1);
+
+  SimulcastEncoder none({});
+  EXPECT_EQ(none.largest(), -1);
+}
+
+TEST(SimulcastEncoderTest, RenditionSizeKeepsAspectAndNeverUpscales) {
+  const cv::Size frame(1920, 1080);
+  EXPECT_EQ(SimulcastEncoder::renditionSize(frame, 540), cv::Size(960, 540));
+  EXPECT_EQ(SimulcastEncoder::renditionSize(frame, 270), cv::Size(480, 270));
+  EXPECT_EQ(SimulcastEncoder::renditionSize(frame, 2160), frame);
+  EXPECT_EQ(SimulcastEncoder::renditionSize(frame, 0), frame);
+
+  // Widths are even
+  EXPECT_EQ(SimulcastEncoder::renditionSize(cv::Size(640, 480), 101).width %
+                2,
+            0);
+}
+
+TEST(SimulcastEncoderTest, EncodesEveryRendition) {
+  SimulcastEncoder simulcast(threeRenditions());
+  const cv::Mat frame = makeFrame();
+
+  std::vector<std::vector<uint8_t>> buffers(3, std::vector<uint8_t>{7, 7});
+  ASSERT_TRUE(simulcast.encode(
+      frame, {&buffers[0], &buffers[1], &buffers[2]}, 2));
+
+  const int heights[] = {360, 180, 90};
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    ASSERT_GT(buffers[i].size(), 2u);
+    EXPECT_EQ(buffers[i][0], 7); // prefix kept
+    EXPECT_EQ(buffers[i][1], 7);
+
+    const cv::Mat jpeg(1, static_cast<int>(buffers[i].size() - 2), CV_8UC1,
+                       buffers[i].data() + 2);
+    const cv::Mat decoded = cv::imdecode(jpeg, cv::IMREAD_COLOR);
+    EXPECT_EQ(decoded.rows, heights[i]);
+    EXPECT_EQ(decoded.cols, heights[i] * 16 / 9);
+  }
+
+  // Smaller renditions are smaller
+  EXPECT_GT(buffers[0].size(), buffers[1].size());
+  EXPECT_GT(buffers[1].size(), buffers[2].size());
+}
+
+TEST(SimulcastEncoderTest, SkipsRenditionsWithoutOutput) {
+  SimulcastEncoder simulcast(threeRenditions());
+  const cv::Mat frame = makeFrame();
+
+  std::vector<uint8_t> small;
+  ASSERT_TRUE(simulcast.encode(frame, {nullptr, nullptr, &small}));
+  EXPECT_FALSE(small.empty());
+
+  const auto stats = simulcast.getStats();
+  ASSERT_EQ(stats.size(), 3u);
+  EXPECT_EQ(stats[0].frames, 0u);
+  EXPECT_EQ(stats[1].frames, 0u);
+  EXPECT_EQ(stats[2].frames, 1u);
+  EXPECT_EQ(stats[2].size, cv::Size(160, 90));
+  EXPECT_EQ(stats[2].bytes, small.size());
+
+  // Nothing wanted, nothing done
+  EXPECT_TRUE(simulcast.encode(frame, {nullptr, nullptr, nullptr}));
+  EXPECT_EQ(simulcast.getStats()[2].frames, 1u);
+}
+
+TEST(SimulcastEncoderTest, RejectsBadInput) {
+  SimulcastEncoder simulcast(threeRenditions());
+  std::vector<uint8_t> out;
+  EXPECT_FALSE(simulcast.encode(cv::Mat(), {&out, &out, &out}));
+  EXPECT_FALSE(simulcast.encode(makeFrame(), {&out}));
+  EXPECT_EQ(simulcast.find("180p"), 1);
+  EXPECT_EQ(simulcast.find("720p"), -1);
+}
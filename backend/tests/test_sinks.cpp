@@ -0,0 +1,348 @@
+// tests/test_sinks.cpp
+#include "core/RawFileSource.hpp"
+#include "sinks/RawFileSink.hpp"
+#include "sinks/RecordingSink.hpp"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <opencv2/opencv.hpp>
+#include <thread>
+
+using namespace visioncore::sinks;
+using visioncore::core::RawFileSource;
+using visioncore::core::RawVideoHeader;
+
+class RawFileSinkTest : public ::testing::Test {
+protected:
+  const std::string vcraw_path_ = "/tmp/test_sink.vcraw";
+  const std::string y4m_path_ = "/tmp/test_sink.y4m";
+
+  void TearDown() override {
+    std::remove(vcraw_path_.c_str());
+    std::remove(y4m_path_.c_str());
+  }
+
+  static cv::Mat makeFrame(int i, int type = CV_8UC3) {
+    cv::Mat frame(48, 64, type, cv::Scalar::all(i * 8));
+    cv::line(frame, cv::Point(i, 0), cv::Point(i, 47), cv::Scalar::all(255));
+    return frame;
+  }
+};
+
+TEST_F(RawFileSinkTest, OpenFailsOnInvalidPath) {
+  RawFileSink sink("/nonexistent/dir/out.vcraw", 30.0);
+  EXPECT_FALSE(sink.open());
+  EXPECT_FALSE(sink.isOpened());
+  EXPECT_FALSE(sink.write(makeFrame(0)));
+}
+
+TEST_F(RawFileSinkTest, VCRawRoundTripIsLossless) {
+  {
+    RawFileSink sink(vcraw_path_, 30.0);
+    ASSERT_TRUE(sink.open());
+    for (int i = 0; i < 20; ++i) {
+      ASSERT_TRUE(sink.write(makeFrame(i)));
+    }
+    sink.close();
+    EXPECT_EQ(sink.getWrittenCount(), 20u);
+    EXPECT_EQ(sink.getDroppedCount(), 0u);
+    EXPECT_EQ(sink.getBytesWritten(),
+              std::filesystem::file_size(vcraw_path_));
+  }
+
+  RawFileSource source(vcraw_path_);
+  ASSERT_TRUE(source.open());
+  EXPECT_EQ(source.getFrameCount(), 20);
+  EXPECT_DOUBLE_EQ(source.getFPS(), 30.0);
+  EXPECT_EQ(source.getHeader().pixel, RawVideoHeader::Pixel::BGR);
+
+  cv::Mat frame;
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_TRUE(source.readFrame(frame));
+    EXPECT_EQ(cv::norm(frame, makeFrame(i), cv::NORM_INF), 0.0);
+  }
+}
+
+TEST_F(RawFileSinkTest, Y4MRoundTrip) {
+  {
+    RawFileSink sink(y4m_path_, 29.97);
+    ASSERT_TRUE(sink.open());
+    for (int i = 0; i < 10; ++i) {
+      ASSERT_TRUE(sink.write(makeFrame(i)));
+    }
+  }
+
+  RawFileSource source(y4m_path_);
+  ASSERT_TRUE(source.open());
+  EXPECT_EQ(source.getHeader().container, RawVideoHeader::Container::Y4M);
+  EXPECT_EQ(source.getHeader().pixel, RawVideoHeader::Pixel::I420);
+  EXPECT_EQ(source.getHeader().fps_den, 1001);
+  EXPECT_EQ(source.getFrameCount(), 10);
+
+  // 4:2:0 is lossy, but a gray frame survives it closely
+  cv::Mat frame;
+  ASSERT_TRUE(source.readFrame(frame));
+  EXPECT_EQ(frame.size(), cv::Size(64, 48));
+  EXPECT_LT(cv::norm(frame, makeFrame(0), cv::NORM_L1) / frame.total(), 8.0);
+}
+
+TEST_F(RawFileSinkTest, GrayY4MIsLossless) {
+  {
+    RawFileSink sink(y4m_path_, 25.0);
+    ASSERT_TRUE(sink.open());
+    for (int i = 0; i < 5; ++i) {
+      ASSERT_TRUE(sink.write(makeFrame(i, CV_8UC1)));
+    }
+  }
+
+  RawFileSource source(y4m_path_);
+  ASSERT_TRUE(source.open());
+  EXPECT_EQ(source.getHeader().pixel, RawVideoHeader::Pixel::GRAY);
+
+  cv::Mat frame;
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(source.readFrame(frame));
+    EXPECT_EQ(cv::norm(frame, makeFrame(i, CV_8UC1), cv::NORM_INF), 0.0);
+  }
+}
+
+TEST_F(RawFileSinkTest, FormatChangesAreRejected) {
+  RawFileSink sink(vcraw_path_, 30.0);
+  ASSERT_TRUE(sink.open());
+
+  EXPECT_TRUE(sink.write(makeFrame(0)));
+  EXPECT_FALSE(sink.write(cv::Mat(10, 10, CV_8UC3, cv::Scalar::all(0))));
+  EXPECT_FALSE(sink.write(makeFrame(1, CV_8UC1)));
+  EXPECT_TRUE(sink.write(makeFrame(2)));
+  sink.close();
+
+  EXPECT_EQ(sink.getWrittenCount(), 2u);
+  EXPECT_EQ(sink.getDroppedCount(), 2u);
+}
+
+TEST_F(RawFileSinkTest, CallerMayReuseFrameAfterWrite) {
+  {
+    RawFileSink sink(vcraw_path_, 30.0);
+    ASSERT_TRUE(sink.open());
+    cv::Mat frame = makeFrame(0);
+    for (int i = 0; i < 10; ++i) {
+      makeFrame(i).copyTo(frame);
+      ASSERT_TRUE(sink.write(frame));
+    }
+  }
+
+  RawFileSource source(vcraw_path_);
+  ASSERT_TRUE(source.open());
+  cv::Mat frame;
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(source.readFrame(frame));
+    EXPECT_EQ(cv::norm(frame, makeFrame(i), cv::NORM_INF), 0.0);
+  }
+}
+
+TEST_F(RawFileSinkTest, ReopenTruncates) {
+  RawFileSink sink(vcraw_path_, 30.0);
+  ASSERT_TRUE(sink.open());
+  for (int i = 0; i < 5; ++i) {
+    sink.write(makeFrame(i));
+  }
+  sink.close();
+
+  ASSERT_TRUE(sink.open());
+  sink.write(makeFrame(0));
+  sink.close();
+  EXPECT_EQ(sink.getWrittenCount(), 1u);
+
+  RawFileSource source(vcraw_path_);
+  ASSERT_TRUE(source.open());
+  EXPECT_EQ(source.getFrameCount(), 1);
+}
+
+class RecordingSinkTest : public ::testing::Test {
+protected:
+  const std::string avi_path_ = "/tmp/test_recording.avi";
+  const std::string y4m_path_ = "/tmp/test_recording.y4m";
+
+  void TearDown() override {
+    for (const auto &entry : std::filesystem::directory_iterator("/tmp")) {
+      if (entry.path().filename().string().rfind("test_recording", 0) == 0) {
+        std::filesystem::remove(entry.path());
+      }
+    }
+  }
+
+  static cv::Mat makeFrame(int i, int type = CV_8UC3) {
+    cv::Mat frame(48, 64, type);
+    cv::RNG rng(i);
+    rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+    return frame;
+  }
+
+  static int countAviFrames(const std::string &path) {
+    cv::VideoCapture capture(path);
+    int frames = 0;
+    cv::Mat frame;
+    while (capture.read(frame)) {
+      ++frames;
+    }
+    return frames;
+  }
+};
+
+TEST_F(RecordingSinkTest, SegmentPathNumbersBeforeExtension) {
+  EXPECT_EQ(RecordingSink::segmentPath("rec.avi", 0), "rec_0000.avi");
+  EXPECT_EQ(RecordingSink::segmentPath("/a.b/rec.Y4M", 12), "/a.b/rec_0012.Y4M");
+  EXPECT_EQ(RecordingSink::segmentPath("/a.b/rec", 3), "/a.b/rec_0003");
+}
+
+TEST_F(RecordingSinkTest, HandlesAviAndSegmentedY4M) {
+  RecordingOptions segmented;
+  segmented.segment_seconds = 60.0;
+
+  EXPECT_TRUE(RecordingSink::handles("rec.avi", {}));
+  EXPECT_TRUE(RecordingSink::handles("REC.AVI", {}));
+  EXPECT_FALSE(RecordingSink::handles("rec.Y4M", {}));
+  EXPECT_TRUE(RecordingSink::handles("rec.Y4M", segmented));
+  EXPECT_FALSE(RecordingSink::handles("rec.vcraw", segmented));
+  EXPECT_FALSE(RecordingSink::handles("/a.avi/rec", {}));
+
+  EXPECT_TRUE(RecordingSink(avi_path_, 25.0).acceptsEncoded());
+  EXPECT_FALSE(RecordingSink(y4m_path_, 25.0).acceptsEncoded());
+}
+
+TEST_F(RecordingSinkTest, SingleAviFile) {
+  RecordingSink sink(avi_path_, 25.0, {4, DropPolicy::BLOCK});
+  ASSERT_TRUE(sink.open());
+  for (int i = 0; i < 12; ++i) {
+    ASSERT_TRUE(sink.write(makeFrame(i)));
+  }
+  sink.close();
+
+  const RecordingStats stats = sink.getStats();
+  EXPECT_EQ(stats.written, 12u);
+  EXPECT_EQ(stats.dropped, 0u);
+  EXPECT_EQ(stats.segments, 1u);
+  EXPECT_EQ(stats.bytes, std::filesystem::file_size(avi_path_));
+  EXPECT_EQ(countAviFrames(avi_path_), 12);
+}
+
+TEST_F(RecordingSinkTest, AviRotatesBySize) {
+  RecordingOptions options;
+  options.drop = DropPolicy::BLOCK;
+  options.segment_bytes = 16 * 1024; // noise frames are a few KB each
+  RecordingSink sink(avi_path_, 30.0, options);
+  ASSERT_TRUE(sink.open());
+  for (int i = 0; i < 30; ++i) {
+    ASSERT_TRUE(sink.write(makeFrame(i)));
+  }
+  sink.close();
+
+  const RecordingStats stats = sink.getStats();
+  ASSERT_GT(stats.segments, 1u);
+  int frames = 0;
+  uint64_t bytes = 0;
+  for (uint32_t i = 0; i < stats.segments; ++i) {
+    const std::string path = RecordingSink::segmentPath(avi_path_, i);
+    bytes += std::filesystem::file_size(path);
+    frames += countAviFrames(path);
+  }
+  EXPECT_EQ(frames, 30);
+  EXPECT_EQ(bytes, stats.bytes);
+}
+
+TEST_F(RecordingSinkTest, Y4MRotatesByTimeAndFormat) {
+  RecordingOptions options;
+  options.drop = DropPolicy::BLOCK;
+  options.segment_seconds = 0.2;
+  RecordingSink sink(y4m_path_, 30.0, options);
+  ASSERT_TRUE(sink.open());
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(sink.write(makeFrame(i, CV_8UC1)));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(250));
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(sink.write(makeFrame(i, CV_8UC1)));
+  }
+  ASSERT_TRUE(sink.write(makeFrame(0))); // color: new segment
+  EXPECT_FALSE(sink.write(cv::Mat(9, 9, CV_8UC3))); // odd 4:2:0 size
+  sink.close();
+
+  EXPECT_EQ(sink.getStats().segments, 3u);
+  EXPECT_EQ(sink.getStats().dropped, 1u);
+
+  const int expected[] = {3, 3, 1};
+  for (uint32_t i = 0; i < 3; ++i) {
+    RawFileSource source(RecordingSink::segmentPath(y4m_path_, i));
+    ASSERT_TRUE(source.open());
+    EXPECT_EQ(source.getFrameCount(), expected[i]);
+  }
+
+  // Gray frames are stored exactly
+  RawFileSource source(RecordingSink::segmentPath(y4m_path_, 1));
+  ASSERT_TRUE(source.open());
+  cv::Mat frame;
+  ASSERT_TRUE(source.readFrame(frame));
+  EXPECT_EQ(cv::norm(frame, makeFrame(0, CV_8UC1), cv::NORM_INF), 0.0);
+}
+
+TEST_F(RecordingSinkTest, EncodedFramesAreStoredAsIs) {
+  RecordingSink sink(avi_path_, 30.0, {4, DropPolicy::BLOCK});
+  ASSERT_TRUE(sink.open());
+
+  visioncore::processing::FrameEncoder encoder(90);
+  std::vector<uint8_t> jpeg;
+  for (int i = 0; i < 5; ++i) {
+    auto buffer = std::make_shared<std::vector<uint8_t>>(6, 0); // header
+    ASSERT_TRUE(encoder.encodeJPEG(makeFrame(i), *buffer, 6));
+    jpeg.assign(buffer->begin() + 6, buffer->end());
+    ASSERT_TRUE(sink.writeEncoded(buffer, 6, cv::Size(64, 48)));
+  }
+  EXPECT_FALSE(sink.writeEncoded(nullptr, 0, cv::Size(64, 48)));
+  sink.close();
+
+  EXPECT_EQ(sink.getStats().written, 5u);
+  EXPECT_EQ(countAviFrames(avi_path_), 5);
+
+  // The last JPEG is in the file byte for byte
+  std::ifstream in(avi_path_, std::ios::binary);
+  const std::string file((std::istreambuf_iterator<char>(in)),
+                         std::istreambuf_iterator<char>());
+  EXPECT_NE(file.find(std::string(jpeg.begin(), jpeg.end())),
+            std::string::npos);
+
+  RecordingSink y4m(y4m_path_, 30.0);
+  ASSERT_TRUE(y4m.open());
+  EXPECT_FALSE(y4m.writeEncoded(std::make_shared<std::vector<uint8_t>>(jpeg),
+                                0, cv::Size(64, 48)));
+}
+
+TEST_F(RecordingSinkTest, DropPoliciesNeverBlockAndAccountForEveryFrame) {
+  const cv::Mat frame = makeFrame(1);
+  cv::Mat large;
+  cv::resize(frame, large, cv::Size(1920, 1080));
+
+  for (DropPolicy policy : {DropPolicy::DROP_NEWEST, DropPolicy::DROP_OLDEST}) {
+    RecordingSink sink(avi_path_, 30.0, {2, policy});
+    ASSERT_TRUE(sink.open());
+    for (int i = 0; i < 100; ++i) {
+      sink.write(large);
+      EXPECT_LE(sink.getStats().backlog, 2u);
+    }
+    sink.close();
+
+    const RecordingStats stats = sink.getStats();
+    EXPECT_EQ(stats.written + stats.dropped, 100u);
+    EXPECT_GT(stats.written, 0u);
+    EXPECT_EQ(countAviFrames(avi_path_), static_cast<int>(stats.written));
+  }
+}
+
+TEST_F(RecordingSinkTest, RejectsWritesWhenClosed) {
+  RecordingSink sink(avi_path_, 30.0);
+  EXPECT_FALSE(sink.write(makeFrame(0)));
+  RecordingSink invalid(avi_path_, 0.0);
+  EXPECT_FALSE(invalid.open());
+}
@@ -1,9 +1,23 @@
+#include "../src/core/ImageSequence.hpp"
 #include "../src/core/ImageSource.hpp"
+#include "../src/core/NetworkSource.hpp"
+#include "../src/core/PrefetchingSource.hpp"
+#include "../src/core/RawFileSource.hpp"
+#include "../src/core/SyntheticSource.hpp"
 #include "../src/core/VideoFileSource.hpp"
 #include "../src/core/WebcamSource.hpp"
 #include <gtest/gtest.h>
 #include <opencv2/opencv.hpp>
 
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <thread>
+#include <vector>
+
 using namespace visioncore::core;
 
 // ==================== ImageSource Tests ====================
@@ -85,6 +99,49 @@ TEST_F(ImageSourceTest, ReadFrameConsistency) {
   EXPECT_DOUBLE_EQ(sum, 0.0);
 }
 
+TEST_F(ImageSourceTest, ReadFrameWithInfo) {
+  ImageSource source("/tmp/test_image.jpg");
+  source.open();
+
+  cv::Mat frame;
+  FrameInfo info;
+  auto before = std::chrono::steady_clock::now();
+  EXPECT_TRUE(source.readFrame(frame, info));
+  EXPECT_GE(info.capture_time, before);
+  EXPECT_LE(info.capture_time, std::chrono::steady_clock::now());
+}
+
+TEST_F(ImageSourceTest, FramesShareTheDecodedImage) {
+  ImageSource source("/tmp/test_image.jpg");
+  source.open();
+
+  cv::Mat frame1, frame2;
+  FrameInfo info1, info2;
+  ASSERT_TRUE(source.readFrame(frame1, info1));
+  ASSERT_TRUE(source.readFrame(frame2, info2));
+
+  // No per-frame copy, and the generation says nothing changed
+  EXPECT_EQ(frame1.data, frame2.data);
+  EXPECT_NE(info1.generation, 0u);
+  EXPECT_EQ(info1.generation, info2.generation);
+}
+
+TEST_F(ImageSourceTest, GenerationChangesOnReload) {
+  ImageSource source("/tmp/test_image.jpg");
+  EXPECT_EQ(source.getGeneration(), 0u);
+
+  source.open();
+  const uint64_t first = source.getGeneration();
+  source.close();
+  source.open();
+
+  cv::Mat frame;
+  FrameInfo info;
+  ASSERT_TRUE(source.readFrame(frame, info));
+  EXPECT_NE(info.generation, first);
+  EXPECT_EQ(info.generation, source.getGeneration());
+}
+
 TEST_F(ImageSourceTest, ReadFrameBeforeOpen) {
   ImageSource source("/tmp/test_image.jpg");
   cv::Mat frame;
@@ -214,6 +271,44 @@ TEST_F(WebcamSourceTest, CloseWebcam) {
   EXPECT_FALSE(webcam.isOpened());
 }
 
+TEST(WebcamSourceConfigTest, FourccToString) {
+  EXPECT_EQ(WebcamSource::fourccToString(
+                cv::VideoWriter::fourcc('M', 'J', 'P', 'G')),
+            "MJPG");
+  EXPECT_EQ(WebcamSource::fourccToString(
+                cv::VideoWriter::fourcc('Y', 'U', 'Y', 'V')),
+            "YUYV");
+  EXPECT_EQ(WebcamSource::fourccToString(0), "????");
+}
+
+TEST(WebcamSourceConfigTest, NegotiatedFormatReported) {
+  WebcamConfig config;
+  config.fourcc = "MJPG";
+  config.width = 1280;
+  config.height = 720;
+  config.fps = 30.0;
+  config.buffer_size = 1;
+
+  WebcamSource webcam(0, config);
+  if (!webcam.open()) {
+    GTEST_SKIP() << "No webcam available, skipping test";
+  }
+
+  const WebcamFormat &format = webcam.getNegotiatedFormat();
+  EXPECT_EQ(format.fourcc.size(), 4u);
+  EXPECT_EQ(format.width, webcam.getWidth());
+  EXPECT_EQ(format.height, webcam.getHeight());
+
+  cv::Mat frame;
+  FrameInfo info;
+  auto before = std::chrono::steady_clock::now();
+  ASSERT_TRUE(webcam.readFrame(frame, info));
+  EXPECT_GE(info.capture_time, before);
+  EXPECT_EQ(frame.cols, format.width);
+
+  webcam.close();
+}
+
 // ==================== VideoFileSource Tests ====================
 class VideoFileSourceTest : public ::testing::Test {
 protected:
@@ -349,3 +444,1100 @@ TEST_F(VideoFileSourceTest, CloseVideoNotOpened) {
   // Should not crash or throw
   video.close();
 }
+
+TEST_F(VideoFileSourceTest, FramesCarryIndexAndTimestamp) {
+  VideoFileSource video("/tmp/test_video.mp4");
+  ASSERT_TRUE(video.open());
+
+  cv::Mat frame;
+  FrameInfo info;
+  double previous_pts = -1.0;
+  for (int64_t i = 0; i < 60; ++i) {
+    ASSERT_TRUE(video.readFrame(frame, info));
+    EXPECT_EQ(info.frame_index, i);
+    EXPECT_GT(info.pts_ms, previous_pts);
+    EXPECT_NEAR(info.pts_ms, i * 1000.0 / 30.0, 1.0);
+    previous_pts = info.pts_ms;
+  }
+}
+
+TEST_F(VideoFileSourceTest, IndexIsBuiltAndPersisted) {
+  VideoFileSource video("/tmp/test_video.mp4");
+  ASSERT_TRUE(video.open());
+  if (!video.hasIndex()) {
+    GTEST_SKIP() << "Capture backend cannot report keyframes";
+  }
+
+  EXPECT_EQ(video.getFrameCount(), 60);
+  ASSERT_FALSE(video.getKeyframes().empty());
+  EXPECT_EQ(video.getKeyframes().front(), 0);
+  EXPECT_TRUE(std::filesystem::exists(video.getIndexPath()));
+
+  // A second open loads the same index from disk
+  VideoFileSource reopened("/tmp/test_video.mp4");
+  ASSERT_TRUE(reopened.open());
+  EXPECT_EQ(reopened.getKeyframes(), video.getKeyframes());
+}
+
+TEST_F(VideoFileSourceTest, IndexNotPersistedWhenDisabled) {
+  std::filesystem::remove("/tmp/test_video.mp4.vcidx");
+
+  VideoFileOptions options;
+  options.persist_index = false;
+  VideoFileSource video("/tmp/test_video.mp4", false, options);
+  ASSERT_TRUE(video.open());
+
+  EXPECT_FALSE(std::filesystem::exists(video.getIndexPath()));
+}
+
+TEST_F(VideoFileSourceTest, StaleIndexIsRebuilt) {
+  {
+    std::ofstream stale("/tmp/test_video.mp4.vcidx", std::ios::trunc);
+    stale << R"({"version":1,"size":1,"mtime":1,"fps":30,)"
+          << R"("keyframes":[0,1,2],"pts_ms":[0,1,2]})";
+  }
+
+  VideoFileSource video("/tmp/test_video.mp4");
+  ASSERT_TRUE(video.open());
+  if (!video.hasIndex()) {
+    GTEST_SKIP() << "Capture backend cannot report keyframes";
+  }
+
+  EXPECT_EQ(video.getFrameCount(), 60);
+}
+
+TEST_F(VideoFileSourceTest, MalformedIndexIsRebuilt) {
+  const std::string path = "/tmp/test_video.mp4";
+  const auto size = std::filesystem::file_size(path);
+  const auto mtime =
+      std::filesystem::last_write_time(path).time_since_epoch().count();
+
+  // Up to date, but keyframes neither sorted nor starting at frame 0
+  std::vector<double> pts_ms(60);
+  for (size_t i = 0; i < pts_ms.size(); ++i) {
+    pts_ms[i] = static_cast<double>(i) * 1000.0 / 30.0;
+  }
+  nlohmann::json index;
+  index["version"] = 1;
+  index["size"] = size;
+  index["mtime"] = mtime;
+  index["fps"] = 30;
+  index["keyframes"] = {30, 10};
+  index["pts_ms"] = pts_ms;
+  {
+    std::ofstream bad(path + ".vcidx", std::ios::trunc);
+    bad << index.dump();
+  }
+
+  VideoFileSource video(path);
+  ASSERT_TRUE(video.open());
+
+  cv::Mat frame;
+  FrameInfo info;
+  ASSERT_TRUE(video.seek(5));
+  ASSERT_TRUE(video.readFrame(frame, info));
+  EXPECT_EQ(info.frame_index, 5);
+  EXPECT_NEAR(cv::mean(frame)[0], 20.0, 3.0);
+}
+
+TEST_F(VideoFileSourceTest, SeekIsFrameAccurate) {
+  VideoFileSource video("/tmp/test_video.mp4");
+  ASSERT_TRUE(video.open());
+
+  cv::Mat frame;
+  FrameInfo info;
+  for (int64_t target : {37, 5, 59, 0, 12}) {
+    ASSERT_TRUE(video.seek(target));
+    EXPECT_EQ(video.getPosition(), target);
+    ASSERT_TRUE(video.readFrame(frame, info));
+    EXPECT_EQ(info.frame_index, target);
+    EXPECT_NEAR(cv::mean(frame)[0], target * 4.0, 3.0);
+  }
+}
+
+TEST_F(VideoFileSourceTest, SeekToTime) {
+  VideoFileSource video("/tmp/test_video.mp4");
+  ASSERT_TRUE(video.open());
+
+  // Frame 30 is displayed from 1000 ms to 1033 ms
+  ASSERT_TRUE(video.seekToTime(1010.0));
+
+  cv::Mat frame;
+  FrameInfo info;
+  ASSERT_TRUE(video.readFrame(frame, info));
+  EXPECT_EQ(info.frame_index, 30);
+  EXPECT_NEAR(cv::mean(frame)[0], 120.0, 3.0);
+}
+
+TEST_F(VideoFileSourceTest, SeekOutOfRange) {
+  VideoFileSource video("/tmp/test_video.mp4");
+  EXPECT_FALSE(video.seek(0)); // not opened
+
+  ASSERT_TRUE(video.open());
+  EXPECT_FALSE(video.seek(-1));
+  EXPECT_FALSE(video.seek(60));
+}
+
+TEST_F(VideoFileSourceTest, LoopRestartsAtFrameZero) {
+  VideoFileSource video("/tmp/test_video.mp4", true);
+  ASSERT_TRUE(video.open());
+
+  cv::Mat frame;
+  FrameInfo info;
+  for (int i = 0; i < 60; ++i) {
+    ASSERT_TRUE(video.readFrame(frame, info));
+  }
+
+  ASSERT_TRUE(video.readFrame(frame, info));
+  EXPECT_EQ(info.frame_index, 0);
+  EXPECT_NEAR(cv::mean(frame)[0], 0.0, 3.0);
+}
+
+TEST_F(VideoFileSourceTest, DecodeThreadsOption) {
+  VideoFileOptions options;
+  options.decode_threads = 2;
+  VideoFileSource video("/tmp/test_video.mp4", false, options);
+  ASSERT_TRUE(video.open());
+
+  cv::Mat frame;
+  int frame_count = 0;
+  while (video.readFrame(frame)) {
+    frame_count++;
+  }
+  EXPECT_EQ(frame_count, 60);
+}
+
+// ==================== ImageSequenceSource Tests ====================
+
+class ImageSequenceSourceTest : public ::testing::Test {
+protected:
+  const std::string dir_ = "/tmp/test_sequence";
+
+  void SetUp() override {
+    std::filesystem::remove_all(dir_);
+    std::filesystem::create_directories(dir_);
+
+    // 20 frames, value i * 10, numbered from 1 like most exports
+    for (int i = 0; i < 20; ++i) {
+      char name[32];
+      std::snprintf(name, sizeof(name), "/frame_%03d.png", i + 1);
+      cv::Mat frame(24, 32, CV_8UC3, cv::Scalar(i * 10, i * 10, i * 10));
+      cv::imwrite(dir_ + name, frame);
+    }
+  }
+
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+
+  static ImageSequenceOptions unpaced() {
+    ImageSequenceOptions options;
+    options.pace = false;
+    options.decode_threads = 2;
+    options.read_ahead = 4;
+    return options;
+  }
+};
+
+TEST_F(ImageSequenceSourceTest, ExpandPatterns) {
+  EXPECT_EQ(ImageSequenceSource::expandPattern(dir_).size(), 20u);
+  EXPECT_EQ(ImageSequenceSource::expandPattern(dir_ + "/frame_%03d.png").size(),
+            20u);
+  EXPECT_EQ(ImageSequenceSource::expandPattern(dir_ + "/frame_*.png").size(),
+            20u);
+  EXPECT_EQ(ImageSequenceSource::expandPattern(dir_ + "/frame_00?.png").size(),
+            9u);
+  EXPECT_TRUE(ImageSequenceSource::expandPattern(dir_ + "/*.jpg").empty());
+  EXPECT_TRUE(ImageSequenceSource::expandPattern("/nonexistent/%d.png").empty());
+}
+
+TEST_F(ImageSequenceSourceTest, NaturalOrder) {
+  const std::string dir = dir_ + "/unpadded";
+  std::filesystem::create_directories(dir);
+  const cv::Mat frame(4, 4, CV_8UC1, cv::Scalar(0));
+  for (int i : {10, 2, 1}) {
+    cv::imwrite(dir + "/f" + std::to_string(i) + ".png", frame);
+  }
+
+  const std::vector<std::string> expected{dir + "/f1.png", dir + "/f2.png",
+                                          dir + "/f10.png"};
+  EXPECT_EQ(ImageSequenceSource::expandPattern(dir), expected);
+  EXPECT_EQ(ImageSequenceSource::expandPattern(dir + "/f%d.png"), expected);
+}
+
+TEST_F(ImageSequenceSourceTest, OpenInvalidPattern) {
+  ImageSequenceSource sequence(dir_ + "/missing_%04d.png", 30.0);
+  EXPECT_FALSE(sequence.open());
+  EXPECT_FALSE(sequence.isOpened());
+}
+
+TEST_F(ImageSequenceSourceTest, OpenReportsGeometry) {
+  ImageSequenceSource sequence(dir_, 25.0);
+  ASSERT_TRUE(sequence.open());
+
+  EXPECT_EQ(sequence.getFrameCount(), 20u);
+  EXPECT_EQ(sequence.getWidth(), 32);
+  EXPECT_EQ(sequence.getHeight(), 24);
+  EXPECT_DOUBLE_EQ(sequence.getFPS(), 25.0);
+  EXPECT_EQ(sequence.getName(), dir_);
+}
+
+TEST_F(ImageSequenceSourceTest, ReadsFramesInOrder) {
+  ImageSequenceSource sequence(dir_ + "/frame_%03d.png", unpaced());
+  ASSERT_TRUE(sequence.open());
+
+  cv::Mat frame;
+  FrameInfo info;
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_TRUE(sequence.readFrame(frame, info));
+    EXPECT_EQ(info.frame_index, i);
+    EXPECT_DOUBLE_EQ(info.pts_ms, i * 1000.0 / 30.0);
+    EXPECT_EQ(frame.at<cv::Vec3b>(0, 0)[0], i * 10);
+  }
+
+  // End of sequence without looping
+  EXPECT_FALSE(sequence.readFrame(frame));
+  EXPECT_EQ(sequence.getDecodeCount(), 20u);
+}
+
+TEST_F(ImageSequenceSourceTest, LoopingServesFramesFromCache) {
+  ImageSequenceOptions options = unpaced();
+  options.loop = true;
+  ImageSequenceSource sequence(dir_, options);
+  ASSERT_TRUE(sequence.open());
+
+  cv::Mat frame;
+  FrameInfo info;
+  for (int i = 0; i < 60; ++i) {
+    ASSERT_TRUE(sequence.readFrame(frame, info));
+    EXPECT_EQ(info.frame_index, i % 20);
+  }
+
+  // Everything fits in the budget: each file is decoded once
+  EXPECT_EQ(sequence.getDecodeCount(), 20u);
+  EXPECT_GE(sequence.getCacheHits(), 40u);
+}
+
+TEST_F(ImageSequenceSourceTest, CacheStaysWithinBudget) {
+  const size_t frame_bytes = 32 * 24 * 3;
+
+  ImageSequenceOptions options = unpaced();
+  options.loop = true;
+  options.read_ahead = 2;
+  options.cache_bytes = 6 * frame_bytes;
+  ImageSequenceSource sequence(dir_, options);
+  ASSERT_TRUE(sequence.open());
+
+  cv::Mat frame;
+  for (int i = 0; i < 40; ++i) {
+    ASSERT_TRUE(sequence.readFrame(frame));
+    EXPECT_EQ(frame.at<cv::Vec3b>(0, 0)[0], (i % 20) * 10);
+    EXPECT_LE(sequence.getCacheBytes(), options.cache_bytes);
+  }
+
+  // The second pass had to decode again
+  EXPECT_GT(sequence.getDecodeCount(), 20u);
+}
+
+TEST_F(ImageSequenceSourceTest, RandomAccess) {
+  ImageSequenceSource sequence(dir_, unpaced());
+  ASSERT_TRUE(sequence.open());
+
+  cv::Mat frame;
+  FrameInfo info;
+  for (size_t target : {13u, 2u, 19u, 7u}) {
+    ASSERT_TRUE(sequence.seek(target));
+    EXPECT_EQ(sequence.getCurrentFrameIndex(), target);
+    ASSERT_TRUE(sequence.readFrame(frame, info));
+    EXPECT_EQ(info.frame_index, static_cast<int64_t>(target));
+    EXPECT_EQ(frame.at<cv::Vec3b>(0, 0)[0], static_cast<int>(target) * 10);
+  }
+
+  EXPECT_FALSE(sequence.seek(20));
+
+  sequence.reset();
+  ASSERT_TRUE(sequence.readFrame(frame, info));
+  EXPECT_EQ(info.frame_index, 0);
+}
+
+TEST_F(ImageSequenceSourceTest, UnreadableFilesAreSkipped) {
+  std::ofstream(dir_ + "/frame_005.png") << "not an image";
+
+  ImageSequenceSource sequence(dir_, unpaced());
+  ASSERT_TRUE(sequence.open());
+
+  cv::Mat frame;
+  int count = 0;
+  while (sequence.readFrame(frame)) {
+    ++count;
+  }
+  EXPECT_EQ(count, 19);
+}
+
+TEST_F(ImageSequenceSourceTest, PacingFollowsFPS) {
+  ImageSequenceOptions options;
+  options.fps = 50.0;
+  ImageSequenceSource sequence(dir_, options);
+  ASSERT_TRUE(sequence.open());
+
+  cv::Mat frame;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 11; ++i) {
+    ASSERT_TRUE(sequence.readFrame(frame));
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+
+  // 10 periods of 20 ms after the first frame
+  EXPECT_GE(elapsed, 180);
+}
+
+TEST_F(ImageSequenceSourceTest, CloseReleasesCache) {
+  ImageSequenceSource sequence(dir_, unpaced());
+  ASSERT_TRUE(sequence.open());
+
+  cv::Mat frame;
+  ASSERT_TRUE(sequence.readFrame(frame));
+  EXPECT_GT(sequence.getCacheBytes(), 0u);
+
+  sequence.close();
+  EXPECT_FALSE(sequence.isOpened());
+  EXPECT_EQ(sequence.getCacheBytes(), 0u);
+  EXPECT_FALSE(sequence.readFrame(frame));
+}
+
+// ==================== RawFileSource Tests ====================
+
+class RawFileSourceTest : public ::testing::Test {
+protected:
+  const std::string vcraw_path_ = "/tmp/test_raw.vcraw";
+  const std::string y4m_path_ = "/tmp/test_raw.y4m";
+
+  void TearDown() override {
+    std::remove(vcraw_path_.c_str());
+    std::remove(y4m_path_.c_str());
+  }
+
+  // 10 BGR frames of 32x24, frame i filled with value i * 10
+  void writeVCRaw(size_t trailing_bytes = 0) {
+    RawVideoHeader header;
+    header.width = 32;
+    header.height = 24;
+    header.fps_num = 25;
+
+    std::ofstream out(vcraw_path_, std::ios::binary);
+    out << formatRawHeader(header);
+    for (int i = 0; i < 10; ++i) {
+      const std::string frame(header.frameBytes(), static_cast<char>(i * 10));
+      out.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+    }
+    out << std::string(trailing_bytes, '\0');
+  }
+
+  // 6 frames of 32x24 4:2:0 (or mono), luma i * 20, neutral chroma
+  void writeY4M(bool mono, bool frame_params = false) {
+    RawVideoHeader header;
+    header.container = RawVideoHeader::Container::Y4M;
+    header.pixel = mono ? RawVideoHeader::Pixel::GRAY
+                        : RawVideoHeader::Pixel::I420;
+    header.width = 32;
+    header.height = 24;
+
+    std::ofstream out(y4m_path_, std::ios::binary);
+    out << formatRawHeader(header);
+    for (int i = 0; i < 6; ++i) {
+      out << (frame_params ? "FRAME Ixyz\n" : "FRAME\n");
+      out << std::string(32 * 24, static_cast<char>(i * 20));
+      if (!mono) {
+        out << std::string(header.frameBytes() - 32 * 24, '\x80');
+      }
+    }
+  }
+};
+
+TEST_F(RawFileSourceTest, HeaderRoundTrip) {
+  RawVideoHeader header;
+  header.width = 640;
+  header.height = 480;
+  fpsToRational(29.97, header.fps_num, header.fps_den);
+
+  const std::string text = formatRawHeader(header);
+  EXPECT_EQ(text.size() % 64, 0u);
+
+  size_t header_size = 0;
+  const auto parsed = parseRawHeader(text.data(), text.size(), header_size);
+  ASSERT_TRUE(parsed.has_value());
+  EXPECT_EQ(header_size, text.size());
+  EXPECT_EQ(parsed->width, 640);
+  EXPECT_EQ(parsed->height, 480);
+  EXPECT_EQ(parsed->fps_num, 30000);
+  EXPECT_EQ(parsed->fps_den, 1001);
+  EXPECT_EQ(parsed->pixel, RawVideoHeader::Pixel::BGR);
+}
+
+TEST_F(RawFileSourceTest, OnlyEightBit420IsAccepted) {
+  size_t header_size = 0;
+  for (const std::string colorspace :
+       {"420", "420jpeg", "420paldv", "420mpeg2"}) {
+    const std::string text = "YUV4MPEG2 W32 H24 F25:1 C" + colorspace + "\n";
+    const auto parsed = parseRawHeader(text.data(), text.size(), header_size);
+    ASSERT_TRUE(parsed.has_value()) << colorspace;
+    EXPECT_EQ(parsed->pixel, RawVideoHeader::Pixel::I420);
+  }
+
+  for (const std::string colorspace : {"420p10", "420p12", "422", "444"}) {
+    const std::string text = "YUV4MPEG2 W32 H24 F25:1 C" + colorspace + "\n";
+    EXPECT_FALSE(parseRawHeader(text.data(), text.size(), header_size))
+        << colorspace;
+  }
+}
+
+TEST_F(RawFileSourceTest, OpenInvalidFile) {
+  RawFileSource missing("/nonexistent/file.vcraw");
+  EXPECT_FALSE(missing.open());
+
+  {
+    std::ofstream out(vcraw_path_);
+    out << "not a raw video\n";
+  }
+  RawFileSource garbage(vcraw_path_);
+  EXPECT_FALSE(garbage.open());
+  EXPECT_FALSE(garbage.isOpened());
+}
+
+TEST_F(RawFileSourceTest, ReadsVCRawZeroCopy) {
+  writeVCRaw();
+  RawFileSource source(vcraw_path_);
+  ASSERT_TRUE(source.open());
+
+  EXPECT_EQ(source.getWidth(), 32);
+  EXPECT_EQ(source.getHeight(), 24);
+  EXPECT_DOUBLE_EQ(source.getFPS(), 25.0);
+  EXPECT_EQ(source.getFrameCount(), 10);
+  EXPECT_TRUE(source.isZeroCopy());
+
+  cv::Mat first, second;
+  FrameInfo info;
+  ASSERT_TRUE(source.readFrame(first, info));
+  EXPECT_EQ(info.frame_index, 0);
+  ASSERT_TRUE(source.readFrame(second, info));
+  EXPECT_EQ(info.frame_index, 1);
+  EXPECT_DOUBLE_EQ(info.pts_ms, 40.0);
+
+  EXPECT_EQ(first.type(), CV_8UC3);
+  EXPECT_EQ(first.at<cv::Vec3b>(5, 5)[0], 0);
+  EXPECT_EQ(second.at<cv::Vec3b>(5, 5)[0], 10);
+
+  // Both frames are views of the same mapping, one frame apart
+  EXPECT_EQ(second.data - first.data, 32 * 24 * 3);
+}
+
+TEST_F(RawFileSourceTest, WritesDoNotReachTheFile) {
+  writeVCRaw();
+  {
+    RawFileSource source(vcraw_path_);
+    ASSERT_TRUE(source.open());
+    cv::Mat frame;
+    ASSERT_TRUE(source.readFrame(frame));
+    frame.setTo(cv::Scalar(255, 255, 255));
+  }
+
+  RawFileSource source(vcraw_path_);
+  ASSERT_TRUE(source.open());
+  cv::Mat frame;
+  ASSERT_TRUE(source.readFrame(frame));
+  EXPECT_EQ(frame.at<cv::Vec3b>(0, 0)[0], 0);
+}
+
+TEST_F(RawFileSourceTest, TruncatedLastFrameIsIgnored) {
+  writeVCRaw(100);
+  RawFileSource source(vcraw_path_);
+  ASSERT_TRUE(source.open());
+  EXPECT_EQ(source.getFrameCount(), 10);
+}
+
+TEST_F(RawFileSourceTest, ReadsY4M420AsBGR) {
+  writeY4M(false);
+  RawFileSource source(y4m_path_);
+  ASSERT_TRUE(source.open());
+  EXPECT_EQ(source.getFrameCount(), 6);
+  EXPECT_FALSE(source.isZeroCopy());
+
+  // Neutral chroma: gray pixels getting brighter with the luma
+  cv::Mat frame;
+  int previous = -1;
+  for (int i = 0; i < 6; ++i) {
+    ASSERT_TRUE(source.readFrame(frame));
+    ASSERT_EQ(frame.type(), CV_8UC3);
+    const cv::Vec3b pixel = frame.at<cv::Vec3b>(10, 10);
+    EXPECT_NEAR(pixel[0], pixel[2], 2);
+    EXPECT_GT(pixel[1], previous);
+    previous = pixel[1];
+  }
+  EXPECT_FALSE(source.readFrame(frame));
+}
+
+TEST_F(RawFileSourceTest, ReadsY4MPlanarWithoutConversion) {
+  writeY4M(false);
+  RawFileOptions options;
+  options.convert_yuv = false;
+  RawFileSource source(y4m_path_, options);
+  ASSERT_TRUE(source.open());
+  EXPECT_TRUE(source.isZeroCopy());
+
+  cv::Mat frame;
+  ASSERT_TRUE(source.readFrame(frame));
+  EXPECT_EQ(frame.rows, 36);
+  EXPECT_EQ(frame.cols, 32);
+  EXPECT_EQ(frame.type(), CV_8UC1);
+}
+
+TEST_F(RawFileSourceTest, ReadsY4MWithFrameParameters) {
+  writeY4M(true, true);
+  RawFileSource source(y4m_path_);
+  ASSERT_TRUE(source.open());
+  EXPECT_EQ(source.getFrameCount(), 6);
+
+  cv::Mat frame;
+  ASSERT_TRUE(source.seek(3));
+  ASSERT_TRUE(source.readFrame(frame));
+  EXPECT_EQ(frame.type(), CV_8UC1);
+  EXPECT_EQ(frame.at<uchar>(0, 0), 60);
+}
+
+TEST_F(RawFileSourceTest, SeekAndLoop) {
+  writeVCRaw();
+  RawFileOptions options;
+  options.loop = true;
+  RawFileSource source(vcraw_path_, options);
+  ASSERT_TRUE(source.open());
+
+  EXPECT_FALSE(source.seek(10));
+  ASSERT_TRUE(source.seek(9));
+  EXPECT_EQ(source.getPosition(), 9);
+
+  cv::Mat frame;
+  ASSERT_TRUE(source.readFrame(frame));
+  EXPECT_EQ(frame.at<cv::Vec3b>(0, 0)[0], 90);
+  ASSERT_TRUE(source.readFrame(frame));
+  EXPECT_EQ(frame.at<cv::Vec3b>(0, 0)[0], 0);
+}
+
+// ==================== SyntheticSource Tests ====================
+
+TEST(SyntheticSourceTest, ConstructorRejectsInvalidOptions) {
+  SyntheticOptions options;
+  options.width = 0;
+  EXPECT_THROW(SyntheticSource{options}, std::invalid_argument);
+
+  options = SyntheticOptions{};
+  options.fps = 0.0;
+  EXPECT_THROW(SyntheticSource{options}, std::invalid_argument);
+
+  options = SyntheticOptions{};
+  options.type = CV_16UC1;
+  EXPECT_THROW(SyntheticSource{options}, std::invalid_argument);
+}
+
+TEST(SyntheticSourceTest, GeneratesRequestedFormat) {
+  for (const int type : {CV_8UC1, CV_8UC3, CV_8UC4}) {
+    SyntheticOptions options;
+    options.width = 320;
+    options.height = 240;
+    options.type = type;
+    SyntheticSource source(options);
+    ASSERT_TRUE(source.open());
+
+    cv::Mat frame;
+    ASSERT_TRUE(source.readFrame(frame));
+    EXPECT_EQ(frame.size(), cv::Size(320, 240));
+    EXPECT_EQ(frame.type(), type);
+  }
+}
+
+TEST(SyntheticSourceTest, FrameIndexIsBurnedIn) {
+  SyntheticOptions options;
+  options.width = 640;
+  options.height = 360;
+  options.fps = 25.0;
+  SyntheticSource source(options);
+  ASSERT_TRUE(source.open());
+
+  cv::Mat frame, gray;
+  FrameInfo info;
+  for (int64_t i = 0; i < 40; ++i) {
+    ASSERT_TRUE(source.readFrame(frame, info));
+    EXPECT_EQ(info.frame_index, i);
+    EXPECT_DOUBLE_EQ(info.pts_ms, i * 40.0);
+    EXPECT_EQ(SyntheticSource::decodeFrameIndex(frame), i);
+
+    // Survives a color conversion downstream
+    cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+    EXPECT_EQ(SyntheticSource::decodeFrameIndex(gray), i);
+  }
+}
+
+TEST(SyntheticSourceTest, EveryPatternIsDeterministic) {
+  for (const char *name : {"bars", "gradient", "checker", "noise"}) {
+    const auto pattern = SyntheticSource::parsePattern(name);
+    ASSERT_TRUE(pattern.has_value()) << name;
+
+    SyntheticOptions options;
+    options.width = 160;
+    options.height = 120;
+    options.pattern = *pattern;
+    SyntheticSource a(options);
+    SyntheticSource b(options);
+    ASSERT_TRUE(a.open());
+    ASSERT_TRUE(b.open());
+
+    cv::Mat fa, fb, first;
+    for (int i = 0; i < 10; ++i) {
+      ASSERT_TRUE(a.readFrame(fa));
+      ASSERT_TRUE(b.readFrame(fb));
+      EXPECT_EQ(cv::norm(fa, fb, cv::NORM_INF), 0.0) << name;
+      if (i == 0) {
+        first = fa.clone();
+      }
+    }
+
+    // The content moves (or changes, for noise) below the stamp
+    const cv::Rect body(0, 8, 160, 112);
+    EXPECT_GT(cv::norm(fa(body), first(body), cv::NORM_INF), 0.0) << name;
+  }
+  EXPECT_FALSE(SyntheticSource::parsePattern("plasma").has_value());
+}
+
+TEST(SyntheticSourceTest, FrameCountEndsStream) {
+  SyntheticOptions options;
+  options.width = 64;
+  options.height = 48;
+  options.frame_count = 5;
+  SyntheticSource source(options);
+  ASSERT_TRUE(source.open());
+
+  cv::Mat frame;
+  int frames = 0;
+  while (source.readFrame(frame)) {
+    ++frames;
+  }
+  EXPECT_EQ(frames, 5);
+
+  source.reset();
+  EXPECT_TRUE(source.readFrame(frame));
+  EXPECT_EQ(SyntheticSource::decodeFrameIndex(frame), 0);
+}
+
+TEST(SyntheticSourceTest, PacingFollowsFPS) {
+  SyntheticOptions options;
+  options.width = 64;
+  options.height = 48;
+  options.fps = 100.0;
+  options.pace = true;
+  SyntheticSource source(options);
+  ASSERT_TRUE(source.open());
+
+  cv::Mat frame;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 11; ++i) {
+    ASSERT_TRUE(source.readFrame(frame));
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_GE(elapsed, std::chrono::milliseconds(95));
+}
+
+// ==================== PrefetchingSource Tests ====================
+
+/**
+ * @brief Source producing frames filled with their index, with an optional
+ * capture delay
+ */
+class CountingSource : public VideoSource {
+public:
+  CountingSource(int frame_count, std::chrono::milliseconds delay)
+      : frame_count_(frame_count), delay_(delay) {}
+
+  bool open() override {
+    opened_ = true;
+    next_ = 0;
+    return true;
+  }
+
+  bool readFrame(cv::Mat &frame) override {
+    if (!opened_ || next_ >= frame_count_) {
+      return false;
+    }
+    std::this_thread::sleep_for(delay_);
+    frame.create(16, 16, CV_8UC1);
+    frame.setTo(cv::Scalar(next_++ % 256));
+    return true;
+  }
+
+  void close() override { opened_ = false; }
+  int getWidth() const override { return 16; }
+  int getHeight() const override { return 16; }
+  double getFPS() const override { return 30.0; }
+  bool isOpened() const override { return opened_; }
+  std::string getName() const override { return "counting"; }
+
+private:
+  int frame_count_;
+  std::chrono::milliseconds delay_;
+  int next_ = 0;
+  bool opened_ = false;
+};
+
+TEST(PrefetchingSourceTest, ConstructorRejectsInvalidArguments) {
+  EXPECT_THROW(PrefetchingSource(nullptr), std::invalid_argument);
+  EXPECT_THROW(PrefetchingSource(std::make_unique<CountingSource>(
+                                     1, std::chrono::milliseconds(0)),
+                                 PrefetchingSource::Mode::NEVER_DROP, 0),
+               std::invalid_argument);
+}
+
+TEST(PrefetchingSourceTest, NeverDropDeliversEveryFrameInOrder) {
+  PrefetchingSource source(
+      std::make_unique<CountingSource>(50, std::chrono::milliseconds(0)),
+      PrefetchingSource::Mode::NEVER_DROP, 3);
+  ASSERT_TRUE(source.open());
+  EXPECT_EQ(source.getName(), "prefetch:counting");
+  EXPECT_EQ(source.getWidth(), 16);
+
+  cv::Mat frame;
+  for (int i = 0; i < 50; ++i) {
+    ASSERT_TRUE(source.readFrame(frame));
+    EXPECT_EQ(frame.at<uchar>(0, 0), i);
+  }
+
+  EXPECT_FALSE(source.readFrame(frame)); // end of stream
+  EXPECT_EQ(source.getCapturedCount(), 50u);
+  EXPECT_EQ(source.getDroppedCount(), 0u);
+
+  // Consumer releases every frame before the next one: the pool is reused
+  EXPECT_LE(source.getPoolAllocations(), 5u);
+
+  source.close();
+}
+
+TEST(PrefetchingSourceTest, SecondOpenKeepsQueuedFrames) {
+  PrefetchingSource source(
+      std::make_unique<CountingSource>(10, std::chrono::milliseconds(0)),
+      PrefetchingSource::Mode::NEVER_DROP, 3);
+  ASSERT_TRUE(source.open());
+
+  // Let the capture thread fill the queue, then open again as
+  // FrameController::start does
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_TRUE(source.open());
+
+  cv::Mat frame;
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(source.readFrame(frame));
+    EXPECT_EQ(frame.at<uchar>(0, 0), i);
+  }
+  EXPECT_FALSE(source.readFrame(frame));
+  source.close();
+}
+
+TEST(PrefetchingSourceTest, OpenAfterEndOfStreamRestarts) {
+  PrefetchingSource source(
+      std::make_unique<CountingSource>(4, std::chrono::milliseconds(0)),
+      PrefetchingSource::Mode::NEVER_DROP, 3);
+
+  cv::Mat frame;
+  for (int pass = 0; pass < 2; ++pass) {
+    ASSERT_TRUE(source.open());
+    for (int i = 0; i < 4; ++i) {
+      ASSERT_TRUE(source.readFrame(frame));
+      EXPECT_EQ(frame.at<uchar>(0, 0), i);
+    }
+    EXPECT_FALSE(source.readFrame(frame)); // end of stream, not closed
+  }
+  EXPECT_EQ(source.getCapturedCount(), 4u);
+  source.close();
+}
+
+TEST(PrefetchingSourceTest, CaptureTimeIsKeptThroughTheQueue) {
+  PrefetchingSource source(
+      std::make_unique<CountingSource>(3, std::chrono::milliseconds(0)),
+      PrefetchingSource::Mode::NEVER_DROP, 3);
+  ASSERT_TRUE(source.open());
+
+  // Let the capture thread fill the queue before reading
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+
+  cv::Mat frame;
+  FrameInfo info;
+  ASSERT_TRUE(source.readFrame(frame, info));
+  const auto age = std::chrono::steady_clock::now() - info.capture_time;
+  EXPECT_GE(age, std::chrono::milliseconds(20));
+
+  source.close();
+}
+
+TEST(PrefetchingSourceTest, LatestOnlyDropsStaleFrames) {
+  PrefetchingSource source(
+      std::make_unique<CountingSource>(200, std::chrono::milliseconds(1)),
+      PrefetchingSource::Mode::LATEST_ONLY, 2);
+  ASSERT_TRUE(source.open());
+
+  cv::Mat frame;
+  int previous = -1;
+  for (int i = 0; i < 5; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20)); // slow stage
+    ASSERT_TRUE(source.readFrame(frame));
+    EXPECT_GT(frame.at<uchar>(0, 0), previous);
+    previous = frame.at<uchar>(0, 0);
+  }
+
+  EXPECT_GT(source.getDroppedCount(), 0u);
+  source.close();
+}
+
+TEST(PrefetchingSourceTest, HeldFramesAreNeverOverwritten) {
+  PrefetchingSource source(
+      std::make_unique<CountingSource>(40, std::chrono::milliseconds(0)),
+      PrefetchingSource::Mode::NEVER_DROP, 2);
+  ASSERT_TRUE(source.open());
+
+  std::vector<cv::Mat> held;
+  cv::Mat frame;
+  while (source.readFrame(frame)) {
+    held.push_back(frame); // keep a reference to every buffer
+  }
+
+  ASSERT_EQ(held.size(), 40u);
+  for (size_t i = 0; i < held.size(); ++i) {
+    EXPECT_EQ(held[i].at<uchar>(0, 0), i);
+  }
+}
+
+TEST(PrefetchingSourceTest, CloseUnblocksCaptureThread) {
+  PrefetchingSource source(
+      std::make_unique<CountingSource>(1000, std::chrono::milliseconds(0)),
+      PrefetchingSource::Mode::NEVER_DROP, 1);
+  ASSERT_TRUE(source.open());
+
+  cv::Mat frame;
+  ASSERT_TRUE(source.readFrame(frame));
+
+  // Capture thread is blocked on the full queue
+  source.close();
+  EXPECT_FALSE(source.isOpened());
+  EXPECT_FALSE(source.readFrame(frame));
+}
+
+TEST_F(VideoFileSourceTest, PrefetchingVideoFile) {
+  PrefetchingSource source(
+      std::make_unique<VideoFileSource>("/tmp/test_video.mp4"),
+      PrefetchingSource::Mode::NEVER_DROP);
+  ASSERT_TRUE(source.open());
+  EXPECT_EQ(source.getWidth(), 100);
+
+  cv::Mat frame;
+  int count = 0;
+  while (source.readFrame(frame)) {
+    EXPECT_EQ(frame.size(), cv::Size(100, 100));
+    ++count;
+  }
+
+  EXPECT_EQ(count, 60);
+  source.close();
+}
+
+// ==================== NetworkSource Tests ====================
+
+class NetworkSourceTest : public ::testing::Test {
+protected:
+  static std::string encodeJpeg(int width, int height, uchar value) {
+    cv::Mat image(height, width, CV_8UC3, cv::Scalar::all(value));
+    std::vector<uchar> buffer;
+    cv::imencode(".jpg", image, buffer);
+    return std::string(buffer.begin(), buffer.end());
+  }
+
+  // Waits until every accepted message was decoded, failed or superseded
+  static void waitSettled(const NetworkSource &source) {
+    for (int i = 0; i < 200; ++i) {
+      const IngestStats stats = source.getStats();
+      if (stats.decoded + stats.failed + stats.superseded == stats.received) {
+        return;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+  }
+};
+
+TEST_F(NetworkSourceTest, DecodesSubmittedFrame) {
+  NetworkSource source;
+  ASSERT_TRUE(source.open());
+  EXPECT_TRUE(source.isOpened());
+
+  ASSERT_TRUE(source.submit(7, encodeJpeg(64, 48, 200)));
+
+  cv::Mat frame;
+  FrameInfo info;
+  ASSERT_TRUE(source.readFrame(frame, info));
+  EXPECT_EQ(frame.size(), cv::Size(64, 48));
+  EXPECT_EQ(frame.type(), CV_8UC3);
+  EXPECT_NEAR(cv::mean(frame)[0], 200.0, 3.0);
+  EXPECT_EQ(info.frame_index, 0);
+  EXPECT_EQ(source.getLastUploader(), 7u);
+  EXPECT_EQ(source.getWidth(), 64);
+  EXPECT_EQ(source.getHeight(), 48);
+
+  const IngestStats stats = source.getStats();
+  EXPECT_EQ(stats.received, 1u);
+  EXPECT_EQ(stats.decoded, 1u);
+  EXPECT_EQ(stats.uploaders, 1u);
+  EXPECT_GT(stats.avg_decode_ms, 0.0);
+}
+
+TEST_F(NetworkSourceTest, LatestFrameWins) {
+  NetworkSourceOptions options;
+  options.decode_threads = 1;
+  NetworkSource source(options);
+  ASSERT_TRUE(source.open());
+
+  for (int i = 0; i < 20; ++i) {
+    const auto value = static_cast<uchar>(i * 10);
+    ASSERT_TRUE(source.submit(1, encodeJpeg(320, 240, value)));
+  }
+  waitSettled(source);
+
+  // Only the newest frame is left to read
+  cv::Mat frame;
+  ASSERT_TRUE(source.readFrame(frame));
+  EXPECT_NEAR(cv::mean(frame)[0], 190.0, 3.0);
+
+  const IngestStats stats = source.getStats();
+  EXPECT_EQ(stats.received, 20u);
+  EXPECT_EQ(stats.decoded + stats.superseded, 20u);
+  EXPECT_EQ(stats.overwritten + 1, stats.decoded);
+}
+
+TEST_F(NetworkSourceTest, InvalidDataCountedAsFailed) {
+  NetworkSource source;
+  ASSERT_TRUE(source.open());
+
+  ASSERT_TRUE(source.submit(1, "definitely not an image"));
+  waitSettled(source);
+
+  const IngestStats stats = source.getStats();
+  EXPECT_EQ(stats.failed, 1u);
+  EXPECT_EQ(stats.decoded, 0u);
+}
+
+TEST_F(NetworkSourceTest, RejectsWhenClosedOrOversized) {
+  NetworkSourceOptions options;
+  options.max_message_bytes = 16;
+  NetworkSource source(options);
+
+  EXPECT_FALSE(source.submit(1, encodeJpeg(8, 8, 0))); // not opened
+  ASSERT_TRUE(source.open());
+  EXPECT_FALSE(source.submit(1, encodeJpeg(64, 64, 0)));
+  EXPECT_FALSE(source.submit(1, ""));
+
+  const IngestStats stats = source.getStats();
+  EXPECT_EQ(stats.rejected, 3u);
+  EXPECT_EQ(stats.received, 0u);
+}
+
+TEST_F(NetworkSourceTest, ServesUploadersInTurn) {
+  NetworkSource source;
+  ASSERT_TRUE(source.open());
+
+  ASSERT_TRUE(source.submit(1, encodeJpeg(32, 32, 50)));
+  waitSettled(source);
+  ASSERT_TRUE(source.submit(2, encodeJpeg(32, 32, 150)));
+  waitSettled(source);
+
+  cv::Mat frame;
+  ASSERT_TRUE(source.readFrame(frame));
+  EXPECT_EQ(source.getLastUploader(), 1u);
+  EXPECT_NEAR(cv::mean(frame)[0], 50.0, 3.0);
+
+  ASSERT_TRUE(source.readFrame(frame));
+  EXPECT_EQ(source.getLastUploader(), 2u);
+  EXPECT_NEAR(cv::mean(frame)[0], 150.0, 3.0);
+
+  EXPECT_EQ(source.getStats().uploaders, 2u);
+}
+
+TEST_F(NetworkSourceTest, FrameSurvivesLaterDecodes) {
+  NetworkSource source;
+  ASSERT_TRUE(source.open());
+
+  ASSERT_TRUE(source.submit(1, encodeJpeg(32, 32, 40)));
+  cv::Mat first;
+  ASSERT_TRUE(source.readFrame(first));
+
+  // Decodes must not land in the buffer still held by the reader
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(source.submit(1, encodeJpeg(32, 32, 220)));
+    waitSettled(source);
+  }
+  EXPECT_NEAR(cv::mean(first)[0], 40.0, 3.0);
+}
+
+TEST_F(NetworkSourceTest, RemovedUploaderFramesDropped) {
+  NetworkSourceOptions options;
+  options.idle_timeout = std::chrono::milliseconds(50);
+  NetworkSource source(options);
+  ASSERT_TRUE(source.open());
+
+  ASSERT_TRUE(source.submit(3, encodeJpeg(32, 32, 100)));
+  waitSettled(source);
+  source.removeUploader(3);
+  EXPECT_EQ(source.getStats().uploaders, 0u);
+
+  cv::Mat frame;
+  EXPECT_FALSE(source.readFrame(frame));
+}
+
+TEST_F(NetworkSourceTest, IdleTimeoutEndsStream) {
+  NetworkSourceOptions options;
+  options.idle_timeout = std::chrono::milliseconds(50);
+  NetworkSource source(options);
+  ASSERT_TRUE(source.open());
+
+  cv::Mat frame;
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(source.readFrame(frame));
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(50));
+}
+
+TEST_F(NetworkSourceTest, InterruptUnblocksReader) {
+  NetworkSource source;
+  ASSERT_TRUE(source.open());
+
+  std::thread reader([&] {
+    cv::Mat frame;
+    EXPECT_FALSE(source.readFrame(frame));
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  source.interrupt();
+  reader.join();
+
+  // Reopening clears the interruption
+  ASSERT_TRUE(source.open());
+  ASSERT_TRUE(source.submit(1, encodeJpeg(16, 16, 0)));
+  cv::Mat frame;
+  EXPECT_TRUE(source.readFrame(frame));
+}
+
+TEST_F(NetworkSourceTest, CloseUnblocksReader) {
+  NetworkSource source;
+  ASSERT_TRUE(source.open());
+
+  std::thread reader([&] {
+    cv::Mat frame;
+    EXPECT_FALSE(source.readFrame(frame));
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  source.close();
+  reader.join();
+  EXPECT_FALSE(source.isOpened());
+}
@@ -0,0 +1,260 @@
+// tests/test_stream_engine.cpp
+#include "core/ImageSource.hpp"
+#include "core/SyntheticSource.hpp"
+#include "filters/GrayscaleFilter.hpp"
+#include "processing/StreamEngine.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <opencv2/opencv.hpp>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+using namespace visioncore::processing;
+using namespace visioncore::core;
+using namespace visioncore::filters;
+
+namespace {
+
+std::unique_ptr<SyntheticSource> makeSource(int64_t frames = 0) {
+  SyntheticOptions options;
+  options.width = 160;
+  options.height = 120;
+  options.frame_count = frames;
+  return std::make_unique<SyntheticSource>(options);
+}
+
+template <typename Predicate>
+bool waitFor(Predicate predicate,
+             std::chrono::milliseconds timeout = std::chrono::seconds(5)) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (!predicate()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+  return true;
+}
+
+} // namespace
+
+// -------------------- StreamEngine Tests --------------------
+
+TEST(StreamEngineTest, AddStreamFailsOnBadSource) {
+  StreamEngine engine(1);
+  EXPECT_THROW(
+      engine.addStream(std::make_unique<ImageSource>("nonexistent.jpg"), 30.0,
+                       nullptr),
+      std::runtime_error);
+  EXPECT_TRUE(engine.getStreams().empty());
+
+  engine.stop();
+  EXPECT_THROW(engine.addStream(makeSource(), 30.0, nullptr),
+               std::runtime_error);
+}
+
+TEST(StreamEngineTest, FramesAreDeliveredInOrderThroughThePipeline) {
+  StreamEngine engine(4);
+  std::vector<int64_t> indices;
+  bool gray = true;
+
+  const StreamId id = engine.addStream(
+      makeSource(50), 0.0,
+      [&](StreamId, const cv::Mat &original, const cv::Mat &processed,
+          uint64_t) {
+        indices.push_back(
+            SyntheticSource::decodeFrameIndex(original).value_or(-1));
+        gray = gray && processed.channels() == 1;
+      },
+      [](visioncore::pipeline::FramePipeline &pipeline) {
+        pipeline.addFilter(std::make_shared<GrayscaleFilter>());
+      });
+
+  ASSERT_TRUE(waitFor([&] { return engine.getStats(id)->finished; }));
+  ASSERT_EQ(indices.size(), 50u);
+  for (size_t i = 0; i < indices.size(); ++i) {
+    EXPECT_EQ(indices[i], static_cast<int64_t>(i));
+  }
+  EXPECT_EQ(engine.getStats(id)->frames, 50u);
+  EXPECT_TRUE(gray);
+  EXPECT_EQ(engine.getPipeline(id)->size(), 1u);
+}
+
+TEST(StreamEngineTest, EmptyPipelineDeliversSourceFrames) {
+  StreamEngine engine(1);
+  std::atomic<bool> same{false};
+
+  const StreamId id = engine.addStream(
+      makeSource(1), 0.0,
+      [&](StreamId, const cv::Mat &original, const cv::Mat &processed,
+          uint64_t) { same = processed.data == original.data; });
+
+  ASSERT_TRUE(waitFor([&] { return engine.getStats(id)->finished; }));
+  EXPECT_TRUE(same);
+}
+
+TEST(StreamEngineTest, ManyStreamsShareAFixedPool) {
+  StreamEngine engine(2);
+  EXPECT_EQ(engine.getWorkerCount(), 2u);
+
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  std::map<StreamId, int> frames;
+
+  std::vector<StreamId> ids;
+  for (int i = 0; i < 8; ++i) {
+    ids.push_back(engine.addStream(
+        makeSource(30), 0.0,
+        [&](StreamId stream, const cv::Mat &, const cv::Mat &, uint64_t) {
+          std::lock_guard<std::mutex> lock(mutex);
+          threads.insert(std::this_thread::get_id());
+          ++frames[stream];
+        }));
+  }
+
+  for (const StreamId id : ids) {
+    ASSERT_TRUE(waitFor([&] { return engine.getStats(id)->finished; }));
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_LE(threads.size(), 2u);
+  for (const StreamId id : ids) {
+    EXPECT_EQ(frames[id], 30);
+  }
+}
+
+TEST(StreamEngineTest, EachStreamKeepsItsOwnRate) {
+  StreamEngine engine(2);
+  const StreamId fast = engine.addStream(makeSource(), 50.0, nullptr);
+  const StreamId slow = engine.addStream(makeSource(), 10.0, nullptr);
+
+  // Wall-clock counts depend on the machine's load: compare the two
+  // streams with each other instead
+  ASSERT_TRUE(waitFor([&] { return engine.getStats(slow)->frames >= 10; }));
+  const StreamStats fast_stats = *engine.getStats(fast);
+  const StreamStats slow_stats = *engine.getStats(slow);
+
+  // Nominal ratio 5
+  const double ratio = static_cast<double>(fast_stats.frames) /
+                       static_cast<double>(slow_stats.frames);
+  EXPECT_GT(ratio, 2.5);
+  EXPECT_LT(ratio, 7.5);
+}
+
+TEST(StreamEngineTest, OverloadIsSharedFairly) {
+  // One worker, four streams asking for far more than it can do
+  StreamEngine engine(1);
+  std::vector<StreamId> ids;
+  for (int i = 0; i < 4; ++i) {
+    ids.push_back(engine.addStream(
+        makeSource(), 500.0,
+        [](StreamId, const cv::Mat &, const cv::Mat &, uint64_t) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }));
+  }
+
+  const auto snapshot = [&](uint64_t &min_frames, uint64_t &max_frames,
+                            uint64_t &missed) {
+    min_frames = UINT64_MAX;
+    max_frames = 0;
+    missed = 0;
+    for (const StreamId id : ids) {
+      const StreamStats stats = *engine.getStats(id);
+      min_frames = std::min(min_frames, stats.frames);
+      max_frames = std::max(max_frames, stats.frames);
+      missed += stats.missed_slots;
+    }
+  };
+
+  uint64_t min_frames = 0;
+  uint64_t max_frames = 0;
+  uint64_t missed = 0;
+  ASSERT_TRUE(waitFor([&] {
+    snapshot(min_frames, max_frames, missed);
+    return min_frames >= 20;
+  }));
+
+  // No stream starves the others, however fast the machine runs
+  EXPECT_LE(max_frames, min_frames + min_frames / 4 + 2);
+  EXPECT_GT(missed, 0u);
+}
+
+TEST(StreamEngineTest, RemovingAStreamDoesNotDisturbOthers) {
+  StreamEngine engine(2);
+  std::atomic<int> removed_frames{0};
+  std::atomic<int> kept_frames{0};
+  std::atomic<bool> removed{false};
+  std::atomic<bool> called_after_remove{false};
+
+  const StreamId a = engine.addStream(
+      makeSource(), 100.0,
+      [&](StreamId, const cv::Mat &, const cv::Mat &, uint64_t) {
+        called_after_remove = called_after_remove || removed;
+        ++removed_frames;
+      });
+  const StreamId b = engine.addStream(
+      makeSource(), 100.0,
+      [&](StreamId, const cv::Mat &, const cv::Mat &, uint64_t) {
+        ++kept_frames;
+      });
+
+  ASSERT_TRUE(waitFor([&] { return removed_frames > 5; }));
+  EXPECT_TRUE(engine.removeStream(a));
+  removed = true;
+  EXPECT_FALSE(engine.removeStream(a));
+  EXPECT_FALSE(engine.getStats(a).has_value());
+  EXPECT_EQ(engine.getPipeline(a), nullptr);
+
+  const int before = kept_frames;
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT_GT(kept_frames - before, 10);
+  EXPECT_FALSE(called_after_remove);
+
+  const auto streams = engine.getStreams();
+  ASSERT_EQ(streams.size(), 1u);
+  EXPECT_EQ(streams[0], b);
+}
+
+TEST(StreamEngineTest, StreamCanRemoveItselfFromItsCallback) {
+  StreamEngine engine(1);
+  std::atomic<int> frames{0};
+  std::atomic<bool> removed{false};
+  const StreamId self = engine.addStream(
+      makeSource(), 0.0,
+      [&](StreamId id, const cv::Mat &, const cv::Mat &, uint64_t) {
+        if (++frames == 3) {
+          removed = engine.removeStream(id);
+        }
+      });
+
+  // Would deadlock if removeStream() waited for its own frame
+  ASSERT_TRUE(waitFor([&] { return removed.load(); }));
+  EXPECT_FALSE(engine.getStats(self).has_value());
+  EXPECT_TRUE(engine.getStreams().empty());
+
+  // The single worker is free for other streams
+  std::atomic<int> other_frames{0};
+  engine.addStream(makeSource(), 0.0,
+                   [&](StreamId, const cv::Mat &, const cv::Mat &,
+                       uint64_t) { ++other_frames; });
+  ASSERT_TRUE(waitFor([&] { return other_frames > 5; }));
+  EXPECT_EQ(frames, 3);
+}
+
+TEST(StreamEngineTest, StatsAreTracked) {
+  StreamEngine engine(1);
+  const StreamId id = engine.addStream(makeSource(20), 0.0, nullptr);
+
+  ASSERT_TRUE(waitFor([&] { return engine.getStats(id)->finished; }));
+  const StreamStats stats = *engine.getStats(id);
+  EXPECT_EQ(stats.frames, 20u);
+  EXPECT_GT(stats.fps, 0.0);
+  EXPECT_GE(stats.avg_process_ms, 0.0);
+  EXPECT_GE(stats.max_latency_ms, stats.avg_latency_ms);
+}
@@ -0,0 +1,182 @@
+// tests/test_tile_delta.cpp
+#include "processing/TileDeltaEncoder.hpp"
+#include "gtest/gtest.h"
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+using namespace visioncore::processing;
+
+namespace {
+
+cv::Mat makeScene() {
+  cv::Mat frame(240, 320, CV_8UC3);
+  cv::RNG rng(11);
+  rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+  cv::GaussianBlur(frame, frame, cv::Size(9, 9), 0);
+  return frame;
+}
+
+struct Packet {
+  TileDeltaHeader header;
+  std::vector<TilePatch> patches;
+};
+
+Packet parsed(const std::vector<uint8_t> &data) {
+  Packet packet;
+  EXPECT_TRUE(TileDeltaEncoder::parse(data.data(), data.size(), packet.header,
+                                      packet.patches));
+  return packet;
+}
+
+/// Client side: decode every patch into the canvas
+void composite(const std::vector<uint8_t> &data, cv::Mat &canvas) {
+  const Packet packet = parsed(data);
+  if (packet.header.keyframe) {
+    canvas.create(packet.header.frame_size, CV_8UC3);
+  }
+  for (const TilePatch &patch : packet.patches) {
+    const cv::Mat jpeg(1, static_cast<int>(patch.jpeg_size), CV_8UC1,
+                       const_cast<uint8_t *>(patch.jpeg));
+    const cv::Mat decoded = cv::imdecode(jpeg, cv::IMREAD_COLOR);
+    ASSERT_EQ(decoded.size(), patch.rect.size());
+    decoded.copyTo(canvas(patch.rect));
+  }
+}
+
+} // namespace
+
+TEST(TileDeltaEncoderTest, FirstFrameIsKeyframe) {
+  TileDeltaEncoder encoder;
+  std::vector<uint8_t> packet;
+  ASSERT_TRUE(encoder.encode(makeScene(), {}, packet));
+  ASSERT_TRUE(TileDeltaEncoder::isPacket(packet.data(), packet.size()));
+
+  const Packet first = parsed(packet);
+  EXPECT_TRUE(first.header.keyframe);
+  EXPECT_EQ(first.header.sequence, 0u);
+  EXPECT_EQ(first.header.frame_size, cv::Size(320, 240));
+  ASSERT_EQ(first.patches.size(), 1u);
+  EXPECT_EQ(first.patches[0].rect, cv::Rect(0, 0, 320, 240));
+}
+
+TEST(TileDeltaEncoderTest, UnchangedFrameSendsNothing) {
+  TileDeltaEncoder encoder;
+  const cv::Mat frame = makeScene();
+  std::vector<uint8_t> packet;
+  ASSERT_TRUE(encoder.encode(frame, {}, packet));
+  ASSERT_TRUE(encoder.encode(frame.clone(), {}, packet));
+  EXPECT_TRUE(packet.empty());
+  EXPECT_EQ(encoder.getStats().unchanged, 1u);
+}
+
+TEST(TileDeltaEncoderTest, OnlyChangedTilesAreSent) {
+  TileDeltaEncoder encoder;
+  cv::Mat frame = makeScene();
+  std::vector<uint8_t> packet;
+  ASSERT_TRUE(encoder.encode(frame, {}, packet));
+
+  // One tile, then two neighbouring tiles merged into one patch
+  cv::rectangle(frame, cv::Rect(70, 10, 4, 4), cv::Scalar(0, 0, 0),
+                cv::FILLED);
+  cv::rectangle(frame, cv::Rect(200, 130, 60, 60),
+                cv::Scalar(255, 255, 255), cv::FILLED);
+  ASSERT_TRUE(encoder.encode(frame, {}, packet));
+
+  const Packet delta = parsed(packet);
+  EXPECT_FALSE(delta.header.keyframe);
+  EXPECT_EQ(delta.header.sequence, 1u);
+  ASSERT_EQ(delta.patches.size(), 2u);
+  EXPECT_EQ(delta.patches[0].rect, cv::Rect(64, 0, 64, 64));
+  EXPECT_EQ(delta.patches[1].rect, cv::Rect(192, 128, 128, 64));
+}
+
+TEST(TileDeltaEncoderTest, DriftBelowThresholdAccumulates) {
+  TileDeltaEncoder encoder;
+  cv::Mat frame(64, 64, CV_8UC1, cv::Scalar(100));
+  std::vector<uint8_t> packet;
+  ASSERT_TRUE(encoder.encode(frame, {}, packet));
+
+  // Compared with what was last sent, not with the previous frame
+  int sent_at = 0;
+  for (int step = 1; step <= 5 && sent_at == 0; ++step) {
+    frame.setTo(cv::Scalar(100 + step * 5));
+    ASSERT_TRUE(encoder.encode(frame, {}, packet));
+    if (!packet.empty()) {
+      sent_at = step;
+    }
+  }
+  EXPECT_EQ(sent_at, 4);
+}
+
+TEST(TileDeltaEncoderTest, KeyframeTriggers) {
+  TileDeltaOptions options;
+  options.keyframe_interval = 3;
+  TileDeltaEncoder encoder(options);
+  cv::Mat frame = makeScene();
+  std::vector<uint8_t> packet;
+
+  int keyframes = 0;
+  for (int i = 0; i < 9; ++i) {
+    frame.at<cv::Vec3b>(0, 0) = cv::Vec3b(i % 2 ? 0 : 255, 0, 0);
+    ASSERT_TRUE(encoder.encode(frame, {}, packet));
+    keyframes += parsed(packet).header.keyframe;
+  }
+  EXPECT_EQ(keyframes, 3);
+
+  // On request, on a resolution change and when most tiles changed
+  encoder.requestKeyframe();
+  frame.at<cv::Vec3b>(0, 0) = cv::Vec3b(128, 0, 0);
+  ASSERT_TRUE(encoder.encode(frame, {}, packet));
+  EXPECT_TRUE(parsed(packet).header.keyframe);
+
+  EncodeSpec half;
+  half.size = cv::Size(160, 120);
+  ASSERT_TRUE(encoder.encode(frame, half, packet));
+  EXPECT_TRUE(parsed(packet).header.keyframe);
+  EXPECT_EQ(parsed(packet).header.frame_size, half.size);
+
+  TileDeltaEncoder fresh;
+  ASSERT_TRUE(fresh.encode(frame, {}, packet));
+  cv::Mat inverted;
+  cv::bitwise_not(frame, inverted);
+  ASSERT_TRUE(fresh.encode(inverted, {}, packet));
+  EXPECT_TRUE(parsed(packet).header.keyframe);
+}
+
+TEST(TileDeltaEncoderTest, CompositedPatchesTrackTheFrame) {
+  TileDeltaEncoder encoder;
+  cv::Mat frame = makeScene();
+  cv::Mat canvas;
+  std::vector<uint8_t> packet;
+
+  for (int i = 0; i < 10; ++i) {
+    cv::rectangle(frame, cv::Rect(20 + i * 25, 100, 30, 30),
+                  cv::Scalar(i * 25, 255 - i * 25, 128), cv::FILLED);
+    EncodeSpec spec;
+    spec.quality = 90;
+    ASSERT_TRUE(encoder.encode(frame, spec, packet));
+    if (!packet.empty()) {
+      composite(packet, canvas);
+    }
+  }
+  ASSERT_EQ(canvas.size(), frame.size());
+  EXPECT_GT(cv::PSNR(canvas, frame), 30.0);
+}
+
+TEST(TileDeltaEncoderTest, ParseRejectsMalformedPackets) {
+  TileDeltaEncoder encoder;
+  std::vector<uint8_t> packet;
+  ASSERT_TRUE(encoder.encode(makeScene(), {}, packet));
+
+  TileDeltaHeader header;
+  std::vector<TilePatch> patches;
+  EXPECT_FALSE(TileDeltaEncoder::parse(packet.data(), packet.size() - 1,
+                                       header, patches));
+  EXPECT_FALSE(TileDeltaEncoder::parse(packet.data(), 10, header, patches));
+
+  std::vector<uint8_t> jpeg;
+  ASSERT_TRUE(cv::imencode(".jpg", makeScene(), jpeg));
+  EXPECT_FALSE(TileDeltaEncoder::isPacket(jpeg.data(), jpeg.size()));
+  EXPECT_FALSE(
+      TileDeltaEncoder::parse(jpeg.data(), jpeg.size(), header, patches));
+}
@@ -0,0 +1,228 @@
+#include "../src/utils/BufferPool.hpp"
+#include "../src/utils/FramePool.hpp"
+#include "../src/utils/ThreadPool.hpp"
+#include "../src/utils/ThreadSafeQueue.hpp"
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace visioncore::utils;
+
+// ==================== ThreadSafeQueue Tests ====================
+
+TEST(ThreadSafeQueueTest, PushPopOrder) {
+  ThreadSafeQueue<int> queue;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(queue.capacity(), 0u);
+
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_TRUE(queue.push(i));
+  }
+  EXPECT_EQ(queue.size(), 5u);
+
+  int value = -1;
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_FALSE(queue.tryPop(value));
+}
+
+TEST(ThreadSafeQueueTest, TryPushFailsWhenFull) {
+  ThreadSafeQueue<int> queue(2);
+  EXPECT_TRUE(queue.tryPush(1));
+  EXPECT_TRUE(queue.tryPush(2));
+  EXPECT_FALSE(queue.tryPush(3));
+
+  queue.clear();
+  EXPECT_TRUE(queue.empty());
+  EXPECT_TRUE(queue.tryPush(3));
+}
+
+TEST(ThreadSafeQueueTest, PopForTimesOut) {
+  ThreadSafeQueue<int> queue(1);
+  int value = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(queue.popFor(value, std::chrono::milliseconds(20)));
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(15));
+}
+
+TEST(ThreadSafeQueueTest, BlockingPushWaitsForConsumer) {
+  ThreadSafeQueue<int> queue(1);
+  ASSERT_TRUE(queue.push(1));
+
+  std::thread producer([&] { EXPECT_TRUE(queue.push(2)); });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(queue.size(), 1u);
+
+  int value = 0;
+  ASSERT_TRUE(queue.pop(value));
+  EXPECT_EQ(value, 1);
+  ASSERT_TRUE(queue.pop(value));
+  EXPECT_EQ(value, 2);
+
+  producer.join();
+}
+
+TEST(ThreadSafeQueueTest, CloseWakesWaitersAndDrains) {
+  ThreadSafeQueue<int> queue(1);
+  int value = 0;
+
+  std::thread consumer([&] { EXPECT_FALSE(queue.pop(value)); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  queue.close();
+  consumer.join();
+
+  EXPECT_TRUE(queue.isClosed());
+  EXPECT_FALSE(queue.push(1));
+}
+
+// ==================== FramePool Tests ====================
+
+TEST(FramePoolTest, ReusesReleasedBuffers) {
+  FramePool pool(2);
+  EXPECT_EQ(pool.capacity(), 2u);
+
+  for (int i = 0; i < 10; ++i) {
+    cv::Mat &slot = pool.acquire(cv::Size(32, 32), CV_8UC3);
+    cv::Mat handed_out = slot; // consumer reference, released each turn
+    EXPECT_EQ(handed_out.size(), cv::Size(32, 32));
+  }
+
+  EXPECT_EQ(pool.allocations(), 2u);
+}
+
+TEST(FramePoolTest, HeldBuffersAreNotReused) {
+  FramePool pool(2);
+  std::vector<cv::Mat> held;
+
+  for (int i = 0; i < 4; ++i) {
+    cv::Mat &slot = pool.acquire(cv::Size(8, 8), CV_8UC1);
+    slot.setTo(cv::Scalar(i));
+    held.push_back(slot);
+  }
+
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(held[i].at<uchar>(0, 0), i);
+  }
+  EXPECT_EQ(pool.allocations(), 4u);
+}
+
+// ==================== BufferPool Tests ====================
+
+TEST(BufferPoolTest, ReusesReleasedBuffers) {
+  BufferPool pool(2);
+  EXPECT_EQ(pool.capacity(), 2u);
+
+  for (int i = 0; i < 10; ++i) {
+    BufferPool::Buffer buffer = pool.acquire();
+    EXPECT_TRUE(buffer->empty()); // cleared, capacity kept
+    buffer->assign(1024, static_cast<uint8_t>(i));
+  }
+
+  EXPECT_EQ(pool.allocations(), 2u);
+  EXPECT_GE(pool.acquire()->capacity(), 1024u);
+}
+
+TEST(BufferPoolTest, HeldBuffersAreNotReused) {
+  BufferPool pool(2);
+  std::vector<BufferPool::Buffer> held;
+
+  for (int i = 0; i < 4; ++i) {
+    BufferPool::Buffer buffer = pool.acquire();
+    buffer->push_back(static_cast<uint8_t>(i));
+    held.push_back(buffer);
+  }
+
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(held[i]->size(), 1u);
+    EXPECT_EQ((*held[i])[0], i);
+  }
+  EXPECT_EQ(pool.allocations(), 4u);
+}
+
+// ==================== ThreadPool Tests ====================
+
+TEST(ThreadPoolTest, RunsTasksAndReturnsResults) {
+  ThreadPool pool(3);
+  EXPECT_EQ(pool.size(), 3u);
+
+  std::vector<std::future<int>> results;
+  for (int i = 0; i < 20; ++i) {
+    results.push_back(pool.enqueue([i] { return i * i; }));
+  }
+
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_EQ(results[i].get(), i * i);
+  }
+}
+
+TEST(ThreadPoolTest, DefaultSizeUsesHardwareThreads) {
+  ThreadPool pool;
+  EXPECT_GE(pool.size(), 1u);
+}
+
+TEST(ThreadPoolTest, TasksRunInParallel) {
+  ThreadPool pool(4);
+  std::atomic<int> running{0};
+  std::atomic<int> peak{0};
+
+  std::vector<std::future<void>> done;
+  for (int i = 0; i < 4; ++i) {
+    done.push_back(pool.enqueue([&] {
+      const int now = ++running;
+      int expected = peak.load();
+      while (now > expected && !peak.compare_exchange_weak(expected, now)) {
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      --running;
+    }));
+  }
+  for (auto &f : done) {
+    f.get();
+  }
+
+  EXPECT_GT(peak.load(), 1);
+}
+
+TEST(ThreadPoolTest, ExceptionsReachTheFuture) {
+  ThreadPool pool(1);
+  auto result = pool.enqueue([]() -> int { throw std::runtime_error("boom"); });
+  EXPECT_THROW(result.get(), std::runtime_error);
+
+  // The worker survived
+  EXPECT_EQ(pool.enqueue([] { return 7; }).get(), 7);
+}
+
+TEST(ThreadPoolTest, DestructionDiscardsQueuedTasks) {
+  std::future<void> blocked;
+  std::future<void> queued;
+  std::atomic<bool> started{false};
+  std::atomic<bool> queued_ran{false};
+
+  {
+    ThreadPool pool(1);
+    blocked = pool.enqueue([&] {
+      started = true;
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    });
+    queued = pool.enqueue([&] { queued_ran = true; });
+
+    while (!started) {
+      std::this_thread::yield();
+    }
+  }
+
+  EXPECT_NO_THROW(blocked.get());
+  EXPECT_THROW(queued.get(), std::future_error);
+  EXPECT_FALSE(queued_ran);
+}